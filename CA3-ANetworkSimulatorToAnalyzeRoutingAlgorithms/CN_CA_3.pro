@@ -2,7 +2,11 @@ TEMPLATE = subdirs
 
 SUBDIRS += src \
            app \
-           tests
+           tests \
+           tools/tracedecode \
+           benchrunner \
+           sweep \
+           netimage
 
 DISTFILES += \
     .clang-format \
@@ -13,3 +17,15 @@ DISTFILES += \
 
 app.depends = src
 tests.depends = src
+benchrunner.subdir = tools/benchrunner
+benchrunner.depends = src
+sweep.subdir = tools/sweep
+sweep.depends = src
+netimage.subdir = tools/netimage
+netimage.depends = src
+
+# Microbenchmarks need Google Benchmark; the target is skipped where it is not installed.
+packagesExist(benchmark) {
+    SUBDIRS += benchmarks
+    benchmarks.depends = src
+}
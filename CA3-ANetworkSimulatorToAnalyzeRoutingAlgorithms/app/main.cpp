@@ -1,35 +1,54 @@
 #include <QDir>
 #include <QString>
+#include <iostream>
+#include <QSaveFile>
+#include <QJsonDocument>
 #include <QCoreApplication>
+#include <QCommandLineParser>
 
 #include "../src/NetworkSimulator/Simulator.h"
-#include "../src/NetworkSimulator/ApplicationContext.h"
 
 int main(int argc, char* argv[])
 {
     QCoreApplication app(argc, argv);
 
-    QString filePath = ":/configs/mainConfig/config.json";
+    QCommandLineParser parser;
+    Simulator::addCommandLineOptions(parser);
+    parser.process(app);
 
-    QSharedPointer<Simulator> simulator = QSharedPointer<Simulator>::create();
+    QString filePath = parser.isSet("config") ? parser.value("config") : ":/configs/mainConfig/config.json";
+    QString summaryPath = parser.value("summary");
 
-    ApplicationContext::instance().setSimulator(simulator);
+    QSharedPointer<Simulator> simulator = QSharedPointer<Simulator>::create();
 
     if (!simulator->loadConfig(filePath))
     {
         qCritical() << "Failed to load configuration.";
-        return -1;
+        return Simulator::ExitBadConfig;
     }
 
-    QStringList arguments = app.arguments();
-    if (!simulator->configureFromCommandLine(arguments))
+    if (!simulator->configure(parser))
     {
         qCritical() << "Failed to configure simulator.";
-        return -1;
+        return Simulator::ExitBadConfig;
     }
 
+    QObject::connect(simulator.data(), &Simulator::batchFinished, &app, [summaryPath](int exitCode, const QJsonObject &summary) {
+        QJsonDocument document(summary);
+        if (summaryPath.isEmpty()) {
+            std::cout << document.toJson(QJsonDocument::Compact).constData() << std::endl;
+        } else {
+            QSaveFile file(summaryPath);
+            if (!file.open(QIODevice::WriteOnly) || file.write(document.toJson()) < 0 || !file.commit()) {
+                qWarning() << "Failed to write batch summary to" << summaryPath << file.errorString();
+            }
+        }
+        QCoreApplication::exit(exitCode);
+    });
+
     simulator->initializeNetwork();
     simulator->startSimulation();
 
+    // Only a batch run returns; the simulator has already stopped its threads.
     return app.exec();
 }
@@ -0,0 +1,36 @@
+#ifndef BENCHMARKFIXTURES_H
+#define BENCHMARKFIXTURES_H
+
+#include <QString>
+#include <QSharedPointer>
+
+#include "Network/Router.h"
+#include "Globals/SimulationContext.h"
+
+// One simulation for every node the microbenchmarks build; it lives as long as the process.
+inline SimulationContext &benchmarkContext()
+{
+    static SimulationContext *context = new SimulationContext();
+    return *context;
+}
+
+// Address of the n-th synthetic destination; unique for n < 2^16.
+inline QString benchmarkAddress(int n)
+{
+    return QString("10.%1.%2.1").arg((n >> 8) & 0xFF).arg(n & 0xFF);
+}
+
+// A router whose table holds `routes` learned RIP routes spread over its ports.
+inline QSharedPointer<Router> routerWithRoutes(int routes)
+{
+    auto router = QSharedPointer<Router>::create(1, "192.168.100.1", &benchmarkContext());
+    std::vector<PortPtr_t> ports = router->getPorts();
+    for (int i = 0; i < routes; ++i) {
+        const PortPtr_t &port = ports[i % ports.size()];
+        router->addRoute(benchmarkAddress(i), "255.255.255.255", QString("192.168.0.%1").arg(port->getPortNumber()),
+                         1 + i % 8, RoutingProtocol::RIP, port);
+    }
+    return router;
+}
+
+#endif // BENCHMARKFIXTURES_H
@@ -0,0 +1,106 @@
+#include <map>
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkFixtures.h"
+#include "Packet/Packet.h"
+
+namespace {
+
+void BM_FindBestRoutePath(benchmark::State &state)
+{
+    const int routes = static_cast<int>(state.range(0));
+    auto router = routerWithRoutes(routes);
+    int next = 0;
+    for (auto _ : state) {
+        RouteEntry route = router->findBestRoutePath(benchmarkAddress(next));
+        benchmark::DoNotOptimize(route);
+        next = (next + 7919) % routes;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindBestRoutePath)->RangeMultiplier(4)->Range(16, 4096);
+
+// The FIB path processPacket takes, for comparison with the scan above.
+void BM_ForwardingEntry(benchmark::State &state)
+{
+    const int routes = static_cast<int>(state.range(0));
+    auto router = routerWithRoutes(routes);
+    int next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(router->forwardingEntry(benchmarkAddress(next)));
+        next = (next + 7919) % routes;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ForwardingEntry)->RangeMultiplier(4)->Range(16, 4096);
+
+// One RIP update carrying `burst` routes into a table of `routes` entries. The first update
+// improves the routes it carries and later ones only confirm them, as in a converged network.
+void BM_AddRouteRipBurst(benchmark::State &state)
+{
+    const int routes = static_cast<int>(state.range(0));
+    const int burst = static_cast<int>(state.range(1));
+    auto router = routerWithRoutes(routes);
+
+    QString payload = "RIP_UPDATE:";
+    for (int i = 0; i < burst; ++i) {
+        payload += benchmarkAddress(i) + ",255.255.255.255,0#";
+    }
+    payload += "192.168.0.1";
+    auto update = QSharedPointer<Packet>::create(PacketType::Control, payload);
+
+    for (auto _ : state) {
+        router->processRIPUpdate(update);
+    }
+    state.SetItemsProcessed(state.iterations() * burst);
+}
+BENCHMARK(BM_AddRouteRipBurst)->ArgsProduct({{64, 512, 4096}, {16, 256}});
+
+enum class LsdbShape { Grid, Torus };
+
+// Link-state view of a side x side grid or torus, as router (0, 0) would hold it after flooding.
+// Each LSA runs SPF as it arrives, so the routers are built once per shape and size.
+Router &routerWithLsdb(LsdbShape shape, int side)
+{
+    static std::map<std::pair<int, int>, QSharedPointer<Router>> cache;
+    auto &router = cache[{static_cast<int>(shape), side}];
+    if (router) return *router;
+
+    auto address = [side](int row, int column) { return benchmarkAddress(row * side + column); };
+    router = QSharedPointer<Router>::create(1, address(0, 0), &benchmarkContext());
+    for (int row = 0; row < side; ++row) {
+        for (int column = 0; column < side; ++column) {
+            QStringList links;
+            for (auto [dr, dc] : {std::pair{-1, 0}, {1, 0}, {0, -1}, {0, 1}}) {
+                int r = row + dr;
+                int c = column + dc;
+                if (shape == LsdbShape::Torus) {
+                    r = (r + side) % side;
+                    c = (c + side) % side;
+                } else if (r < 0 || r >= side || c < 0 || c >= side) {
+                    continue;
+                }
+                links << address(r, c);
+            }
+            auto lsa = QSharedPointer<Packet>::create(PacketType::OSPFLSA,
+                                                      "LSA:" + address(row, column) + ":" + links.join(","), 10);
+            lsa->setSequenceNumber(1);
+            router->processLSA(lsa, nullptr);
+        }
+    }
+    return *router;
+}
+
+void BM_RunDijkstra(benchmark::State &state, LsdbShape shape)
+{
+    const int side = static_cast<int>(state.range(0));
+    Router &router = routerWithLsdb(shape, side);
+    for (auto _ : state) {
+        router.runDijkstra();
+    }
+    state.counters["nodes"] = side * side;
+}
+BENCHMARK_CAPTURE(BM_RunDijkstra, grid, LsdbShape::Grid)->DenseRange(4, 16, 4)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RunDijkstra, torus, LsdbShape::Torus)->DenseRange(4, 16, 4)->Unit(benchmark::kMicrosecond);
+
+}
@@ -0,0 +1,106 @@
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkFixtures.h"
+#include "Network/PC.h"
+#include "Packet/Packet.h"
+#include "DataGenerator/DataGenerator.h"
+#include "MetricsCollector/MetricsCollector.h"
+
+namespace {
+
+void BM_PacketCreate(benchmark::State &state)
+{
+    for (auto _ : state) {
+        auto packet = QSharedPointer<Packet>::create(PacketType::Data, "Hello from PC 1", 10);
+        benchmark::DoNotOptimize(packet);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketCreate);
+
+// Copy of a packet that has already crossed `hops` routers; the path vectors dominate.
+void BM_PacketCopy(benchmark::State &state)
+{
+    Packet packet(PacketType::Data, "Hello from PC 1", 64);
+    for (int hop = 0; hop < state.range(0); ++hop) {
+        packet.addToPath(benchmarkAddress(hop));
+        packet.addToPathTaken(benchmarkAddress(hop));
+    }
+    for (auto _ : state) {
+        Packet copy(packet);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketCopy)->Arg(0)->Arg(8)->Arg(32);
+
+// Per-hop work of a forwarded packet: the FIB lookup and the packet updates processPacket makes.
+void BM_PacketForwardHop(benchmark::State &state)
+{
+    auto router = routerWithRoutes(256);
+    const QString destination = benchmarkAddress(128);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto packet = QSharedPointer<Packet>::create(PacketType::Data, "Hello from PC 1", 64);
+        state.ResumeTiming();
+
+        const FibEntry &entry = router->forwardingEntry(destination);
+        const Adjacency &adjacency = router->getForwardingTable().adjacency(entry.adjacency);
+        packet->decrementTTL();
+        packet->addToPath(adjacency.nextHop);
+        packet->addToPathTaken(adjacency.nextHop);
+        benchmark::DoNotOptimize(packet);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketForwardHop);
+
+// One tick's batch at 10000 pps, built as the coordinator injects it.
+void BM_GenerateTrafficTick(benchmark::State &state)
+{
+    std::vector<QSharedPointer<PC>> senders;
+    for (int i = 0; i < state.range(0); ++i) {
+        senders.push_back(QSharedPointer<PC>::create(i + 1, QString("192.168.0.%1").arg(i + 1), &benchmarkContext()));
+    }
+    DataGenerator generator(&benchmarkContext());
+    generator.setSenders(senders);
+    generator.setOfferedLoad(10000.0);
+    generator.setCycleDuration(std::chrono::milliseconds(100));
+    generator.setTrafficDuration(std::chrono::hours(24));
+    generator.startTraffic();
+
+    qint64 packets = 0;
+    for (auto _ : state) {
+        std::vector<QSharedPointer<Packet>> batch = generator.nextBatch();
+        packets += static_cast<qint64>(batch.size());
+        benchmark::DoNotOptimize(batch);
+    }
+    state.SetItemsProcessed(packets);
+}
+BENCHMARK(BM_GenerateTrafficTick)->Arg(2)->Arg(16)->Arg(64)->Unit(benchmark::kMicrosecond);
+
+// Delivery accounting from every thread at once, as routers on their own threads do.
+void BM_MetricsCollectorRecord(benchmark::State &state)
+{
+    static MetricsCollector *collector = nullptr;
+    static QVector<QString> path;
+    if (state.thread_index() == 0) {
+        collector = new MetricsCollector;
+        path = {benchmarkAddress(1), benchmarkAddress(2), benchmarkAddress(3), benchmarkAddress(4)};
+    }
+    for (auto _ : state) {
+        collector->recordPacketSent();
+        collector->recordRouterUsage(path.first());
+        collector->recordHopCount(path.size());
+        collector->recordPacketReceived(path);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        delete collector;
+        collector = nullptr;
+    }
+}
+BENCHMARK(BM_MetricsCollectorRecord)->ThreadRange(1, 8)->UseRealTime();
+
+}
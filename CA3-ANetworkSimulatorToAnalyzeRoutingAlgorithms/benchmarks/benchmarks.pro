@@ -0,0 +1,18 @@
+TEMPLATE = app
+TARGET = cnca3bench
+CONFIG += console c++20 link_pkgconfig
+QT += core network
+
+# Google Benchmark, found through pkg-config (libbenchmark-dev, or brew install google-benchmark).
+PKGCONFIG += benchmark
+
+SOURCES += $$PWD/main.cpp \
+           $$PWD/RouterBenchmarks.cpp \
+           $$PWD/TrafficBenchmarks.cpp
+
+HEADERS += $$PWD/BenchmarkFixtures.h
+
+INCLUDEPATH += $$PWD/../src \
+               $$PWD/../src/Globals
+
+LIBS += -L$$PWD/../lib -lcnca3lib
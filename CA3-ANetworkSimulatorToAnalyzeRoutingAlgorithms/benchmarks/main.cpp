@@ -0,0 +1,37 @@
+#include <cstdio>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+
+namespace {
+
+void quietMessageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    if (type != QtDebugMsg && type != QtInfoMsg) {
+        fprintf(stderr, "%s\n", qPrintable(message));
+    }
+}
+
+}
+
+// Results are JSON by default so runs can be compared over time, e.g.
+//     cnca3bench --benchmark_out=bench.json --benchmark_out_format=json
+// Later flags override the default, so --benchmark_format=console still works.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    qInstallMessageHandler(quietMessageHandler);
+
+    std::vector<char *> args(argv, argv + argc);
+    char jsonFormat[] = "--benchmark_format=json";
+    args.insert(args.begin() + 1, jsonFormat);
+    int count = static_cast<int>(args.size());
+
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
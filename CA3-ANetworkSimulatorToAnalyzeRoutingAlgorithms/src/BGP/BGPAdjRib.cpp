@@ -0,0 +1,122 @@
+#include <QMap>
+
+#include "BGPAdjRib.h"
+
+static bool samePath(const BGPPath &a, const BGPPath &b)
+{
+    return a.asPath == b.asPath && a.localPref == b.localPref && a.med == b.med && a.nextHop == b.nextHop &&
+           a.external == b.external && a.igpCost == b.igpCost && a.originatorId == b.originatorId &&
+           a.clusterList == b.clusterList && a.confedPath == b.confedPath;
+}
+
+bool BGPAdjRibIn::announce(const BGPPath &path)
+{
+    QHash<Prefix, BGPPath> &paths = m_paths[path.peerId];
+    auto it = paths.find(path.prefix);
+    if (it != paths.end() && samePath(it.value(), path)) {
+        return false;
+    }
+    paths.insert(path.prefix, path);
+    return true;
+}
+
+bool BGPAdjRibIn::withdraw(int peerId, const Prefix &prefix)
+{
+    auto peer = m_paths.find(peerId);
+    return peer != m_paths.end() && peer->remove(prefix) > 0;
+}
+
+int BGPAdjRibIn::pathCount() const
+{
+    int count = 0;
+    for (const auto &paths : m_paths) {
+        count += paths.size();
+    }
+    return count;
+}
+
+void BGPAdjRibOut::queue(int peerId, const QVector<Prefix> &prefixes)
+{
+    Peer &peer = m_peers[peerId];
+    for (const Prefix &prefix : prefixes) {
+        if (!peer.pendingSet.contains(prefix)) {
+            peer.pendingSet.insert(prefix);
+            peer.pending.append(prefix);
+        }
+    }
+}
+
+QVector<int> BGPAdjRibOut::pendingPeers() const
+{
+    QVector<int> peers;
+    for (auto it = m_peers.constBegin(); it != m_peers.constEnd(); ++it) {
+        if (!it.value().pending.isEmpty()) {
+            peers.append(it.key());
+        }
+    }
+    return peers;
+}
+
+QVector<Prefix> BGPAdjRibOut::takePending(int peerId)
+{
+    Peer &peer = m_peers[peerId];
+    QVector<Prefix> pending = peer.pending;
+    peer.pending.clear();
+    peer.pendingSet.clear();
+    return pending;
+}
+
+QVector<BGPUpdate> BGPAdjRibOut::diff(int peerId, const QVector<Prefix> &prefixes,
+                                      const QHash<Prefix, BGPUpdate> &exports, const BGPUpdate &header)
+{
+    Peer &peer = m_peers[peerId];
+    QMap<QString, BGPUpdate> updates;
+    QVector<Prefix> withdrawn;
+
+    for (const Prefix &prefix : prefixes) {
+        auto exported = exports.constFind(prefix);
+        if (exported == exports.constEnd()) {
+            if (peer.advertised.remove(prefix) > 0) {
+                withdrawn.append(prefix);
+            }
+            continue;
+        }
+
+        QString signature = exported.value().toPayload();
+        auto sent = peer.advertised.constFind(prefix);
+        if (sent != peer.advertised.constEnd() && sent.value() == signature) {
+            ++m_suppressed;
+            continue;
+        }
+        peer.advertised.insert(prefix, signature);
+
+        auto it = updates.find(signature);
+        if (it == updates.end()) {
+            it = updates.insert(signature, exported.value());
+        }
+        it->announced.append(prefix);
+    }
+
+    QVector<BGPUpdate> outgoing = updates.values();
+    if (!withdrawn.isEmpty()) {
+        // Withdrawals ride along with the first announcement instead of costing a message of their own.
+        if (outgoing.isEmpty()) {
+            BGPUpdate withdrawal;
+            withdrawal.internal = header.internal;
+            withdrawal.senderId = header.senderId;
+            withdrawal.nextHop = header.nextHop;
+            outgoing.append(withdrawal);
+        }
+        outgoing.first().withdrawn = withdrawn;
+    }
+    return outgoing;
+}
+
+int BGPAdjRibOut::advertisedCount() const
+{
+    int count = 0;
+    for (const Peer &peer : m_peers) {
+        count += peer.advertised.size();
+    }
+    return count;
+}
@@ -0,0 +1,61 @@
+#ifndef BGPADJRIB_H
+#define BGPADJRIB_H
+
+#include <QSet>
+#include <QHash>
+#include <QVector>
+
+#include "BGPRib.h"
+
+constexpr int BGP_DEFAULT_MRAI_TICKS = 2;
+
+// Adj-RIB-In: the paths each peer currently announces, after loop checks.
+class BGPAdjRibIn
+{
+public:
+    // Returns false when the peer re-announced exactly the path it already had.
+    bool announce(const BGPPath &path);
+    // Returns false when the peer never announced the prefix.
+    bool withdraw(int peerId, const Prefix &prefix);
+
+    int pathCount() const;
+
+private:
+    QHash<int, QHash<Prefix, BGPPath>> m_paths;
+};
+
+// Adj-RIB-Out: what each peer was last told, plus the prefixes queued for it until its
+// Min Route Advertisement Interval expires. Send times are simulation ticks.
+class BGPAdjRibOut
+{
+public:
+    void queue(int peerId, const QVector<Prefix> &prefixes);
+    QVector<int> pendingPeers() const;
+    QVector<Prefix> takePending(int peerId);
+
+    // exports maps each prefix to the attributes that would be sent now; a prefix missing from it
+    // is withdrawn if the peer has it. Prefixes the peer already has with the same attributes are
+    // skipped, the rest are packed into one UPDATE per attribute set. header supplies the sender
+    // fields of a withdrawal-only UPDATE.
+    QVector<BGPUpdate> diff(int peerId, const QVector<Prefix> &prefixes,
+                            const QHash<Prefix, BGPUpdate> &exports, const BGPUpdate &header);
+
+    int lastSent(int peerId) const { return m_peers.value(peerId).lastSentTick; }
+    void markSent(int peerId, int tick) { m_peers[peerId].lastSentTick = tick; }
+
+    int advertisedCount() const;
+    int suppressedCount() const { return m_suppressed; }
+
+private:
+    struct Peer {
+        QHash<Prefix, QString> advertised;   // Prefix -> attribute signature last sent
+        QVector<Prefix> pending;
+        QSet<Prefix> pendingSet;
+        int lastSentTick = -1;
+    };
+
+    QHash<int, Peer> m_peers;
+    int m_suppressed = 0;
+};
+
+#endif // BGPADJRIB_H
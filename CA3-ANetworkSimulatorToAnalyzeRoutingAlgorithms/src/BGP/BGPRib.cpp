@@ -0,0 +1,191 @@
+#include "BGPRib.h"
+
+bool BGPRib::isBetter(const BGPPath &candidate, const BGPPath &current)
+{
+    if (candidate.isLocal() != current.isLocal()) {
+        return candidate.isLocal();
+    }
+    if (candidate.localPref != current.localPref) {
+        return candidate.localPref > current.localPref;
+    }
+    if (candidate.asPath.size() != current.asPath.size()) {
+        return candidate.asPath.size() < current.asPath.size();
+    }
+    if (candidate.neighborAs() == current.neighborAs() && candidate.med != current.med) {
+        return candidate.med < current.med;
+    }
+    if (candidate.external != current.external) {
+        return candidate.external;
+    }
+    if (candidate.igpCost != current.igpCost) {
+        return candidate.igpCost < current.igpCost;
+    }
+    if (candidate.clusterList.size() != current.clusterList.size()) {
+        return candidate.clusterList.size() < current.clusterList.size();
+    }
+    return candidate.peerId < current.peerId;
+}
+
+int BGPRib::selectBest(const QVector<BGPPath> &candidates)
+{
+    int best = -1;
+    for (int i = 0; i < candidates.size(); ++i) {
+        if (best < 0 || isBetter(candidates[i], candidates[best])) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+BGPRib::Entry *BGPRib::find(const Prefix &prefix)
+{
+    auto bucket = m_byLength.find(prefix.length);
+    if (bucket == m_byLength.end()) {
+        return nullptr;
+    }
+    auto it = bucket->second.find(prefix.network);
+    return it != bucket->second.end() ? &it.value() : nullptr;
+}
+
+const BGPRib::Entry *BGPRib::find(const Prefix &prefix) const
+{
+    auto bucket = m_byLength.find(prefix.length);
+    if (bucket == m_byLength.end()) {
+        return nullptr;
+    }
+    auto it = bucket->second.constFind(prefix.network);
+    return it != bucket->second.constEnd() ? &it.value() : nullptr;
+}
+
+bool BGPRib::update(const BGPPath &path)
+{
+    if (!path.prefix.isValid()) {
+        return false;
+    }
+
+    Entry *entry = find(path.prefix);
+    if (!entry) {
+        entry = &m_byLength[path.prefix.length][path.prefix.network];
+        ++m_prefixCount;
+    }
+
+    BGPPath previous;
+    if (entry->best >= 0) {
+        previous = entry->candidates[entry->best];
+    }
+
+    // A peer holds at most one path per prefix; a new announcement replaces the old one.
+    bool replaced = false;
+    for (BGPPath &candidate : entry->candidates) {
+        if (candidate.peerId == path.peerId) {
+            candidate = path;
+            replaced = true;
+            break;
+        }
+    }
+    if (!replaced) {
+        entry->candidates.append(path);
+    }
+
+    bool hadBest = entry->best >= 0;
+    entry->best = selectBest(entry->candidates);
+    const BGPPath &current = entry->candidates[entry->best];
+
+    return !hadBest || current.peerId != previous.peerId || current.asPath != previous.asPath ||
+           current.localPref != previous.localPref || current.med != previous.med ||
+           current.nextHop != previous.nextHop;
+}
+
+bool BGPRib::withdraw(const Prefix &prefix, int peerId)
+{
+    Entry *entry = find(prefix);
+    if (!entry) {
+        return false;
+    }
+
+    int index = -1;
+    for (int i = 0; i < entry->candidates.size(); ++i) {
+        if (entry->candidates[i].peerId == peerId) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        return false;
+    }
+
+    bool wasBest = index == entry->best;
+    entry->candidates.removeAt(index);
+
+    if (entry->candidates.isEmpty()) {
+        auto bucket = m_byLength.find(prefix.length);
+        bucket->second.remove(prefix.network);
+        if (bucket->second.isEmpty()) {
+            m_byLength.erase(bucket);
+        }
+        --m_prefixCount;
+        return true;
+    }
+
+    entry->best = selectBest(entry->candidates);
+    return wasBest;
+}
+
+const BGPPath *BGPRib::best(const Prefix &prefix) const
+{
+    const Entry *entry = find(prefix);
+    return entry && entry->best >= 0 ? &entry->candidates[entry->best] : nullptr;
+}
+
+const BGPPath *BGPRib::lookup(quint32 address) const
+{
+    for (const auto &[length, bucket] : m_byLength) {
+        auto it = bucket.constFind(address & Prefix::maskFor(length));
+        if (it != bucket.constEnd() && it->best >= 0) {
+            return &it->candidates[it->best];
+        }
+    }
+    return nullptr;
+}
+
+const BGPPath *BGPRib::lookup(const QString &address) const
+{
+    quint32 value = 0;
+    return Prefix::parseAddress(address, value) ? lookup(value) : nullptr;
+}
+
+int BGPRib::pathCount() const
+{
+    int count = 0;
+    for (const auto &[length, bucket] : m_byLength) {
+        for (const Entry &entry : bucket) {
+            count += entry.candidates.size();
+        }
+    }
+    return count;
+}
+
+QVector<BGPPath> BGPRib::allPaths() const
+{
+    QVector<BGPPath> paths;
+    for (const auto &[length, bucket] : m_byLength) {
+        for (const Entry &entry : bucket) {
+            paths += entry.candidates;
+        }
+    }
+    return paths;
+}
+
+QVector<BGPPath> BGPRib::bestPaths() const
+{
+    QVector<BGPPath> paths;
+    paths.reserve(m_prefixCount);
+    for (const auto &[length, bucket] : m_byLength) {
+        for (const Entry &entry : bucket) {
+            if (entry.best >= 0) {
+                paths.append(entry.candidates[entry.best]);
+            }
+        }
+    }
+    return paths;
+}
@@ -0,0 +1,66 @@
+#ifndef BGPRIB_H
+#define BGPRIB_H
+
+#include <map>
+#include <functional>
+#include <QHash>
+#include <QVector>
+
+#include "BGPUpdate.h"
+
+struct BGPPath
+{
+    Prefix prefix;
+    QVector<int> asPath;
+    int localPref = BGP_DEFAULT_LOCAL_PREF;
+    int med = 0;
+    QString nextHop;
+    int peerId = -1;          // Router the path was heard from; -1 for locally originated prefixes
+    bool external = false;
+    int igpCost = 0;          // IGP metric to nextHop
+    int originatorId = -1;    // Set by route reflectors
+    QVector<int> clusterList;
+    QVector<int> confedPath;  // Member ASes crossed inside a confederation
+
+    bool isLocal() const { return peerId < 0; }
+    int neighborAs() const { return asPath.isEmpty() ? 0 : asPath.first(); }
+};
+
+// Loc-RIB: every candidate path per prefix plus the one chosen by the decision process.
+// Prefixes are bucketed by length so a longest-prefix lookup costs one hash probe per length.
+class BGPRib
+{
+public:
+    // Both return true when the best path for the prefix changed (including appearing or vanishing).
+    bool update(const BGPPath &path);
+    bool withdraw(const Prefix &prefix, int peerId);
+
+    const BGPPath *best(const Prefix &prefix) const;
+    const BGPPath *lookup(quint32 address) const;
+    const BGPPath *lookup(const QString &address) const;
+
+    QVector<BGPPath> bestPaths() const;
+    QVector<BGPPath> allPaths() const;      // Every candidate; update() with each rebuilds the RIB
+    int prefixCount() const { return m_prefixCount; }
+    int pathCount() const;
+
+    // Decision process: locally originated, higher LOCAL_PREF, shorter AS_PATH, lower MED between
+    // paths from the same neighbour AS, eBGP over iBGP, lower IGP cost to the next hop, shorter
+    // CLUSTER_LIST, lower peer id.
+    static bool isBetter(const BGPPath &candidate, const BGPPath &current);
+
+private:
+    struct Entry {
+        QVector<BGPPath> candidates;
+        int best = -1;
+    };
+
+    Entry *find(const Prefix &prefix);
+    const Entry *find(const Prefix &prefix) const;
+    static int selectBest(const QVector<BGPPath> &candidates);
+
+    std::map<int, QHash<quint32, Entry>, std::greater<int>> m_byLength;
+    int m_prefixCount = 0;
+};
+
+#endif // BGPRIB_H
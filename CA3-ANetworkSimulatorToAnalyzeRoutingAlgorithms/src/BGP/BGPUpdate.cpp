@@ -0,0 +1,102 @@
+#include <QStringList>
+
+#include "BGPUpdate.h"
+
+static bool parseNumbers(const QString &text, QVector<int> &numbers)
+{
+    for (const QString &item : text.split(',', Qt::SkipEmptyParts)) {
+        bool ok = false;
+        numbers.append(item.toInt(&ok));
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static QString formatNumbers(const QVector<int> &numbers)
+{
+    QStringList items;
+    for (int number : numbers) {
+        items.append(QString::number(number));
+    }
+    return items.join(',');
+}
+
+static bool parsePrefixes(const QString &text, QVector<Prefix> &prefixes)
+{
+    for (const QString &item : text.split(';', Qt::SkipEmptyParts)) {
+        Prefix prefix;
+        if (!Prefix::parse(item, prefix)) {
+            return false;
+        }
+        prefixes.append(prefix);
+    }
+    return true;
+}
+
+static QString formatPrefixes(const QVector<Prefix> &prefixes)
+{
+    QStringList items;
+    for (const Prefix &prefix : prefixes) {
+        items.append(prefix.toString());
+    }
+    return items.join(';');
+}
+
+bool BGPUpdate::parse(const QString &payload, BGPUpdate &update)
+{
+    QStringList parts = payload.split(':');
+    if ((parts.size() != 9 && parts.size() != 12) || parts[0] != "BGP_UPDATE" || (parts[1] != "E" && parts[1] != "I")) {
+        return false;
+    }
+
+    update = BGPUpdate();
+    update.internal = parts[1] == "I";
+
+    bool ok = false;
+    update.senderId = parts[2].toInt(&ok);
+    if (!ok) {
+        return false;
+    }
+    update.nextHop = parts[3];
+    update.localPref = parts[4].toInt(&ok);
+    if (!ok) {
+        return false;
+    }
+    update.med = parts[5].toInt(&ok);
+    if (!ok) {
+        return false;
+    }
+
+    if (!parseNumbers(parts[6], update.asPath)) {
+        return false;
+    }
+
+    if (parts.size() == 12) {
+        update.originatorId = parts[9].toInt(&ok);
+        if (!ok || !parseNumbers(parts[10], update.clusterList) || !parseNumbers(parts[11], update.confedPath)) {
+            return false;
+        }
+    }
+
+    return parsePrefixes(parts[7], update.announced) && parsePrefixes(parts[8], update.withdrawn);
+}
+
+QString BGPUpdate::toPayload() const
+{
+    QString payload = QString("BGP_UPDATE:%1:%2:%3:%4:%5:%6:%7:%8")
+        .arg(internal ? "I" : "E")
+        .arg(senderId)
+        .arg(nextHop)
+        .arg(localPref)
+        .arg(med)
+        .arg(formatNumbers(asPath))
+        .arg(formatPrefixes(announced))
+        .arg(formatPrefixes(withdrawn));
+
+    if (hasReflectionAttributes()) {
+        payload += QString(":%1:%2:%3").arg(originatorId).arg(formatNumbers(clusterList)).arg(formatNumbers(confedPath));
+    }
+    return payload;
+}
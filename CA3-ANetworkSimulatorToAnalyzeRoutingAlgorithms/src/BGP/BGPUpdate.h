@@ -0,0 +1,41 @@
+#ifndef BGPUPDATE_H
+#define BGPUPDATE_H
+
+#include <QString>
+#include <QVector>
+
+#include "Prefix.h"
+
+constexpr int BGP_DEFAULT_LOCAL_PREF = 100;
+
+// One BGP UPDATE: a single set of path attributes shared by every announced prefix.
+//   BGP_UPDATE:<E|I>:<sender>:<next hop>:<local pref>:<med>:<as path>:<announced>:<withdrawn>
+//              [:<originator>:<cluster list>:<confederation path>]
+// as path is a comma separated list of AS numbers, nearest AS first; prefixes are ';' separated.
+// The bracketed route reflection and confederation attributes are only sent when set.
+struct BGPUpdate
+{
+    bool internal = false;
+    int senderId = -1;
+    QString nextHop;
+    int localPref = BGP_DEFAULT_LOCAL_PREF;
+    int med = 0;
+    QVector<int> asPath;
+    QVector<Prefix> announced;
+    QVector<Prefix> withdrawn;
+
+    int originatorId = -1;
+    QVector<int> clusterList;
+    QVector<int> confedPath;
+
+    static bool parse(const QString &payload, BGPUpdate &update);
+    QString toPayload() const;
+
+    bool isEmpty() const { return announced.isEmpty() && withdrawn.isEmpty(); }
+    bool hasReflectionAttributes() const
+    {
+        return originatorId >= 0 || !clusterList.isEmpty() || !confedPath.isEmpty();
+    }
+};
+
+#endif // BGPUPDATE_H
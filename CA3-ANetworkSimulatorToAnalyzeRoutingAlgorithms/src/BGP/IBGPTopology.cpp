@@ -0,0 +1,197 @@
+#include <QSet>
+#include <QDebug>
+#include <QJsonArray>
+
+#include "IBGPTopology.h"
+
+const IBGPPeer *IBGPRole::findPeer(int routerId) const
+{
+    for (const IBGPPeer &peer : peers) {
+        if (peer.routerId == routerId) {
+            return &peer;
+        }
+    }
+    return nullptr;
+}
+
+bool IBGPTopology::parseMode(const QString &text, IBGPMode &mode)
+{
+    QString name = text.trimmed().toLower();
+    if (name == "flood") {
+        mode = IBGPMode::Flood;
+    } else if (name == "full_mesh") {
+        mode = IBGPMode::FullMesh;
+    } else if (name == "route_reflector") {
+        mode = IBGPMode::RouteReflector;
+    } else if (name == "confederation") {
+        mode = IBGPMode::Confederation;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QString IBGPTopology::modeName(IBGPMode mode)
+{
+    switch (mode) {
+    case IBGPMode::Flood:
+        return "flood";
+    case IBGPMode::RouteReflector:
+        return "route_reflector";
+    case IBGPMode::Confederation:
+        return "confederation";
+    default:
+        return "full_mesh";
+    }
+}
+
+void IBGPTopology::addSession(int a, int b, bool aReflectsB, bool bReflectsA)
+{
+    if (a == b) {
+        return;
+    }
+
+    auto attach = [this](int local, int remote, bool client) {
+        IBGPRole &role = m_roles[local];
+        for (IBGPPeer &peer : role.peers) {
+            if (peer.routerId == remote) {
+                peer.client = peer.client || client;
+                return;
+            }
+        }
+        role.peers.append(IBGPPeer{remote, client, m_roles.value(remote).subAs});
+    };
+
+    attach(a, b, aReflectsB);
+    attach(b, a, bReflectsA);
+}
+
+bool IBGPTopology::configure(const QJsonObject &config, const QVector<int> &routers, const QVector<QPair<int, int>> &links)
+{
+    m_roles.clear();
+
+    QString modeText = config.value("mode").toString("full_mesh");
+    if (!parseMode(modeText, m_mode)) {
+        qWarning() << "IBGPTopology: Unknown iBGP mode" << modeText << ". Using full mesh.";
+        m_mode = IBGPMode::FullMesh;
+    }
+
+    for (int id : routers) {
+        m_roles[id].mode = m_mode;
+    }
+
+    switch (m_mode) {
+    case IBGPMode::Flood:
+        return true;
+
+    case IBGPMode::FullMesh:
+        for (int i = 0; i < routers.size(); ++i) {
+            for (int j = i + 1; j < routers.size(); ++j) {
+                addSession(routers[i], routers[j]);
+            }
+        }
+        return true;
+
+    case IBGPMode::RouteReflector: {
+        QJsonArray reflectors = config.value("route_reflectors").toArray();
+        QSet<int> reflectorIds;
+        for (const QJsonValue &value : reflectors) {
+            int id = value.toObject().value("router").toInt();
+            if (m_roles.contains(id)) {
+                reflectorIds.insert(id);
+            } else {
+                qWarning() << "IBGPTopology: Route reflector" << id << "is not a router of this AS.";
+            }
+        }
+
+        if (reflectorIds.isEmpty()) {
+            qWarning() << "IBGPTopology: No route reflectors configured.";
+            return false;
+        }
+
+        // Reflectors peer with each other as ordinary iBGP neighbours.
+        for (int a : reflectorIds) {
+            for (int b : reflectorIds) {
+                if (a < b) {
+                    addSession(a, b);
+                }
+            }
+        }
+
+        for (const QJsonValue &value : reflectors) {
+            QJsonObject reflector = value.toObject();
+            int id = reflector.value("router").toInt();
+            if (!reflectorIds.contains(id)) {
+                continue;
+            }
+            m_roles[id].clusterId = reflector.value("cluster_id").toInt(id);
+
+            QVector<int> clients;
+            if (reflector.contains("clients")) {
+                for (const QJsonValue &client : reflector.value("clients").toArray()) {
+                    clients.append(client.toInt());
+                }
+            } else {
+                clients = routers;
+            }
+
+            for (int client : clients) {
+                if (m_roles.contains(client) && !reflectorIds.contains(client)) {
+                    addSession(id, client, true, false);
+                }
+            }
+        }
+        return true;
+    }
+
+    case IBGPMode::Confederation: {
+        QHash<int, int> memberOf;
+        for (const QJsonValue &value : config.value("sub_as").toArray()) {
+            QJsonObject member = value.toObject();
+            int subAs = member.value("id").toInt();
+            for (const QJsonValue &router : member.value("routers").toArray()) {
+                int id = router.toInt();
+                if (m_roles.contains(id) && subAs != 0) {
+                    memberOf.insert(id, subAs);
+                    m_roles[id].subAs = subAs;
+                }
+            }
+        }
+
+        for (int id : routers) {
+            if (!memberOf.contains(id)) {
+                qWarning() << "IBGPTopology: Router" << id << "belongs to no confederation member AS and gets no iBGP sessions.";
+            }
+        }
+
+        for (int i = 0; i < routers.size(); ++i) {
+            for (int j = i + 1; j < routers.size(); ++j) {
+                int a = routers[i];
+                int b = routers[j];
+                if (memberOf.contains(a) && memberOf.value(a) == memberOf.value(b)) {
+                    addSession(a, b);
+                }
+            }
+        }
+
+        // Member ASes only peer where they are physically adjacent.
+        for (const auto &[a, b] : links) {
+            if (memberOf.contains(a) && memberOf.contains(b) && memberOf.value(a) != memberOf.value(b)) {
+                addSession(a, b);
+            }
+        }
+        return !memberOf.isEmpty();
+    }
+    }
+
+    return false;
+}
+
+int IBGPTopology::sessionCount() const
+{
+    int endpoints = 0;
+    for (const IBGPRole &role : m_roles) {
+        endpoints += role.peers.size();
+    }
+    return endpoints / 2;
+}
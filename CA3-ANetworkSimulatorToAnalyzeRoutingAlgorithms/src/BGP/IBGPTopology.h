@@ -0,0 +1,58 @@
+#ifndef IBGPTOPOLOGY_H
+#define IBGPTOPOLOGY_H
+
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <QString>
+#include <QJsonObject>
+
+enum class IBGPMode {
+    Flood,              // Relay updates hop by hop over physical ports
+    FullMesh,           // Logical session between every pair of routers
+    RouteReflector,     // Clients peer only with their reflectors
+    Confederation       // Full mesh inside member ASes, eBGP-like sessions between them
+};
+
+struct IBGPPeer {
+    int routerId = -1;
+    bool client = false;    // The peer is a route reflector client of this router
+    int subAs = 0;          // Confederation member AS of the peer, 0 outside confederations
+};
+
+struct IBGPRole {
+    IBGPMode mode = IBGPMode::FullMesh;
+    int clusterId = 0;      // Non-zero on route reflectors
+    int subAs = 0;
+    QVector<IBGPPeer> peers;
+
+    bool isReflector() const { return clusterId != 0; }
+    const IBGPPeer *findPeer(int routerId) const;
+};
+
+// Builds the logical iBGP sessions of one AS from its "ibgp" configuration object:
+//   {"mode": "full_mesh"}
+//   {"mode": "route_reflector", "route_reflectors": [{"router": 5, "cluster_id": 1, "clients": [1, 2]}]}
+//   {"mode": "confederation", "sub_as": [{"id": 65001, "routers": [1, 2, 3]}, ...]}
+// Reflectors without a client list serve every router that is not itself a reflector.
+class IBGPTopology
+{
+public:
+    static bool parseMode(const QString &text, IBGPMode &mode);
+    static QString modeName(IBGPMode mode);
+
+    // links holds the physical router adjacencies; confederations only peer across member ASes over them.
+    bool configure(const QJsonObject &config, const QVector<int> &routers, const QVector<QPair<int, int>> &links);
+
+    IBGPMode mode() const { return m_mode; }
+    IBGPRole roleOf(int routerId) const { return m_roles.value(routerId); }
+    int sessionCount() const;
+
+private:
+    void addSession(int a, int b, bool aReflectsB = false, bool bReflectsA = false);
+
+    IBGPMode m_mode = IBGPMode::FullMesh;
+    QHash<int, IBGPRole> m_roles;
+};
+
+#endif // IBGPTOPOLOGY_H
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <QStringList>
+
+#include "Prefix.h"
+
+Prefix::Prefix(quint32 address, int prefixLength)
+    : network(address & maskFor(prefixLength)),
+    length(prefixLength)
+{}
+
+quint32 Prefix::maskFor(int prefixLength)
+{
+    if (prefixLength <= 0) {
+        return 0;
+    }
+    return prefixLength >= 32 ? ~quint32(0) : ~quint32(0) << (32 - prefixLength);
+}
+
+bool Prefix::parseAddress(const QString &text, quint32 &address)
+{
+    QStringList octets = text.split('.');
+    if (octets.size() != 4) {
+        return false;
+    }
+
+    address = 0;
+    for (const QString &octet : octets) {
+        bool ok = false;
+        int value = octet.toInt(&ok);
+        if (!ok || value < 0 || value > 255) {
+            return false;
+        }
+        address = (address << 8) | static_cast<quint32>(value);
+    }
+    return true;
+}
+
+QString Prefix::formatAddress(quint32 address)
+{
+    return QString("%1.%2.%3.%4")
+        .arg((address >> 24) & 0xFF)
+        .arg((address >> 16) & 0xFF)
+        .arg((address >> 8) & 0xFF)
+        .arg(address & 0xFF);
+}
+
+bool Prefix::parse(const QString &text, Prefix &prefix)
+{
+    QStringList parts = text.trimmed().split('/');
+    quint32 address = 0;
+    bool ok = parts.size() == 2;
+    int prefixLength = ok ? parts[1].toInt(&ok) : -1;
+
+    if (!ok || prefixLength < 0 || prefixLength > 32 || !parseAddress(parts[0], address)) {
+        return false;
+    }
+
+    prefix = Prefix(address, prefixLength);
+    return true;
+}
+
+QString Prefix::toString() const
+{
+    return QString("%1/%2").arg(formatAddress(network)).arg(length);
+}
+
+bool Prefix::contains(const QString &address) const
+{
+    quint32 value = 0;
+    return parseAddress(address, value) && contains(value);
+}
+
+QVector<Prefix> Prefix::aggregate(QVector<Prefix> prefixes)
+{
+    prefixes.erase(std::remove_if(prefixes.begin(), prefixes.end(),
+                                  [](const Prefix &prefix) { return !prefix.isValid(); }),
+                   prefixes.end());
+
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        std::sort(prefixes.begin(), prefixes.end());
+
+        QVector<Prefix> result;
+        for (const Prefix &prefix : prefixes) {
+            if (!result.isEmpty() && result.last().contains(prefix)) {
+                continue;
+            }
+            // Two halves of the same parent collapse into the parent.
+            if (!result.isEmpty() && result.last().length == prefix.length && prefix.length > 0) {
+                Prefix parent(prefix.network, prefix.length - 1);
+                if (parent.network == result.last().network && prefix.network != result.last().network) {
+                    result.last() = parent;
+                    merged = true;
+                    continue;
+                }
+            }
+            result.append(prefix);
+        }
+        prefixes = result;
+    }
+    return prefixes;
+}
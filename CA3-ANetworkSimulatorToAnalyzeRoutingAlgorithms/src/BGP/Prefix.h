@@ -0,0 +1,48 @@
+#ifndef PREFIX_H
+#define PREFIX_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// IPv4 network prefix ("a.b.c.d/len") carried as BGP NLRI.
+struct Prefix
+{
+    quint32 network = 0;
+    int length = -1;
+
+    Prefix() = default;
+    Prefix(quint32 address, int prefixLength);
+
+    static bool parse(const QString &text, Prefix &prefix);
+    static bool parseAddress(const QString &text, quint32 &address);
+    static QString formatAddress(quint32 address);
+    static quint32 maskFor(int prefixLength);
+
+    // Smallest equivalent set: covered prefixes are dropped and sibling halves are merged.
+    static QVector<Prefix> aggregate(QVector<Prefix> prefixes);
+
+    bool isValid() const { return length >= 0 && length <= 32; }
+    quint32 mask() const { return maskFor(length); }
+    QString maskString() const { return formatAddress(mask()); }
+    QString toString() const;
+
+    bool contains(quint32 address) const { return isValid() && (address & mask()) == network; }
+    bool contains(const QString &address) const;
+    bool contains(const Prefix &other) const { return other.length >= length && contains(other.network); }
+
+    bool operator==(const Prefix &other) const { return network == other.network && length == other.length; }
+    bool operator!=(const Prefix &other) const { return !(*this == other); }
+    bool operator<(const Prefix &other) const
+    {
+        return network != other.network ? network < other.network : length < other.length;
+    }
+};
+
+inline size_t qHash(const Prefix &prefix, size_t seed = 0)
+{
+    return qHash((quint64(prefix.network) << 6) | quint64(prefix.length & 63), seed);
+}
+
+#endif // PREFIX_H
@@ -0,0 +1,157 @@
+#include <bit>
+#include <QDebug>
+#include <QStringList>
+
+#include "AddressPool.h"
+
+static bool parseIPv4(const QString &text, quint32 &address)
+{
+    QStringList octets = text.split('.');
+    if (octets.size() != 4) {
+        return false;
+    }
+
+    address = 0;
+    for (const QString &octet : octets) {
+        bool ok = false;
+        int value = octet.toInt(&ok);
+        if (!ok || value < 0 || value > 255) {
+            return false;
+        }
+        address = (address << 8) | static_cast<quint32>(value);
+    }
+    return true;
+}
+
+static QString formatIPv4(quint32 address)
+{
+    return QString("%1.%2.%3.%4")
+        .arg((address >> 24) & 0xFF)
+        .arg((address >> 16) & 0xFF)
+        .arg((address >> 8) & 0xFF)
+        .arg(address & 0xFF);
+}
+
+bool AddressPool::configure(const QString &subnet)
+{
+    m_capacity = 0;
+    m_allocated = 0;
+    m_nextHint = 1;
+    m_bitmap.clear();
+
+    QStringList parts = subnet.trimmed().split('/');
+    bool ok = parts.size() == 2;
+    int prefixLength = ok ? parts[1].toInt(&ok) : 0;
+    quint32 address = 0;
+
+    // /31 and /32 leave no usable hosts; anything wider than /8 is not worth a bitmap.
+    if (!ok || prefixLength < 8 || prefixLength > 30 || !parseIPv4(parts[0], address)) {
+        qWarning() << "AddressPool: Invalid subnet" << subnet;
+        return false;
+    }
+
+    quint32 mask = ~quint32(0) << (32 - prefixLength);
+    m_network = address & mask;
+    m_prefixLength = prefixLength;
+    m_capacity = static_cast<int>((quint32(1) << (32 - prefixLength)) - 2);
+    m_bitmap.assign((m_capacity + 64) / 64, 0);
+    return true;
+}
+
+bool AddressPool::isAllocated(int host) const
+{
+    if (host < 1 || host > m_capacity) {
+        return false;
+    }
+    return (m_bitmap[host >> 6] >> (host & 63)) & 1;
+}
+
+bool AddressPool::reserve(int host)
+{
+    if (host < 1 || host > m_capacity || isAllocated(host)) {
+        return false;
+    }
+    m_bitmap[host >> 6] |= quint64(1) << (host & 63);
+    ++m_allocated;
+    return true;
+}
+
+void AddressPool::release(int host)
+{
+    if (!isAllocated(host)) {
+        return;
+    }
+    m_bitmap[host >> 6] &= ~(quint64(1) << (host & 63));
+    --m_allocated;
+    if (host < m_nextHint) {
+        m_nextHint = host;
+    }
+}
+
+int AddressPool::findFree(int from) const
+{
+    const size_t words = m_bitmap.size();
+    size_t word = static_cast<size_t>(from) >> 6;
+    // Bit 0 of the first word is the network address and stays out of the search.
+    quint64 skip = (from & 63) ? (quint64(1) << (from & 63)) - 1 : 0;
+    if (word == 0) {
+        skip |= 1;
+    }
+
+    for (; word < words; ++word, skip = 0) {
+        quint64 freeBits = ~(m_bitmap[word] | skip);
+        if (freeBits) {
+            int host = static_cast<int>(word * 64) + std::countr_zero(freeBits);
+            return host <= m_capacity ? host : -1;
+        }
+    }
+    return -1;
+}
+
+int AddressPool::allocate(int preferredHost)
+{
+    if (reserve(preferredHost)) {
+        return preferredHost;
+    }
+
+    int host = findFree(m_nextHint);
+    if (host < 0 && m_nextHint > 1) {
+        host = findFree(1);
+    }
+    if (host < 0) {
+        return -1;
+    }
+
+    reserve(host);
+    m_nextHint = host + 1;
+    return host;
+}
+
+QString AddressPool::addressOf(int host) const
+{
+    if (host < 1 || host > m_capacity) {
+        return QString();
+    }
+    return formatIPv4(m_network + static_cast<quint32>(host));
+}
+
+int AddressPool::hostOf(const QString &address) const
+{
+    quint32 value = 0;
+    if (!isValid() || !parseIPv4(address, value)) {
+        return -1;
+    }
+
+    quint32 mask = ~quint32(0) << (32 - m_prefixLength);
+    if ((value & mask) != m_network) {
+        return -1;
+    }
+
+    int host = static_cast<int>(value - m_network);
+    return (host >= 1 && host <= m_capacity) ? host : -1;
+}
+
+QString AddressPool::subnet() const
+{
+    return QString("%1/%2").arg(formatIPv4(m_network)).arg(m_prefixLength);
+}
@@ -0,0 +1,42 @@
+#ifndef ADDRESSPOOL_H
+#define ADDRESSPOOL_H
+
+#include <vector>
+#include <QString>
+#include <QtGlobal>
+
+// Bitmap allocator over the usable host addresses of an IPv4 subnet ("a.b.c.d/len").
+// Hosts are numbered 1 .. capacity(); the network and broadcast addresses are never handed out.
+class AddressPool
+{
+public:
+    AddressPool() = default;
+
+    bool configure(const QString &subnet);
+    bool isValid() const { return m_capacity > 0; }
+
+    // Takes preferredHost when it is free, otherwise the next free host. Returns -1 when exhausted.
+    int allocate(int preferredHost = -1);
+    bool reserve(int host);
+    void release(int host);
+    bool isAllocated(int host) const;
+
+    int capacity() const { return m_capacity; }
+    int available() const { return m_capacity - m_allocated; }
+
+    QString addressOf(int host) const;
+    int hostOf(const QString &address) const;
+    QString subnet() const;
+
+private:
+    int findFree(int from) const;
+
+    quint32 m_network = 0;
+    int m_prefixLength = 0;
+    int m_capacity = 0;
+    int m_allocated = 0;
+    int m_nextHint = 1;
+    std::vector<quint64> m_bitmap;
+};
+
+#endif // ADDRESSPOOL_H
@@ -0,0 +1,88 @@
+#include <QStringList>
+
+#include "DHCPMessage.h"
+
+static QVector<int> parseRoute(const QString &text)
+{
+    QVector<int> route;
+    for (const QString &hop : text.split(',', Qt::SkipEmptyParts)) {
+        route.append(hop.toInt());
+    }
+    return route;
+}
+
+static QString formatRoute(const QVector<int> &route)
+{
+    QStringList hops;
+    for (int hop : route) {
+        hops.append(QString::number(hop));
+    }
+    return hops.join(',');
+}
+
+bool DHCPMessage::parse(const QString &payload, DHCPMessage &message)
+{
+    QStringList parts = payload.split(':');
+    if (parts.isEmpty()) {
+        return false;
+    }
+
+    bool ok = false;
+    message = DHCPMessage();
+
+    if (parts[0] == "DHCP_REQUEST") {
+        if (parts.size() < 2) {
+            return false;
+        }
+        message.kind = Request;
+        message.clientId = parts[1].toInt(&ok);
+        // Older clients send only "DHCP_REQUEST:<client>"; they are flooded like before.
+        if (parts.size() >= 5) {
+            message.xid = parts[2].toUInt();
+            message.unicast = parts[3] == "U";
+            message.route = parseRoute(parts[4]);
+        }
+        return ok;
+    }
+
+    if (parts[0] == "DHCP_OFFER") {
+        // IPv6 addresses contain ':', so the fixed fields are taken from the end.
+        if (parts.size() >= 5) {
+            message.route = parseRoute(parts.takeLast());
+            message.xid = parts.takeLast().toUInt();
+            message.unicast = true;
+        } else if (parts.size() < 3) {
+            return false;
+        }
+        message.kind = Offer;
+        message.clientId = parts.takeLast().toInt(&ok);
+        message.offeredIP = parts.mid(1).join(':');
+        return ok && !message.offeredIP.isEmpty();
+    }
+
+    return false;
+}
+
+QString DHCPMessage::toPayload() const
+{
+    if (kind == Offer) {
+        return QString("DHCP_OFFER:%1:%2:%3:%4").arg(offeredIP).arg(clientId).arg(xid).arg(formatRoute(route));
+    }
+    return QString("DHCP_REQUEST:%1:%2:%3:%4")
+        .arg(clientId).arg(xid).arg(unicast ? "U" : "F").arg(formatRoute(route));
+}
+
+int DHCPMessage::nextHop(int routerId) const
+{
+    int index = static_cast<int>(route.indexOf(routerId));
+    if (index < 0 || index + 1 >= route.size()) {
+        return -1;
+    }
+    return route[index + 1];
+}
+
+quint64 DHCPMessage::transactionKey() const
+{
+    return (static_cast<quint64>(static_cast<quint32>(clientId)) << 33) |
+           (static_cast<quint64>(kind == Offer) << 32) | xid;
+}
@@ -0,0 +1,34 @@
+#ifndef DHCPMESSAGE_H
+#define DHCPMESSAGE_H
+
+#include <QString>
+#include <QVector>
+
+// Control payloads exchanged between DHCP clients, relay agents and the server:
+//   DHCP_REQUEST:<client>:<xid>:<F|U>:<route>
+//   DHCP_OFFER:<ip>:<client>:<xid>:<route>
+// route is a comma separated list of router ids. A flooded (F) request records the routers it
+// crossed; a unicast (U) request and every offer carry the full path and are forwarded hop by hop.
+struct DHCPMessage
+{
+    enum Kind {
+        Request,
+        Offer
+    };
+
+    Kind kind = Request;
+    int clientId = -1;
+    quint32 xid = 0;
+    bool unicast = false;
+    QString offeredIP;
+    QVector<int> route;
+
+    static bool parse(const QString &payload, DHCPMessage &message);
+    QString toPayload() const;
+
+    // Router after routerId on the route, or -1 when routerId is the last hop or not on it.
+    int nextHop(int routerId) const;
+    quint64 transactionKey() const;
+};
+
+#endif // DHCPMESSAGE_H
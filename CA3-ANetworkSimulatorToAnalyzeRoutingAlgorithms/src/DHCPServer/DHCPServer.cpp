@@ -1,59 +1,56 @@
 #include <QDebug>
-#include <QDateTime>
+#include <algorithm>
 
 #include "../IP/IP.h"
 #include "DHCPServer.h"
+#include "../Logger/Logger.h"
 #include "../IP/IPHeader.h"
 #include "../Network/Router.h"
+#include "../Globals/SimulationContext.h"
 
-DHCPServer::DHCPServer(int asId, const QSharedPointer<Router> &router, QObject *parent)
+DHCPServer::DHCPServer(int asId, const AsIdRange &idRange, const QString &subnet,
+                       const QSharedPointer<Router> &router, QObject *parent)
     : QObject(parent),
     m_asId(asId),
+    m_idRange(idRange),
     m_router(router),
-    m_nextAvailableId(1),
     m_currentTime(0)
 {
-    QString logFileName;
-    if (m_asId == 1) {
-        m_ipPrefix = "192.168.100.";
-        logFileName = "D:/QTProjects/CN-CA3/CN-CA3/logs/dhcp_server_5.log";
-    } else if (m_asId == 2) {
-        m_ipPrefix = "192.168.200.";
-        logFileName = "D:/QTProjects/CN-CA3/CN-CA3/logs/dhcp_server_23.log";
-    } else {
-        qWarning() << "Unsupported AS ID:" << m_asId;
-        logFileName = "dhcp_server_unknown.log";
-    }
-
-    m_logFile.setFileName(logFileName);
-    if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-        qWarning() << "Unable to open log file:" << logFileName;
-    } else {
-        m_logStream.setDevice(&m_logFile);
-    }
-
-    qDebug() << "DHCP Server initialized for AS ID:" << m_asId << "on Router ID:" << router->getId();
-    writeLog(QString("DHCP Server initialized for AS ID: %1 on Router ID: %2")
-               .arg(m_asId).arg(router->getId()));
+    m_log.reset(new AsyncLogWriter(router->getContext()->logFilePath(QString("dhcp_server_%1.log").arg(router->getId()))));
+
+    if (!m_pool.configure(subnet)) {
+        LOG_WARNING(Dhcp) << "DHCP Server for AS" << m_asId << "falling back to" << defaultSubnet(m_asId);
+        m_pool.configure(defaultSubnet(m_asId));
+    }
+
+    LOG_DEBUG(Dhcp) << "DHCP Server initialized for AS ID:" << m_asId << "on Router ID:" << router->getId()
+                    << "with pool" << m_pool.subnet() << "(" << m_pool.capacity() << "hosts)";
+    writeLog(QString("DHCP Server initialized for AS ID: %1 on Router ID: %2 with pool %3")
+               .arg(m_asId).arg(router->getId()).arg(m_pool.subnet()));
 }
 
-DHCPServer::~DHCPServer()
+QString DHCPServer::defaultSubnet(int asId)
 {
-    if (m_logFile.isOpen()) {
-        m_logFile.close();
+    if (asId == 1) {
+        return "192.168.100.0/24";
+    } else if (asId == 2) {
+        return "192.168.200.0/24";
     }
+    return QString("10.%1.0.0/16").arg(asId & 0xFF);
 }
 
+DHCPServer::~DHCPServer() {}
+
 void DHCPServer::receivePacket(const PacketPtr_t &packet)
 {
     if (!packet || packet->getType() != PacketType::Control) {
-        qWarning() << "DHCP Server received invalid packet.";
-        writeLog("DHCP Server received invalid packet.");
+        LOG_WARNING(Dhcp) << "DHCP Server received invalid packet.";
+        writeLog<WARNING_LEVEL>("DHCP Server received invalid packet.");
         return;
     }
 
     QString payload = packet->getPayload();
-    qDebug() << "DHCP Server processing packet with payload:" << payload;
+    LOG_TRACE(Dhcp) << "DHCP Server processing packet with payload:" << payload;
     writeLog(QString("DHCP Server processing packet with payload: %1").arg(payload));
 
     if (payload.contains("DHCP_REQUEST")) {
@@ -61,59 +58,64 @@ void DHCPServer::receivePacket(const PacketPtr_t &packet)
     }
 }
 
+bool DHCPServer::acceptsClient(int clientId) const
+{
+    return (clientId >= m_idRange.routerStartId && clientId <= m_idRange.routerEndId) ||
+           (clientId >= m_idRange.pcStartId && clientId <= m_idRange.pcEndId);
+}
+
 void DHCPServer::assignIP(const PacketPtr_t &packet)
 {
-    QStringList parts = packet->getPayload().split(":");
-    if (parts.size() < 2) {
-        qWarning() << "Malformed DHCP_REQUEST packet.";
-        writeLog("Malformed DHCP_REQUEST packet.");
+    DHCPMessage request;
+    if (!DHCPMessage::parse(packet->getPayload(), request) || request.kind != DHCPMessage::Request) {
+        LOG_WARNING(Dhcp) << "Malformed DHCP_REQUEST packet.";
+        writeLog<WARNING_LEVEL>("Malformed DHCP_REQUEST packet.");
         return;
     }
 
-    int clientId = parts[1].toInt();
+    int clientId = request.clientId;
 
-    if (m_asId == 1) {
-        if (!((clientId >= 1 && clientId <= 16) || (clientId >= 24 && clientId <= 31))) {
-            QString msg = QString("Client %1 not in our AS (1)").arg(clientId);
-            qDebug() << msg;
-            writeLog(msg);
-            return;
-        }
-    } else if (m_asId == 2) {
-        if (!((clientId >= 17 && clientId <= 23) || (clientId >= 32 && clientId <= 38))) {
-            QString msg = QString("Client %1 not in our AS (2)").arg(clientId);
-            qDebug() << msg;
-            writeLog(msg);
-            return;
-        }
-    } else {
-        QString msg = QString("Unsupported AS ID: %1").arg(m_asId);
-        qWarning() << msg;
+    if (!acceptsClient(clientId)) {
+        QString msg = QString("Client %1 not in our AS (%2)").arg(clientId).arg(m_asId);
+        LOG_DEBUG(Dhcp) << msg;
         writeLog(msg);
         return;
     }
 
     QString assigningMsg = QString("Assigning IP to client %1 in AS %2").arg(clientId).arg(m_asId);
-    qDebug() << assigningMsg;
+    LOG_DEBUG(Dhcp) << assigningMsg;
     writeLog(assigningMsg);
 
-    for (const auto &lease : m_leases) {
-        if (lease.clientId == clientId) {
-            QString msg = QString("Client %1 already has an IP: %2. Re-sending offer.")
-            .arg(clientId)
-              .arg(lease.ipAddress);
-            qDebug() << msg;
-            writeLog(msg);
-            sendOffer(lease);
-            return;
+    auto existing = m_leasesByClient.find(clientId);
+    if (existing != m_leasesByClient.end()) {
+        QString msg = QString("Client %1 already has an IP: %2. Re-sending offer.")
+        .arg(clientId)
+          .arg(existing->ipAddress);
+        LOG_DEBUG(Dhcp) << msg;
+        writeLog(msg);
+
+        if (existing->leaseExpirationTime != STATIC_LEASE) {
+            existing->leaseExpirationTime = m_currentTime + LEASE_DURATION;
+            m_expiryQueue.push({existing->leaseExpirationTime, clientId});
         }
+        sendOffer(*existing, request);
+        return;
     }
 
-    QString ipAddress = QString("%1%2").arg(m_ipPrefix).arg(clientId);
+    // Routing code reads the node id back from the last octet, so keep host == client id when possible.
+    int host = m_pool.allocate(clientId);
+    if (host < 0) {
+        QString msg = QString("Address pool %1 exhausted. Cannot assign to client %2")
+        .arg(m_pool.subnet()).arg(clientId);
+        LOG_WARNING(Dhcp) << msg;
+        writeLog<WARNING_LEVEL>(msg);
+        return;
+    }
+
+    QString ipAddress = m_pool.addressOf(host);
 
     if (packet->isIPv6()) {
-        QString assignedIpAddress = ipAddress;
-        qDebug() << "Packet indicates IPv6. Converting assigned IPv4 address to IPv6.";
+        LOG_DEBUG(Dhcp) << "Packet indicates IPv6. Converting assigned IPv4 address to IPv6.";
         writeLog("Packet indicates IPv6. Converting assigned IPv4 address to IPv6.");
 
         QSharedPointer<IPv4Header> ipv4Header = QSharedPointer<IPv4Header>::create();
@@ -125,99 +127,122 @@ void DHCPServer::assignIP(const PacketPtr_t &packet)
         if (!ip.convertToIPv6()) {
             QString msg = QString("Failed to convert IPv4 address %1 to IPv6 for client %2")
             .arg(ipAddress).arg(clientId);
-            qWarning() << msg;
-            writeLog(msg);
+            LOG_WARNING(Dhcp) << msg;
+            writeLog<WARNING_LEVEL>(msg);
+            m_pool.release(host);
             return;
         }
 
-        assignedIpAddress = ip.getIp();
-        QString convertedMsg = QString("Converted IPv6 Address: %1").arg(assignedIpAddress);
-        qDebug() << convertedMsg;
+        ipAddress = ip.getIp();
+        QString convertedMsg = QString("Converted IPv6 Address: %1").arg(ipAddress);
+        LOG_DEBUG(Dhcp) << convertedMsg;
         writeLog(convertedMsg);
+    }
 
-        for (const auto &lease : m_leases) {
-            if (lease.ipAddress == assignedIpAddress) {
-                QString msg = QString("IPv6 address %1 is already assigned. Cannot assign to client %2")
-                .arg(assignedIpAddress).arg(clientId);
-                qWarning() << msg;
-                writeLog(msg);
-                return;
-            }
-        }
+    DHCPLease lease = { ipAddress, clientId, host, m_currentTime + LEASE_DURATION };
+    if (!addLease(lease)) {
+        QString msg = QString("IP address %1 is already assigned. Cannot assign to client %2")
+        .arg(ipAddress).arg(clientId);
+        LOG_WARNING(Dhcp) << msg;
+        writeLog<WARNING_LEVEL>(msg);
+        m_pool.release(host);
+        return;
+    }
 
-        DHCPLease newLease;
-        newLease.ipAddress = assignedIpAddress;
-        newLease.clientId = clientId;
+    QString newIpMsg = QString("New IP assigned%1: %2 for client %3")
+                           .arg(packet->isIPv6() ? " (IPv6)" : "").arg(ipAddress).arg(clientId);
+    LOG_DEBUG(Dhcp) << newIpMsg;
+    writeLog(newIpMsg);
 
-        m_leases.append(newLease);
+    sendOffer(lease, request);
+}
 
-        QString newLeaseMsg = QString("New IP assigned (IPv6): %1 for client %2")
-                                .arg(newLease.ipAddress).arg(clientId);
-        qDebug() << newLeaseMsg;
-        writeLog(newLeaseMsg);
+bool DHCPServer::addLease(const DHCPLease &lease)
+{
+    if (m_clientByIp.contains(lease.ipAddress)) {
+        return false;
+    }
 
-        sendOffer(newLease);
-        return;
+    m_leasesByClient.insert(lease.clientId, lease);
+    m_clientByIp.insert(lease.ipAddress, lease.clientId);
+    if (lease.leaseExpirationTime != STATIC_LEASE) {
+        m_expiryQueue.push({lease.leaseExpirationTime, lease.clientId});
     }
+    return true;
+}
 
-    for (const auto &lease : m_leases) {
-        if (lease.ipAddress == ipAddress) {
-            QString msg = QString("IP address %1 is already assigned. Cannot assign to client %2")
-            .arg(ipAddress).arg(clientId);
-            qWarning() << msg;
-            writeLog(msg);
-            return;
-        }
+QString DHCPServer::assignStaticIP(int clientId)
+{
+    auto existing = m_leasesByClient.constFind(clientId);
+    if (existing != m_leasesByClient.constEnd()) {
+        return existing->ipAddress;
     }
 
-    DHCPLease lease = { ipAddress, clientId, m_currentTime + LEASE_DURATION };
-    m_leases.append(lease);
+    int host = m_pool.allocate(clientId);
+    if (host < 0) {
+        LOG_WARNING(Dhcp) << "Address pool" << m_pool.subnet() << "exhausted. No static IP for" << clientId;
+        return QString();
+    }
 
-    QString newIpMsg = QString("New IP assigned: %1 for client %2").arg(ipAddress).arg(clientId);
-    qDebug() << newIpMsg;
-    writeLog(newIpMsg);
+    DHCPLease lease = { m_pool.addressOf(host), clientId, host, STATIC_LEASE };
+    addLease(lease);
+    writeLog(QString("Static IP %1 bound to client %2").arg(lease.ipAddress).arg(clientId));
+    return lease.ipAddress;
+}
+
+bool DHCPServer::hasLease(int clientId) const
+{
+    return m_leasesByClient.contains(clientId);
+}
 
-    sendOffer(lease);
+QString DHCPServer::leasedIP(int clientId) const
+{
+    return m_leasesByClient.value(clientId).ipAddress;
 }
 
-void DHCPServer::sendOffer(const DHCPLease &lease)
+int DHCPServer::leaseCount() const
 {
-    QString payload = QString("DHCP_OFFER:%1:%2").arg(lease.ipAddress).arg(lease.clientId);
-    auto offerPacket = QSharedPointer<Packet>::create(PacketType::Control, payload);
-
-    offerPacket->setTTL(10);
-
-    if (m_router) {
-        const auto &ports = m_router->getPorts();
-        QString msg = QString("Sending DHCP offer from Router %1 to client %2 with IP %3")
-                        .arg(m_router->getId())
-                        .arg(lease.clientId)
-                        .arg(lease.ipAddress);
-        qDebug() << msg;
-        writeLog(msg);
+    return static_cast<int>(m_leasesByClient.size());
+}
 
-        QString portCountMsg = QString("Number of ports on Router %1: %2")
-                                 .arg(m_router->getId())
-                                 .arg(ports.size());
-        qDebug() << portCountMsg;
-        writeLog(portCountMsg);
-
-        for (const auto &port : ports) {
-            if (port->isConnected()) {
-                port->sendPacket(offerPacket);
-
-                QString broadcastMsg = QString("DHCP Server on Router %1 broadcasted DHCP offer: %2 via Port %3")
-                                         .arg(m_router->getId())
-                                         .arg(payload)
-                                         .arg(port->getPortNumber());
-                qDebug() << broadcastMsg;
-                writeLog(broadcastMsg);
-            }
-        }
-    } else {
-        qWarning() << "DHCP Server has no associated Router to broadcast offers.";
-        writeLog("DHCP Server has no associated Router to broadcast offers.");
+const AddressPool &DHCPServer::addressPool() const
+{
+    return m_pool;
+}
+
+void DHCPServer::sendOffer(const DHCPLease &lease, const DHCPMessage &request)
+{
+    if (!m_router) {
+        LOG_WARNING(Dhcp) << "DHCP Server has no associated Router to send offers.";
+        writeLog<WARNING_LEVEL>("DHCP Server has no associated Router to send offers.");
+        return;
     }
+
+    // The offer retraces the request: server first, client's attachment router last.
+    DHCPMessage offer;
+    offer.kind = DHCPMessage::Offer;
+    offer.offeredIP = lease.ipAddress;
+    offer.clientId = lease.clientId;
+    offer.xid = request.xid;
+    offer.unicast = true;
+    offer.route = request.route;
+    if (offer.route.isEmpty() || offer.route.last() != m_router->getId()) {
+        offer.route.append(m_router->getId());
+    }
+    std::reverse(offer.route.begin(), offer.route.end());
+
+    auto offerPacket = QSharedPointer<Packet>::create(PacketType::Control, offer.toPayload());
+    offerPacket->setTTL(qMax(10, static_cast<int>(offer.route.size()) + 1));
+
+    QString msg = QString("Router %1 sending DHCP offer %2 to client %3 along route %4")
+                    .arg(m_router->getId())
+                    .arg(lease.ipAddress)
+                    .arg(lease.clientId)
+                    .arg(offerPacket->getPayload().section(':', -1));
+    LOG_DEBUG(Dhcp) << msg;
+    writeLog(msg);
+
+    m_router->processDHCPResponse(offerPacket, nullptr);
 }
 
 void DHCPServer::tick(int currentTime)
@@ -228,22 +253,21 @@ void DHCPServer::tick(int currentTime)
 
 void DHCPServer::reclaimExpiredLeases()
 {
-    for (int i = m_leases.size() - 1; i >= 0; --i) {
-        if (m_leases[i].leaseExpirationTime <= m_currentTime) {
-            QString msg = QString("Reclaiming expired IP: %1").arg(m_leases[i].ipAddress);
-            qDebug() << msg;
-            writeLog(msg);
+    while (!m_expiryQueue.empty() && m_expiryQueue.top().first <= m_currentTime) {
+        Expiry expiry = m_expiryQueue.top();
+        m_expiryQueue.pop();
 
-            m_leases.removeAt(i);
+        auto it = m_leasesByClient.find(expiry.second);
+        if (it == m_leasesByClient.end() || it->leaseExpirationTime != expiry.first) {
+            continue;
         }
-    }
-}
 
-void DHCPServer::writeLog(const QString &message)
-{
-    if (m_logFile.isOpen()) {
-        m_logStream << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss")
-                    << " - " << message << "\n";
-        m_logStream.flush();
+        QString msg = QString("Reclaiming expired IP: %1").arg(it->ipAddress);
+        LOG_DEBUG(Dhcp) << msg;
+        writeLog(msg);
+
+        m_pool.release(it->host);
+        m_clientByIp.remove(it->ipAddress);
+        m_leasesByClient.erase(it);
     }
 }
@@ -1,13 +1,19 @@
 #ifndef DHCPSERVER_H
 #define DHCPSERVER_H
 
-#include <QFile>
+#include <queue>
+#include <vector>
+#include <QHash>
 #include <QObject>
-#include <QTextStream>
+#include <QScopedPointer>
 #include <QSharedPointer>
 
 #include "../Port/Port.h"
 #include "../Packet/Packet.h"
+#include "../Globals/IdAssignment.h"
+#include "../Logger/AsyncLogWriter.h"
+#include "AddressPool.h"
+#include "DHCPMessage.h"
 
 class Router;
 
@@ -16,12 +22,23 @@ class DHCPServer : public QObject
     Q_OBJECT
 
 public:
-    explicit DHCPServer(int asId, const QSharedPointer<Router> &router, QObject *parent = nullptr);
+    explicit DHCPServer(int asId, const AsIdRange &idRange, const QString &subnet,
+                        const QSharedPointer<Router> &router, QObject *parent = nullptr);
     ~DHCPServer() override;
 
     void receivePacket(const PacketPtr_t &packet);
     void tick(int currentTime);
 
+    // Permanent binding for the server's own router; it never expires.
+    QString assignStaticIP(int clientId);
+
+    bool hasLease(int clientId) const;
+    QString leasedIP(int clientId) const;
+    int leaseCount() const;
+    const AddressPool &addressPool() const;
+
+    static QString defaultSubnet(int asId);
+
 Q_SIGNALS:
     void broadcastPacket(const PacketPtr_t &packet);
 
@@ -29,26 +46,37 @@ private:
     struct DHCPLease {
         QString ipAddress;
         int clientId;
+        int host;
         int leaseExpirationTime;
     };
 
+    typedef std::pair<int, int> Expiry; // (expiration time, client id)
+
+    bool acceptsClient(int clientId) const;
     void assignIP(const PacketPtr_t &packet);
-    void sendOffer(const DHCPLease &lease);
+    bool addLease(const DHCPLease &lease);
+    void sendOffer(const DHCPLease &lease, const DHCPMessage &request);
     void reclaimExpiredLeases();
 
     int m_asId;
+    AsIdRange m_idRange;
     QSharedPointer<Port> m_port;
     QSharedPointer<Router> m_router;
-    QVector<DHCPLease> m_leases;
-    QString m_ipPrefix;
+    AddressPool m_pool;
+
+    QHash<int, DHCPLease> m_leasesByClient;
+    QHash<QString, int> m_clientByIp;
+    // Renewed leases leave stale entries behind; they are skipped when popped.
+    std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry>> m_expiryQueue;
 
-    int m_nextAvailableId;
     int m_currentTime;
-    QFile m_logFile;
-    QTextStream m_logStream;
-    void writeLog(const QString &message);
+    QScopedPointer<AsyncLogWriter> m_log;
+
+    template <LogLevel Level = DEBUG_LEVEL>
+    void writeLog(const QString &message) { m_log->log<Level>(message); }
 
     static const int LEASE_DURATION = 300; // Lease duration in seconds
+    static const int STATIC_LEASE = -1;
 };
 
 #endif // DHCPSERVER_H
@@ -0,0 +1,39 @@
+#include "DHCPTransactionCache.h"
+
+DHCPTransactionCache::DHCPTransactionCache(int capacity, qint64 ttlMs)
+    : m_capacity(qMax(1, capacity)),
+    m_ttlMs(ttlMs)
+{}
+
+void DHCPTransactionCache::expire(qint64 nowMs)
+{
+    // m_order is sorted by expiry; entries refreshed later are dropped when their stale copy pops.
+    while (!m_order.empty() && (m_order.front().first <= nowMs || size() > m_capacity)) {
+        auto [expiry, key] = m_order.front();
+        m_order.pop_front();
+
+        auto it = m_expiry.find(key);
+        if (it != m_expiry.end() && it.value() == expiry) {
+            m_expiry.erase(it);
+        }
+    }
+}
+
+bool DHCPTransactionCache::insert(quint64 key, qint64 nowMs)
+{
+    if (contains(key, nowMs)) {
+        return false;
+    }
+
+    qint64 expiry = nowMs + m_ttlMs;
+    m_expiry.insert(key, expiry);
+    m_order.emplace_back(expiry, key);
+    expire(nowMs);
+    return true;
+}
+
+bool DHCPTransactionCache::contains(quint64 key, qint64 nowMs) const
+{
+    auto it = m_expiry.constFind(key);
+    return it != m_expiry.constEnd() && it.value() > nowMs;
+}
@@ -0,0 +1,30 @@
+#ifndef DHCPTRANSACTIONCACHE_H
+#define DHCPTRANSACTIONCACHE_H
+
+#include <deque>
+#include <QHash>
+#include <QtGlobal>
+
+// Duplicate filter for flooded DHCP messages. Keys expire after ttlMs and the oldest keys are
+// evicted once capacity is reached, so the set stays bounded for the lifetime of a router.
+class DHCPTransactionCache
+{
+public:
+    explicit DHCPTransactionCache(int capacity = 1024, qint64 ttlMs = 30000);
+
+    // Records key and returns true, or returns false when key was seen within the last ttlMs.
+    bool insert(quint64 key, qint64 nowMs);
+    bool contains(quint64 key, qint64 nowMs) const;
+
+    int size() const { return static_cast<int>(m_expiry.size()); }
+
+private:
+    void expire(qint64 nowMs);
+
+    int m_capacity;
+    qint64 m_ttlMs;
+    QHash<quint64, qint64> m_expiry;
+    std::deque<std::pair<qint64, quint64>> m_order;
+};
+
+#endif // DHCPTRANSACTIONCACHE_H
@@ -0,0 +1,81 @@
+#include "AliasTable.h"
+
+AliasTable::AliasTable(const std::vector<double> &weights)
+{
+    build(weights);
+}
+
+void AliasTable::build(const std::vector<double> &weights)
+{
+    const int n = static_cast<int>(weights.size());
+    m_probability.assign(n, 0.0);
+    m_alias.assign(n, 0);
+    m_normalized.assign(n, 0.0);
+
+    double total = 0.0;
+    for (double w : weights) {
+        total += w > 0.0 ? w : 0.0;
+    }
+
+    if (n == 0 || total <= 0.0) {
+        m_probability.clear();
+        m_alias.clear();
+        m_normalized.clear();
+        return;
+    }
+
+    std::vector<double> scaled(n);
+    std::vector<int> small;
+    std::vector<int> large;
+    small.reserve(n);
+    large.reserve(n);
+
+    for (int i = 0; i < n; ++i) {
+        m_normalized[i] = (weights[i] > 0.0 ? weights[i] : 0.0) / total;
+        scaled[i] = m_normalized[i] * n;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty()) {
+        int less = small.back();
+        small.pop_back();
+        int more = large.back();
+        large.pop_back();
+
+        m_probability[less] = scaled[less];
+        m_alias[less] = more;
+
+        scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+        (scaled[more] < 1.0 ? small : large).push_back(more);
+    }
+
+    // Whatever is left is 1 up to rounding error.
+    for (int i : large) {
+        m_probability[i] = 1.0;
+        m_alias[i] = i;
+    }
+    for (int i : small) {
+        m_probability[i] = 1.0;
+        m_alias[i] = i;
+    }
+}
+
+int AliasTable::sample(RandomStream &rng) const
+{
+    if (m_probability.empty()) {
+        return -1;
+    }
+
+    std::uniform_int_distribution<int> column(0, size() - 1);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    int i = column(rng);
+    return coin(rng) < m_probability[i] ? i : m_alias[i];
+}
+
+double AliasTable::probabilityOf(int index) const
+{
+    if (index < 0 || index >= size()) {
+        return 0.0;
+    }
+    return m_normalized[index];
+}
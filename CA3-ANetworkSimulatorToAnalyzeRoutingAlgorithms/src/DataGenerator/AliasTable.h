@@ -0,0 +1,29 @@
+#ifndef ALIASTABLE_H
+#define ALIASTABLE_H
+
+#include <random>
+#include <vector>
+
+#include "../Globals/RandomStream.h"
+
+// Walker/Vose alias table: O(n) build, O(1) sampling from a discrete distribution.
+class AliasTable
+{
+public:
+    AliasTable() = default;
+    explicit AliasTable(const std::vector<double> &weights);
+
+    void build(const std::vector<double> &weights);
+    int sample(RandomStream &rng) const;
+
+    bool isEmpty() const { return m_probability.empty(); }
+    int size() const { return static_cast<int>(m_probability.size()); }
+    double probabilityOf(int index) const;
+
+private:
+    std::vector<double> m_probability;
+    std::vector<int> m_alias;
+    std::vector<double> m_normalized;
+};
+
+#endif // ALIASTABLE_H
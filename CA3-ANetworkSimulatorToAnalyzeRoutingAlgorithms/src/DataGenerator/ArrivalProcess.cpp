@@ -0,0 +1,249 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <QFile>
+#include <QDebug>
+#include <QTextStream>
+#include <QRegularExpression>
+
+#include "ArrivalProcess.h"
+
+namespace {
+
+double uniformOpen(RandomStream &rng)
+{
+    // (0, 1]: never zero, so the inverse transforms below stay finite.
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    return 1.0 - unit(rng);
+}
+
+}
+
+bool ArrivalProcess::parseType(const QString &name, UT::DistributionType &type)
+{
+    QString key = name.trimmed().toLower();
+    if (key == "poisson") {
+        type = UT::DistributionType::Poisson;
+    } else if (key == "pareto") {
+        type = UT::DistributionType::Pareto;
+    } else if (key == "on_off" || key == "onoff" || key == "mmpp") {
+        type = UT::DistributionType::OnOff;
+    } else if (key == "trace") {
+        type = UT::DistributionType::Trace;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QSharedPointer<ArrivalProcess> ArrivalProcess::fromConfig(const QJsonObject &model, double defaultRatePps,
+                                                          double cycleSeconds)
+{
+    UT::DistributionType type = UT::DistributionType::Poisson;
+    QString name = model.value("model").toString("poisson");
+    if (!parseType(name, type)) {
+        qWarning() << "ArrivalProcess: Unknown traffic model" << name << ". Using Poisson.";
+    }
+
+    double rate = model.value("rate_pps").toDouble(defaultRatePps);
+
+    switch (type) {
+    case UT::DistributionType::Pareto:
+        return QSharedPointer<ParetoArrivals>::create(rate, model.value("shape").toDouble(1.5), cycleSeconds);
+
+    case UT::DistributionType::OnOff:
+        return QSharedPointer<OnOffArrivals>::create(model.value("on_rate_pps").toDouble(rate * 5.0),
+                                                     model.value("off_rate_pps").toDouble(0.0),
+                                                     model.value("mean_on_s").toDouble(0.2),
+                                                     model.value("mean_off_s").toDouble(0.8),
+                                                     model.value("sojourn_shape").toDouble(0.0),
+                                                     cycleSeconds);
+
+    case UT::DistributionType::Trace: {
+        auto trace = QSharedPointer<TraceArrivals>::create(model.value("file").toString(), cycleSeconds,
+                                                           model.value("loop").toBool(false));
+        if (trace->isValid()) {
+            return trace;
+        }
+        qWarning() << "ArrivalProcess: Trace" << model.value("file").toString()
+                   << (trace->error().isEmpty() ? QString("is empty") : trace->error()) << ". Using Poisson.";
+        break;
+    }
+
+    case UT::DistributionType::Poisson:
+        break;
+    }
+
+    return QSharedPointer<PoissonArrivals>::create(rate, cycleSeconds);
+}
+
+bool ArrivalProcess::checkConfig(const QJsonObject &model, double cycleSeconds, QString *error)
+{
+    UT::DistributionType type = UT::DistributionType::Poisson;
+    if (!parseType(model.value("model").toString("poisson"), type) || type != UT::DistributionType::Trace) {
+        return true;
+    }
+
+    TraceArrivals trace(model.value("file").toString(), cycleSeconds, false);
+    if (!trace.error().isEmpty()) {
+        if (error) {
+            *error = QString("trace %1 %2").arg(model.value("file").toString(), trace.error());
+        }
+        return false;
+    }
+    return true;
+}
+
+PoissonArrivals::PoissonArrivals(double ratePps, double cycleSeconds) :
+    m_meanPerTick(std::max(ratePps * cycleSeconds, 0.0)),
+    m_perTick(m_meanPerTick > 0.0 ? m_meanPerTick : 1.0)
+{}
+
+int PoissonArrivals::nextTick(RandomStream &rng)
+{
+    return m_meanPerTick > 0.0 ? m_perTick(rng) : 0;
+}
+
+ParetoArrivals::ParetoArrivals(double ratePps, double shape, double cycleSeconds) :
+    m_shape(shape > 1.0 ? shape : 1.5),
+    m_scale(0.0),
+    m_cycleSeconds(cycleSeconds)
+{
+    // Mean gap of a Pareto(scale, shape) is scale * shape / (shape - 1); match it to 1 / rate.
+    if (ratePps > 0.0) {
+        m_scale = (m_shape - 1.0) / (m_shape * ratePps);
+    }
+}
+
+double ParetoArrivals::sampleGap(RandomStream &rng)
+{
+    return m_scale / std::pow(uniformOpen(rng), 1.0 / m_shape);
+}
+
+int ParetoArrivals::nextTick(RandomStream &rng)
+{
+    if (m_scale <= 0.0) {
+        return 0;
+    }
+
+    if (m_nextArrival < 0.0) {
+        m_nextArrival = sampleGap(rng);
+    }
+
+    m_clock += m_cycleSeconds;
+    int count = 0;
+    while (m_nextArrival <= m_clock) {
+        ++count;
+        m_nextArrival += sampleGap(rng);
+    }
+    return count;
+}
+
+OnOffArrivals::OnOffArrivals(double onRatePps, double offRatePps, double meanOnSeconds, double meanOffSeconds,
+                             double sojournShape, double cycleSeconds) :
+    m_onRate(std::max(onRatePps, 0.0)),
+    m_offRate(std::max(offRatePps, 0.0)),
+    m_meanOn(std::max(meanOnSeconds, 1e-6)),
+    m_meanOff(std::max(meanOffSeconds, 1e-6)),
+    m_sojournShape(sojournShape),
+    m_cycleSeconds(cycleSeconds)
+{}
+
+double OnOffArrivals::sampleSojourn(RandomStream &rng, double mean)
+{
+    if (m_sojournShape > 1.0) {
+        double scale = mean * (m_sojournShape - 1.0) / m_sojournShape;
+        return scale / std::pow(uniformOpen(rng), 1.0 / m_sojournShape);
+    }
+    return -mean * std::log(uniformOpen(rng));
+}
+
+int OnOffArrivals::nextTick(RandomStream &rng)
+{
+    if (!m_started) {
+        std::bernoulli_distribution startOn(m_meanOn / (m_meanOn + m_meanOff));
+        m_on = startOn(rng);
+        m_stateLeft = sampleSojourn(rng, m_on ? m_meanOn : m_meanOff);
+        m_started = true;
+    }
+
+    // Integrate the modulated rate over the tick, then draw one Poisson count for it.
+    double remaining = m_cycleSeconds;
+    double expected = 0.0;
+    while (remaining > 0.0) {
+        if (m_stateLeft <= 0.0) {
+            m_on = !m_on;
+            m_stateLeft = sampleSojourn(rng, m_on ? m_meanOn : m_meanOff);
+        }
+        double dt = std::min(remaining, m_stateLeft);
+        expected += (m_on ? m_onRate : m_offRate) * dt;
+        m_stateLeft -= dt;
+        remaining -= dt;
+    }
+
+    if (expected <= 0.0) {
+        return 0;
+    }
+    std::poisson_distribution<int> arrivals(expected);
+    return arrivals(rng);
+}
+
+TraceArrivals::TraceArrivals(const QString &path, double cycleSeconds, bool loop) :
+    m_loop(loop)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_error = "cannot be opened: " + file.errorString();
+        qWarning() << "TraceArrivals: Could not open trace file:" << path;
+        return;
+    }
+
+    std::vector<std::pair<double, int>> records;
+    double origin = std::numeric_limits<double>::infinity();
+    double last = -origin;
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine().section('#', 0, 0).trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        QStringList fields = line.split(QRegularExpression("[\\s,]+"), Qt::SkipEmptyParts);
+        bool ok = false;
+        double timestamp = fields.at(0).toDouble(&ok);
+        if (!ok || !std::isfinite(timestamp) || timestamp < 0.0) {
+            continue;
+        }
+        int count = fields.size() > 1 ? fields.at(1).toInt() : 1;
+        records.emplace_back(timestamp, std::max(count, 0));
+        origin = std::min(origin, timestamp);
+        last = std::max(last, timestamp);
+    }
+    if (records.empty()) {
+        return;
+    }
+
+    // Checked in floating point, before any tick index is formed.
+    double span = (last - origin) / cycleSeconds;
+    if (!(span < static_cast<double>(MAX_TICKS))) {
+        m_error = QString("spans %1 s, more than %2 ticks").arg(last - origin).arg(MAX_TICKS);
+        qWarning() << "TraceArrivals:" << path << m_error;
+        return;
+    }
+
+    m_perTick.assign(static_cast<size_t>(span) + 1, 0);
+    for (const auto &[timestamp, count] : records) {
+        m_perTick[static_cast<size_t>((timestamp - origin) / cycleSeconds)] += count;
+    }
+}
+
+int TraceArrivals::nextTick(RandomStream &)
+{
+    if (m_position >= m_perTick.size()) {
+        if (!m_loop || m_perTick.empty()) {
+            return 0;
+        }
+        m_position = 0;
+    }
+    return m_perTick[m_position++];
+}
@@ -0,0 +1,110 @@
+#ifndef ARRIVALPROCESS_H
+#define ARRIVALPROCESS_H
+
+#include <random>
+#include <vector>
+#include <QString>
+#include <QJsonObject>
+#include <QSharedPointer>
+
+#include "../Globals/Globals.h"
+#include "../Globals/RandomStream.h"
+
+// Per-sender packet arrival model, sampled once per simulation tick.
+class ArrivalProcess
+{
+public:
+    virtual ~ArrivalProcess() = default;
+
+    virtual UT::DistributionType type() const = 0;
+    virtual int nextTick(RandomStream &rng) = 0;
+
+    // Builds the model described by a "traffic_models" entry. rate_pps falls back to defaultRatePps.
+    static QSharedPointer<ArrivalProcess> fromConfig(const QJsonObject &model, double defaultRatePps,
+                                                     double cycleSeconds);
+    // False, with the reason in error, when fromConfig could not honour the model as written.
+    static bool checkConfig(const QJsonObject &model, double cycleSeconds, QString *error);
+    static bool parseType(const QString &name, UT::DistributionType &type);
+};
+
+class PoissonArrivals : public ArrivalProcess
+{
+public:
+    PoissonArrivals(double ratePps, double cycleSeconds);
+
+    UT::DistributionType type() const override { return UT::DistributionType::Poisson; }
+    int nextTick(RandomStream &rng) override;
+
+private:
+    double m_meanPerTick;
+    std::poisson_distribution<int> m_perTick;
+};
+
+// Renewal process with Pareto inter-arrival times; 1 < shape < 2 gives infinite variance.
+class ParetoArrivals : public ArrivalProcess
+{
+public:
+    ParetoArrivals(double ratePps, double shape, double cycleSeconds);
+
+    UT::DistributionType type() const override { return UT::DistributionType::Pareto; }
+    int nextTick(RandomStream &rng) override;
+
+private:
+    double sampleGap(RandomStream &rng);
+
+    double m_shape;
+    double m_scale;
+    double m_cycleSeconds;
+    double m_clock = 0.0;
+    double m_nextArrival = -1.0;
+};
+
+// Two-state MMPP. Sojourn times are exponential, or Pareto when a sojourn shape is given, which
+// makes the superposition of many sources self-similar.
+class OnOffArrivals : public ArrivalProcess
+{
+public:
+    OnOffArrivals(double onRatePps, double offRatePps, double meanOnSeconds, double meanOffSeconds,
+                  double sojournShape, double cycleSeconds);
+
+    UT::DistributionType type() const override { return UT::DistributionType::OnOff; }
+    int nextTick(RandomStream &rng) override;
+
+private:
+    double sampleSojourn(RandomStream &rng, double mean);
+
+    double m_onRate;
+    double m_offRate;
+    double m_meanOn;
+    double m_meanOff;
+    double m_sojournShape;
+    double m_cycleSeconds;
+    bool m_on = false;
+    bool m_started = false;
+    double m_stateLeft = 0.0;
+};
+
+// Replays a recorded trace: one "<seconds> [count]" record per line, '#' starts a comment.
+// Timestamps are taken relative to the earliest one, so absolute (e.g. Unix epoch) times work;
+// a trace spanning more than MAX_TICKS ticks is rejected.
+class TraceArrivals : public ArrivalProcess
+{
+public:
+    static constexpr size_t MAX_TICKS = 1 << 24;
+
+    TraceArrivals(const QString &path, double cycleSeconds, bool loop);
+
+    UT::DistributionType type() const override { return UT::DistributionType::Trace; }
+    int nextTick(RandomStream &rng) override;
+
+    bool isValid() const { return !m_perTick.empty(); }
+    QString error() const { return m_error; }    // Why an unreadable or oversized trace was refused
+
+private:
+    std::vector<int> m_perTick;
+    QString m_error;
+    size_t m_position = 0;
+    bool m_loop;
+};
+
+#endif // ARRIVALPROCESS_H
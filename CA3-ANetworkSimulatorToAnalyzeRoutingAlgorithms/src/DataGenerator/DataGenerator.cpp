@@ -1,105 +1,136 @@
+#include <algorithm>
 #include <QFile>
-#include <QTimer>
 #include <QDebug>
 #include <QJsonObject>
 #include <QJsonDocument>
 
 #include "DataGenerator.h"
+#include "ArrivalProcess.h"
+#include "../Globals/SimulationContext.h"
 
-DataGenerator::DataGenerator(QObject *parent) :
+DataGenerator::DataGenerator(SimulationContext *context, QObject *parent) :
     QObject(parent),
-    m_lambda(1.0),
-    m_distribution(m_lambda)
-{
-    std::random_device rd;
-    m_generator.seed(rd());
-}
-
-void DataGenerator::setLambda(double lambda) {
-    m_lambda = lambda;
-    m_distribution = std::poisson_distribution<int>(m_lambda);
-}
+    m_generator(context->randomStream("traffic"))
+{}
 
 void DataGenerator::setSenders(const std::vector<QSharedPointer<PC>> &senders) {
     m_senders = senders;
     qDebug() << "DataGenerator: Set" << m_senders.size() << "senders.";
 }
 
-std::vector<int> DataGenerator::generatePoissonLoads(int numSamples, int timeScale) {
-    std::vector<int> loads(timeScale, 0);
-    for (int i = 0; i < numSamples; ++i) {
-        int value = m_distribution(m_generator);
-        if (value < timeScale) {
-            loads[value]++;
-        }
-    }
-    return loads;
+void DataGenerator::setOfferedLoad(double packetsPerSecond) {
+    m_offeredLoad = packetsPerSecond;
 }
 
-void DataGenerator::generatePackets() {
-    if (m_senders.empty()) {
-        qWarning() << "DataGenerator: No senders set. Cannot generate packets.";
-        return;
-    }
+void DataGenerator::setCycleDuration(std::chrono::milliseconds cycleDuration) {
+    m_cycleDuration = cycleDuration;
+}
 
-    const int numSamples = m_packetsPerSimulation;
-    const int timeScale = 100;
-    std::vector<int> loads = generatePoissonLoads(numSamples, timeScale);
-    std::vector<QSharedPointer<Packet>> packets;
+void DataGenerator::setTrafficDuration(std::chrono::milliseconds trafficDuration) {
+    m_trafficDuration = trafficDuration;
+}
 
-    QMap<QString, QMap<QString, int>> distributionMap; // Origin -> (Destination -> Count)
+bool DataGenerator::buildDestinationTables() {
+    const int senderCount = static_cast<int>(m_senders.size());
+
+    m_senderIps.clear();
+    m_destinationPrefixes.clear();
+    m_payloadSuffixes.clear();
+    m_senderIps.reserve(senderCount);
+    m_destinationPrefixes.reserve(senderCount);
+    m_payloadSuffixes.reserve(senderCount);
+
+    QVector<int> senderIds;
+    senderIds.reserve(senderCount);
+    for (const auto &pc : m_senders) {
+        QString ip = pc->getIpAddress();
+        m_senderIps.append(ip);
+        m_destinationPrefixes.append("Data:" + ip + ":");
+        m_payloadSuffixes.append("Hello from PC " + QString::number(pc->getId()));
+        senderIds.append(pc->getId());
+    }
 
-    for (int second = 0; second < timeScale; ++second) {
-        int packetsForThisSecond = loads[second];
+    m_trafficMatrix.build(senderIds);
 
-        for (int i = 0; i < packetsForThisSecond; ++i) {
-            int senderIndex = m_generator() % m_senders.size();
-            QSharedPointer<PC> sender = m_senders[senderIndex];
+    return senderCount >= 2;
+}
 
-            std::vector<QString> possibleDestinations;
-            for (const auto &pc : m_senders) {
-                if (pc->getId() != sender->getId()) {
-                    possibleDestinations.push_back(pc->getIpAddress());
-                }
-            }
+int DataGenerator::pickDestination(int senderIndex) {
+    return m_trafficMatrix.sampleDestination(senderIndex, m_generator);
+}
 
-            if (possibleDestinations.empty()) {
-                qWarning() << "DataGenerator: No valid destinations available.";
-                continue;
-            }
+QSharedPointer<Packet> DataGenerator::createPacket(int senderIndex, int destinationIndex) {
+    QSharedPointer<Packet> packet = QSharedPointer<Packet>::create(
+        PacketType::Data, m_destinationPrefixes[destinationIndex] + m_payloadSuffixes[senderIndex], 64);
+    packet->addToPath(m_senderIps[senderIndex]);
+    packet->addToPathTaken(m_senderIps[senderIndex]);
+    packet->addToPath(m_senderIps[destinationIndex]);
+    return packet;
+}
 
-            int destIndex = m_generator() % possibleDestinations.size();
-            QString destination = possibleDestinations[destIndex];
+bool DataGenerator::startTraffic() {
+    m_processes.clear();
+    m_ticks = 0;
+    m_tick = 0;
 
-            QString actualPayload = "Hello from PC " + QString::number(sender->getId());
-            QString payload = "Data:" + destination + ":" + actualPayload;
+    if (m_senders.empty()) {
+        qWarning() << "DataGenerator: No senders set. Cannot schedule traffic.";
+        return false;
+    }
 
-            QSharedPointer<Packet> packet = QSharedPointer<Packet>::create(PacketType::Data, payload, 64);
-            packet->addToPath(sender->getIpAddress());
-            packet->addToPathTaken(sender->getIpAddress());
-            packet->addToPath(destination);
-            packets.push_back(packet);
+    if (!buildDestinationTables()) {
+        qWarning() << "DataGenerator: No valid destinations available.";
+        return false;
+    }
 
-            distributionMap[sender->getIpAddress()][destination]++;
-        }
+    const qint64 cycleMs = std::max<qint64>(m_cycleDuration.count(), 1);
+    const double cycleSeconds = static_cast<double>(cycleMs) / 1000.0;
+    m_ticks = static_cast<int>(std::max<qint64>(m_trafficDuration.count() / cycleMs, 1));
+    m_phaseLoad = m_offeredLoad > 0.0
+                      ? m_offeredLoad
+                      : static_cast<double>(m_packetsPerSimulation) / (m_ticks * cycleSeconds);
+
+    const int senderCount = static_cast<int>(m_senderIps.size());
+    m_processes.reserve(senderCount);
+    for (int i = 0; i < senderCount; ++i) {
+        QJsonObject model = m_pcTrafficModels.value(m_senders[i]->getId(), m_defaultTrafficModel);
+        double defaultRate = m_phaseLoad * m_trafficMatrix.senderShare(i);
+        m_processes.push_back(ArrivalProcess::fromConfig(model, defaultRate, cycleSeconds));
     }
 
-    emit packetsGenerated(packets);
+    m_distribution.assign(senderCount * senderCount, 0);
+    m_scheduled = 0;
 
-    qDebug() << packets.size() << "packets generated and emitted over a timescale of" << timeScale << "seconds.";
+    qDebug() << "DataGenerator: Traffic phase of" << m_ticks << "ticks of" << cycleMs << "ms at" << m_phaseLoad
+             << "pps default load.";
+    return true;
+}
 
-    QTimer::singleShot(4000, this, [distributionMap]() {
-        qDebug() << "---- Packet Distribution ----";
-        for (auto itOrigin = distributionMap.constBegin(); itOrigin != distributionMap.constEnd(); ++itOrigin) {
-            QString origin = itOrigin.key();
-            for (auto itDest = itOrigin.value().constBegin(); itDest != itOrigin.value().constEnd(); ++itDest) {
-                QString destination = itDest.key();
-                int count = itDest.value();
-                qDebug() << "Origin:" << origin << "-> Destination:" << destination << " | Packets:" << count;
-            }
+std::vector<QSharedPointer<Packet>> DataGenerator::nextBatch() {
+    std::vector<QSharedPointer<Packet>> batch;
+    if (!hasPendingTraffic()) {
+        return batch;
+    }
+
+    const int senderCount = static_cast<int>(m_senderIps.size());
+    for (int senderIndex = 0; senderIndex < senderCount; ++senderIndex) {
+        int arrivals = m_processes[senderIndex]->nextTick(m_generator);
+        for (int i = 0; i < arrivals; ++i) {
+            int destIndex = pickDestination(senderIndex);
+            batch.push_back(createPacket(senderIndex, destIndex));
+            m_distribution[senderIndex * senderCount + destIndex]++;
         }
-        qDebug() << "------------------------------";
-    });
+    }
+    m_scheduled += batch.size();
+
+    if (++m_tick == m_ticks) {
+        const double seconds = m_ticks * static_cast<double>(std::max<qint64>(m_cycleDuration.count(), 1)) / 1000.0;
+        qDebug() << "DataGenerator: Injected" << m_scheduled << "packets over" << m_ticks << "ticks ("
+                 << m_scheduled / seconds << "pps achieved," << m_phaseLoad << "pps default load).";
+        m_trafficMatrix.report(m_distribution);
+        m_processes.clear();
+    }
+    return batch;
 }
 
 std::vector<QSharedPointer<PC>> DataGenerator::getSenders() const {
@@ -122,7 +153,11 @@ void DataGenerator::loadConfig(const QString &configFilePath)
         return;
     }
 
-    QJsonObject rootObj = doc.object();
+    loadConfig(doc.object());
+}
+
+void DataGenerator::loadConfig(const QJsonObject &rootObj)
+{
 
     if (rootObj.contains("packets_per_simulation") && rootObj["packets_per_simulation"].isDouble()) {
         m_packetsPerSimulation = rootObj["packets_per_simulation"].toInt();
@@ -131,4 +166,78 @@ void DataGenerator::loadConfig(const QString &configFilePath)
         qWarning() << "DataGenerator: 'packets_per_simulation' not found or invalid in config file. Using default value."
                    << m_packetsPerSimulation;
     }
+
+    if (rootObj.contains("offered_load_pps") && rootObj["offered_load_pps"].isDouble()) {
+        m_offeredLoad = rootObj["offered_load_pps"].toDouble();
+        qDebug() << "DataGenerator: Loaded offered_load_pps =" << m_offeredLoad;
+    }
+
+    loadTrafficModels(rootObj);
+    m_trafficMatrix.loadConfig(rootObj);
+}
+
+void DataGenerator::loadTrafficModels(const QJsonObject &rootObj)
+{
+    m_defaultTrafficModel = QJsonObject();
+    m_pcTrafficModels.clear();
+
+    // PCs per gateway router and per AS, so groups can be resolved down to PC ids.
+    QHash<int, QVector<int>> usersByGateway;
+    QHash<int, QVector<int>> usersByAS;
+    for (const QJsonValue &asVal : rootObj.value("Autonomous_systems").toArray()) {
+        QJsonObject asObj = asVal.toObject();
+        int asId = asObj.value("id").toInt();
+        for (const QJsonValue &gwVal : asObj.value("gateways").toArray()) {
+            QJsonObject gwObj = gwVal.toObject();
+            int gatewayId = gwObj.value("node").toInt();
+            for (const QJsonValue &user : gwObj.value("users").toArray()) {
+                usersByGateway[gatewayId].append(user.toInt());
+                usersByAS[asId].append(user.toInt());
+            }
+        }
+    }
+
+    // The most specific selector wins: pcs, then gateways, then as, then an entry without a selector.
+    QHash<int, int> specificity;
+    auto assign = [this, &specificity](int pcId, const QJsonObject &model, int level) {
+        if (specificity.value(pcId, -1) < level) {
+            specificity[pcId] = level;
+            m_pcTrafficModels[pcId] = model;
+        }
+    };
+
+    for (const QJsonValue &modelVal : rootObj.value("traffic_models").toArray()) {
+        QJsonObject model = modelVal.toObject();
+        UT::DistributionType type;
+        if (!ArrivalProcess::parseType(model.value("model").toString("poisson"), type)) {
+            qWarning() << "DataGenerator: Unknown traffic model" << model.value("model").toString() << "ignored.";
+            continue;
+        }
+
+        bool hasSelector = false;
+        for (const QJsonValue &id : model.value("as").toArray()) {
+            hasSelector = true;
+            for (int pcId : usersByAS.value(id.toInt())) {
+                assign(pcId, model, 1);
+            }
+        }
+        for (const QJsonValue &id : model.value("gateways").toArray()) {
+            hasSelector = true;
+            for (int pcId : usersByGateway.value(id.toInt())) {
+                assign(pcId, model, 2);
+            }
+        }
+        for (const QJsonValue &id : model.value("pcs").toArray()) {
+            hasSelector = true;
+            assign(id.toInt(), model, 3);
+        }
+
+        if (!hasSelector) {
+            m_defaultTrafficModel = model;
+        }
+    }
+
+    if (!m_pcTrafficModels.isEmpty() || !m_defaultTrafficModel.isEmpty()) {
+        qDebug() << "DataGenerator: Loaded traffic models for" << m_pcTrafficModels.size() << "PCs.";
+    }
 }
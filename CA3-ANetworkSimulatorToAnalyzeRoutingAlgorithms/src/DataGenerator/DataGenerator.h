@@ -1,40 +1,78 @@
 #ifndef DATAGENERATOR_H
 #define DATAGENERATOR_H
 
+#include <chrono>
 #include <random>
 #include <vector>
+#include <QHash>
+#include <QVector>
 #include <QString>
+#include <QJsonObject>
 #include <QObject>
 #include <QSharedPointer>
 
 #include "../Network/PC.h"
 #include "../Packet/Packet.h"
+#include "TrafficMatrix.h"
+
+class ArrivalProcess;
+class SimulationContext;
 
 class DataGenerator : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit DataGenerator(QObject *parent = nullptr);
+    // Traffic is drawn from the "traffic" stream of the context's seed.
+    explicit DataGenerator(SimulationContext *context, QObject *parent = nullptr);
     ~DataGenerator() override = default;
 
-    void setLambda(double lambda);
     void setSenders(const std::vector<QSharedPointer<PC>> &senders);
-    void generatePackets();
+    void setOfferedLoad(double packetsPerSecond);
+    void setCycleDuration(std::chrono::milliseconds cycleDuration);
+    void setTrafficDuration(std::chrono::milliseconds trafficDuration);
+    // Sets up one arrival process per sender for a traffic phase of trafficDuration. Packets are
+    // built tick by tick in nextBatch(), so only the current tick's batch is ever alive.
+    // Returns false when there is nothing to send.
+    bool startTraffic();
+    // Packets arriving during the next tick of the traffic phase.
+    std::vector<QSharedPointer<Packet>> nextBatch();
+    bool hasPendingTraffic() const { return m_tick < m_ticks; }
     void loadConfig(const QString &configFilePath);
+    void loadConfig(const QJsonObject &config);
 
     std::vector<QSharedPointer<PC>> getSenders() const;
-    std::vector<int> generatePoissonLoads(int numSamples, int timeScale);
-
-Q_SIGNALS:
-    void packetsGenerated(const std::vector<QSharedPointer<Packet>> &packets);
 
 private:
-    double m_lambda;
     int m_packetsPerSimulation = 150;
+    double m_offeredLoad = 0.0; // packets per second, 0 spreads packets_per_simulation over the window
+    std::chrono::milliseconds m_cycleDuration {100};
+    std::chrono::milliseconds m_trafficDuration {60000};
+
+    // "traffic_models" entries resolved per PC id; PCs without one use the default model.
+    QJsonObject m_defaultTrafficModel;
+    QHash<int, QJsonObject> m_pcTrafficModels;
+    TrafficMatrix m_trafficMatrix;
+
+    // Built once per run; the senders only have addresses after the DHCP phase.
+    QVector<QString> m_senderIps;
+    QVector<QString> m_destinationPrefixes;
+    QVector<QString> m_payloadSuffixes;
+
+    // State of the running traffic phase
+    std::vector<QSharedPointer<ArrivalProcess>> m_processes;
+    std::vector<int> m_distribution;    // Origin x Destination -> Count
+    int m_ticks = 0;
+    int m_tick = 0;
+    size_t m_scheduled = 0;
+    double m_phaseLoad = 0.0;
+
+    void loadTrafficModels(const QJsonObject &rootObj);
+    bool buildDestinationTables();
+    int pickDestination(int senderIndex);
+    QSharedPointer<Packet> createPacket(int senderIndex, int destinationIndex);
 
-    std::default_random_engine m_generator;
-    std::poisson_distribution<int> m_distribution;
+    RandomStream m_generator;
     std::vector<QSharedPointer<PC>> m_senders;
 };
 
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <QDebug>
+#include <QJsonArray>
+
+#include "TrafficMatrix.h"
+
+void TrafficMatrix::loadConfig(const QJsonObject &rootObj)
+{
+    m_groupByPc.clear();
+    m_mass.clear();
+    m_explicit.clear();
+    m_elephants.clear();
+
+    QJsonObject matrixObj = rootObj.value("traffic_matrix").toObject();
+    m_granularity = matrixObj.value("granularity").toString("as").toLower();
+    m_model = matrixObj.value("model").toString(matrixObj.isEmpty() ? "uniform" : "gravity").toLower();
+
+    if (m_granularity != "as" && m_granularity != "gateway") {
+        qWarning() << "TrafficMatrix: Unknown granularity" << m_granularity << ". Using per-AS groups.";
+        m_granularity = "as";
+    }
+
+    for (const QJsonValue &asVal : rootObj.value("Autonomous_systems").toArray()) {
+        QJsonObject asObj = asVal.toObject();
+        int asId = asObj.value("id").toInt();
+        for (const QJsonValue &gwVal : asObj.value("gateways").toArray()) {
+            QJsonObject gwObj = gwVal.toObject();
+            int group = m_granularity == "gateway" ? gwObj.value("node").toInt() : asId;
+            for (const QJsonValue &user : gwObj.value("users").toArray()) {
+                m_groupByPc.insert(user.toInt(), group);
+            }
+        }
+    }
+
+    QJsonObject weights = matrixObj.value("weights").toObject();
+    for (const QString &key : weights.keys()) {
+        m_mass.insert(key.toInt(), weights.value(key).toDouble());
+    }
+
+    for (const QJsonValue &demandVal : matrixObj.value("demands").toArray()) {
+        QJsonObject demand = demandVal.toObject();
+        m_explicit.insert(qMakePair(demand.value("from").toInt(), demand.value("to").toInt()),
+                          demand.value("weight").toDouble());
+    }
+
+    for (const QJsonValue &flowVal : matrixObj.value("elephant_flows").toArray()) {
+        QJsonObject flow = flowVal.toObject();
+        ElephantFlow elephant {flow.value("src").toInt(), flow.value("dst").toInt(), flow.value("share").toDouble()};
+        if (elephant.srcPc == elephant.dstPc || elephant.share <= 0.0) {
+            qWarning() << "TrafficMatrix: Ignoring invalid elephant flow" << elephant.srcPc << "->" << elephant.dstPc;
+            continue;
+        }
+        m_elephants.append(elephant);
+    }
+
+    if (m_model != "uniform") {
+        qDebug() << "TrafficMatrix: Loaded" << m_model << "matrix over" << m_granularity << "groups with"
+                 << m_elephants.size() << "elephant flows.";
+    }
+}
+
+double TrafficMatrix::groupWeight(int srcGroup, int dstGroup, int srcSize, int dstSize) const
+{
+    if (m_model == "explicit") {
+        return m_explicit.value(qMakePair(srcGroup, dstGroup), 0.0);
+    }
+    // Gravity: groups without an explicit weight weigh as much as their PC count.
+    return m_mass.value(srcGroup, srcSize) * m_mass.value(dstGroup, dstSize);
+}
+
+void TrafficMatrix::build(const QVector<int> &pcIds)
+{
+    const int n = static_cast<int>(pcIds.size());
+    m_pcIds = pcIds;
+
+    // PCs that are not listed under any gateway fall into group 0.
+    m_groups.clear();
+    for (int pcId : pcIds) {
+        int group = m_groupByPc.value(pcId, 0);
+        if (!m_groups.contains(group)) {
+            m_groups.append(group);
+        }
+    }
+    std::sort(m_groups.begin(), m_groups.end());
+    const int groupCount = static_cast<int>(m_groups.size());
+
+    QHash<int, int> indexOfPc;
+    std::vector<int> groupSize(groupCount, 0);
+    m_senderGroup.assign(n, 0);
+    for (int i = 0; i < n; ++i) {
+        indexOfPc.insert(pcIds[i], i);
+        m_senderGroup[i] = static_cast<int>(m_groups.indexOf(m_groupByPc.value(pcIds[i], 0)));
+        groupSize[m_senderGroup[i]]++;
+    }
+
+    // Group demand F(g, h) is spread evenly over the PC pairs it covers.
+    std::vector<double> demand(groupCount * groupCount, 0.0);
+    for (int g = 0; g < groupCount; ++g) {
+        for (int h = 0; h < groupCount; ++h) {
+            demand[g * groupCount + h] = groupWeight(m_groups[g], m_groups[h], groupSize[g], groupSize[h]);
+        }
+    }
+
+    std::vector<std::vector<double>> rows(n, std::vector<double>(n, 0.0));
+    std::vector<double> rowSum(n, 0.0);
+    double total = 0.0;
+    for (int i = 0; i < n; ++i) {
+        int g = m_senderGroup[i];
+        for (int j = 0; j < n; ++j) {
+            if (i == j) {
+                continue;
+            }
+            int h = m_senderGroup[j];
+            int destinations = groupSize[h] - (g == h ? 1 : 0);
+            double weight = m_model == "uniform" ? 1.0 : demand[g * groupCount + h] / (groupSize[g] * destinations);
+            rows[i][j] = weight;
+            rowSum[i] += weight;
+        }
+        total += rowSum[i];
+    }
+
+    m_senderShare.assign(n, 0.0);
+    m_requested.assign(groupCount * groupCount, 0.0);
+    m_destinations.assign(n, AliasTable());
+
+    for (int i = 0; i < n; ++i) {
+        std::vector<double> &row = rows[i];
+        if (rowSum[i] > 0.0) {
+            for (double &w : row) {
+                w /= rowSum[i];
+            }
+        } else {
+            // No demand configured for this sender; it may still send under its own arrival model.
+            for (int j = 0; j < n; ++j) {
+                row[j] = (i == j) ? 0.0 : 1.0 / std::max(n - 1, 1);
+            }
+        }
+
+        double elephantShare = 0.0;
+        std::vector<double> elephants(n, 0.0);
+        for (const ElephantFlow &flow : m_elephants) {
+            if (flow.srcPc == pcIds[i] && indexOfPc.contains(flow.dstPc)) {
+                elephants[indexOfPc.value(flow.dstPc)] += flow.share;
+                elephantShare += flow.share;
+            }
+        }
+        if (elephantShare > 1.0) {
+            for (double &share : elephants) {
+                share /= elephantShare;
+            }
+            elephantShare = 1.0;
+        }
+        for (int j = 0; j < n; ++j) {
+            row[j] = (1.0 - elephantShare) * row[j] + elephants[j];
+        }
+
+        m_destinations[i].build(row);
+        m_senderShare[i] = total > 0.0 ? rowSum[i] / total : 1.0 / n;
+
+        for (int j = 0; j < n; ++j) {
+            m_requested[m_senderGroup[i] * groupCount + m_senderGroup[j]] += m_senderShare[i] * row[j];
+        }
+    }
+
+    m_senders.build(m_senderShare);
+}
+
+int TrafficMatrix::sampleSender(RandomStream &rng) const
+{
+    return m_senders.sample(rng);
+}
+
+int TrafficMatrix::sampleDestination(int senderIndex, RandomStream &rng) const
+{
+    return m_destinations[senderIndex].sample(rng);
+}
+
+double TrafficMatrix::senderShare(int senderIndex) const
+{
+    return m_senderShare[senderIndex];
+}
+
+QString TrafficMatrix::groupName(int groupIndex) const
+{
+    int group = m_groups.value(groupIndex);
+    if (group == 0) {
+        return "other";
+    }
+    return (m_granularity == "gateway" ? "GW" : "AS") + QString::number(group);
+}
+
+double TrafficMatrix::requestedShare(int srcGroupIndex, int dstGroupIndex) const
+{
+    return m_requested[srcGroupIndex * m_groups.size() + dstGroupIndex];
+}
+
+std::vector<double> TrafficMatrix::achievedShares(const std::vector<int> &pcCounts) const
+{
+    const int n = static_cast<int>(m_pcIds.size());
+    const int groupCount = static_cast<int>(m_groups.size());
+    std::vector<double> achieved(groupCount * groupCount, 0.0);
+
+    double total = 0.0;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            int count = pcCounts[i * n + j];
+            achieved[m_senderGroup[i] * groupCount + m_senderGroup[j]] += count;
+            total += count;
+        }
+    }
+
+    if (total > 0.0) {
+        for (double &share : achieved) {
+            share /= total;
+        }
+    }
+    return achieved;
+}
+
+void TrafficMatrix::report(const std::vector<int> &pcCounts) const
+{
+    const int groupCount = static_cast<int>(m_groups.size());
+    std::vector<double> achieved = achievedShares(pcCounts);
+
+    qDebug() << "---- Traffic Matrix (" << m_model << "," << m_granularity << ") ----";
+    for (int g = 0; g < groupCount; ++g) {
+        for (int h = 0; h < groupCount; ++h) {
+            double requested = requestedShare(g, h);
+            double actual = achieved[g * groupCount + h];
+            if (requested <= 0.0 && actual <= 0.0) {
+                continue;
+            }
+            qDebug().noquote() << groupName(g) << "->" << groupName(h)
+                               << "| requested:" << QString::number(requested * 100.0, 'f', 2) + "%"
+                               << "| achieved:" << QString::number(actual * 100.0, 'f', 2) + "%";
+        }
+    }
+    qDebug() << "------------------------------";
+}
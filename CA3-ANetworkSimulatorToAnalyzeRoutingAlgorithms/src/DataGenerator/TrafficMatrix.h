@@ -0,0 +1,62 @@
+#ifndef TRAFFICMATRIX_H
+#define TRAFFICMATRIX_H
+
+#include <random>
+#include <vector>
+#include <QMap>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+
+#include "AliasTable.h"
+
+// Source/destination demand between groups of PCs (per AS or per gateway router), expanded to
+// per-sender alias tables so each packet's destination is drawn in O(1).
+class TrafficMatrix
+{
+public:
+    TrafficMatrix() = default;
+
+    // Reads group membership from "Autonomous_systems" and demand from "traffic_matrix".
+    void loadConfig(const QJsonObject &rootObj);
+    void build(const QVector<int> &pcIds);
+
+    int sampleSender(RandomStream &rng) const;
+    int sampleDestination(int senderIndex, RandomStream &rng) const;
+    double senderShare(int senderIndex) const;
+
+    QVector<int> groups() const { return m_groups; }
+    QString groupName(int groupIndex) const;
+    double requestedShare(int srcGroupIndex, int dstGroupIndex) const;
+    std::vector<double> achievedShares(const std::vector<int> &pcCounts) const;
+    void report(const std::vector<int> &pcCounts) const;
+
+private:
+    struct ElephantFlow
+    {
+        int srcPc;
+        int dstPc;
+        double share;
+    };
+
+    double groupWeight(int srcGroup, int dstGroup, int srcSize, int dstSize) const;
+
+    QString m_granularity = "as";
+    QString m_model = "uniform";
+    QHash<int, int> m_groupByPc;
+    QHash<int, double> m_mass;
+    QMap<QPair<int, int>, double> m_explicit;
+    QVector<ElephantFlow> m_elephants;
+
+    QVector<int> m_pcIds;
+    QVector<int> m_groups;
+    std::vector<int> m_senderGroup;
+    std::vector<double> m_senderShare;
+    std::vector<double> m_requested;
+    std::vector<AliasTable> m_destinations;
+    AliasTable m_senders;
+};
+
+#endif // TRAFFICMATRIX_H
@@ -0,0 +1,55 @@
+#include "ConvergenceDetector.h"
+
+ConvergenceDetector::ConvergenceDetector(int stableTicks)
+    : m_stableTicks(qMax(1, stableTicks))
+{}
+
+bool ConvergenceDetector::observe(int tick, quint64 ribVersion)
+{
+    if (!m_seen || ribVersion != m_version) {
+        m_seen = true;
+        m_version = ribVersion;
+        m_lastChangeTick = tick;
+        m_quietTicks = 0;
+        m_converged = false;
+        m_verified = false;
+        m_check.reset();    // Its result would be about routes that have changed since
+        return false;
+    }
+
+    ++m_quietTicks;
+    if (m_converged) {
+        return false;
+    }
+
+    if (m_check && m_check->finished.load(std::memory_order_acquire)) {
+        bool clean = m_check->clean;
+        m_check.reset();
+        if (clean) {
+            m_verified = true;
+            m_converged = true;
+            return true;
+        }
+    }
+
+    // The oracle walks every route, so one run at a time, started every few quiet ticks.
+    if (m_oracle && !m_check && m_quietTicks % ORACLE_QUIET_TICKS == 0) {
+        m_check = m_oracle();
+    }
+
+    if (m_quietTicks >= m_stableTicks) {
+        m_converged = true;
+        m_check.reset();
+        return true;
+    }
+    return false;
+}
+
+void ConvergenceDetector::reset()
+{
+    m_seen = false;
+    m_quietTicks = 0;
+    m_converged = false;
+    m_verified = false;
+    m_check.reset();
+}
@@ -0,0 +1,56 @@
+#ifndef CONVERGENCEDETECTOR_H
+#define CONVERGENCEDETECTOR_H
+
+#include <atomic>
+#include <functional>
+#include <QtGlobal>
+#include <QSharedPointer>
+
+// One run of a convergence oracle. Whichever thread finishes the run sets clean, then finished.
+struct OracleCheck
+{
+    std::atomic<bool> finished {false};
+    bool clean = false;
+};
+
+// Watches the combined RIB version of every router once per tick. The network converged at the
+// last tick the version moved; that is declared once it stays still for the stability window,
+// or as soon as the optional oracle confirms the routes while it is still.
+class ConvergenceDetector
+{
+public:
+    static constexpr int DEFAULT_STABLE_TICKS = 20;
+    static constexpr int ORACLE_QUIET_TICKS = 2;
+
+    // Starts checking the routes as they are now and returns without waiting for the result.
+    using Oracle = std::function<QSharedPointer<OracleCheck>()>;
+
+    explicit ConvergenceDetector(int stableTicks = DEFAULT_STABLE_TICKS);
+
+    void setStableTicks(int ticks) { m_stableTicks = qMax(1, ticks); }
+    void setOracle(Oracle oracle) { m_oracle = std::move(oracle); }
+
+    // Returns true on the tick convergence is declared.
+    bool observe(int tick, quint64 ribVersion);
+    // Forgets everything observed so far; the next observation starts a new measurement.
+    void reset();
+
+    bool isConverged() const { return m_converged; }
+    bool isVerified() const { return m_verified; }
+    int lastChangeTick() const { return m_lastChangeTick; }
+    int quietTicks() const { return m_quietTicks; }
+
+private:
+    int m_stableTicks;
+    Oracle m_oracle;
+    QSharedPointer<OracleCheck> m_check;    // Outstanding run, started at the current version
+
+    bool m_seen = false;
+    quint64 m_version = 0;
+    int m_lastChangeTick = 0;
+    int m_quietTicks = 0;
+    bool m_converged = false;
+    bool m_verified = false;
+};
+
+#endif // CONVERGENCEDETECTOR_H
@@ -2,14 +2,14 @@
 
 #include "QCoreApplication"
 #include "EventsCoordinator.h"
+#include "../Logger/Logger.h"
+#include "../Trace/TimelineTrace.h"
 #include "DataGenerator/DataGenerator.h"
 
-EventsCoordinator::EventsCoordinator(QThread *parent) :
+EventsCoordinator::EventsCoordinator(QObject *parent) :
     QThread {parent},
     m_timer {new QTimer(this)},
-    m_dataGenerator {nullptr},
-    m_routingChangedThisTick(false),
-    m_convergenceTickCounter(0)
+    m_dataGenerator {nullptr}
 {
     connect(m_timer, &QTimer::timeout, this, &EventsCoordinator::onTick);
 }
@@ -26,25 +26,6 @@ EventsCoordinator::~EventsCoordinator() {
     wait();
 }
 
-EventsCoordinator * EventsCoordinator::instance(QThread *parent)
-{
-    if (!m_self)
-    {
-        m_self = new EventsCoordinator(parent);
-    }
-
-    return m_self;
-}
-
-void EventsCoordinator::release()
-{
-    if (m_self)
-    {
-        delete m_self;
-        m_self = nullptr;
-    }
-}
-
 void EventsCoordinator::startClock(Millis interval) {
     QMetaObject::invokeMethod(this, [this, interval]() {
         if (!m_timer) {
@@ -52,7 +33,7 @@ void EventsCoordinator::startClock(Millis interval) {
             connect(m_timer, &QTimer::timeout, this, &EventsCoordinator::onTick);
         }
         m_timer->start(interval.count());
-        qDebug() << "Clock started with interval:" << interval.count() << "ms";
+        LOG_DEBUG(Events) << "Clock started with interval:" << interval.count() << "ms";
     });
 }
 
@@ -60,77 +41,70 @@ void EventsCoordinator::stopClock() {
     QMetaObject::invokeMethod(this, [this]() {
         if (m_timer && m_timer->isActive()) {
             m_timer->stop();
-            qDebug() << "Clock stopped.";
+            LOG_DEBUG(Events) << "Clock stopped.";
         }
     });
 }
 
-void EventsCoordinator::setDataGenerator(DataGenerator *generator)
-{
-    if (m_dataGenerator)
-    {
-        disconnect(m_dataGenerator, &DataGenerator::packetsGenerated, this, &EventsCoordinator::onPacketsGenerated);
-    }
-
-    m_dataGenerator = generator;
-
-    if (m_dataGenerator)
-    {
-        connect(m_dataGenerator, &DataGenerator::packetsGenerated, this, &EventsCoordinator::onPacketsGenerated);
-        m_dataGenerator->generatePackets();
-    }
-}
-
 void EventsCoordinator::onTick() {
-    ++m_currentTime;
+    int time = ++m_currentTime;
+    if (m_recordsTimeline.load(std::memory_order_relaxed)) {
+        TimelineTrace::clockTick(time);
+    }
     emit tick();
 
-    if (m_packetQueue.empty()) {
-    } else {
-        auto packet = m_packetQueue.front();
-        m_packetQueue.erase(m_packetQueue.begin());
-        emit packetGenerated(packet);
-        qDebug() << "Packet emitted from the queue.";
+    if (m_dataGenerator && m_dataGenerator->hasPendingTraffic()) {
+        std::vector<QSharedPointer<Packet>> batch = m_dataGenerator->nextBatch();
+        if (!batch.empty()) {
+            emit packetsInjected(batch);
+        }
+        if (!m_dataGenerator->hasPendingTraffic()) {
+            LOG_DEBUG(Events) << "All traffic injected at tick" << time;
+            emit trafficDrained();
+        }
     }
 
-    if (!m_routingChangedThisTick) {
-        m_convergenceTickCounter++;
-        qDebug() << "No routing table changes detected this tick. Convergence counter:" << m_convergenceTickCounter;
-        if (m_convergenceTickCounter >= REQUIRED_STABLE_TICKS) {
-            qDebug() << "Network has converged. Notifying simulation.";
-            emit convergenceDetected();
-            stopClock();
-        }
-    } else {
-        qDebug() << "Routing tables changed this tick. Resetting convergence counter.";
-        m_convergenceTickCounter = 0;
+    if (m_convergence.observe(time, ribVersion())) {
+        LOG_DEBUG(Events) << "Network converged at tick" << m_convergence.lastChangeTick() << "(detected at tick" << time
+                          << (m_convergence.isVerified() ? ", routes verified)" : ")");
+        // The clock keeps running: later routing stages and the traffic phase share it.
+        emit convergenceDetected();
     }
+}
 
-    m_routingChangedThisTick = false;
+void EventsCoordinator::setConvergenceOracle(ConvergenceDetector::Oracle oracle)
+{
+    m_oracle = std::move(oracle);
+    m_convergence.setOracle(m_oracle);
 }
 
-void EventsCoordinator::onPacketsGenerated(const std::vector<QSharedPointer<Packet>> &packets)
+void EventsCoordinator::restartConvergence(bool useOracle)
 {
-    m_packetQueue.insert(m_packetQueue.end(), packets.begin(), packets.end());
-    qDebug() << packets.size() << "packets added to the queue. Total queue size:" << m_packetQueue.size();
+    QMetaObject::invokeMethod(this, [this, useOracle]() {
+        m_convergence.reset();
+        m_convergence.setOracle(useOracle ? m_oracle : ConvergenceDetector::Oracle());
+    });
 }
 
-void EventsCoordinator::onRoutingTableUpdated(int routerId) {
-    qDebug() << "EventsCoordinator received routingTableUpdated signal from Router" << routerId;
-    m_routingChangedThisTick = true;
+quint64 EventsCoordinator::ribVersion() const
+{
+    quint64 version = 0;
+    for (const auto &router : m_routers) {
+        version += router->getRibVersion();
+    }
+    return version;
 }
 
 void EventsCoordinator::addRouter(const QSharedPointer<Router> &router) {
     m_routers.push_back(router);
-    connect(router.data(), &Router::routingTableUpdated, this, &EventsCoordinator::onRoutingTableUpdated);
-    qDebug() << "Router" << router->getId() << "added to EventsCoordinator.";
+    LOG_DEBUG(Events) << "Router" << router->getId() << "added to EventsCoordinator.";
 }
 
 void EventsCoordinator::run() {
     m_timer = new QTimer();
     connect(m_timer, &QTimer::timeout, this, &EventsCoordinator::onTick);
     m_timer->start(1000);
-    qDebug() << "Clock started with interval:" << 1000 << "ms";
+    LOG_DEBUG(Events) << "Clock started with interval:" << 1000 << "ms";
 
     exec();
     m_timer->stop();
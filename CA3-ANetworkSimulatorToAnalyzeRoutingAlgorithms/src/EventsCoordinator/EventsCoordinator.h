@@ -2,6 +2,7 @@
 #define EVENTSCOORDINATOR_H
 
 #include <QTimer>
+#include <atomic>
 #include <vector>
 #include <chrono>
 #include <QObject>
@@ -10,6 +11,7 @@
 
 #include "../Network/Router.h"
 #include "../Network/PC.h"
+#include "ConvergenceDetector.h"
 
 class DataGenerator;
 class Packet;
@@ -20,49 +22,57 @@ class EventsCoordinator : public QThread
 
     typedef std::chrono::milliseconds Millis;
 
-protected:
-    explicit EventsCoordinator(QThread *parent = nullptr);
-
 public:
+    // One per simulation, owned by its SimulationContext.
     explicit EventsCoordinator(QObject *parent = nullptr);
     ~EventsCoordinator() override;
-    static EventsCoordinator *instance(QThread *parent = nullptr);
-    static void release();
 
     void startClock(Millis interval);
     void stopClock();
 
-    void setDataGenerator(DataGenerator *generator);
+    // The generator is driven from the coordinator's thread: each tick injects the batch it builds.
+    void setDataGenerator(DataGenerator *generator) { m_dataGenerator = generator; }
     void addRouter(const QSharedPointer<Router> &router);
 
+    // Both must be set before the clock starts. The oracle is started from the coordinator's
+    // thread and must not block it; the detector picks up its result on a later tick.
+    void setConvergenceWindow(int stableTicks) { m_convergence.setStableTicks(stableTicks); }
+    void setConvergenceOracle(ConvergenceDetector::Oracle oracle);
+    // Measures convergence afresh from the next tick, e.g. for the next stage of a staged routing
+    // start. Without useOracle only the stability window can declare it.
+    void restartConvergence(bool useOracle);
+    int convergenceTick() const { return m_convergence.lastChangeTick(); }
+
+    int currentTick() const { return m_currentTime.load(std::memory_order_relaxed); }
+    // Set by the SimulationContext holding the timeline trace; each tick then lands on its clock track.
+    void setRecordsTimeline(bool records) { m_recordsTimeline.store(records, std::memory_order_relaxed); }
+
 protected:
     void run() override;
 
 signals:
     void tick();
-    void packetGenerated(QSharedPointer<Packet> packet);
+    void packetsInjected(const std::vector<QSharedPointer<Packet>> &batch);
+    void trafficDrained();
     void convergenceDetected();
 
 private slots:
     void onTick();
-    void onPacketsGenerated(const std::vector<QSharedPointer<Packet>> &packets);
-    void onRoutingTableUpdated(int routerId);
 
 private:
-    inline static EventsCoordinator *m_self = nullptr;
     QTimer *m_timer = nullptr;
     DataGenerator *m_dataGenerator = nullptr;
 
-    std::vector<QSharedPointer<Packet>> m_packetQueue;
     std::vector<QSharedPointer<Router>> m_routers;
     std::vector<QSharedPointer<PC>> m_pcs;
 
-    bool m_routingChangedThisTick;
-    int m_convergenceTickCounter;
-    const int REQUIRED_STABLE_TICKS = 20;
+    ConvergenceDetector m_convergence;
+    ConvergenceDetector::Oracle m_oracle;
+    quint64 ribVersion() const;
 
     void synchronizeRoutersWithDHCP();
-    int m_currentTime = 0;
+    std::atomic<int> m_currentTime {0};
+    std::atomic<bool> m_recordsTimeline {false};
 };
 
 #endif // EVENTSCOORDINATOR_H
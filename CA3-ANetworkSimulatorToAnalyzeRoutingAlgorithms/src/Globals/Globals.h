@@ -34,7 +34,9 @@ enum class PacketControlType
 enum class DistributionType
 {
     Poisson,
-    Pareto
+    Pareto,
+    OnOff,
+    Trace
 };
 
 enum class TopologyType
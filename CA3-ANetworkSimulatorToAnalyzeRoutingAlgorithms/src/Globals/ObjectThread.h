@@ -0,0 +1,34 @@
+#ifndef OBJECTTHREAD_H
+#define OBJECTTHREAD_H
+
+#include <QObject>
+#include <QThread>
+#include <QMetaObject>
+
+// Runs function on the thread object lives in and waits for it. Objects whose thread is the
+// caller's, or is not running, are the caller's to touch, so function then runs right away.
+template <typename Function>
+void runOnObjectThread(QObject *object, Function function)
+{
+    QThread *thread = object->thread();
+    if (thread == QThread::currentThread() || !thread->isRunning()) {
+        function();
+    } else {
+        QMetaObject::invokeMethod(object, function, Qt::BlockingQueuedConnection);
+    }
+}
+
+// Like runOnObjectThread, but returns at once when function has to be queued. A queued function
+// is dropped if object is destroyed before its thread gets to it.
+template <typename Function>
+void postToObjectThread(QObject *object, Function function)
+{
+    QThread *thread = object->thread();
+    if (thread == QThread::currentThread() || !thread->isRunning()) {
+        function();
+    } else {
+        QMetaObject::invokeMethod(object, function, Qt::QueuedConnection);
+    }
+}
+
+#endif // OBJECTTHREAD_H
@@ -0,0 +1,29 @@
+#include "RandomStream.h"
+
+quint64 RandomStream::s_globalSeed = 0;
+
+RandomStream RandomStream::forComponent(quint64 seed, const char *component, quint64 index)
+{
+    // FNV-1a over the component name keeps stream keys stable across builds.
+    quint64 hash = 0xCBF29CE484222325ULL;
+    for (const char *c = component; c && *c; ++c) {
+        hash = (hash ^ static_cast<unsigned char>(*c)) * 0x100000001B3ULL;
+    }
+
+    return RandomStream(mix(seed ^ hash) + mix(index + GOLDEN_GAMMA));
+}
+
+RandomStream RandomStream::forComponent(const char *component, quint64 index)
+{
+    return forComponent(s_globalSeed, component, index);
+}
+
+void RandomStream::setGlobalSeed(quint64 seed)
+{
+    s_globalSeed = seed;
+}
+
+quint64 RandomStream::globalSeed()
+{
+    return s_globalSeed;
+}
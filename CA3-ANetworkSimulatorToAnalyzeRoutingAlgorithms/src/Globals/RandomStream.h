@@ -0,0 +1,49 @@
+#ifndef RANDOMSTREAM_H
+#define RANDOMSTREAM_H
+
+#include <QtGlobal>
+
+// Counter-based SplitMix64 stream. Draw i of a stream is a pure function of (global seed, component,
+// index, i), so each component gets the same numbers no matter how the others interleave.
+// Satisfies UniformRandomBitGenerator, so it plugs into the <random> distributions.
+class RandomStream
+{
+public:
+    typedef quint64 result_type;
+
+    explicit RandomStream(quint64 key = 0) : m_key(mix(key)) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    result_type operator()() { return at(m_counter++); }
+    result_type at(quint64 counter) const { return mix(m_key + (counter + 1) * GOLDEN_GAMMA); }
+
+    quint64 position() const { return m_counter; }
+    void discard(quint64 count) { m_counter += count; }
+
+    // Independent stream for a named component (and e.g. a node id), derived from a run's seed.
+    static RandomStream forComponent(quint64 seed, const char *component, quint64 index = 0);
+    // Same, from the global seed; simulations use their SimulationContext's seed instead.
+    static RandomStream forComponent(const char *component, quint64 index = 0);
+
+    static void setGlobalSeed(quint64 seed);
+    static quint64 globalSeed();
+
+    static constexpr quint64 mix(quint64 z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    static constexpr quint64 GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+    static quint64 s_globalSeed;
+
+    quint64 m_key;
+    quint64 m_counter = 0;
+};
+
+#endif // RANDOMSTREAM_H
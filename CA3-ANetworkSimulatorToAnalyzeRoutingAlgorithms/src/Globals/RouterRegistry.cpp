@@ -1,3 +1,42 @@
 #include "RouterRegistry.h"
 
-std::vector<QSharedPointer<Router>> RouterRegistry::allRouters;
+void RouterRegistry::addRouters(const std::vector<QSharedPointer<Router>> &routers)
+{
+    for (auto &r : routers) {
+        allRouters.push_back(r);
+    }
+    reindex();
+}
+
+void RouterRegistry::reindex()
+{
+    m_positionById.clear();
+    for (size_t i = 0; i < allRouters.size(); ++i) {
+        int id = allRouters[i]->getId();
+        if (id < 0) continue;
+        if (id >= m_positionById.size()) {
+            m_positionById.resize(id + 1, -1);
+        }
+        // The first router registered under an id wins.
+        if (m_positionById[id] < 0) {
+            m_positionById[id] = static_cast<int>(i);
+        }
+    }
+    m_indexedCount = allRouters.size();
+}
+
+QSharedPointer<Router> RouterRegistry::findRouterById(int routerId) const
+{
+    if (m_indexedCount == allRouters.size()) {
+        if (routerId < 0 || routerId >= m_positionById.size()) return nullptr;
+        int position = m_positionById[routerId];
+        return position >= 0 ? allRouters[position] : nullptr;
+    }
+
+    for (const auto &r : allRouters) {
+        if (r->getId() == routerId) {
+            return r;
+        }
+    }
+    return nullptr;
+}
@@ -2,28 +2,27 @@
 #define ROUTERREGISTRY_H
 
 #include <vector>
+#include <QVector>
 #include <QSharedPointer>
 
 #include <../Network/Router.h>
 
+// The routers of one simulation, owned by its SimulationContext.
 class RouterRegistry {
 public:
-    static std::vector<QSharedPointer<Router>> allRouters;
-
-    static void addRouters(const std::vector<QSharedPointer<Router>> &routers) {
-        for (auto &r : routers) {
-            allRouters.push_back(r);
-        }
-    }
-
-    static QSharedPointer<Router> findRouterById(int routerId) {
-        for (auto &r : allRouters) {
-            if (r->getId() == routerId) {
-                return r;
-            }
-        }
-        return nullptr;
-    }
+    std::vector<QSharedPointer<Router>> allRouters;
+
+    void addRouters(const std::vector<QSharedPointer<Router>> &routers);
+
+    // Constant time through a table indexed by router id; falls back to a scan if allRouters
+    // was edited directly since the last addRouters.
+    QSharedPointer<Router> findRouterById(int routerId) const;
+
+private:
+    QVector<int> m_positionById;    // Position in allRouters, or -1
+    size_t m_indexedCount = 0;
+
+    void reindex();
 };
 
 #endif // ROUTERREGISTRY_H
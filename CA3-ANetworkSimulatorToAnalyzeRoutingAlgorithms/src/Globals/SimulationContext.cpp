@@ -0,0 +1,118 @@
+#include <QDir>
+#include <QDebug>
+
+#include "SimulationContext.h"
+#include "../Logger/AsyncLogWriter.h"
+#include "../Topology/TopologySnapshot.h"
+#include "../Trace/EventTrace.h"
+#include "../Trace/TimelineTrace.h"
+#include "../EventsCoordinator/EventsCoordinator.h"
+
+SimulationContext::SimulationContext(quint64 seed)
+    : m_events(std::make_unique<EventsCoordinator>()),
+    m_macAddresses(seed),
+    m_seed(seed),
+    m_logDirectory(AsyncLogWriter::logDirectory())
+{}
+
+namespace {
+
+// Which context, if any, holds each process-wide trace file.
+std::atomic<const SimulationContext *> s_eventTraceOwner {nullptr};
+std::atomic<const SimulationContext *> s_timelineOwner {nullptr};
+
+bool claim(std::atomic<const SimulationContext *> &owner, const SimulationContext *context)
+{
+    const SimulationContext *expected = nullptr;
+    return owner.compare_exchange_strong(expected, context) || expected == context;
+}
+
+}
+
+SimulationContext::~SimulationContext()
+{
+    stopTraces();
+}
+
+int SimulationContext::tick() const
+{
+    return m_events->currentTick();
+}
+
+void SimulationContext::setSeed(quint64 seed)
+{
+    m_seed = seed;
+    m_macAddresses.setSeed(seed);
+}
+
+QString SimulationContext::logDirectory() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_logDirectory;
+}
+
+void SimulationContext::setLogDirectory(const QString &directory)
+{
+    QMutexLocker locker(&m_mutex);
+    m_logDirectory = directory;
+}
+
+QString SimulationContext::logFilePath(const QString &fileName) const
+{
+    return QDir(logDirectory()).absoluteFilePath(fileName);
+}
+
+QSharedPointer<const TopologySnapshot> SimulationContext::topology()
+{
+    QMutexLocker locker(&m_mutex);
+    quint64 epoch = topologyEpoch();
+    if (!m_topology || m_topology->version() != epoch) {
+        auto snapshot = QSharedPointer<TopologySnapshot>::create(m_routers.allRouters, epoch);
+        qDebug() << "Topology snapshot" << snapshot->version() << "built:" << snapshot->nodeCount() << "routers,"
+                 << snapshot->edgeCount() / 2 << "links";
+        m_topology = snapshot;
+    }
+    return m_topology;
+}
+
+bool SimulationContext::startEventTrace(const QString &fileName, quint64 capacityRecords)
+{
+    if (!claim(s_eventTraceOwner, this)) {
+        qWarning() << "EventTrace: already recording for another simulation; not tracing" << fileName;
+        return false;
+    }
+    m_ownsEventTrace = EventTrace::start(logFilePath(fileName), capacityRecords);
+    if (!m_ownsEventTrace) {
+        s_eventTraceOwner.store(nullptr);
+    }
+    return m_ownsEventTrace;
+}
+
+bool SimulationContext::startTimeline(const QString &fileName, quint64 maxEvents)
+{
+    if (!claim(s_timelineOwner, this)) {
+        qWarning() << "TimelineTrace: already recording for another simulation; not tracing" << fileName;
+        return false;
+    }
+    m_ownsTimeline = TimelineTrace::start(logFilePath(fileName), maxEvents);
+    m_events->setRecordsTimeline(m_ownsTimeline);
+    if (!m_ownsTimeline) {
+        s_timelineOwner.store(nullptr);
+    }
+    return m_ownsTimeline;
+}
+
+void SimulationContext::stopTraces()
+{
+    if (m_ownsEventTrace) {
+        EventTrace::stop();
+        m_ownsEventTrace = false;
+        s_eventTraceOwner.store(nullptr);
+    }
+    if (m_ownsTimeline) {
+        m_events->setRecordsTimeline(false);
+        TimelineTrace::stop();
+        m_ownsTimeline = false;
+        s_timelineOwner.store(nullptr);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef SIMULATIONCONTEXT_H
+#define SIMULATIONCONTEXT_H
+
+#include <atomic>
+#include <memory>
+#include <QMutex>
+#include <QString>
+#include <QSharedPointer>
+
+#include "RandomStream.h"
+#include "RouterRegistry.h"
+#include "../MACAddress/MACAddressGenerator.h"
+
+class EventsCoordinator;
+class TopologySnapshot;
+
+// State shared by the nodes of one simulation: its clock, routers, seed, MAC addresses, log
+// directory and the traces it records. Every Simulator owns one, so several simulations can run
+// side by side in a process. Create it on the thread that will drive the simulation; the
+// coordinator lives there, and so must every call that starts or stops a trace.
+class SimulationContext
+{
+public:
+    explicit SimulationContext(quint64 seed = RandomStream::globalSeed());
+    ~SimulationContext();
+
+    SimulationContext(const SimulationContext &) = delete;
+    SimulationContext &operator=(const SimulationContext &) = delete;
+
+    EventsCoordinator *events() const { return m_events.get(); }
+    int tick() const;    // The current tick of events(); safe from any thread
+    RouterRegistry &routers() { return m_routers; }
+    MACAddressGenerator &macAddresses() { return m_macAddresses; }
+
+    quint64 seed() const { return m_seed; }
+    void setSeed(quint64 seed);
+    RandomStream randomStream(const char *component, quint64 index = 0) const
+    {
+        return RandomStream::forComponent(m_seed, component, index);
+    }
+
+    // Relative log and trace file names resolve against this ("log_directory" in the config).
+    QString logDirectory() const;
+    void setLogDirectory(const QString &directory);
+    QString logFilePath(const QString &fileName) const;    // Always absolute
+
+    // Snapshot of routers(), rebuilt on the first call after a port binding in this context changes.
+    QSharedPointer<const TopologySnapshot> topology();
+    quint64 topologyEpoch() const { return m_topologyEpoch.load(std::memory_order_acquire); }
+    void invalidateTopology() { m_topologyEpoch.fetch_add(1, std::memory_order_acq_rel); }
+
+    // Bumped whenever a node of this simulation changes address; caches of neighbour addresses
+    // compare against it.
+    quint64 addressEpoch() const { return m_addressEpoch.load(std::memory_order_acquire); }
+    void invalidateAddresses() { m_addressEpoch.fetch_add(1, std::memory_order_acq_rel); }
+
+    // The event and timeline traces each write one process-wide file, so at most one context
+    // records into each at a time. Start fails while another context holds the trace; the holder
+    // alone feeds the timeline's clock track, and stopTraces() closes only what it opened.
+    bool startEventTrace(const QString &fileName, quint64 capacityRecords);
+    bool startTimeline(const QString &fileName, quint64 maxEvents);
+    void stopTraces();
+
+private:
+    std::unique_ptr<EventsCoordinator> m_events;
+    RouterRegistry m_routers;
+    MACAddressGenerator m_macAddresses;
+    quint64 m_seed;
+
+    mutable QMutex m_mutex;
+    QString m_logDirectory;
+    QSharedPointer<const TopologySnapshot> m_topology;
+    std::atomic<quint64> m_topologyEpoch {0};
+    std::atomic<quint64> m_addressEpoch {0};
+
+    bool m_ownsEventTrace = false;
+    bool m_ownsTimeline = false;
+};
+
+#endif // SIMULATIONCONTEXT_H
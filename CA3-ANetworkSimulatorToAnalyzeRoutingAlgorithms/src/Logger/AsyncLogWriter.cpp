@@ -0,0 +1,134 @@
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include "AsyncLogWriter.h"
+
+QString AsyncLogWriter::s_logDirectory = "logs";
+
+AsyncLogWriter::AsyncLogWriter(const QString &fileName, int batchSize, int flushIntervalMs, QObject *parent)
+    : QThread(parent),
+    m_batchSize(qMax(1, batchSize)),
+    m_flushIntervalMs(qMax(1, flushIntervalMs))
+{
+    m_filePath = QFileInfo(fileName).isAbsolute() ? fileName : QDir(s_logDirectory).filePath(fileName);
+
+    Entry *stub = new Entry;
+    m_head.store(stub, std::memory_order_relaxed);
+    m_tail = stub;
+
+    start(QThread::LowPriority);
+}
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+    m_stopping.store(true, std::memory_order_release);
+    {
+        QMutexLocker locker(&m_wakeMutex);
+        m_wake.wakeOne();
+    }
+    wait();
+
+    while (Entry *entry = pop()) {
+        delete entry;
+    }
+    delete m_tail;
+}
+
+void AsyncLogWriter::setLogDirectory(const QString &directory)
+{
+    s_logDirectory = directory;
+}
+
+QString AsyncLogWriter::logDirectory()
+{
+    return s_logDirectory;
+}
+
+QString AsyncLogWriter::filePath() const
+{
+    return m_filePath;
+}
+
+void AsyncLogWriter::append(LogLevel level, const QString &message)
+{
+    Entry *entry = new Entry;
+    entry->timestampMs = QDateTime::currentMSecsSinceEpoch();
+    entry->level = level;
+    entry->message = message;
+
+    Entry *previous = m_head.exchange(entry, std::memory_order_acq_rel);
+    previous->next.store(entry, std::memory_order_release);
+
+    // The first producer to find a full batch since the writer last looked wakes it, however far
+    // the backlog has overshot the batch size in the meantime.
+    if (m_pending.fetch_add(1) + 1 >= m_batchSize && !m_wakePending.exchange(true)) {
+        QMutexLocker locker(&m_wakeMutex);
+        m_wake.wakeOne();
+    }
+}
+
+AsyncLogWriter::Entry *AsyncLogWriter::pop()
+{
+    // The popped entry becomes the new stub; the caller gets the old stub carrying its payload.
+    Entry *tail = m_tail;
+    Entry *next = tail->next.load(std::memory_order_acquire);
+    if (!next) {
+        return nullptr;
+    }
+
+    tail->timestampMs = next->timestampMs;
+    tail->level = next->level;
+    tail->message = std::move(next->message);
+    m_tail = next;
+    return tail;
+}
+
+void AsyncLogWriter::run()
+{
+    QFileInfo fileInfo(m_filePath);
+    if (!fileInfo.dir().exists() && !QDir().mkpath(fileInfo.absolutePath())) {
+        qWarning() << "Failed to create log directory:" << fileInfo.absolutePath();
+    }
+
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Unable to open log file:" << m_filePath;
+    }
+    QTextStream stream(&file);
+
+    static const char *const levelNames[] = {"ERROR", "WARNING", "DEBUG", "TRACE"};
+
+    bool stopping = false;
+    while (!stopping) {
+        {
+            // Cleared before the check: a producer filling a batch after it sees the flag down and
+            // wakes us, or its count is already visible here.
+            m_wakePending.store(false);
+            QMutexLocker locker(&m_wakeMutex);
+            if (m_pending.load() < m_batchSize &&
+                !m_stopping.load(std::memory_order_acquire)) {
+                m_wake.wait(&m_wakeMutex, static_cast<unsigned long>(m_flushIntervalMs));
+            }
+        }
+        stopping = m_stopping.load(std::memory_order_acquire);
+
+        int written = 0;
+        while (Entry *entry = pop()) {
+            if (file.isOpen()) {
+                stream << QDateTime::fromMSecsSinceEpoch(entry->timestampMs).toString("yyyy-MM-dd hh:mm:ss.zzz")
+                       << " [" << levelNames[entry->level] << "] " << entry->message << "\n";
+            }
+            delete entry;
+            ++written;
+        }
+
+        if (written > 0) {
+            m_pending.fetch_sub(written);
+            stream.flush();
+        }
+    }
+}
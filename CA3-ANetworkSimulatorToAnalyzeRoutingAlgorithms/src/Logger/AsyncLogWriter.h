@@ -0,0 +1,74 @@
+#ifndef ASYNCLOGWRITER_H
+#define ASYNCLOGWRITER_H
+
+#include <atomic>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "Logger.h"
+
+// Lines below this level are compiled out of every AsyncLogWriter::log call site.
+#ifndef ASYNC_LOG_LEVEL
+#define ASYNC_LOG_LEVEL DEBUG_LEVEL
+#endif
+
+// Appends timestamped lines to a file from a background thread. Producers push onto a lock-free
+// MPSC queue; the writer drains it when batchSize lines are pending or every flushIntervalMs,
+// and flushes once per batch.
+class AsyncLogWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit AsyncLogWriter(const QString &fileName, int batchSize = 256, int flushIntervalMs = 200,
+                            QObject *parent = nullptr);
+    ~AsyncLogWriter() override;
+
+    template <LogLevel Level>
+    void log(const QString &message)
+    {
+        if constexpr (Level <= ASYNC_LOG_LEVEL) {
+            append(Level, message);
+        }
+    }
+
+    void append(LogLevel level, const QString &message);
+    QString filePath() const;
+
+    // Directory that relative log file names resolve against ("log_directory" in the config).
+    static void setLogDirectory(const QString &directory);
+    static QString logDirectory();
+
+protected:
+    void run() override;
+
+private:
+    struct Entry {
+        std::atomic<Entry *> next {nullptr};
+        qint64 timestampMs = 0;
+        LogLevel level = DEBUG_LEVEL;
+        QString message;
+    };
+
+    Entry *pop();
+
+    QString m_filePath;
+    int m_batchSize;
+    int m_flushIntervalMs;
+
+    // Vyukov intrusive queue: producers exchange m_head, the writer thread alone advances m_tail.
+    std::atomic<Entry *> m_head;
+    Entry *m_tail;
+    std::atomic<int> m_pending {0};
+    std::atomic<bool> m_wakePending {false};   // A full batch was signalled since the writer last looked
+    std::atomic<bool> m_stopping {false};
+
+    QMutex m_wakeMutex;
+    QWaitCondition m_wake;
+
+    static QString s_logDirectory;
+};
+
+#endif // ASYNCLOGWRITER_H
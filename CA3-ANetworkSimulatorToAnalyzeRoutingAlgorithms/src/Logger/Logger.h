@@ -6,27 +6,52 @@
 enum LogLevel {
     ERROR_LEVEL,
     WARNING_LEVEL,
-    DEBUG_LEVEL
+    DEBUG_LEVEL,
+    TRACE_LEVEL     // Per packet and per tick
 };
 
-constexpr LogLevel CURRENT_LOG_LEVEL = WARNING_LEVEL;
+enum class LogCategory : unsigned {
+    General    = 1u << 0,
+    Forwarding = 1u << 1,   // Data packets through routers, PCs and ports
+    Rip        = 1u << 2,
+    Ospf       = 1u << 3,
+    Bgp        = 1u << 4,
+    Dhcp       = 1u << 5,
+    Topology   = 1u << 6,   // Ports and bindings
+    Events     = 1u << 7,   // Clock and traffic queue
+};
 
-#if CURRENT_LOG_LEVEL >= DEBUG_LEVEL
-    #define LOG_DEBUG() qDebug()
+// Both are fixed at compile time, e.g. DEFINES += LOG_LEVEL=3 LOG_CATEGORIES=0x12. Release builds
+// keep warnings and errors only.
+#ifndef LOG_LEVEL
+#ifdef QT_NO_DEBUG
+#define LOG_LEVEL 1
 #else
-    #define LOG_DEBUG() QNoDebug()
+#define LOG_LEVEL 3
 #endif
-
-#if CURRENT_LOG_LEVEL >= WARNING_LEVEL
-    #define LOG_WARNING() qWarning()
-#else
-    #define LOG_WARNING() QNoDebug()
 #endif
 
-#if CURRENT_LOG_LEVEL >= ERROR_LEVEL
-    #define LOG_ERROR() qCritical()
-#else
-    #define LOG_ERROR() QNoDebug()
+#ifndef LOG_CATEGORIES
+#define LOG_CATEGORIES 0xFFFFFFFFu
 #endif
 
+constexpr LogLevel CURRENT_LOG_LEVEL = static_cast<LogLevel>(LOG_LEVEL);
+
+constexpr bool logEnabled(LogLevel level, LogCategory category)
+{
+    return level <= CURRENT_LOG_LEVEL &&
+           (level == ERROR_LEVEL || (static_cast<unsigned>(category) & (LOG_CATEGORIES)) != 0);
+}
+
+// A disabled statement is discarded by if constexpr, so its stream arguments are never evaluated:
+//     LOG_TRACE(Forwarding) << "Router" << id << "forwarding" << packet->getPayload();
+// Errors cannot be filtered by category.
+#define LOG_AT(level, category, stream) \
+    if constexpr (!logEnabled(level, LogCategory::category)) {} else stream()
+
+#define LOG_ERROR()             LOG_AT(ERROR_LEVEL, General, qCritical)
+#define LOG_WARNING(category)   LOG_AT(WARNING_LEVEL, category, qWarning)
+#define LOG_DEBUG(category)     LOG_AT(DEBUG_LEVEL, category, qDebug)
+#define LOG_TRACE(category)     LOG_AT(TRACE_LEVEL, category, qDebug)
+
 #endif // LOGGER_H
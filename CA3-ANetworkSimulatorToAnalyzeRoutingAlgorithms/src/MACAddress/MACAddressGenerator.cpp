@@ -0,0 +1,50 @@
+#include "MACAddressGenerator.h"
+#include <QMutexLocker>
+
+MACAddressGenerator::MACAddressGenerator(quint64 seed) : m_seed(seed) {}
+
+void MACAddressGenerator::setSeed(quint64 seed) {
+    QMutexLocker locker(&m_mutex);
+    m_seed = seed;
+}
+
+MACAddress MACAddressGenerator::generate() {
+    RandomStream stream;
+    {
+        QMutexLocker locker(&m_mutex);
+        stream = RandomStream::forComponent(m_seed, "mac-anonymous", m_anonymousCount++);
+    }
+    return generateFrom(stream);
+}
+
+MACAddress MACAddressGenerator::generate(quint64 nodeKey) {
+    RandomStream stream;
+    {
+        QMutexLocker locker(&m_mutex);
+        stream = RandomStream::forComponent(m_seed, "mac", nodeKey);
+    }
+    return generateFrom(stream);
+}
+
+MACAddress MACAddressGenerator::generateFrom(RandomStream &stream) {
+    QMutexLocker locker(&m_mutex);
+
+    QString newAddress;
+    do {
+        newAddress = generateRandomAddress(stream);
+    } while (m_usedAddresses.contains(newAddress));
+
+    m_usedAddresses.insert(newAddress);
+    return MACAddress(newAddress);
+}
+
+QString MACAddressGenerator::generateRandomAddress(RandomStream &stream) {
+    quint64 bits = stream();
+    QString address;
+    for (int i = 0; i < 6; ++i) {
+        int byte = static_cast<int>((bits >> (8 * i)) & 0xFF);
+        address += QString::asprintf("%02X", byte);
+        if (i < 5) address += ":";
+    }
+    return address;
+}
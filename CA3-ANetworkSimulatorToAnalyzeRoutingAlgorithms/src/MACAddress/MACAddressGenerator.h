@@ -0,0 +1,31 @@
+#ifndef MACADDRESSGENERATOR_H
+#define MACADDRESSGENERATOR_H
+
+#include "MACAddress.h"
+#include <QSet>
+#include <QMutex>
+#include <QString>
+
+#include "../Globals/RandomStream.h"
+
+// Hands out addresses unique within one generator; each simulation owns one.
+class MACAddressGenerator {
+public:
+    explicit MACAddressGenerator(quint64 seed = RandomStream::globalSeed());
+
+    void setSeed(quint64 seed);
+
+    MACAddress generate();
+    // Same node key and seed always give the same address, regardless of creation order.
+    MACAddress generate(quint64 nodeKey);
+
+private:
+    QSet<QString> m_usedAddresses;
+    QMutex m_mutex;
+    quint64 m_seed;
+    quint64 m_anonymousCount = 0;
+    MACAddress generateFrom(RandomStream &stream);
+    static QString generateRandomAddress(RandomStream &stream);
+};
+
+#endif // MACADDRESSGENERATOR_H
@@ -1,3 +1,5 @@
+#include <cmath>
+#include <algorithm>
 #include <QDebug>
 #include "MetricsCollector.h"
 
@@ -27,6 +29,7 @@ void MetricsCollector::recordPacketReceived(const QVector<QString> &path) {
 }
 
 void MetricsCollector::recordWaitCycle(int waitCycle) {
+    QMutexLocker locker(&m_mutex);
     m_waitCyclesBuffer.append(waitCycle);
 }
 
@@ -37,6 +40,11 @@ void MetricsCollector::recordPacketDropped() {
     m_droppedPackets++;
 }
 
+int MetricsCollector::packetsInFlight() const {
+    QMutexLocker locker(&m_mutex);
+    return m_sentPackets - m_receivedPackets - m_droppedPackets;
+}
+
 void MetricsCollector::recordRouterUsage(const QString &routerIP) {
     QMutexLocker locker(&m_mutex);
     if (routerIP.startsWith("192.168.")) {
@@ -49,6 +57,32 @@ void MetricsCollector::recordHopCount(int hopCount) {
     m_totalHops += hopCount;
 }
 
+QJsonObject MetricsCollector::summary() const {
+    QMutexLocker locker(&m_mutex);
+
+    QVector<int> waitCycles = m_waitCyclesBuffer;
+    std::sort(waitCycles.begin(), waitCycles.end());
+    // Nearest rank
+    auto percentile = [&waitCycles](double p) {
+        if (waitCycles.isEmpty()) return 0;
+        int rank = static_cast<int>(std::ceil(p / 100.0 * waitCycles.size()));
+        return waitCycles[qBound(0, rank - 1, static_cast<int>(waitCycles.size()) - 1)];
+    };
+
+    QJsonObject summary;
+    summary["sent"] = m_sentPackets;
+    summary["received"] = m_receivedPackets;
+    summary["dropped"] = m_droppedPackets;
+    summary["loss_rate"] = m_sentPackets > 0 ? 1.0 - static_cast<double>(m_receivedPackets) / m_sentPackets : 0.0;
+    summary["average_hops"] = m_receivedPackets > 0 ? static_cast<double>(m_totalHops) / m_receivedPackets : 0.0;
+    summary["packets_processed"] = static_cast<double>(m_processedPackets.load());
+    summary["wait_cycles_p50"] = percentile(50);
+    summary["wait_cycles_p90"] = percentile(90);
+    summary["wait_cycles_p99"] = percentile(99);
+    summary["wait_cycles_max"] = waitCycles.isEmpty() ? 0 : waitCycles.last();
+    return summary;
+}
+
 void MetricsCollector::printStatistics() const {
     QMutexLocker locker(&m_mutex);
 
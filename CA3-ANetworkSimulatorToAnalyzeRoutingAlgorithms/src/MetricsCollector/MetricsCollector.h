@@ -1,10 +1,12 @@
 #ifndef METRICSCOLLECTOR_H
 #define METRICSCOLLECTOR_H
 
+#include <atomic>
 #include <QMap>
 #include <QMutex>
 #include <QString>
 #include <QObject>
+#include <QJsonObject>
 
 class MetricsCollector : public QObject
 {
@@ -17,12 +19,18 @@ public:
     void recordPacketSent();
     void recordPacketReceived(const QVector<QString> &path);
     void recordPacketDropped();
+    // Sent packets that have been neither delivered nor dropped yet.
+    int packetsInFlight() const;
 
     void recordRouterUsage(const QString &routerIP);
     void recordHopCount(int hopCount);
     void recordWaitCycle(int waitCycle);
+    // Every packet a router handles, data or control; lock-free for the forwarding path.
+    void recordPacketProcessed() { m_processedPackets.fetch_add(1, std::memory_order_relaxed); }
 
     void printStatistics() const;
+    // Totals, loss rate and wait-cycle percentiles, for machine-readable run reports.
+    QJsonObject summary() const;
     void increamentHops();
 
 private:
@@ -34,6 +42,7 @@ private:
     int m_totalHops;
     QVector<int> m_waitCyclesBuffer;
     QMap<QString, int> m_routerUsage;
+    std::atomic<qint64> m_processedPackets {0};
 };
 
 #endif // METRICSCOLLECTOR_H
@@ -6,7 +6,8 @@
 #include "../Topology/TopologyBuilder.h"
 #include "../Topology/TopologyController.h"
 
-AutonomousSystem::AutonomousSystem(const QJsonObject &config, const IdAssignment &idAssignment, const bool torus, QObject *parent)
+AutonomousSystem::AutonomousSystem(const QJsonObject &config, const IdAssignment &idAssignment, const bool torus,
+                                   SimulationContext *context, QObject *parent)
     : QObject(parent), m_config(config)
 {
     if (!config.contains("id") || !config.contains("topology_type"))
@@ -24,7 +25,7 @@ AutonomousSystem::AutonomousSystem(const QJsonObject &config, const IdAssignment
         return;
     }
 
-    m_topologyBuilder = QSharedPointer<TopologyBuilder>::create(m_config, idAssignment, this);
+    m_topologyBuilder = QSharedPointer<TopologyBuilder>::create(m_config, idAssignment, context, this);
     m_topologyBuilder->buildTopology(torus);
 
     m_topologyController = QSharedPointer<TopologyController>::create(m_topologyBuilder, this);
@@ -38,6 +39,13 @@ AutonomousSystem::~AutonomousSystem()
     m_topologyBuilder.reset();
 }
 
+void AutonomousSystem::shutdown()
+{
+    if (m_topologyBuilder) {
+        m_topologyBuilder->stopThreads();
+    }
+}
+
 int AutonomousSystem::getId() const
 {
     return m_id;
@@ -12,13 +12,15 @@ class Router;
 class PC;
 class TopologyBuilder;
 class TopologyController;
+class SimulationContext;
 
 class AutonomousSystem : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit AutonomousSystem(const QJsonObject &config, const IdAssignment &idAssignment, const bool torus, QObject *parent = nullptr);
+    explicit AutonomousSystem(const QJsonObject &config, const IdAssignment &idAssignment, const bool torus,
+                              SimulationContext *context, QObject *parent = nullptr);
     ~AutonomousSystem() override;
 
     int getId() const;
@@ -26,6 +28,7 @@ public:
     const std::vector<QSharedPointer<PC>> &getPCs() const;
     void connectToOtherAS(const std::vector<QSharedPointer<AutonomousSystem>> &allAS);
     QSharedPointer<TopologyController> getTopologyController() const;
+    void shutdown();
 
 private:
     int m_id;
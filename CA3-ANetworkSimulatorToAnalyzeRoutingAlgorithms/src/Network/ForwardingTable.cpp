@@ -0,0 +1,41 @@
+#include "ForwardingTable.h"
+
+qint32 ForwardingTable::adjacencyFor(const PortPtr_t &port, const QString &nextHop)
+{
+    if (!port) return FibEntry::NO_ADJACENCY;
+
+    auto key = qMakePair(port.data(), nextHop);
+    auto it = m_adjacencyIds.constFind(key);
+    if (it != m_adjacencyIds.constEnd()) {
+        return it.value();
+    }
+
+    qint32 id = m_adjacencies.size();
+    m_adjacencies.append(Adjacency {port, port->getPortNumber(), nextHop});
+    m_adjacencyIds.insert(key, id);
+    return id;
+}
+
+void ForwardingTable::insert(const QString &destination, qint32 adjacency, int metric, quint8 protocol, bool local)
+{
+    FibEntry entry;
+    entry.adjacency = adjacency;
+    entry.metric = static_cast<qint16>(metric);
+    entry.protocol = protocol;
+    entry.flags = FibEntry::VALID | (local ? FibEntry::LOCAL : 0);
+    m_entries.insert(destination, entry);
+}
+
+void ForwardingTable::clear()
+{
+    m_entries.clear();
+    m_adjacencies.clear();
+    m_adjacencyIds.clear();
+}
+
+const FibEntry &ForwardingTable::lookup(const QString &destination) const
+{
+    static const FibEntry miss;
+    auto it = m_entries.constFind(destination);
+    return it != m_entries.constEnd() ? it.value() : miss;
+}
@@ -0,0 +1,67 @@
+#ifndef FORWARDINGTABLE_H
+#define FORWARDINGTABLE_H
+
+#include <type_traits>
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <QString>
+
+#include "../Port/Port.h"
+
+// One neighbour as seen by forwarding: the port to send on and the next hop address recorded in
+// the packet's path. Routes that share a next hop share one adjacency.
+struct Adjacency
+{
+    PortPtr_t port;
+    uint8_t portNumber = 0;
+    QString nextHop;
+};
+
+struct FibEntry
+{
+    static constexpr qint32 NO_ADJACENCY = -1;
+    static constexpr quint8 LOCAL = 0x1;    // Destination is a host attached to this router
+    static constexpr quint8 VALID = 0x2;
+
+    qint32 adjacency = NO_ADJACENCY;
+    qint16 metric = 0;
+    quint8 protocol = 0;
+    quint8 flags = 0;
+
+    bool isValid() const { return flags & VALID; }
+    bool isLocal() const { return flags & LOCAL; }
+};
+
+static_assert(sizeof(FibEntry) == 8 && std::is_trivially_copyable_v<FibEntry>, "FIB entries must stay 8-byte PODs");
+
+// Forwarding view of a router's routing table: destination -> FibEntry, with the per-neighbour
+// details kept once in the adjacency table. Lookups hand out references; nothing is copied.
+class ForwardingTable
+{
+public:
+    // Returns the id of the adjacency for (port, nextHop), adding it if needed.
+    qint32 adjacencyFor(const PortPtr_t &port, const QString &nextHop);
+    void insert(const QString &destination, qint32 adjacency, int metric, quint8 protocol, bool local);
+    void clear();
+
+    // A shared invalid entry when there is no route. References stay valid until the table changes.
+    const FibEntry &lookup(const QString &destination) const;
+    const Adjacency &adjacency(qint32 id) const { return m_adjacencies[id]; }
+
+    int size() const { return m_entries.size(); }
+    const QHash<QString, FibEntry> &entries() const { return m_entries; }
+    int adjacencyCount() const { return m_adjacencies.size(); }
+
+    // RIB version the table was built from.
+    quint64 version() const { return m_version; }
+    void setVersion(quint64 version) { m_version = version; }
+
+private:
+    QHash<QString, FibEntry> m_entries;
+    QVector<Adjacency> m_adjacencies;
+    QHash<QPair<Port *, QString>, qint32> m_adjacencyIds;
+    quint64 m_version = 0;
+};
+
+#endif // FORWARDINGTABLE_H
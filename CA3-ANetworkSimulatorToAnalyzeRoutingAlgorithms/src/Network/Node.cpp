@@ -1,10 +1,12 @@
 #include "Node.h"
 #include "../IP/IP.h"
+#include "../Globals/SimulationContext.h"
 
 int Node::s_globalNodeId = 0;
 
-Node::Node(int id, const QString &ipAddress, NodeType type, QObject *parent)
-    : QObject(parent), m_id(id), m_ipAddress(QSharedPointer<IP>::create(ipAddress)), m_type(type)
+Node::Node(int id, const QString &ipAddress, NodeType type, SimulationContext *context, QObject *parent)
+    : QObject(parent), m_id(id), m_context(context),
+    m_ipAddress(QSharedPointer<IP>::create(ipAddress)), m_type(type)
 {
 }
 
@@ -15,6 +17,15 @@ int Node::getNextGlobalId()
     return ++s_globalNodeId;
 }
 
+void Node::assignIP(const QString &ip)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_ipAddress->setIp(ip);
+    }
+    m_context->invalidateAddresses();
+}
+
 int Node::getId() const
 {
     QMutexLocker locker(&m_mutex);
@@ -8,6 +8,8 @@
 #include "../IP/IP.h"
 #include "../MACAddress/MACAddress.h"
 
+class SimulationContext;
+
 enum class NodeType
 {
     PC,
@@ -19,18 +21,26 @@ class Node : public QObject
     Q_OBJECT
 
 public:
-    explicit Node(int id, const QString &ipAddress, NodeType type, QObject *parent = nullptr);
+    // The node belongs to the simulation of context, which must outlive it.
+    explicit Node(int id, const QString &ipAddress, NodeType type, SimulationContext *context, QObject *parent = nullptr);
     virtual ~Node();
 
     int getId() const;
     QString getIPAddress() const;
     NodeType getNodeType() const;
     void setMacAddress(MACAddress macAddr) { m_macAddress = macAddr; }
+    SimulationContext *getContext() const { return m_context; }
 
     static int getNextGlobalId();
 
+signals:
+    void ipAssigned(int nodeId, const QString &ip);
+
 protected:
+    void assignIP(const QString &ip);
+
     int m_id;
+    SimulationContext *m_context;
     QSharedPointer<IP> m_ipAddress;
     NodeType m_type;
     MACAddress m_macAddress;
@@ -2,27 +2,30 @@
 #include <QThread>
 
 #include "PC.h"
+#include "../Logger/Logger.h"
 #include "../Packet/Packet.h"
-#include "../MACAddress/MACADdressGenerator.h"
+#include "../Globals/SimulationContext.h"
+#include "../DHCPServer/DHCPMessage.h"
+#include "../Globals/RandomStream.h"
 
-PC::PC(int id, const QString &ipAddress, QObject *parent)
-    : Node(id, ipAddress, NodeType::PC, parent)
+PC::PC(int id, const QString &ipAddress, SimulationContext *context, QObject *parent)
+    : Node(id, ipAddress, NodeType::PC, context, parent)
 {
-    m_port = PortPtr_t::create(this);
+    m_port = PortPtr_t::create(m_context, this);
     m_port->setPortNumber(1);
     m_port->setRouterIP(m_ipAddress->getIp());
 
     connect(m_port.data(), &Port::packetReceived, this, &PC::processPacket);
 
-    QSharedPointer<MACAddressGenerator> generator = QSharedPointer<MACAddressGenerator>::create();
-    m_macAddress = generator->generate();
+    m_macAddress = m_context->macAddresses().generate(m_id);
 
-    qDebug() << "PC initialized: ID =" << m_id << ", IP =" << m_ipAddress->getIp();
+    LOG_DEBUG(Forwarding) << "PC initialized: ID =" << m_id << ", IP =" << m_ipAddress->getIp();
 }
 
 PC::~PC()
 {
-    qDebug() << "PC destroyed: ID =" << m_id;
+    m_port->setParent(nullptr);
+    LOG_DEBUG(Forwarding) << "PC destroyed: ID =" << m_id;
 }
 
 PortPtr_t PC::getPort()
@@ -32,13 +35,13 @@ PortPtr_t PC::getPort()
 
 void PC::initialize()
 {
-    qDebug() << "PC initialized: ID =" << m_id << ", IP =" << m_ipAddress->getIp()
-             << ", running in thread" << (quintptr)QThread::currentThreadId();
+    LOG_DEBUG(Forwarding) << "PC initialized: ID =" << m_id << ", IP =" << m_ipAddress->getIp()
+                          << ", running in thread" << (quintptr)QThread::currentThreadId();
 }
 
 void PC::generatePacket()
 {
-    qDebug() << "PC" << m_id << "is generating a packet.";
+    LOG_TRACE(Forwarding) << "PC" << m_id << "is generating a packet.";
     auto packet = QSharedPointer<Packet>::create(PacketType::Data, "Payload");
     m_port->sendPacket(packet);
 
@@ -47,8 +50,12 @@ void PC::generatePacket()
 
 void PC::requestIPFromDHCP()
 {
-    qDebug() << "PC" << m_id << "requesting IP via DHCP.";
-    auto packet = QSharedPointer<Packet>::create(PacketType::Control, QString("DHCP_REQUEST:%1").arg(m_id));
+    LOG_DEBUG(Dhcp) << "PC" << m_id << "requesting IP via DHCP.";
+    DHCPMessage request;
+    request.clientId = m_id;
+    request.xid = static_cast<quint32>(m_context->randomStream("dhcp-xid", m_id).at(m_dhcpAttempts++));
+
+    auto packet = QSharedPointer<Packet>::create(PacketType::Control, request.toPayload());
     m_port->sendPacket(packet);
 
     emit packetSent(packet);
@@ -59,7 +66,7 @@ void PC::processPacket(const PacketPtr_t &packet)
     if (!packet) return;
 
     QString payload = packet->getPayload();
-    qDebug() << "PC" << m_id << "received packet with payload:" << payload;
+    LOG_TRACE(Forwarding) << "PC" << m_id << "received packet with payload:" << payload;
 
     if (packet->getType() == PacketType::Data) {
         QStringList parts = payload.split(":");
@@ -68,17 +75,17 @@ void PC::processPacket(const PacketPtr_t &packet)
             QString actualPayload = parts.at(2);
 
             if (destinationIP == m_ipAddress->getIp()) {
-                qDebug() << "PC" << m_id << "received data packet intended for itself.";
+                LOG_TRACE(Forwarding) << "PC" << m_id << "received data packet intended for itself.";
 
                 // Record packet reception metrics
                 if (m_metricsCollector) {
                     m_metricsCollector->recordPacketReceived(packet->getPath());
                 }
 
-                qDebug() << "PC" << m_id << "processing payload:" << actualPayload;
+                LOG_TRACE(Forwarding) << "PC" << m_id << "processing payload:" << actualPayload;
             }
             else {
-                qDebug() << "PC" << m_id << "received data packet not intended for it. Dropping.";
+                LOG_TRACE(Forwarding) << "PC" << m_id << "received data packet not intended for it. Dropping.";
 
                 // Record packet drop
                 if (m_metricsCollector) {
@@ -87,28 +94,26 @@ void PC::processPacket(const PacketPtr_t &packet)
             }
         }
         else {
-            qWarning() << "Malformed Data packet on PC" << m_id << "payload:" << payload;
+            LOG_WARNING(Forwarding) << "Malformed Data packet on PC" << m_id << "payload:" << payload;
             if (m_metricsCollector) {
                 m_metricsCollector->recordPacketDropped();
             }
         }
     }
-    else if (payload.contains("DHCP_OFFER")) {
-        QStringList parts = payload.split(":");
-        if (parts.size() == 3) {
-            QString offeredIP = parts.at(1);
-            int clientId = parts.at(2).toInt();
-
-            if (clientId == m_id) {
-                qDebug() << "PC" << m_id << "received DHCP offer:" << offeredIP << "Assigning IP.";
-                m_ipAddress->setIp(offeredIP);
-                qDebug() << "PC" << m_id << "assigned IP:" << m_ipAddress;
+    else if (payload.startsWith("DHCP_OFFER")) {
+        DHCPMessage offer;
+        if (DHCPMessage::parse(payload, offer)) {
+            if (offer.clientId == m_id) {
+                LOG_DEBUG(Dhcp) << "PC" << m_id << "received DHCP offer:" << offer.offeredIP << "Assigning IP.";
+                assignIP(offer.offeredIP);
+                LOG_DEBUG(Dhcp) << "PC" << m_id << "assigned IP:" << m_ipAddress;
+                emit ipAssigned(m_id, offer.offeredIP);
             }
         } else {
-            qWarning() << "Malformed DHCP_OFFER packet on PC" << m_id << "payload:" << payload;
+            LOG_WARNING(Dhcp) << "Malformed DHCP_OFFER packet on PC" << m_id << "payload:" << payload;
         }
     } else {
-        qDebug() << "PC" << m_id << "received unknown/unsupported packet, dropping it.";
+        LOG_TRACE(Forwarding) << "PC" << m_id << "received unknown/unsupported packet, dropping it.";
     }
 }
 
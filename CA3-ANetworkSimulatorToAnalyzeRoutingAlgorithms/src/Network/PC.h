@@ -12,12 +12,13 @@ class PC : public Node
     Q_OBJECT
 
 public:
-    explicit PC(int id, const QString &ipAddress, QObject *parent = nullptr);
+    explicit PC(int id, const QString &ipAddress, SimulationContext *context, QObject *parent = nullptr);
     ~PC() override;
 
     PortPtr_t getPort();
 
     QString getIpAddress() const;
+    void setIP(const QString &ip) { assignIP(ip); }
 
     void setMetricsCollector(QSharedPointer<MetricsCollector> collector);
 
@@ -33,6 +34,7 @@ public Q_SLOTS:
 private:
     PortPtr_t m_port;
     QSharedPointer<MetricsCollector> m_metricsCollector;
+    int m_dhcpAttempts = 0;
 };
 
 #endif // PC_H
@@ -2,19 +2,24 @@
 #include "EventsCoordinator/EventsCoordinator.h"
 #include "../Topology/TopologyBuilder.h"
 #include "../MetricsCollector/MetricsCollector.h"
-#include "../Globals/RouterRegistry.h"
+#include "../Globals/SimulationContext.h"
 #include "../Network/PC.h"
-#include "../MACAddress/MACADdressGenerator.h"
+#include "../Logger/Logger.h"
+#include "../Trace/EventTrace.h"
+#include "../Trace/TimelineTrace.h"
+#include "../Globals/RandomStream.h"
 #include <QDebug>
+#include <algorithm>
 #include <QThread>
 #include <QFile>
 #include <QFileInfo>
+#include <QDataStream>
 #include <QDir>
 #include <QTextStream>
 #include <QDateTime>
 
-Router::Router(int id, const QString &ipAddress, int portCount, QObject *parent, bool isBroken)
-    : Node(id, ipAddress, NodeType::Router, parent),
+Router::Router(int id, const QString &ipAddress, SimulationContext *context, int portCount, QObject *parent, bool isBroken)
+    : Node(id, ipAddress, NodeType::Router, context, parent),
     m_portCount(portCount),
     m_hasValidIP(false),
     m_lsdb(),
@@ -50,22 +55,25 @@ Router::Router(int id, const QString &ipAddress, int portCount, QObject *parent,
     connect(m_bufferTimer, &QTimer::timeout, this, &Router::processBuffer);
     m_bufferTimer->start(1000);
 
-    QSharedPointer<MACAddressGenerator> generator = QSharedPointer<MACAddressGenerator>::create();
-    m_macAddress = generator->generate();
+    m_macAddress = m_context->macAddresses().generate(m_id);
 
-    qDebug() << "Router initialized: ID =" << m_id << ", IP =" << m_ipAddress->getIp() << ", Ports =" << m_portCount;
+    LOG_DEBUG(Topology) << "Router initialized: ID =" << m_id << ", IP =" << m_ipAddress->getIp() << ", Ports =" << m_portCount;
 }
 
 Router::~Router()
 {
-    qDebug() << "Router destroyed: ID =" << m_id;
+    // Ports are parented only to follow the router between threads; the shared pointers own them.
+    for (const auto &port : m_ports) {
+        port->setParent(nullptr);
+    }
+    LOG_DEBUG(Topology) << "Router destroyed: ID =" << m_id;
 }
 
 void Router::initializePorts()
 {
     for (int i = 0; i < m_portCount; ++i)
     {
-        auto port = PortPtr_t::create(this);
+        auto port = PortPtr_t::create(m_context, this);
         port->setPortNumber(static_cast<uint8_t>(i + 1));
         port->setRouterIP(m_ipAddress->getIp());
         m_ports.push_back(port);
@@ -80,11 +88,9 @@ void Router::initializePorts()
 }
 
 void Router::setTopologyBuilder(TopologyBuilder *builder) {
-    s_topologyBuilder = builder;
+    m_topologyBuilder = builder;
 }
 
-TopologyBuilder* Router::s_topologyBuilder = nullptr;
-
 PortPtr_t Router::getAvailablePort()
 {
     for (const auto &port : m_ports)
@@ -114,8 +120,6 @@ void Router::initialize()
     startTimers();
 }
 
-int Router::IBGPCounter = 0;
-
 void Router::sendHelloPackets()
 {
     // qDebug() << "Router" << m_id << "sending OSPF Hello packets.";
@@ -137,26 +141,33 @@ void Router::startTimers()
 bool Router::enqueuePacketToBuffer(const PacketPtr_t &packet) {
     QMutexLocker locker(&m_bufferMutex);
     if (m_buffer.size() >= m_bufferSize) {
-        qWarning() << "Router" << m_id << ": Buffer full. Dropping packet with payload:" << packet->getPayload();
-        if (m_metricsCollector) {
-            m_metricsCollector->recordPacketDropped();
-        }
+        LOG_WARNING(Forwarding) << "Router" << m_id << ": Buffer full. Dropping packet with payload:" << packet->getPayload();
+        dropPacket(packet, TraceDrop::BufferFull);
         return false;
     }
     BufferedPacket bp;
     bp.packet = packet;
     bp.enqueueTime = QDateTime::currentMSecsSinceEpoch();
     m_buffer.enqueue(bp);
+    EventTrace::record(TraceEvent::PacketEnqueue, m_id, packet->getId(), m_buffer.size());
+    TimelineTrace::counter("queue", m_id, m_buffer.size());
     // qDebug() << "Router" << m_id << ": Packet enqueued. Current buffer size:" << m_buffer.size();
     return true;
 }
 
+void Router::setBufferSize(int size) {
+    QMutexLocker locker(&m_bufferMutex);
+    m_bufferSize = size > 0 ? size : 1;
+}
+
 PacketPtr_t Router::dequeuePacketFromBuffer() {
     QMutexLocker locker(&m_bufferMutex);
     if (m_buffer.isEmpty()) {
         return nullptr;
     }
     BufferedPacket bp = m_buffer.dequeue();
+    EventTrace::record(TraceEvent::PacketDequeue, m_id, bp.packet->getId(), m_buffer.size());
+    TimelineTrace::counter("queue", m_id, m_buffer.size());
     // qDebug() << "Router" << m_id << ": Packet dequeued. Current buffer size:" << m_buffer.size();
     return bp.packet;
 }
@@ -168,20 +179,25 @@ void Router::processBuffer() {
         BufferedPacket bp = m_buffer.head();
         if ((currentTime - bp.enqueueTime) > m_bufferRetentionTime) {
             m_buffer.dequeue();
+            dropPacket(bp.packet, TraceDrop::BufferExpired);
             // qWarning() << "Router" << m_id << ": Packet expired and removed from buffer with payload:" << bp.packet->getPayload();
-            if (m_metricsCollector) {
-                m_metricsCollector->recordPacketDropped();
-            }
         } else {
             break;
         }
     }
 }
 
+void Router::dropPacket(const PacketPtr_t &packet, TraceDrop reason) {
+    EventTrace::drop(m_id, packet->getId(), reason);
+    if (m_metricsCollector && packet->getType() == PacketType::Data) {
+        m_metricsCollector->recordPacketDropped();
+    }
+}
+
 void Router::forwardPacket(const PacketPtr_t &packet) {
     if (!packet) return;
     if (packet->getTTL() <= 0) {
-        qDebug() << "Router" << m_id << "dropping packet due to TTL expiration.";
+        LOG_TRACE(Forwarding) << "Router" << m_id << "dropping packet due to TTL expiration.";
         return;
     }
 
@@ -190,7 +206,7 @@ void Router::forwardPacket(const PacketPtr_t &packet) {
     for (auto &port : m_ports) {
         if (port->isConnected()) {
             port->sendPacket(fwdPacket);
-            qDebug() << "Router" << m_id << "forwarded packet via Port" << port->getPortNumber();
+            LOG_TRACE(Forwarding) << "Router" << m_id << "forwarded packet via Port" << port->getPortNumber();
         }
     }
 }
@@ -199,7 +215,7 @@ void Router::addConnectedPC(QSharedPointer<PC> pc, PortPtr_t port)
 {
     m_connectedPCs.push_back(pc);
     QString pcIP = pc->getIpAddress();
-    qDebug() << "Router" << m_id << "adding route for connected PC:" << pcIP;
+    LOG_DEBUG(Topology) << "Router" << m_id << "adding route for connected PC:" << pcIP;
 
     addRoute(pcIP, "255.255.255.255", m_ipAddress->getIp(), 1, RoutingProtocol::RIP, port);
 }
@@ -208,57 +224,148 @@ void Router::logPortStatuses() const
 {
     for (const auto &port : m_ports)
     {
-        qDebug() << "Port" << port->getPortNumber() << (port->isConnected() ? "Connected" : "Available");
+        LOG_DEBUG(Topology) << "Port" << port->getPortNumber() << (port->isConnected() ? "Connected" : "Available");
     }
 }
 
 void Router::requestIPFromDHCP() {
     if (m_hasValidIP) {
-        qDebug() << "Router" << m_id << "already has a valid IP:" << m_assignedIP;
+        LOG_DEBUG(Dhcp) << "Router" << m_id << "already has a valid IP:" << m_assignedIP;
+        return;
+    }
+
+    DHCPMessage request;
+    request.clientId = m_id;
+    request.xid = static_cast<quint32>(m_context->randomStream("dhcp-xid", m_id).at(m_dhcpAttempts++));
+
+    auto packet = QSharedPointer<Packet>::create(PacketType::Control, request.toPayload());
+    LOG_DEBUG(Dhcp) << "Router" << m_id << "created DHCP request with payload:" << packet->getPayload();
+
+    // Handled on the router's own thread, which also owns the DHCP transaction state.
+    QMetaObject::invokeMethod(this, [this, packet]() { processPacket(packet, nullptr); }, Qt::QueuedConnection);
+}
+
+bool Router::sendDHCPToward(int nodeId, const DHCPMessage &message, int ttl)
+{
+    for (auto &port : m_ports) {
+        if (port->isConnected() && port->getConnectedRouterId() == nodeId) {
+            port->sendPacket(PacketPtr_t(new Packet(PacketType::Control, message.toPayload(), ttl)));
+            return true;
+        }
+    }
+    return false;
+}
+
+void Router::floodDHCP(const DHCPMessage &message, int ttl, const PortPtr_t &incomingPort)
+{
+    PacketPtr_t fwdPacket(new Packet(PacketType::Control, message.toPayload(), ttl));
+    for (auto &port : m_ports) {
+        if (port->isConnected() && port != incomingPort && port->getConnectedPC().isNull()) {
+            port->sendPacket(fwdPacket);
+        }
+    }
+}
+
+void Router::processDHCPRequest(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
+{
+    DHCPMessage request;
+    if (!DHCPMessage::parse(packet->getPayload(), request)) {
+        LOG_WARNING(Dhcp) << "Malformed DHCP_REQUEST packet on Router" << m_id << "payload:" << packet->getPayload();
+        return;
+    }
+
+    if (!m_dhcpTransactions.insert(request.transactionKey(), QDateTime::currentMSecsSinceEpoch())) {
+        LOG_DEBUG(Dhcp) << "Router" << m_id << "already seen DHCP transaction" << request.xid << "of client"
+                        << request.clientId << ", dropping.";
         return;
     }
 
-    auto packet = QSharedPointer<Packet>::create(PacketType::Control, QString("DHCP_REQUEST:%1").arg(m_id));
-    qDebug() << "Router" << m_id << "created DHCP request with payload:" << packet->getPayload();
+    if (!request.unicast && request.route.isEmpty() && m_isDHCPRelay && !m_dhcpServerPath.isEmpty()) {
+        // Relay agent: a client's broadcast becomes a unicast along the learned path to the server.
+        request.unicast = true;
+        request.route = m_dhcpServerPath;
+    } else if (!request.unicast) {
+        request.route.append(m_id);
+    }
+
+    if (isDHCPServer()) {
+        packet->setPayload(request.toPayload());
+        m_dhcpServer->receivePacket(packet);
+        return;
+    }
+
+    if (!request.unicast) {
+        floodDHCP(request, packet->getTTL() - 1, incomingPort);
+        return;
+    }
 
-    processPacket(packet, nullptr);
+    int nextHop = request.nextHop(m_id);
+    if (nextHop < 0 || !sendDHCPToward(nextHop, request, packet->getTTL() - 1)) {
+        LOG_WARNING(Dhcp) << "Router" << m_id << "cannot relay DHCP request of client" << request.clientId
+                          << "to next hop" << nextHop;
+    }
 }
 
-void Router::processDHCPResponse(const PacketPtr_t &packet)
+void Router::processDHCPResponse(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
 {
     if (!packet || packet->getPayload().isEmpty()) return;
 
-    if (packet->getPayload().contains("DHCP_OFFER")) {
-        QStringList parts = packet->getPayload().split(":");
-        if (parts.size() == 3) {
-            QString offeredIP = parts[1];
-            int clientId = parts[2].toInt();
+    DHCPMessage offer;
+    if (!DHCPMessage::parse(packet->getPayload(), offer) || offer.kind != DHCPMessage::Offer) {
+        LOG_WARNING(Dhcp) << "Malformed DHCP_OFFER packet on Router" << m_id << "payload:" << packet->getPayload();
+        return;
+    }
 
-            if (clientId == m_id) {
-                if (m_hasValidIP) {
-                    qDebug() << "Router" << m_id << "already has a valid IP:" << m_assignedIP;
-                    return;
-                }
-                qDebug() << "Router" << m_id << "received DHCP offer:" << offeredIP << "for itself. Assigning IP.";
-                m_assignedIP = offeredIP;
-                m_ipAddress->setIp(m_assignedIP);
-                m_hasValidIP = true;
-                qDebug() << "Router" << m_id << "received and assigned IP:" << m_assignedIP;
-
-                addDirectRoute(m_assignedIP, "255.255.255.255");
-                qDebug() << "Router" << m_id << "added direct route for its own IP.";
-            } else {
-                if (!hasSeenPacket(packet)) {
-                    markPacketAsSeen(packet);
-                    forwardPacket(packet);
-                } else {
-                    qDebug() << "Router" << m_id << "already seen this DHCP offer, dropping to prevent loops.";
-                }
-            }
-        } else {
-            qWarning() << "Malformed DHCP_OFFER packet on Router" << m_id << "payload:" << packet->getPayload();
+    int position = static_cast<int>(offer.route.indexOf(m_id));
+    if (!offer.route.isEmpty() && position < 0) {
+        LOG_DEBUG(Dhcp) << "Router" << m_id << "is not on the route of DHCP offer for client" << offer.clientId << ", dropping.";
+        return;
+    }
+
+    if (position > 0) {
+        m_dhcpServerPath = offer.route.mid(0, position + 1);
+        std::reverse(m_dhcpServerPath.begin(), m_dhcpServerPath.end());
+    }
+
+    int nextHop = offer.nextHop(m_id);
+    if (nextHop >= 0) {
+        if (!sendDHCPToward(nextHop, offer, packet->getTTL() - 1)) {
+            LOG_WARNING(Dhcp) << "Router" << m_id << "has no link to" << nextHop << "for DHCP offer to client" << offer.clientId;
+        }
+        return;
+    }
+
+    if (offer.clientId == m_id) {
+        if (m_hasValidIP) {
+            LOG_DEBUG(Dhcp) << "Router" << m_id << "already has a valid IP:" << m_assignedIP;
+            return;
+        }
+        LOG_DEBUG(Dhcp) << "Router" << m_id << "received DHCP offer:" << offer.offeredIP << "for itself. Assigning IP.";
+        m_assignedIP = offer.offeredIP;
+        assignIP(m_assignedIP);
+        m_hasValidIP = true;
+        LOG_DEBUG(Dhcp) << "Router" << m_id << "received and assigned IP:" << m_assignedIP;
+
+        addDirectRoute(m_assignedIP, "255.255.255.255");
+        LOG_DEBUG(Dhcp) << "Router" << m_id << "added direct route for its own IP.";
+        emit ipAssigned(m_id, m_assignedIP);
+        return;
+    }
+
+    // Last hop: hand the offer to the client PC behind this router.
+    for (auto &port : m_ports) {
+        auto pc = port->getConnectedPC();
+        if (pc && pc->getId() == offer.clientId) {
+            port->sendPacket(PacketPtr_t(new Packet(PacketType::Control, offer.toPayload(), packet->getTTL() - 1)));
+            return;
         }
     }
+
+    // Offers without a route come from old-style requests and are still flooded.
+    if (offer.route.isEmpty() &&
+        m_dhcpTransactions.insert(offer.transactionKey(), QDateTime::currentMSecsSinceEpoch())) {
+        forwardPacket(packet);
+    }
 }
 
 QString Router::getAssignedIP()
@@ -269,7 +376,7 @@ QString Router::getAssignedIP()
 void Router::setDHCPServer(QSharedPointer<DHCPServer> dhcpServer)
 {
     m_dhcpServer = dhcpServer;
-    qDebug() << "Router" << m_id << "configured as DHCP server.";
+    LOG_DEBUG(Dhcp) << "Router" << m_id << "configured as DHCP server.";
 }
 
 bool Router::isDHCPServer() const
@@ -282,43 +389,32 @@ QSharedPointer<DHCPServer> Router::getDHCPServer()
     return m_dhcpServer;
 }
 
-bool Router::hasSeenPacket(const PacketPtr_t &packet) {
-    return m_seenPackets.contains(packet->getPayload());
-}
-
-void Router::markPacketAsSeen(const PacketPtr_t &packet) {
-    m_seenPackets.insert(packet->getPayload());
-}
-
 void Router::processPacket(const PacketPtr_t &packet, const PortPtr_t &incomingPort) {
+    TraceSpan span("processPacket", m_id, m_context->tick());
+    if (!packet) return;
     if (m_isBroken) {
-        m_metricsCollector->recordPacketDropped();
+        dropPacket(packet, TraceDrop::RouterBroken);
         return;
     }
 
-    if (!packet) return;
     packet->increamentTotalCycle();
+    if (m_metricsCollector) {
+        m_metricsCollector->recordPacketProcessed();
+    }
 
-    bool enqueued = enqueuePacketToBuffer(packet);
-
-    // -----> Handle Congestion Using The Boolean Of Enqueue <-----
+    if (!enqueuePacketToBuffer(packet)) {
+        return;
+    }
 
     packet->increamentWaitCycle();
 
     QString payload = packet->getPayload();
-    qDebug() << "Router" << m_id << "processing packet with payload:" << payload;
+    LOG_TRACE(Forwarding) << "Router" << m_id << "processing packet with payload:" << payload;
 
     // Check and handle TTL
     if (packet->getTTL() <= 0) {
-        qDebug() << "Router" << m_id << "dropping packet due to TTL = 0.";
-        if (m_metricsCollector &&
-           !payload.contains("DHCP_REQUEST") &&
-           !payload.contains("DHCP_OFFER") &&
-           !payload.startsWith("RIP_UPDATE") &&
-           packet->getType() != PacketType::OSPFHello &&
-           packet->getType() != PacketType::OSPFLSA) {
-            m_metricsCollector->recordPacketDropped();
-        }
+        LOG_TRACE(Forwarding) << "Router" << m_id << "dropping packet due to TTL = 0.";
+        dropPacket(packet, TraceDrop::TtlExpired);
         dequeuePacketFromBuffer();
         if (m_metricsCollector)
             m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
@@ -326,67 +422,20 @@ void Router::processPacket(const PacketPtr_t &packet, const PortPtr_t &incomingP
     }
 
     // Handle DHCP Requests
-    if (payload.contains("DHCP_REQUEST")) {
-        if (isDHCPServer()) {
-            if (m_dhcpServer) {
-                m_dhcpServer->receivePacket(packet);
-            }
-        } else {
-            if (!hasSeenPacket(packet)) {
-                markPacketAsSeen(packet);
-                forwardPacket(packet);
-            } else {
-                qDebug() << "Router" << m_id << "already seen this DHCP request, dropping to prevent loops.";
-            }
-        }
+    if (payload.startsWith("DHCP_REQUEST")) {
+        processDHCPRequest(packet, incomingPort);
     }
     // Handle DHCP Offers
-    else if (payload.contains("DHCP_OFFER")) {
-        QStringList parts = payload.split(":");
-        if (parts.size() == 3) {
-            QString offeredIP = parts[1];
-            int clientId = parts[2].toInt();
-
-            if (clientId == m_id) {
-                if (m_hasValidIP) {
-                    qDebug() << "Router" << m_id << "already has a valid IP:" << m_assignedIP;
-                    dequeuePacketFromBuffer();
-                    if (m_metricsCollector)
-                        m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
-                    return;
-                }
-                qDebug() << "Router" << m_id << "received DHCP offer:" << offeredIP << "for itself. Assigning IP.";
-                m_assignedIP = offeredIP;
-                m_ipAddress->setIp(m_assignedIP);
-                m_hasValidIP = true;
-                qDebug() << "Router" << m_id << "received and assigned IP:" << m_assignedIP;
-
-                addDirectRoute(m_assignedIP, "255.255.255.255");
-                qDebug() << "Router" << m_id << "added direct route for its own IP.";
-
-            } else {
-                if (!hasSeenPacket(packet)) {
-                    markPacketAsSeen(packet);
-                    forwardPacket(packet);
-                } else {
-                    qDebug() << "Router" << m_id << "already seen this DHCP offer, dropping to prevent loops.";
-                }
-            }
-        } else {
-            qWarning() << "Malformed DHCP_OFFER packet on Router" << m_id << "payload:" << payload;
-        }
+    else if (payload.startsWith("DHCP_OFFER")) {
+        processDHCPResponse(packet, incomingPort);
     }
     // Handle RIP Updates
     else if (payload.startsWith("RIP_UPDATE")) {
         processRIPUpdate(packet);
     }
-    // Handle EBGP Updates
-    else if (payload.startsWith("EBGP_UPDATE")) {
-        processEBGPUpdate(packet);
-    }
-    // Handle IBGP Updates
-    else if (payload.startsWith("IBGP_UPDATE")) {
-        processIBGPUpdate(packet);
+    // Handle BGP Updates
+    else if (payload.startsWith("BGP_UPDATE") || payload.startsWith("BGP_SESSION")) {
+        processBGPUpdate(packet, incomingPort);
     }
     // Handle OSPF Updates
     else if (packet->getType() == PacketType::OSPFHello) {
@@ -404,29 +453,29 @@ void Router::processPacket(const PacketPtr_t &packet, const PortPtr_t &incomingP
             QString actualPayload = parts.at(2);
 
             if (destinationIP == m_ipAddress->getIp()) {
-                qDebug() << "Router" << m_id << "received packet intended for itself.";
+                LOG_TRACE(Forwarding) << "Router" << m_id << "received packet intended for itself.";
+                EventTrace::record(TraceEvent::PacketDeliver, m_id, packet->getId());
 
                 if (m_metricsCollector) {
                     m_metricsCollector->recordPacketReceived(packet->getPath());
                 }
 
-                qDebug() << "Router" << m_id << "processing payload:" << actualPayload;
+                LOG_TRACE(Forwarding) << "Router" << m_id << "processing payload:" << actualPayload;
             }
             else {
-                RouteEntry bestRoute = findBestRoutePath(destinationIP);
-                if (bestRoute.destination.isEmpty()) {
-                    qDebug() << "Router" << m_id << "has no route to destination IP:" << destinationIP << ". Dropping packet.";
-                    if (m_metricsCollector) {
-                        m_metricsCollector->recordPacketDropped();
-                    }
+                const FibEntry &bestRoute = forwardingEntry(destinationIP);
+                if (!bestRoute.isValid()) {
+                    LOG_TRACE(Forwarding) << "Router" << m_id << "has no route to destination IP:" << destinationIP << ". Dropping packet.";
+                    dropPacket(packet, TraceDrop::NoRoute);
                     dequeuePacketFromBuffer();
                     if (m_metricsCollector)
                         m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
                     return;
                 }
 
-                if (bestRoute.destination == bestRoute.nextHop) {
-                    qDebug() << "Router" << m_id << "received packet intended for its PC.";
+                if (bestRoute.isLocal()) {
+                    LOG_TRACE(Forwarding) << "Router" << m_id << "received packet intended for its PC.";
+                    EventTrace::record(TraceEvent::PacketDeliver, m_id, packet->getId());
 
                     if (m_metricsCollector) {
                         m_metricsCollector->increamentHops();
@@ -434,11 +483,11 @@ void Router::processPacket(const PacketPtr_t &packet, const PortPtr_t &incomingP
                         m_metricsCollector->increamentHops();
                     }
 
-                    packet->addToPathTaken(bestRoute.destination);
-                    qDebug() << "PC" << destinationIP << "processing payload:" << actualPayload;
-                    qDebug() << "Packet with source" << packet->getPath()[0] << "with destination" << packet->getPath()[1]
-                             << "with total wait cycle" << packet->getWaitingCycle() << "and it's total cycle is"
-                             << packet->getTotalCycle() << "and it's path taken is" << packet->getPathTaken();
+                    packet->addToPathTaken(destinationIP);
+                    LOG_TRACE(Forwarding) << "PC" << destinationIP << "processing payload:" << actualPayload;
+                    LOG_TRACE(Forwarding) << "Packet with source" << packet->getPath()[0] << "with destination" << packet->getPath()[1]
+                                          << "with total wait cycle" << packet->getWaitingCycle() << "and it's total cycle is"
+                                          << packet->getTotalCycle() << "and it's path taken is" << packet->getPathTaken();
                     dequeuePacketFromBuffer();
                     if (m_metricsCollector)
                         m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
@@ -447,10 +496,8 @@ void Router::processPacket(const PacketPtr_t &packet, const PortPtr_t &incomingP
 
                 packet->decrementTTL();
                 if (packet->getTTL() <= 0) {
-                    qDebug() << "Router" << m_id << "dropping packet due to TTL = 0 after decrement.";
-                    if (m_metricsCollector) {
-                        m_metricsCollector->recordPacketDropped();
-                    }
+                    LOG_TRACE(Forwarding) << "Router" << m_id << "dropping packet due to TTL = 0 after decrement.";
+                    dropPacket(packet, TraceDrop::TtlExpired);
                     dequeuePacketFromBuffer();
                     if (m_metricsCollector)
                         m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
@@ -463,39 +510,35 @@ void Router::processPacket(const PacketPtr_t &packet, const PortPtr_t &incomingP
                     m_metricsCollector->recordRouterUsage(m_ipAddress->getIp());
                 }
 
-                PortPtr_t outPort = bestRoute.learnedFromPort;
-                if (outPort && outPort->isConnected()) {
+                const Adjacency *adjacency = bestRoute.adjacency != FibEntry::NO_ADJACENCY
+                                                 ? &m_fib.adjacency(bestRoute.adjacency) : nullptr;
+                if (adjacency && adjacency->port->isConnected()) {
                     if (m_metricsCollector) {
                         m_metricsCollector->increamentHops();
                     }
-                    packet->addToPathTaken(bestRoute.nextHop);
-                    outPort->sendPacket(packet);
-                    qDebug() << "Router" << m_id << "forwarded packet to next hop via Port" << outPort->getPortNumber();
+                    packet->addToPathTaken(adjacency->nextHop);
+                    EventTrace::record(TraceEvent::PacketForward, m_id, packet->getId(), adjacency->portNumber,
+                                       packet->getTTL());
+                    adjacency->port->sendPacket(packet);
+                    LOG_TRACE(Forwarding) << "Router" << m_id << "forwarded packet to next hop via Port" << adjacency->portNumber;
                 }
                 else {
-                    qDebug() << "Router" << m_id << "has no valid outgoing port to forward the packet. Dropping packet.";
-                    if (m_metricsCollector) {
-                        m_metricsCollector->recordPacketDropped();
-                    }
+                    LOG_TRACE(Forwarding) << "Router" << m_id << "has no valid outgoing port to forward the packet. Dropping packet.";
+                    dropPacket(packet, TraceDrop::NoPort);
                 }
             }
         }
         else {
-            qWarning() << "Malformed Data packet on Router" << m_id << "payload:" << payload;
-            if (m_metricsCollector) {
-                m_metricsCollector->recordPacketDropped();
-            }
+            LOG_WARNING(Forwarding) << "Malformed Data packet on Router" << m_id << "payload:" << payload;
+            dropPacket(packet, TraceDrop::Malformed);
         }
     }
     else {
-        qDebug() << "Router" << m_id << "received unknown/unsupported packet:" << payload << "Dropping it.";
-        if (m_metricsCollector) {
-            m_metricsCollector->recordPacketDropped();
-        }
+        LOG_TRACE(Forwarding) << "Router" << m_id << "received unknown/unsupported packet:" << payload << "Dropping it.";
+        dropPacket(packet, TraceDrop::Unsupported);
     }
 
-    if (enqueued)
-        PacketPtr_t nextPacket = dequeuePacketFromBuffer();
+    dequeuePacketFromBuffer();
     if (m_metricsCollector)
         m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
 }
@@ -506,8 +549,7 @@ void Router::addRoute(const QString &destination, const QString &mask, const QSt
     for (auto &entry : m_routingTable) {
         if (!vip) {
             if (entry.isDirect && entry.destination == destination && entry.mask == mask) {
-                qDebug() << "Router" << m_id << ": Ignoring learned route to" << destination << "due to direct route.";
-                IBGPCounter += 1;
+                LOG_TRACE(Rip) << "Router" << m_id << ": Ignoring learned route to" << destination << "due to direct route.";
                 return;
             }
         }
@@ -521,7 +563,6 @@ void Router::addRoute(const QString &destination, const QString &mask, const QSt
 
             if (entry.holdDownTimer > 0 && metric >= entry.metric) {
                 // qDebug() << "Router" << m_id << ": hold-down active for" << destination << ", ignoring equal or worse route.";
-                IBGPCounter += 1;
                 return;
             }
 
@@ -535,10 +576,14 @@ void Router::addRoute(const QString &destination, const QString &mask, const QSt
                 entry.invalidTimer = newInvalidTimer;
                 entry.holdDownTimer = 0;
                 entry.flushTimer = 0;
+                markRibChanged();
+            } else if (metric == entry.metric && nextHop == entry.nextHop) {
+                // The current next hop confirmed the route; only its timers move.
+                entry.lastUpdateTime = m_currentTime;
+                entry.invalidTimer = newInvalidTimer;
             } else {
                 // qDebug() << "Router" << m_id << ": got equal or worse metric (" << metric << ") for" << destination << ", ignoring update.";
             }
-            IBGPCounter += 1;
             return;
         }
     }
@@ -548,41 +593,243 @@ void Router::addRoute(const QString &destination, const QString &mask, const QSt
         newEntry.invalidTimer = newInvalidTimer;
         // qDebug() << "Router" << m_id << "added new learned route to" << destination << "metric" << metric;
         m_routingTable.append(newEntry);
-        emit routingTableUpdated(m_id);
-        IBGPCounter = 0;
+        markRibChanged();
+    }
+}
+
+QHash<QString, PortPtr_t> Router::forwardingPorts() const
+{
+    QHash<QString, PortPtr_t> portByNextHop;
+    for (const auto &port : m_ports) {
+        if (port->isConnected()) {
+            portByNextHop.insert(port->getConnectedRouterIP(), port);
+        }
+    }
+
+    QHash<QString, int> metrics;
+    QHash<QString, PortPtr_t> ports;
+    for (const auto &route : m_routingTable) {
+        if (route.metric >= RIP_INFINITY) continue;
+        auto known = metrics.constFind(route.destination);
+        if (known != metrics.constEnd() && known.value() <= route.metric) continue;
+
+        metrics.insert(route.destination, route.metric);
+        PortPtr_t port = route.learnedFromPort ? route.learnedFromPort : portByNextHop.value(route.nextHop);
+        if (port) {
+            ports.insert(route.destination, port);
+        } else {
+            ports.remove(route.destination);
+        }
     }
+    return ports;
 }
 
 RouteEntry Router::findBestRoutePath(const QString &destinationIP) const {
     RouteEntry bestRoute;
     int minMetric = RIP_INFINITY;
-    QString bgpDest = " III ";
 
-    if(m_ASnum != -1)
-        bgpDest = (m_ASnum == 1) ? "192.168.200.xx" : "192.168.100.xx";
+    for (const auto &route : m_routingTable) {
+        if (destinationIP == route.destination && route.metric < minMetric) {
+            minMetric = route.metric;
+            bestRoute = route;
+        }
+    }
+
+    // Hosts the interior protocol does not know fall back to the longest matching BGP prefix.
+    if (bestRoute.destination.isEmpty() && m_ASnum != -1) {
+        const BGPPath *path = m_bgpRib.lookup(destinationIP);
+        if (path && !path->isLocal()) {
+            bestRoute = bgpRouteFor(*path);
+        }
+    }
+
+    return bestRoute;
+}
+
+const ForwardingTable &Router::currentForwardingTable()
+{
+    if (m_fib.version() != m_ribVersion) {
+        rebuildForwardingTable();
+    }
+    return m_fib;
+}
+
+const FibEntry &Router::forwardingEntry(const QString &destinationIP)
+{
+    const FibEntry &entry = currentForwardingTable().lookup(destinationIP);
+    if (entry.isValid() || m_ASnum == -1) {
+        return entry;
+    }
 
-    QString bgpPrefix;
-    if (bgpDest.endsWith(".xx")) {
-        bgpPrefix = bgpDest.left(bgpDest.length() - 3);
-    } else {
-        bgpPrefix = bgpDest;
+    // Hosts the interior protocol does not know resolve through BGP once; the result stays
+    // cached until the RIB changes.
+    const BGPPath *path = m_bgpRib.lookup(destinationIP);
+    if (!path || path->isLocal()) {
+        return entry;
     }
+    RouteEntry route = bgpRouteFor(*path);
+    m_fib.insert(destinationIP, m_fib.adjacencyFor(route.learnedFromPort, route.nextHop), route.metric,
+                 static_cast<quint8>(route.protocol), route.destination == route.nextHop);
+    return m_fib.lookup(destinationIP);
+}
+
+void Router::rebuildForwardingTable()
+{
+    m_fib.clear();
+    m_fib.setVersion(m_ribVersion);
 
+    // Lowest metric wins and the first entry wins ties, as in findBestRoutePath.
     for (const auto &route : m_routingTable) {
-        if (destinationIP == route.destination) {
-            if (route.metric < minMetric) {
-                minMetric = route.metric;
-                bestRoute = route;
-            }
-        } else if (route.destination == bgpDest) {
-            if (destinationIP.startsWith(bgpPrefix + ".")) {
-                minMetric = route.metric;
-                bestRoute = route;
-            }
+        if (route.metric >= RIP_INFINITY) continue;
+        const FibEntry &current = m_fib.lookup(route.destination);
+        if (current.isValid() && current.metric <= route.metric) continue;
+
+        m_fib.insert(route.destination, m_fib.adjacencyFor(route.learnedFromPort, route.nextHop), route.metric,
+                     static_cast<quint8>(route.protocol), route.destination == route.nextHop);
+    }
+}
+
+static void writePath(QDataStream &out, const BGPPath &path)
+{
+    out << path.prefix.network << qint32(path.prefix.length) << path.asPath << qint32(path.localPref)
+        << qint32(path.med) << path.nextHop << qint32(path.peerId) << path.external << qint32(path.igpCost)
+        << qint32(path.originatorId) << path.clusterList << path.confedPath;
+}
+
+static void readPath(QDataStream &in, BGPPath &path)
+{
+    qint32 length, localPref, med, peerId, igpCost, originatorId;
+    in >> path.prefix.network >> length >> path.asPath >> localPref >> med >> path.nextHop >> peerId
+       >> path.external >> igpCost >> originatorId >> path.clusterList >> path.confedPath;
+    path.prefix.length = length;
+    path.localPref = localPref;
+    path.med = med;
+    path.peerId = peerId;
+    path.igpCost = igpCost;
+    path.originatorId = originatorId;
+}
+
+void Router::writeState(QDataStream &out) const
+{
+    out << getIPAddress() << m_assignedIP << m_hasValidIP << qint32(m_ASnum) << m_currentTime
+        << m_lastRIPUpdateTime;
+
+    out << quint32(m_routingTable.size());
+    for (const RouteEntry &route : m_routingTable) {
+        out << route.destination << route.mask << route.nextHop << qint32(route.metric)
+            << quint8(route.protocol) << route.lastUpdateTime
+            << quint8(route.learnedFromPort ? route.learnedFromPort->getPortNumber() : 0) << route.isDirect
+            << route.vip << qint32(route.invalidTimer) << qint32(route.holdDownTimer) << qint32(route.flushTimer);
+    }
+
+    out << quint32(m_neighbors.size());
+    for (auto it = m_neighbors.constBegin(); it != m_neighbors.constEnd(); ++it) {
+        out << it.key() << it->ipAddress << qint32(it->cost) << it->lastHelloReceived;
+    }
+    out << quint32(m_lsdb.size());
+    for (auto it = m_lsdb.constBegin(); it != m_lsdb.constEnd(); ++it) {
+        out << it.key() << it->originRouterIP << it->links << it->sequenceNumber << it->age;
+    }
+    out << m_lsaSequenceNumber;
+
+    QVector<BGPPath> paths = m_bgpRib.allPaths();
+    out << quint32(paths.size());
+    for (const BGPPath &path : paths) {
+        writePath(out, path);
+    }
+}
+
+bool Router::parseState(QDataStream &in, RouterState &state) const
+{
+    in >> state.ip >> state.assignedIP >> state.hasValidIP >> state.asNum >> state.currentTime
+       >> state.lastRIPUpdateTime;
+
+    quint32 count = 0;
+    in >> count;
+    state.routingTable.clear();
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        RouteEntry route;
+        qint32 metric, invalidTimer, holdDownTimer, flushTimer;
+        quint8 protocol, portNumber;
+        in >> route.destination >> route.mask >> route.nextHop >> metric >> protocol >> route.lastUpdateTime
+           >> portNumber >> route.isDirect >> route.vip >> invalidTimer >> holdDownTimer >> flushTimer;
+        if (portNumber > m_ports.size() || protocol > quint8(RoutingProtocol::ITSELF)) {
+            in.setStatus(QDataStream::ReadCorruptData);
+            break;
         }
+        route.metric = metric;
+        route.protocol = static_cast<RoutingProtocol>(protocol);
+        route.learnedFromPort = portNumber > 0 ? m_ports[portNumber - 1] : PortPtr_t();
+        route.invalidTimer = invalidTimer;
+        route.holdDownTimer = holdDownTimer;
+        route.flushTimer = flushTimer;
+        state.routingTable.append(route);
+    }
+
+    in >> count;
+    state.neighbors.clear();
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString key;
+        OSPFNeighbor neighbor;
+        qint32 cost;
+        in >> key >> neighbor.ipAddress >> cost >> neighbor.lastHelloReceived;
+        neighbor.cost = cost;
+        state.neighbors.insert(key, neighbor);
+    }
+    in >> count;
+    state.lsdb.clear();
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString key;
+        OSPFLSA lsa;
+        in >> key >> lsa.originRouterIP >> lsa.links >> lsa.sequenceNumber >> lsa.age;
+        state.lsdb.insert(key, lsa);
+    }
+    in >> state.lsaSequenceNumber;
+
+    in >> count;
+    state.bgpPaths.clear();
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        BGPPath path;
+        readPath(in, path);
+        state.bgpPaths.append(path);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        LOG_WARNING(General) << "Router" << m_id << "cannot restore its state: the data is truncated or corrupt.";
+        return false;
     }
+    return true;
+}
 
-    return bestRoute;
+void Router::applyState(const RouterState &state)
+{
+    if (state.ip != getIPAddress()) {
+        assignIP(state.ip);
+    }
+    m_assignedIP = state.assignedIP;
+    m_hasValidIP = state.hasValidIP;
+    m_ASnum = state.asNum;
+    m_currentTime = state.currentTime;
+    m_lastRIPUpdateTime = state.lastRIPUpdateTime;
+    m_routingTable = state.routingTable;
+    m_neighbors = state.neighbors;
+    m_lsdb = state.lsdb;
+    m_lsaSequenceNumber = state.lsaSequenceNumber;
+    m_bgpRib = BGPRib();
+    for (const BGPPath &path : state.bgpPaths) {
+        m_bgpRib.update(path);
+    }
+    markRibChanged();
+}
+
+bool Router::readState(QDataStream &in)
+{
+    RouterState state;
+    if (!parseState(in, state)) {
+        return false;
+    }
+    applyState(state);
+    return true;
 }
 
 void Router::printRoutingTable() const
@@ -595,8 +842,7 @@ void Router::printRoutingTable() const
 
     routerIdStr = QString::number(m_id);
 
-    QString logFilePath = QString("D:/QTProjects/GitHub/CN-CourseProjects/CA3-ANetworkSimulatorToAnalyzeRoutingAlgorithms/logs/routingTableRouter%1.txt")
-                            .arg(routerIdStr);
+    QString logFilePath = m_context->logFilePath(QString("routingTableRouter%1.txt").arg(routerIdStr));
 
     QFileInfo fileInfo(logFilePath);
     QDir logDir = fileInfo.dir();
@@ -654,13 +900,34 @@ void Router::printRoutingTable() const
         out << entryTimeStamp << " " << logEntry << "\n";
     }
 
+    for (const BGPPath &path : m_bgpRib.bestPaths()) {
+        QStringList asPath;
+        for (int as : path.asPath) {
+            asPath.append(QString::number(as));
+        }
+
+        QString logEntry;
+        QTextStream(&logEntry) << "Dest: " << Prefix::formatAddress(path.prefix.network)
+                               << " Mask: " << path.prefix.maskString()
+                               << " NextHop: " << path.nextHop
+                               << " LocalPref: " << path.localPref
+                               << " MED: " << path.med
+                               << " AS_PATH: " << (asPath.isEmpty() ? QString("i") : asPath.join(' '))
+                               << " Protocol: " << (path.isLocal() ? "BGP" : path.external ? "EBGP" : "IBGP");
+
+        qDebug() << logEntry;
+
+        QString entryTimeStamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
+        out << entryTimeStamp << " " << logEntry << "\n";
+    }
+
     logFile.close();
 }
 
 void Router::enableRIP()
 {
-    connect(EventsCoordinator::instance(), &EventsCoordinator::tick, this, &Router::onTick);
-    qDebug() << "RIP enabled on Router" << m_id;
+    connect(m_context->events(), &EventsCoordinator::tick, this, &Router::onTick);
+    LOG_DEBUG(Rip) << "RIP enabled on Router" << m_id;
 }
 
 void Router::onTick()
@@ -678,16 +945,9 @@ void Router::onTick()
 }
 
 void Router::sendRIPUpdate() {
+    TraceSpan span("sendRIPUpdate", m_id, m_context->tick());
     for (auto &port : m_ports) {
-        if (m_ASnum != -1) {
-            Range range = getRange(m_ASnum);
-            int connectedRouterId = port->getConnectedRouterId();
-            if (connectedRouterId <= range.pcMax && connectedRouterId >= range.pcMin) {
-
-            } else if (connectedRouterId > range.max || connectedRouterId < range.min) {
-                continue;
-            }
-        }
+        if (isExternalPort(port)) continue;
 
         if (!port->isConnected()) continue;
 
@@ -710,12 +970,13 @@ void Router::sendRIPUpdate() {
         auto updatePacket = QSharedPointer<Packet>::create(PacketType::Control, payload);
         updatePacket->setTTL(10);
         port->sendPacket(updatePacket);
-        qDebug() << "Router" << m_id << "sent RIP update via Port" << port->getPortNumber() << "with" << routeCount << "routes";
+        LOG_TRACE(Rip) << "Router" << m_id << "sent RIP update via Port" << port->getPortNumber() << "with" << routeCount << "routes";
     }
 }
 
 void Router::processRIPUpdate(const PacketPtr_t &packet)
 {
+    TraceSpan span("processRIPUpdate", m_id, m_context->tick());
     if (!packet) return;
 
     QString payload = packet->getPayload();
@@ -723,7 +984,7 @@ void Router::processRIPUpdate(const PacketPtr_t &packet)
 
     auto parts = payload.split(":");
     if (parts.size() < 2) {
-        qWarning() << "Router" << m_id << "received malformed RIP update:" << payload;
+        LOG_WARNING(Rip) << "Router" << m_id << "received malformed RIP update:" << payload;
         return;
     }
 
@@ -751,7 +1012,7 @@ void Router::processRIPUpdate(const PacketPtr_t &packet)
         if (routeStr.isEmpty()) continue;
         auto fields = routeStr.split(",");
         if (fields.size() < 3) {
-            qWarning() << "Router" << m_id << "RIP route entry malformed:" << routeStr;
+            LOG_WARNING(Rip) << "Router" << m_id << "RIP route entry malformed:" << routeStr;
             continue;
         }
 
@@ -763,7 +1024,7 @@ void Router::processRIPUpdate(const PacketPtr_t &packet)
         // qDebug() << "Router" << m_id << "processing route" << dest << "/" << mask << "from" << senderIP << "metric" << newMetric;
 
         if (newMetric >= RIP_INFINITY) {
-            qDebug() << "Router" << m_id << "received unreachable route for" << dest << "skipping.";
+            LOG_TRACE(Rip) << "Router" << m_id << "received unreachable route for" << dest << "skipping.";
             continue;
         }
 
@@ -780,7 +1041,8 @@ void Router::handleRouteTimeouts() {
             if (entry.invalidTimer == 0 && entry.metric < RIP_INFINITY) {
                 entry.metric = RIP_INFINITY;
                 entry.holdDownTimer = RIP_HOLDOWN_TIMER;
-                qDebug() << "Router" << m_id << ": Route to" << entry.destination << "invalidated, starting hold-down.";
+                markRibChanged();
+                LOG_DEBUG(Rip) << "Router" << m_id << ": Route to" << entry.destination << "invalidated, starting hold-down.";
             }
         }
 
@@ -788,7 +1050,7 @@ void Router::handleRouteTimeouts() {
             entry.holdDownTimer--;
             if (entry.holdDownTimer == 0 && entry.metric == RIP_INFINITY) {
                 entry.flushTimer = RIP_FLUSH_TIMER;
-                qDebug() << "Router" << m_id << ": Hold-down ended for" << entry.destination << ", starting flush timer.";
+                LOG_DEBUG(Rip) << "Router" << m_id << ": Hold-down ended for" << entry.destination << ", starting flush timer.";
             }
         }
 
@@ -799,14 +1061,15 @@ void Router::handleRouteTimeouts() {
 
     for (int i = m_routingTable.size() - 1; i >= 0; i--) {
         if (!m_routingTable[i].isDirect && m_routingTable[i].metric == RIP_INFINITY && m_routingTable[i].flushTimer == 0 && m_routingTable[i].holdDownTimer == 0 && m_routingTable[i].invalidTimer == 0) {
-            qDebug() << "Router" << m_id << ": Removing fully expired route to" << m_routingTable[i].destination;
+            LOG_DEBUG(Rip) << "Router" << m_id << ": Removing fully expired route to" << m_routingTable[i].destination;
             m_routingTable.removeAt(i);
+            markRibChanged();
         }
     }
 }
 
 void Router::addDirectRoute(const QString &destination, const QString &mask) {
-    qDebug() << "Router" << m_id << "adding stable direct route:" << destination << "/" << mask;
+    LOG_DEBUG(Topology) << "Router" << m_id << "adding stable direct route:" << destination << "/" << mask;
     RouteEntry directRoute(destination, mask, destination, 0, RoutingProtocol::ITSELF, m_currentTime, nullptr, true);
     for (int i = m_routingTable.size() - 1; i >= 0; i--) {
         if (m_routingTable[i].destination == destination && m_routingTable[i].mask == mask && m_routingTable[i].isDirect) {
@@ -814,19 +1077,20 @@ void Router::addDirectRoute(const QString &destination, const QString &mask) {
         }
     }
     m_routingTable.append(directRoute);
+    markRibChanged();
 }
 
-void Router::setupDirectNeighborRoutes(RoutingProtocol protocol, int ASId, bool bgp) {
-    auto neighbors = getDirectlyConnectedRouters(ASId, bgp);
+void Router::setupDirectNeighborRoutes(RoutingProtocol protocol, bool bgp) {
+    auto neighbors = getDirectlyConnectedRouters(bgp);
     for (auto &nbr : neighbors) {
         QString nbrIP = nbr->getIPAddress();
-        qDebug() << "neighbor IP " << nbrIP;
+        LOG_DEBUG(Topology) << "neighbor IP " << nbrIP;
         if (nbrIP.isEmpty()) {
-            qWarning() << "Router" << m_id << ": Neighbor" << nbr->getId() << "has no IP yet.";
+            LOG_WARNING(Topology) << "Router" << m_id << ": Neighbor" << nbr->getId() << "has no IP yet.";
             continue;
         }
 
-        qDebug() << "Router" << m_id << "adding direct neighbor route to" << nbrIP;
+        LOG_DEBUG(Topology) << "Router" << m_id << "adding direct neighbor route to" << nbrIP;
         RouteEntry directNeighborRoute(nbrIP, "255.255.255.255", nbrIP, 1,
                                        protocol, m_currentTime, nullptr, true);
 
@@ -849,59 +1113,45 @@ void Router::setupDirectNeighborRoutes(RoutingProtocol protocol, int ASId, bool
         }
     }
     if (protocol == RoutingProtocol::OSPF) {
-        std::vector<QSharedPointer<Router>> connectedPCs = getDirectlyConnectedRouters(ASId, bgp);
-
-        for (auto &pc : connectedPCs) {
-            if (pc->getId() > 23) {
-                QString pcIP = pc->getIPAddress();
-                PortPtr_t learnedFromPort = nullptr;
-                for (auto &port : m_ports) {
-                    if (port->getConnectedPC() != nullptr && port->getConnectedPC()->getIpAddress() == pcIP)
-                        learnedFromPort = port;
-                }
-                addRoute(pcIP, "255.255.255.255", pcIP, 1, RoutingProtocol::OSPF, learnedFromPort, true);
-                RouteEntry directRoute(pcIP, "255.255.255.255", pcIP, 1, RoutingProtocol::OSPF, m_currentTime, nullptr, true, true);
-                for (int i = m_routingTable.size() - 1; i >= 0; i--) {
-                    if (m_routingTable[i].destination == pcIP && m_routingTable[i].mask == "255.255.255.255" && m_routingTable[i].isDirect) {
-                        m_routingTable.removeAt(i);
-                    }
+        for (auto &pc : getConnectedPCs()) {
+            QString pcIP = pc->getIpAddress();
+            PortPtr_t learnedFromPort = nullptr;
+            for (auto &port : m_ports) {
+                if (port->getConnectedPC() != nullptr && port->getConnectedPC()->getIpAddress() == pcIP)
+                    learnedFromPort = port;
+            }
+            addRoute(pcIP, "255.255.255.255", pcIP, 1, RoutingProtocol::OSPF, learnedFromPort, true);
+            RouteEntry directRoute(pcIP, "255.255.255.255", pcIP, 1, RoutingProtocol::OSPF, m_currentTime, nullptr, true, true);
+            for (int i = m_routingTable.size() - 1; i >= 0; i--) {
+                if (m_routingTable[i].destination == pcIP && m_routingTable[i].mask == "255.255.255.255" && m_routingTable[i].isDirect) {
+                    m_routingTable.removeAt(i);
                 }
-                m_routingTable.append(directRoute);
             }
+            m_routingTable.append(directRoute);
         }
     }
+    markRibChanged();
 }
 
-std::vector<QSharedPointer<Router>> Router::getDirectlyConnectedRouters(int ASId, bool bgp) {
-    Range range = {0, 0, 0, 0};
-    if (bgp) {
-        range = getRange(ASId);
-    }
-
+std::vector<QSharedPointer<Router>> Router::getDirectlyConnectedRouters(bool bgp) {
     std::vector<QSharedPointer<Router>> neighbors;
     for (auto &port : m_ports) {
         if (port->isConnected()) {
             int remoteId = port->getConnectedRouterId();
             QSharedPointer<PC> pc = port->getConnectedPC();
 
-            if (bgp) {
-                if (remoteId <= range.pcMax && remoteId >= range.pcMin) {
-                } else if (remoteId > range.max || remoteId < range.min) {
-                    continue;
-                }
+            if (bgp && !isInOwnAS(remoteId)) {
+                continue;
             }
 
-            if (remoteId > 0 && remoteId != m_id && s_topologyBuilder && remoteId < 24) {
-                QSharedPointer<Router> nbr = nullptr;
-                if (remoteId < 24) {
-                    nbr = s_topologyBuilder->findRouterById(remoteId);
-                }
+            if (pc.isNull() && remoteId > 0 && remoteId != m_id) {
+                QSharedPointer<Router> nbr = m_context->routers().findRouterById(remoteId);
                 if (nbr && !nbr->isBroken()) {
                     neighbors.push_back(nbr);
                 }
             } else if (!pc.isNull()) {
                 port->setConnectedRouterIP(pc->getIpAddress());
-                neighbors.push_back(QSharedPointer<Router>::create(pc->getId(), pc->getIpAddress()));
+                neighbors.push_back(QSharedPointer<Router>::create(pc->getId(), pc->getIpAddress(), m_context));
             }
         }
     }
@@ -909,10 +1159,22 @@ std::vector<QSharedPointer<Router>> Router::getDirectlyConnectedRouters(int ASId
     return neighbors;
 }
 
+std::vector<QSharedPointer<PC>> Router::getConnectedPCs() const
+{
+    std::vector<QSharedPointer<PC>> pcs;
+    for (const auto &port : m_ports) {
+        QSharedPointer<PC> pc = port->getConnectedPC();
+        if (pc) {
+            pcs.push_back(pc);
+        }
+    }
+    return pcs;
+}
+
 void Router::enableOSPF()
 {
     initializeOSPF();
-    qDebug() << "OSPF enabled on Router" << m_id;
+    LOG_DEBUG(Ospf) << "OSPF enabled on Router" << m_id;
 }
 
 void Router::initializeOSPF()
@@ -922,23 +1184,16 @@ void Router::initializeOSPF()
     m_helloTimer->start(OSPF_HELLO_INTERVAL * 1000);
     m_lsaTimer->start(OSPF_LSA_INTERVAL * 1000);
 
-    connect(EventsCoordinator::instance(), &EventsCoordinator::tick, this, &Router::handleLSAExpiration);
+    connect(m_context->events(), &EventsCoordinator::tick, this, &Router::handleLSAExpiration);
 }
 
 void Router::sendOSPFHello()
 {
-    qDebug() << "Router" << m_id << "sending OSPF Hello packets.";
+    LOG_TRACE(Ospf) << "Router" << m_id << "sending OSPF Hello packets.";
 
     for (const auto &port : m_ports)
     {
-        if (m_ASnum != -1) {
-            Range range = getRange(m_ASnum);
-            int connectedRouterId = port->getConnectedRouterId();
-            if (connectedRouterId <= range.pcMax && connectedRouterId >= range.pcMin) {
-            } else if (connectedRouterId > range.max || connectedRouterId < range.min) {
-                continue;
-            }
-        }
+        if (isExternalPort(port)) continue;
 
         if (!port->isConnected()) continue;
 
@@ -948,7 +1203,7 @@ void Router::sendOSPFHello()
         auto helloPacket = QSharedPointer<Packet>::create(PacketType::OSPFHello, helloPayload, 10);
 
         port->sendPacket(helloPacket);
-        qDebug() << "Router" << m_id << "sent OSPF Hello via Port" << port->getPortNumber();
+        LOG_TRACE(Ospf) << "Router" << m_id << "sent OSPF Hello via Port" << port->getPortNumber();
     }
 }
 
@@ -960,12 +1215,12 @@ void Router::processOSPFHello(const PacketPtr_t &packet)
     QStringList parts = payload.split(":");
     if (parts.size() != 2 || parts[0] != "OSPF_HELLO")
     {
-        qWarning() << "Router" << m_id << "received malformed OSPF Hello packet.";
+        LOG_WARNING(Ospf) << "Router" << m_id << "received malformed OSPF Hello packet.";
         return;
     }
 
     QString neighborIP = parts[1];
-    qDebug() << "Router" << m_id << "received OSPF Hello from" << neighborIP;
+    LOG_TRACE(Ospf) << "Router" << m_id << "received OSPF Hello from" << neighborIP;
 
     if (!m_neighbors.contains(neighborIP))
     {
@@ -976,20 +1231,20 @@ void Router::processOSPFHello(const PacketPtr_t &packet)
 
         m_neighbors.insert(neighborIP, neighbor);
 
-        qDebug() << "Router" << m_id << "added new OSPF neighbor:" << neighborIP;
+        LOG_DEBUG(Ospf) << "Router" << m_id << "added new OSPF neighbor:" << neighborIP;
 
         sendLSA();
     }
     else
     {
         m_neighbors[neighborIP].lastHelloReceived = QDateTime::currentSecsSinceEpoch();
-        qDebug() << "Router" << m_id << "updated lastHelloReceived for neighbor:" << neighborIP;
+        LOG_TRACE(Ospf) << "Router" << m_id << "updated lastHelloReceived for neighbor:" << neighborIP;
     }
 }
 
 void Router::sendLSA()
 {
-    qDebug() << "Router" << m_id << "sending LSA.";
+    LOG_TRACE(Ospf) << "Router" << m_id << "sending LSA.";
 
     QString lsaPayload = "LSA:" + m_ipAddress->getIp() + ":";
 
@@ -1021,19 +1276,20 @@ void Router::sendLSA()
         if (port->getConnectedRouterIP().isEmpty()) continue;
 
         port->sendPacket(lsaPacket);
-        qDebug() << "Router" << m_id << "sent LSA via Port" << port->getPortNumber();
+        LOG_TRACE(Ospf) << "Router" << m_id << "sent LSA via Port" << port->getPortNumber();
     }
 }
 
 void Router::processLSA(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
 {
+    TraceSpan span("processLSA", m_id, m_context->tick());
     if (!packet) return;
 
     QString payload = packet->getPayload();
     QStringList parts = payload.split(":");
     if (parts.size() < 3 || parts[0] != "LSA")
     {
-        qWarning() << "Router" << m_id << "received malformed LSA packet.";
+        LOG_WARNING(Ospf) << "Router" << m_id << "received malformed LSA packet.";
         return;
     }
 
@@ -1052,7 +1308,7 @@ void Router::processLSA(const PacketPtr_t &packet, const PortPtr_t &incomingPort
         newLSA.age = 0;
 
         m_lsdb.insert(originIP, newLSA);
-        qDebug() << "Router" << m_id << "updated LSDB with LSA from" << originIP;
+        LOG_DEBUG(Ospf) << "Router" << m_id << "updated LSDB with LSA from" << originIP;
 
         auto lsaPacket = QSharedPointer<Packet>::create(PacketType::OSPFLSA, payload, 10);
         lsaPacket->setSequenceNumber(sequenceNumber);
@@ -1064,20 +1320,21 @@ void Router::processLSA(const PacketPtr_t &packet, const PortPtr_t &incomingPort
             if (port->getConnectedRouterIP().isEmpty()) continue;
 
             port->sendPacket(lsaPacket);
-            qDebug() << "Router" << m_id << "flooded LSA via Port" << port->getPortNumber();
+            LOG_TRACE(Ospf) << "Router" << m_id << "flooded LSA via Port" << port->getPortNumber();
         }
 
         runDijkstra();
     }
     else
     {
-        qDebug() << "Router" << m_id << "received outdated LSA from" << originIP << ". Ignoring.";
+        LOG_DEBUG(Ospf) << "Router" << m_id << "received outdated LSA from" << originIP << ". Ignoring.";
     }
 }
 
 void Router::runDijkstra()
 {
-    qDebug() << "Router" << m_id << "running Dijkstra algorithm.";
+    TraceSpan span("runDijkstra", m_id, m_context->tick());
+    LOG_DEBUG(Ospf) << "Router" << m_id << "running Dijkstra algorithm.";
 
     m_distance.clear();
     m_previous.clear();
@@ -1132,7 +1389,21 @@ void Router::runDijkstra()
 
 void Router::updateRoutingTable()
 {
-    qDebug() << "Router" << m_id << "updating routing table based on Dijkstra results.";
+    LOG_DEBUG(Ospf) << "Router" << m_id << "updating routing table based on Dijkstra results.";
+
+    auto ospfRoutes = [this]() {
+        QMap<QString, QPair<QString, int>> routes;
+        for (const auto &route : m_routingTable) {
+            if (route.protocol == RoutingProtocol::OSPF && !route.vip) {
+                routes.insert(route.destination, qMakePair(route.nextHop, route.metric));
+            }
+        }
+        return routes;
+    };
+
+    // The table is rebuilt from scratch; only a different result counts as a change.
+    QMap<QString, QPair<QString, int>> previousRoutes = ospfRoutes();
+    m_deferRibChanges = true;
 
     for (int i = m_routingTable.size() - 1; i >= 0; i--)
     {
@@ -1165,7 +1436,7 @@ void Router::updateRoutingTable()
 
         if (nextHop.isEmpty())
         {
-            qDebug() << "Router" << m_id << "could not determine nextHop for destination" << dest;
+            LOG_DEBUG(Ospf) << "Router" << m_id << "could not determine nextHop for destination" << dest;
             continue;
         }
 
@@ -1192,7 +1463,7 @@ void Router::updateRoutingTable()
         if (outPort)
         {
             addRoute(dest, "255.255.255.255", nextHop, m_distance[dest], RoutingProtocol::OSPF, outPort);
-            qDebug() << "Router" << m_id << "added OSPF route to" << dest << "via" << nextHop;
+            LOG_TRACE(Ospf) << "Router" << m_id << "added OSPF route to" << dest << "via" << nextHop;
 
             static const QRegularExpression regex(R"(\.([a-zA-Z0-9_]+)$)");
             QString id = "";
@@ -1201,26 +1472,27 @@ void Router::updateRoutingTable()
             QRegularExpressionMatch match1 = regex.match(dest);
             if (match1.hasMatch()) {
                 id = match1.captured(1);
-                qDebug() << "Extracted ID from Dest: " << id;
+                LOG_TRACE(Ospf) << "Extracted ID from Dest: " << id;
             } else {
             }
 
-            QSharedPointer<Router> destRouter = s_topologyBuilder->findRouterById(id.toInt(&ok));
-            std::vector<QSharedPointer<Router>> connectedPCs = destRouter->getDirectlyConnectedRouters(0, false);
-            for (auto &pc : connectedPCs) {
-                if (pc->getId() > 23) {
-                    QString pcIP = pc->getIPAddress();
-                    addRoute(pcIP, "255.255.255.255", nextHop, m_distance[dest] + 1, RoutingProtocol::OSPF, outPort);
+            QSharedPointer<Router> destRouter = m_context->routers().findRouterById(id.toInt(&ok));
+            if (destRouter) {
+                for (auto &pc : destRouter->getConnectedPCs()) {
+                    addRoute(pc->getIpAddress(), "255.255.255.255", nextHop, m_distance[dest] + 1, RoutingProtocol::OSPF, outPort);
                 }
             }
         }
         else
         {
-            qDebug() << "Router" << m_id << "could not find outPort for destination" << dest << "via" << nextHop;
+            LOG_DEBUG(Ospf) << "Router" << m_id << "could not find outPort for destination" << dest << "via" << nextHop;
         }
     }
 
-    emit routingTableUpdated(m_id);
+    m_deferRibChanges = false;
+    if (ospfRoutes() != previousRoutes) {
+        markRibChanged();
+    }
 }
 
 void Router::handleLSAExpiration()
@@ -1242,246 +1514,426 @@ void Router::handleLSAExpiration()
     for (const auto &originIP : expiredLSAs)
     {
         m_lsdb.remove(originIP);
-        qDebug() << "Router" << m_id << "removed expired LSA from" << originIP;
+        LOG_DEBUG(Ospf) << "Router" << m_id << "removed expired LSA from" << originIP;
         runDijkstra();
     }
 }
 
+void Router::markRibChanged()
+{
+    if (m_deferRibChanges) return;
+    ++m_ribVersion;
+    EventTrace::record(TraceEvent::RouteChange, m_id, -1, static_cast<qint32>(m_ribVersion), m_routingTable.size());
+    emit routingTableUpdated(m_id);
+}
+
+void Router::setAutonomousSystem(const AsIdRange &range, const QVector<Prefix> &prefixes)
+{
+    m_asRange = range;
+    m_originatedPrefixes = Prefix::aggregate(prefixes);
+}
+
+bool Router::isInOwnAS(int nodeId) const
+{
+    return (nodeId >= m_asRange.routerStartId && nodeId <= m_asRange.routerEndId) ||
+           (nodeId >= m_asRange.pcStartId && nodeId <= m_asRange.pcEndId);
+}
+
+bool Router::isExternalPort(const PortPtr_t &port) const
+{
+    return m_ASnum != -1 && !isInOwnAS(port->getConnectedRouterId());
+}
+
 bool Router::isRouterBorder() {
-    bool isBorder = false;
     for (auto &port : m_ports) {
-        if (m_ASnum != -1) {
-            Range range = getRange(m_ASnum);
-            int connectedRouterId = port->getConnectedRouterId();
-            if (connectedRouterId != -1) {
-                if (connectedRouterId <= range.pcMax && connectedRouterId >= range.pcMin) {
-                } else if (connectedRouterId > range.max || connectedRouterId < range.min) {
-                    isBorder = true;
-                }
-            }
+        if (port->getConnectedRouterId() != -1 && isExternalPort(port)) {
+            return true;
         }
     }
-    return isBorder;
+    return false;
 }
 
-void Router::startEBGP() {
-    for (auto &port : m_ports) {
-        if (m_ASnum != -1) {
-            Range range = getRange(m_ASnum);
-            int connectedRouterId = port->getConnectedRouterId();
-            if (connectedRouterId != -1) {
-                if (connectedRouterId <= range.pcMax && connectedRouterId >= range.pcMin) {
-                } else if (connectedRouterId > range.max || connectedRouterId < range.min) {
-                    if (!port->isConnected()) continue;
-
-                    QString payload = "EBGP_UPDATE:";
-                    int routeCount = 0;
-                    for (const auto &entry : m_routingTable) {
-                        int advertisedMetric = entry.metric;
-                        if (entry.learnedFromPort == port && !entry.isDirect) {
-                            advertisedMetric = RIP_INFINITY;
-                        }
-                        payload += entry.destination + "," + entry.mask + "," + QString::number(advertisedMetric) + "#";
-                        routeCount++;
-                    }
+void Router::originatePrefixes()
+{
+    for (const Prefix &prefix : m_originatedPrefixes) {
+        BGPPath path;
+        path.prefix = prefix;
+        path.nextHop = m_ipAddress->getIp();
+        m_bgpRib.update(path);
+    }
+}
 
-                    payload += m_ipAddress->getIp();
-                    if (routeCount == 0) {
-                        payload = "EBGP_UPDATE:" + m_ipAddress->getIp();
-                    }
+void Router::startEBGP() {
+    // The RIB belongs to the router's thread; the simulator calls this from the main thread.
+    QMetaObject::invokeMethod(this, [this]() {
+        originatePrefixes();
 
-                    auto updatePacket = QSharedPointer<Packet>::create(PacketType::Control, payload);
-                    updatePacket->setTTL(10);
-                    port->sendPacket(updatePacket);
-                    qDebug() << "Router" << m_id << "sent EBGP update via Port" << port->getPortNumber() << "with" << routeCount << "routes";
-                }
-            }
+        QVector<Prefix> prefixes;
+        for (const BGPPath &path : m_bgpRib.bestPaths()) {
+            prefixes.append(path.prefix);
         }
-    }
+        advertiseBGP(prefixes, true, false);
+    }, Qt::QueuedConnection);
 }
 
 void Router::startIBGP() {
-    IBGPCounter = 0;
-    for (auto &port : m_ports) {
-        if (m_ASnum != -1) {
-            Range range = getRange(m_ASnum);
-            int connectedRouterId = port->getConnectedRouterId();
-            if (connectedRouterId != -1) {
-                QSharedPointer<Router> foundRouter = RouterRegistry::findRouterById(connectedRouterId);
-                if (connectedRouterId <= range.pcMax && connectedRouterId >= range.pcMin) {
-                } else if (connectedRouterId <= range.max && connectedRouterId >= range.min && !foundRouter->isRouterBorder()) {
-                    if (!port->isConnected()) continue;
-
-                    QString payload = "IBGP_UPDATE:";
-                    int routeCount = 0;
-                    QString destination = (m_ASnum == 1) ? "192.168.200.xx" : "192.168.100.xx";
-                    payload += destination + "," + "255.255.255.255" + "," + QString::number(1) + "#";
-                    routeCount++;
-
-                    payload += m_ipAddress->getIp();
-                    if (routeCount == 0) {
-                        payload = "IBGP_UPDATE:" + m_ipAddress->getIp();
-                    }
+    QMetaObject::invokeMethod(this, [this]() {
+        originatePrefixes();
 
-                    auto updatePacket = QSharedPointer<Packet>::create(PacketType::Control, payload);
-                    updatePacket->setTTL(10);
-                    port->sendPacket(updatePacket);
-                    qDebug() << "Router" << m_id << "sent IBGP update via Port" << port->getPortNumber() << "with" << routeCount << "routes";
-                }
-            }
+        QVector<Prefix> prefixes;
+        for (const BGPPath &path : m_bgpRib.bestPaths()) {
+            prefixes.append(path.prefix);
+        }
+        advertiseBGP(prefixes, false, true);
+    }, Qt::QueuedConnection);
+}
+
+bool Router::mayAdvertise(const BGPPath &path, const IBGPPeer &peer) const
+{
+    if (path.peerId == peer.routerId) return false;
+    if (path.isLocal() || path.external) return true;
+
+    const IBGPPeer *from = m_ibgpRole.findPeer(path.peerId);
+    // Crossing a confederation boundary behaves like eBGP in both directions.
+    if ((from && from->subAs != m_ibgpRole.subAs) || peer.subAs != m_ibgpRole.subAs) return true;
+
+    // A reflector passes client routes to everyone and non-client routes to clients only.
+    if (m_ibgpRole.isReflector()) {
+        return (from && from->client) || peer.client;
+    }
+    return false;
+}
+
+bool Router::exportPath(const Prefix &prefix, int peerId, bool external, const IBGPPeer *session, BGPUpdate &update) const
+{
+    const BGPPath *path = m_bgpRib.best(prefix);
+    if (!path || path->peerId == peerId) return false;
+    if (session && !mayAdvertise(*path, *session)) return false;
+
+    update.internal = !external;
+    update.senderId = m_id;
+    update.asPath = path->asPath;
+    if (external) {
+        // LOCAL_PREF, MED and confederation state stay inside the AS; the next hop becomes this border router.
+        update.asPath.prepend(m_ASnum);
+        update.nextHop = m_ipAddress->getIp();
+        return true;
+    }
+
+    update.localPref = path->localPref;
+    update.med = path->med;
+    update.nextHop = (path->isLocal() || path->external) ? m_ipAddress->getIp() : path->nextHop;
+    update.originatorId = path->originatorId;
+    update.clusterList = path->clusterList;
+    update.confedPath = path->confedPath;
+
+    const IBGPPeer *from = m_ibgpRole.findPeer(path->peerId);
+    bool learnedInternally = !path->isLocal() && !path->external && from && from->subAs == m_ibgpRole.subAs;
+    if (session && session->subAs != m_ibgpRole.subAs) {
+        update.confedPath.prepend(m_ibgpRole.subAs);
+    } else if (session && m_ibgpRole.isReflector() && learnedInternally) {
+        if (update.originatorId < 0) {
+            update.originatorId = path->peerId;
         }
+        update.clusterList.prepend(m_ibgpRole.clusterId);
     }
+    return true;
 }
 
-void Router::processEBGPUpdate(const PacketPtr_t &packet)
+void Router::advertiseBGP(const QVector<Prefix> &prefixes, bool toExternal, bool toInternal)
 {
-    if (!packet) return;
+    if (m_ASnum == -1 || prefixes.isEmpty()) return;
 
-    QString payload = packet->getPayload();
+    bool flood = m_ibgpRole.mode == IBGPMode::Flood;
+    for (const auto &port : m_ports) {
+        if (!port->isConnected() || port->getConnectedPC()) continue;
 
-    auto parts = payload.split(":");
-    if (parts.size() < 2) {
-        qWarning() << "Router" << m_id << "received malformed EBGP update:" << payload;
-        return;
+        bool external = isExternalPort(port);
+        if ((external && !toExternal) || (!external && (!toInternal || !flood))) continue;
+
+        int peerId = port->getConnectedRouterId();
+        if (!external) {
+            QSharedPointer<Router> peer = m_context->routers().findRouterById(peerId);
+            if (!peer || peer->isBroken()) continue;
+        }
+        m_adjRibOut.queue(peerId, prefixes);
     }
 
-    QString data = parts[1];
-    auto routesAndSender = data.split("#");
-    if (routesAndSender.isEmpty()) return;
+    if (toInternal && !flood) {
+        for (const IBGPPeer &peer : m_ibgpRole.peers) {
+            m_adjRibOut.queue(peer.routerId, prefixes);
+        }
+    }
 
-    QString senderIP = routesAndSender.last();
-    routesAndSender.removeLast();
+    // Changes arriving in the same burst are collected before anything goes out.
+    scheduleBGPFlush();
+}
 
-    // Determine incoming port
-    Port *incomingPort = qobject_cast<Port*>(sender());
-    PortPtr_t incomingPortPtr;
-    if (incomingPort) {
-        for (auto &p : m_ports) {
-            if (p.data() == incomingPort) {
-                incomingPortPtr = p;
-                break;
-            }
+void Router::scheduleBGPFlush()
+{
+    if (m_bgpFlushScheduled) return;
+    m_bgpFlushScheduled = true;
+    QTimer::singleShot(0, this, [this]() {
+        m_bgpFlushScheduled = false;
+        flushBGP();
+    });
+}
+
+void Router::onBGPTick()
+{
+    if (m_bgpFlushDueTick >= 0 && m_context->tick() >= m_bgpFlushDueTick) {
+        m_bgpFlushDueTick = -1;
+        flushBGP();
+    }
+}
+
+PortPtr_t Router::bgpPeerPort(int peerId) const
+{
+    for (const auto &port : m_ports) {
+        if (port->isConnected() && port->getConnectedRouterId() == peerId) {
+            return port;
         }
     }
+    return nullptr;
+}
 
-    for (const auto &routeStr : routesAndSender) {
-        if (routeStr.isEmpty()) continue;
-        auto fields = routeStr.split(",");
-        if (fields.size() < 3) {
-            qWarning() << "Router" << m_id << "EBGP route entry malformed:" << routeStr;
+void Router::flushBGP()
+{
+    int now = m_context->tick();
+    int nextDue = -1;
+
+    for (int peerId : m_adjRibOut.pendingPeers()) {
+        int lastSent = m_adjRibOut.lastSent(peerId);
+        if (lastSent >= 0 && now - lastSent < m_bgpMraiTicks) {
+            // The peer heard from us within its MRAI; its pending prefixes wait for a later tick.
+            int due = lastSent + m_bgpMraiTicks;
+            nextDue = nextDue < 0 ? due : qMin(nextDue, due);
             continue;
         }
 
-        QString dest = fields[0];
-        QString mask = fields[1];
-        int recvMetric = fields[2].toInt();
-        int newMetric = recvMetric + 1;
+        QVector<Prefix> prefixes = m_adjRibOut.takePending(peerId);
+        const IBGPPeer *session = m_ibgpRole.mode == IBGPMode::Flood ? nullptr : m_ibgpRole.findPeer(peerId);
+        PortPtr_t port = session ? nullptr : bgpPeerPort(peerId);
+        if (!session && !port) continue;
+
+        bool external = !session && isExternalPort(port);
+        QHash<Prefix, BGPUpdate> exports;
+        for (const Prefix &prefix : prefixes) {
+            BGPUpdate update;
+            if (exportPath(prefix, peerId, external, session, update)) {
+                exports.insert(prefix, update);
+            }
+        }
 
-        if (newMetric >= RIP_INFINITY) {
-            qDebug() << "Router" << m_id << "received unreachable route for" << dest << "skipping.";
-            continue;
+        BGPUpdate header;
+        header.internal = !external;
+        header.senderId = m_id;
+        header.nextHop = m_ipAddress->getIp();
+
+        QVector<BGPUpdate> updates = m_adjRibOut.diff(peerId, prefixes, exports, header);
+        m_bgpUpdatesSuppressed = m_adjRibOut.suppressedCount();
+        if (updates.isEmpty()) continue;
+
+        m_adjRibOut.markSent(peerId, now);
+        for (const BGPUpdate &update : updates) {
+            if (session) {
+                auto sessionPacket = QSharedPointer<Packet>::create(PacketType::Control,
+                    QString("BGP_SESSION:%1:%2").arg(peerId).arg(update.toPayload()));
+                sessionPacket->setTTL(64);
+                sendBGPSession(peerId, sessionPacket);
+            } else {
+                auto updatePacket = QSharedPointer<Packet>::create(PacketType::Control, update.toPayload());
+                updatePacket->setTTL(10);
+                port->sendPacket(updatePacket);
+            }
+            ++m_bgpUpdatesSent;
+            LOG_DEBUG(Bgp) << "Router" << m_id << "sent" << (external ? "EBGP" : "IBGP") << "update to" << peerId
+                           << "with" << update.announced.size() << "prefixes and" << update.withdrawn.size() << "withdrawals";
         }
+    }
 
-        addRoute(dest, mask, senderIP, newMetric, RoutingProtocol::EBGP, incomingPortPtr);
+    if (nextDue >= 0) {
+        m_bgpFlushDueTick = m_bgpFlushDueTick < 0 ? nextDue : qMin(m_bgpFlushDueTick, nextDue);
+        connect(m_context->events(), &EventsCoordinator::tick, this, &Router::onBGPTick, Qt::UniqueConnection);
     }
 }
 
-void Router::processIBGPUpdate(const PacketPtr_t &packet)
+PortPtr_t Router::portToward(int nodeId, const QString &ip) const
 {
-    m_gotIBGP = true;
+    for (const auto &port : m_ports) {
+        if (port->isConnected() && port->getConnectedRouterId() == nodeId) {
+            return port;
+        }
+    }
 
-    if (!packet) return;
+    RouteEntry best;
+    int minMetric = RIP_INFINITY;
+    for (const auto &route : m_routingTable) {
+        if (route.destination == ip && route.metric < minMetric) {
+            minMetric = route.metric;
+            best = route;
+        }
+    }
+    if (best.learnedFromPort) {
+        return best.learnedFromPort;
+    }
 
-    QString payload = packet->getPayload();
+    for (const auto &port : m_ports) {
+        if (port->isConnected() && !best.nextHop.isEmpty() && port->getConnectedRouterIP() == best.nextHop) {
+            return port;
+        }
+    }
+    return nullptr;
+}
 
-    auto parts = payload.split(":");
-    if (parts.size() < 2) {
-        qWarning() << "Router" << m_id << "received malformed IBGP update:" << payload;
+void Router::sendBGPSession(int peerId, const PacketPtr_t &packet)
+{
+    // iBGP sessions ride the interior routes, the way a TCP session would.
+    QSharedPointer<Router> peer = m_context->routers().findRouterById(peerId);
+    if (!peer || peer->isBroken()) return;
+
+    PortPtr_t port = portToward(peerId, peer->getIPAddress());
+    if (!port) {
+        LOG_DEBUG(Bgp) << "Router" << m_id << "has no interior route to BGP peer" << peerId << ". Dropping update.";
         return;
     }
 
-    QString data = parts[1];
-    auto routesAndSender = data.split("#");
-    if (routesAndSender.isEmpty()) return;
-
-    QString senderIP = routesAndSender.last();
-    routesAndSender.removeLast();
+    port->sendPacket(packet);
+}
 
-    // Determine incoming port
-    Port *incomingPort = qobject_cast<Port*>(sender());
-    PortPtr_t incomingPortPtr;
-    if (incomingPort) {
-        for (auto &p : m_ports) {
-            if (p.data() == incomingPort) {
-                incomingPortPtr = p;
-                break;
+RouteEntry Router::bgpRouteFor(const BGPPath &path) const
+{
+    QString nextHop = path.nextHop;
+    PortPtr_t outPort = nullptr;
+    int metric = path.asPath.size();
+
+    if (!path.external) {
+        // iBGP next hops are border routers inside the AS; resolve them through the interior table.
+        int minMetric = RIP_INFINITY;
+        for (const auto &route : m_routingTable) {
+            if (route.destination == path.nextHop && route.metric < minMetric) {
+                minMetric = route.metric;
+                nextHop = route.nextHop;
+                outPort = route.learnedFromPort;
             }
         }
+        metric += minMetric;
     }
 
-    for (const auto &routeStr : routesAndSender) {
-        if (routeStr.isEmpty()) continue;
-        auto fields = routeStr.split(",");
-        if (fields.size() < 3) {
-            qWarning() << "Router" << m_id << "IBGP route entry malformed:" << routeStr;
-            continue;
+    for (const auto &port : m_ports) {
+        if (outPort) break;
+        if (!port->isConnected()) continue;
+        if (port->getConnectedRouterIP() == nextHop) {
+            outPort = port;
+        } else if (port->getConnectedRouterId() == path.peerId) {
+            // The router that relayed the update is always on a path toward its next hop.
+            outPort = port;
+            nextHop = port->getConnectedRouterIP();
         }
+    }
 
-        QString dest = fields[0];
-        QString mask = fields[1];
+    return RouteEntry(Prefix::formatAddress(path.prefix.network), path.prefix.maskString(), nextHop, metric,
+                      path.external ? RoutingProtocol::EBGP : RoutingProtocol::IBGP, m_currentTime, outPort);
+}
 
-        int recvMetric = fields[2].toInt();
-        int newMetric = recvMetric + 1;
+void Router::processBGPUpdate(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
+{
+    if (!packet) return;
 
-        if (newMetric >= RIP_INFINITY) {
-            qDebug() << "Router" << m_id << "received unreachable route for" << dest << "skipping.";
-            continue;
+    QString payload = packet->getPayload();
+    if (payload.startsWith("BGP_SESSION:")) {
+        // BGP_SESSION:<peer>:<update>; routers on the way only relay it.
+        int separator = payload.indexOf(':', 12);
+        int peerId = separator > 0 ? payload.mid(12, separator - 12).toInt() : -1;
+        if (peerId != m_id) {
+            packet->decrementTTL();
+            if (peerId > 0 && packet->getTTL() > 0) {
+                sendBGPSession(peerId, packet);
+            }
+            return;
         }
+        payload = payload.mid(separator + 1);
+    }
 
-        addRoute(dest, mask, senderIP, newMetric, RoutingProtocol::IBGP, incomingPortPtr);
+    BGPUpdate update;
+    if (!BGPUpdate::parse(payload, update)) {
+        LOG_WARNING(Bgp) << "Router" << m_id << "received malformed BGP update:" << payload;
+        return;
     }
 
-    if (IBGPCounter < 10) {
-        forwardIBGP();
+    if (m_ASnum == -1) {
+        LOG_DEBUG(Bgp) << "Router" << m_id << "is not running BGP. Ignoring update from" << update.senderId;
+        return;
     }
-}
 
-void Router::forwardIBGP() {
-    for (auto &port : m_ports) {
-        if (m_ASnum != -1) {
-            Range range = getRange(m_ASnum);
-            int connectedRouterId = port->getConnectedRouterId();
-            if (connectedRouterId != -1) {
-                QSharedPointer<Router> foundRouter = RouterRegistry::findRouterById(connectedRouterId);
-                if (connectedRouterId <= range.pcMax && connectedRouterId >= range.pcMin) {
-                } else if (connectedRouterId <= range.max && connectedRouterId >= range.min && !foundRouter->isRouterBorder()) {
-                    if (!port->isConnected()) continue;
-                    QString destination = (m_ASnum == 1) ? "192.168.200.xx" : "192.168.100.xx";
-
-                    QString payload = "IBGP_UPDATE:";
-                    int routeCount = 0;
-                    for (const auto &entry : m_routingTable) {
-                        if (entry.destination == destination) {
-                            int advertisedMetric = entry.metric;
-                            if (entry.learnedFromPort == port && !entry.isDirect) {
-                                advertisedMetric = RIP_INFINITY;
-                            }
-                            payload += entry.destination + "," + entry.mask + "," + QString::number(advertisedMetric) + "#";
-                            routeCount++;
-                        }
-                    }
+    QVector<Prefix> changed;
+    auto withdraw = [&](const Prefix &prefix) {
+        if (m_adjRibIn.withdraw(update.senderId, prefix) && m_bgpRib.withdraw(prefix, update.senderId)) {
+            changed.append(prefix);
+        }
+    };
+    for (const Prefix &prefix : update.withdrawn) {
+        withdraw(prefix);
+    }
+
+    // A rejected announcement replaces whatever the peer announced before, so it acts as a withdrawal.
+    // AS_PATH loop detection: a path that already crossed this AS is rejected.
+    if (!update.internal && update.asPath.contains(m_ASnum)) {
+        LOG_DEBUG(Bgp) << "Router" << m_id << "rejected" << update.announced.size() << "prefixes from" << update.senderId
+                       << "with looping AS_PATH" << update.asPath;
+        for (const Prefix &prefix : update.announced) {
+            withdraw(prefix);
+        }
+        update.announced.clear();
+    }
 
-                    payload += m_ipAddress->getIp();
-                    if (routeCount == 0) {
-                        payload = "IBGP_UPDATE:" + m_ipAddress->getIp();
-                    }
+    // Route reflection and confederation loop detection.
+    if (update.internal && !update.announced.isEmpty() &&
+        (update.originatorId == m_id ||
+         (m_ibgpRole.isReflector() && update.clusterList.contains(m_ibgpRole.clusterId)) ||
+         (m_ibgpRole.subAs != 0 && update.confedPath.contains(m_ibgpRole.subAs)))) {
+        LOG_DEBUG(Bgp) << "Router" << m_id << "rejected" << update.announced.size() << "reflected prefixes from" << update.senderId;
+        for (const Prefix &prefix : update.announced) {
+            withdraw(prefix);
+        }
+        update.announced.clear();
+    }
 
-                    auto updatePacket = QSharedPointer<Packet>::create(PacketType::Control, payload);
-                    updatePacket->setTTL(10);
-                    port->sendPacket(updatePacket);
-                    qDebug() << "Router" << m_id << "sent IBGP update via Port" << port->getPortNumber() << "with" << routeCount << "routes";
-                }
+    int igpCost = 0;
+    if (update.internal) {
+        igpCost = RIP_INFINITY;
+        for (const auto &route : m_routingTable) {
+            if (route.destination == update.nextHop) {
+                igpCost = qMin(igpCost, route.metric);
             }
         }
     }
+
+    for (const Prefix &prefix : update.announced) {
+        BGPPath path;
+        path.prefix = prefix;
+        path.asPath = update.asPath;
+        path.localPref = update.internal ? update.localPref : BGP_DEFAULT_LOCAL_PREF;
+        path.med = update.med;
+        path.nextHop = update.nextHop;
+        path.peerId = update.senderId;
+        path.external = !update.internal;
+        path.igpCost = igpCost;
+        path.originatorId = update.originatorId;
+        path.clusterList = update.clusterList;
+        path.confedPath = update.confedPath;
+
+        // Re-announcements of an unchanged path stop at the Adj-RIB-In.
+        if (m_adjRibIn.announce(path) && m_bgpRib.update(path)) {
+            changed.append(prefix);
+        }
+    }
+
+    if (changed.isEmpty()) return;
+
+    LOG_DEBUG(Bgp) << "Router" << m_id << "BGP best path changed for" << changed.size() << "prefixes";
+    markRibChanged();
+
+    // In flood mode iBGP is relayed hop by hop; it stops once no router's best path changes any more.
+    advertiseBGP(changed, true, true);
 }
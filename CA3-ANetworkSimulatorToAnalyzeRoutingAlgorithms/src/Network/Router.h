@@ -2,6 +2,7 @@
 #define ROUTER_H
 
 #include <QSet>
+#include <atomic>
 #include <QTimer>
 #include <QQueue>
 #include <QMutex>
@@ -12,10 +13,19 @@
 #include <QEnableSharedFromThis>
 
 #include "Node.h"
+#include "ForwardingTable.h"
 #include "../Port/Port.h"
 #include "../DHCPServer/DHCPServer.h"
+#include "../DHCPServer/DHCPMessage.h"
+#include "../DHCPServer/DHCPTransactionCache.h"
+#include "../BGP/BGPRib.h"
+#include "../BGP/BGPAdjRib.h"
+#include "../BGP/IBGPTopology.h"
+#include "../Globals/IdAssignment.h"
+#include "../Trace/EventTrace.h"
 
 class UDP;
+class QDataStream;
 class TopologyBuilder;
 class MetricsCollector;
 class PC;
@@ -75,11 +85,20 @@ struct OSPFLSA {
     qint64 age;
 };
 
-struct Range {
-    int min;
-    int max;
-    int pcMin;
-    int pcMax;
+// Router::writeState's output once parsed; its learnedFromPort pointers belong to the router that
+// parsed it.
+struct RouterState {
+    QString ip;
+    QString assignedIP;
+    bool hasValidIP = false;
+    qint32 asNum = 0;
+    qint64 currentTime = 0;
+    qint64 lastRIPUpdateTime = 0;
+    QVector<RouteEntry> routingTable;
+    QMap<QString, OSPFNeighbor> neighbors;
+    QMap<QString, OSPFLSA> lsdb;
+    qint64 lsaSequenceNumber = 0;
+    QVector<BGPPath> bgpPaths;
 };
 
 constexpr int HELLO_INTERVAL = 1000;
@@ -89,7 +108,8 @@ class Router : public Node, public QEnableSharedFromThis<Router>
     Q_OBJECT
 
 public:
-    explicit Router(int id, const QString &ipAddress, int portCount = 6, QObject *parent = nullptr, bool isBroken = false);
+    explicit Router(int id, const QString &ipAddress, SimulationContext *context, int portCount = 6, QObject *parent = nullptr,
+                    bool isBroken = false);
     ~Router() override;
 
     PortPtr_t getAvailablePort();
@@ -100,32 +120,59 @@ public:
     void forwardPacket(const PacketPtr_t  &packet);
     void logPortStatuses() const;
     void processPacket(const PacketPtr_t &packet, const PortPtr_t &incomingPort);
-    void setIP(QString IP) { m_ipAddress->setIp(IP); }
+    void setIP(QString IP) { assignIP(IP); }
     QString getAssignedIP();
 
     void setDHCPServer(QSharedPointer<DHCPServer> dhcpServer);
     QSharedPointer<DHCPServer> getDHCPServer();
     bool isDHCPServer() const;
+    void setDHCPRelay(bool relay) { m_isDHCPRelay = relay; }
+    bool isDHCPRelay() const { return m_isDHCPRelay; }
     QString findBestRoute(const QString &destinationIP) const;
     void addDirectRoute(const QString &destination, const QString &mask);
 
-    void setupDirectNeighborRoutes(RoutingProtocol protocol, int ASId, bool bgp);
-    std::vector<QSharedPointer<Router>> getDirectlyConnectedRouters(int ASId, bool bgp);
-    static void setTopologyBuilder(TopologyBuilder *builder);
+    void setupDirectNeighborRoutes(RoutingProtocol protocol, bool bgp);
+    std::vector<QSharedPointer<Router>> getDirectlyConnectedRouters(bool bgp);
+    std::vector<QSharedPointer<PC>> getConnectedPCs() const;
+    void setTopologyBuilder(TopologyBuilder *builder);
     void setMetricsCollector(QSharedPointer<MetricsCollector> collector);
+    void setBufferSize(int size);
+    // Queues the packet ahead of processing; false (and a recorded drop) when the buffer is full.
+    bool enqueuePacketToBuffer(const PacketPtr_t &packet);
     RouteEntry findBestRoutePath(const QString &destinationIP) const;
+    // Same choice as findBestRoutePath, served from the forwarding table, which is rebuilt from
+    // the routing table whenever the RIB version moved.
+    const FibEntry &forwardingEntry(const QString &destinationIP);
+    const ForwardingTable &getForwardingTable() const { return m_fib; }
+    const ForwardingTable &currentForwardingTable();      // Rebuilt first if the RIB moved on
+    // Outgoing port per destination of the interior table, chosen the way findBestRoutePath does.
+    QHash<QString, PortPtr_t> forwardingPorts() const;
+    // Bumped on every change to the routing table or the BGP best paths; safe to read from any thread.
+    quint64 getRibVersion() const { return m_ribVersion; }
+    // Converged control-plane state: address, routing table, OSPF neighbours and LSDB, BGP Loc-RIB.
+    // Call on the router's thread. parseState only reads and applyState cannot fail, so a caller
+    // restoring many routers can check every state before changing any router.
+    void writeState(QDataStream &out) const;
+    bool parseState(QDataStream &in, RouterState &state) const;
+    void applyState(const RouterState &state);
+    bool readState(QDataStream &in);    // Leaves the router untouched when the data is invalid
 
     bool isBroken() { return m_isBroken; }
     void addConnectedPC(QSharedPointer<PC> pc, PortPtr_t port);
 
     void startTimers();
     void setASNum(int num) { m_ASnum = num; }
+    int getAsId() const { return m_asRange.asId; }       // From the topology; -1 outside any AS
+    void setAutonomousSystem(const AsIdRange &range, const QVector<Prefix> &prefixes);
     bool isRouterBorder();
     void startEBGP();
     void startIBGP();
-    void forwardIBGP();
-    bool gottenIBGP() { return m_gotIBGP; }
-    void setGotIBGP(bool gotten) { m_gotIBGP = gotten; }
+    const BGPRib &getBGPRib() const { return m_bgpRib; }
+    void setIBGPRole(const IBGPRole &role) { m_ibgpRole = role; }
+    const IBGPRole &getIBGPRole() const { return m_ibgpRole; }
+    int getBGPUpdatesSent() const { return m_bgpUpdatesSent; }
+    int getBGPUpdatesSuppressed() const { return m_bgpUpdatesSuppressed; }
+    void setBGPMrai(int mraiTicks) { m_bgpMraiTicks = mraiTicks; }
 
 signals:
     void routingTableUpdated(int routerId);
@@ -137,7 +184,7 @@ public slots:
 
 public Q_SLOTS:
     void initialize();
-    void processDHCPResponse(const PacketPtr_t  &packet);
+    void processDHCPResponse(const PacketPtr_t  &packet, const PortPtr_t &incomingPort = nullptr);
 
     void addRoute(const QString &destination, const QString &mask, const QString &nextHop, int metric,
                   RoutingProtocol protocol, PortPtr_t learnedFromPort = nullptr, bool vip = false);
@@ -151,8 +198,7 @@ public Q_SLOTS:
     void handleRouteTimeouts();
 
     // BGP specific methods
-    void processEBGPUpdate(const PacketPtr_t  &packet);
-    void processIBGPUpdate(const PacketPtr_t  &packet);
+    void processBGPUpdate(const PacketPtr_t &packet, const PortPtr_t &incomingPort);
 
     // OSPF-specific methods
     void enableOSPF();
@@ -173,9 +219,17 @@ private:
     QSharedPointer<MetricsCollector> m_metricsCollector;
     QString m_assignedIP;
 
-    QSet<QString> m_seenPackets;
-    static TopologyBuilder *s_topologyBuilder;
+    bool m_isDHCPRelay = false;
+    int m_dhcpAttempts = 0;
+    QVector<int> m_dhcpServerPath;            // Learned from offers: this router first, server last
+    DHCPTransactionCache m_dhcpTransactions;
+    TopologyBuilder *m_topologyBuilder = nullptr;
     QVector<RouteEntry> m_routingTable;
+    std::atomic<quint64> m_ribVersion {0};
+    bool m_deferRibChanges = false;
+    void markRibChanged();
+    ForwardingTable m_fib;
+    void rebuildForwardingTable();
 
     // RIP-related fields
     const int RIP_UPDATE_INTERVAL = 5;
@@ -204,9 +258,10 @@ private:
     int m_bufferRetentionTime;                // Retention time in milliseconds
 
     // Buffer management methods
-    bool enqueuePacketToBuffer(const PacketPtr_t &packet);
     PacketPtr_t dequeuePacketFromBuffer();
     void processBuffer();
+    // Traces the drop and, for data packets only, counts it against the delivery metrics.
+    void dropPacket(const PacketPtr_t &packet, TraceDrop reason);
 
     const int OSPF_HELLO_INTERVAL = 10;
     const int OSPF_LSA_INTERVAL = 30;
@@ -219,29 +274,40 @@ private:
     qint64 m_currentTime;
 
     void initializePorts();
-    bool hasSeenPacket(const PacketPtr_t  &packet);
     bool m_isBroken;
-    bool m_gotIBGP;
-    void markPacketAsSeen(const PacketPtr_t  &packet);
-    std::vector<QSharedPointer<PC>> m_connectedPCs;
 
-    static int IBGPCounter;
-
-    Range getRange(int ASnum) const {
-        Range range = {0, 0, 0, 0};
-        if (ASnum == 1) {
-            range.min = 1;
-            range.max = 16;
-            range.pcMin = 24;
-            range.pcMax = 31;
-        } else if (ASnum == 2) {
-            range.min = 17;
-            range.max = 23;
-            range.pcMin = 32;
-            range.pcMax = 38;
-        }
-        return range;
-    }
+    // BGP state; m_asRange is known from construction, m_ASnum is set once BGP runs
+    AsIdRange m_asRange {-1, 0, 0, 0, 0};
+    QVector<Prefix> m_originatedPrefixes;
+    BGPRib m_bgpRib;
+    IBGPRole m_ibgpRole;
+    std::atomic<int> m_bgpUpdatesSent {0};
+    std::atomic<int> m_bgpUpdatesSuppressed {0};
+    BGPAdjRibIn m_adjRibIn;
+    BGPAdjRibOut m_adjRibOut;
+    int m_bgpMraiTicks = BGP_DEFAULT_MRAI_TICKS;
+    bool m_bgpFlushScheduled = false;
+    int m_bgpFlushDueTick = -1;    // Earliest tick at which an MRAI-held peer may be sent to
+
+    bool isInOwnAS(int nodeId) const;
+    bool isExternalPort(const PortPtr_t &port) const;
+    void originatePrefixes();
+    void advertiseBGP(const QVector<Prefix> &prefixes, bool toExternal, bool toInternal);
+    void scheduleBGPFlush();
+    void flushBGP();
+    void onBGPTick();
+    PortPtr_t bgpPeerPort(int peerId) const;
+    RouteEntry bgpRouteFor(const BGPPath &path) const;
+    bool mayAdvertise(const BGPPath &path, const IBGPPeer &peer) const;
+    bool exportPath(const Prefix &prefix, int peerId, bool external, const IBGPPeer *session,
+                    BGPUpdate &update) const;
+    void sendBGPSession(int peerId, const PacketPtr_t &packet);
+    PortPtr_t portToward(int nodeId, const QString &ip) const;
+
+    void processDHCPRequest(const PacketPtr_t &packet, const PortPtr_t &incomingPort);
+    bool sendDHCPToward(int nodeId, const DHCPMessage &message, int ttl);
+    void floodDHCP(const DHCPMessage &message, int ttl, const PortPtr_t &incomingPort);
+    std::vector<QSharedPointer<PC>> m_connectedPCs;
 
     mutable QMutex m_logMutex;
 };
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <QDebug>
+#include <QThreadPool>
+
+#include "ConvergenceOracle.h"
+#include "../Network/Router.h"
+#include "../Globals/ObjectThread.h"
+#include "../Topology/TopologySnapshot.h"
+
+ConvergenceOracle::ConvergenceOracle(const QSharedPointer<const TopologySnapshot> &topology,
+                                     const QVector<std::vector<QSharedPointer<Router>>> &domains, bool interDomain)
+{
+    // Routers without an address take no part in routing.
+    QVector<int> domainOf;
+    for (int domain = 0; domain < domains.size(); ++domain) {
+        for (const auto &router : domains[domain]) {
+            if (router && !router->isBroken() && !router->getIPAddress().isEmpty()) {
+                m_indexOf.insert(router->getId(), m_routers.size());
+                m_indexOfAddress.insert(router->getIPAddress(), m_routers.size());
+                m_routers.append(router);
+                domainOf.append(domain);
+            }
+        }
+    }
+
+    QVector<QPair<int, int>> links;
+    for (int i = 0; i < m_routers.size(); ++i) {
+        int node = topology->indexOf(m_routers[i]->getId());
+        if (node < 0) continue;
+        for (const int *it = topology->neighborsBegin(node); it != topology->neighborsEnd(node); ++it) {
+            int neighbor = m_indexOf.value(topology->routerId(*it), -1);
+            if (neighbor > i) {
+                links.append(qMakePair(i, neighbor));
+            }
+        }
+    }
+
+    m_validator.setTopology(m_routers.size(), links, domainOf);
+    m_validator.setInterDomain(interDomain);
+}
+
+ConvergenceOracle::RouterNextHops ConvergenceOracle::nextHopsOf(int router) const
+{
+    RouterNextHops nextHops;
+    const QHash<QString, PortPtr_t> ports = m_routers[router]->forwardingPorts();
+    nextHops.reserve(ports.size());
+    for (auto it = ports.constBegin(); it != ports.constEnd(); ++it) {
+        int destination = m_indexOfAddress.value(it.key(), -1);
+        int neighbor = m_indexOf.value(it.value()->getConnectedRouterId(), -1);
+        if (destination >= 0 && neighbor >= 0) {
+            nextHops.emplace_back(destination, neighbor);
+        }
+    }
+    std::sort(nextHops.begin(), nextHops.end());
+    return nextHops;
+}
+
+bool ConvergenceOracle::verify()
+{
+    std::vector<RouterNextHops> nextHops(m_routers.size());
+    for (int i = 0; i < m_routers.size(); ++i) {
+        runOnObjectThread(m_routers[i].data(), [this, &nextHops, i]() { nextHops[i] = nextHopsOf(i); });
+    }
+    return validate(nextHops);
+}
+
+QSharedPointer<OracleCheck> ConvergenceOracle::startCheck()
+{
+    struct Reports
+    {
+        explicit Reports(int routers) : nextHops(routers), pending(routers) {}
+        std::vector<RouterNextHops> nextHops;
+        std::atomic<int> pending;
+    };
+
+    auto check = QSharedPointer<OracleCheck>::create();
+    if (m_routers.isEmpty()) {
+        check->clean = validate({});
+        check->finished.store(true, std::memory_order_release);
+        return check;
+    }
+
+    // A router destroyed before it reports leaves the check unfinished, which the detector
+    // treats like a check still running.
+    QSharedPointer<ConvergenceOracle> self = sharedFromThis();
+    auto reports = QSharedPointer<Reports>::create(m_routers.size());
+    for (int i = 0; i < m_routers.size(); ++i) {
+        postToObjectThread(m_routers[i].data(), [self, reports, check, i]() {
+            reports->nextHops[i] = self->nextHopsOf(i);
+            if (reports->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                QThreadPool::globalInstance()->start([self, reports, check]() {
+                    check->clean = self->validate(reports->nextHops);
+                    check->finished.store(true, std::memory_order_release);
+                });
+            }
+        });
+    }
+    return check;
+}
+
+bool ConvergenceOracle::validate(const std::vector<RouterNextHops> &reports)
+{
+    // Flattened into compressed sparse rows: router n's entries are [offsets[n], offsets[n + 1]),
+    // sorted by destination, so a lookup is a binary search within one row.
+    std::vector<int> offsets(reports.size() + 1, 0);
+    for (size_t i = 0; i < reports.size(); ++i) {
+        offsets[i + 1] = offsets[i] + static_cast<int>(reports[i].size());
+    }
+    std::vector<int> destinations(offsets.back());
+    std::vector<int> neighbors(offsets.back());
+    for (size_t i = 0; i < reports.size(); ++i) {
+        int slot = offsets[i];
+        for (const auto &[destination, neighbor] : reports[i]) {
+            destinations[slot] = destination;
+            neighbors[slot++] = neighbor;
+        }
+    }
+
+    RoutingReport report = m_validator.validate([&](int node, int destination) {
+        auto begin = destinations.cbegin() + offsets[node];
+        auto end = destinations.cbegin() + offsets[node + 1];
+        auto it = std::lower_bound(begin, end, destination);
+        return it != end && *it == destination ? neighbors[it - destinations.cbegin()] : -1;
+    });
+
+    if (!report.isClean()) {
+        qDebug() << "ConvergenceOracle:" << report.summary() << "; first:" << report.samples.value(0);
+    }
+
+    QMutexLocker locker(&m_reportMutex);
+    m_lastReport = report;
+    return report.isClean();
+}
+
+RoutingReport ConvergenceOracle::lastReport() const
+{
+    QMutexLocker locker(&m_reportMutex);
+    return m_lastReport;
+}
@@ -0,0 +1,50 @@
+#ifndef CONVERGENCEORACLE_H
+#define CONVERGENCEORACLE_H
+
+#include <vector>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+#include <QSharedPointer>
+
+#include "RoutingValidator.h"
+#include "../EventsCoordinator/ConvergenceDetector.h"
+
+class Router;
+class TopologySnapshot;
+
+// Checks the distributed routing tables of live routers against the RoutingValidator's ground truth.
+// Each entry of domains is one routing domain; with interDomain set, routers in different domains
+// must also reach each other. Links come from the given snapshot of the simulation's topology.
+// Routing tables belong to their routers' threads, so every router reports its own next hops.
+class ConvergenceOracle : public QEnableSharedFromThis<ConvergenceOracle>
+{
+public:
+    ConvergenceOracle(const QSharedPointer<const TopologySnapshot> &topology,
+                      const QVector<std::vector<QSharedPointer<Router>>> &domains, bool interDomain = true);
+
+    // Waits for every router's report, so it must not be called from a router's thread.
+    bool verify();
+    // Returns at once: the routers report when their threads get to it, and the last one hands the
+    // validation to the global thread pool. Only for oracles owned by a QSharedPointer.
+    QSharedPointer<OracleCheck> startCheck();
+
+    RoutingReport lastReport() const;
+
+private:
+    // One router's next hops as (destination, neighbour) pairs, sorted by destination.
+    using RouterNextHops = std::vector<std::pair<int, int>>;
+
+    RouterNextHops nextHopsOf(int router) const;    // On that router's thread
+    bool validate(const std::vector<RouterNextHops> &reports);
+
+    QVector<QSharedPointer<Router>> m_routers;
+    QHash<int, int> m_indexOf;
+    QHash<QString, int> m_indexOfAddress;
+    RoutingValidator m_validator;
+
+    mutable QMutex m_reportMutex;
+    RoutingReport m_lastReport;
+};
+
+#endif // CONVERGENCEORACLE_H
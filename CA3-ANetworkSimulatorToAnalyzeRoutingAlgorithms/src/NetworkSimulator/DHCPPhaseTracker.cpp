@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <QTimer>
+#include <QDebug>
+#include <QEventLoop>
+#include <QElapsedTimer>
+
+#include "DHCPPhaseTracker.h"
+#include "../Network/Node.h"
+
+DHCPPhaseTracker::DHCPPhaseTracker(QObject *parent)
+    : QObject(parent)
+{}
+
+void DHCPPhaseTracker::track(Node *node)
+{
+    expect(node->getId());
+    connect(node, &Node::ipAssigned, this, &DHCPPhaseTracker::onIpAssigned);
+}
+
+void DHCPPhaseTracker::expect(int nodeId)
+{
+    m_pending.insert(nodeId);
+}
+
+void DHCPPhaseTracker::onIpAssigned(int nodeId, const QString &ip)
+{
+    if (!m_pending.remove(nodeId)) {
+        return;
+    }
+
+    qDebug() << "DHCP: Node" << nodeId << "bound to" << ip << "-" << m_pending.size() << "leases outstanding.";
+    if (m_pending.isEmpty()) {
+        emit completed();
+    }
+}
+
+bool DHCPPhaseTracker::waitForCompletion(int timeoutMs)
+{
+    if (isComplete()) {
+        return true;
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    QEventLoop loop;
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+    connect(this, &DHCPPhaseTracker::completed, &loop, &QEventLoop::quit);
+    timeout.start(timeoutMs);
+    loop.exec();
+
+    if (!isComplete()) {
+        QList<int> missing = m_pending.values();
+        std::sort(missing.begin(), missing.end());
+        qWarning() << "DHCP: Timed out after" << timeoutMs << "ms;" << missing.size() << "nodes have no lease:" << missing;
+        return false;
+    }
+
+    qDebug() << "DHCP: Phase completed in" << elapsed.elapsed() << "ms.";
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef DHCPPHASETRACKER_H
+#define DHCPPHASETRACKER_H
+
+#include <QSet>
+#include <QObject>
+#include <QString>
+
+class Node;
+
+// Counts down the nodes that still wait for a DHCP lease and reports when the last one is bound.
+class DHCPPhaseTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DHCPPhaseTracker(QObject *parent = nullptr);
+
+    void track(Node *node);
+    void expect(int nodeId);
+
+    // Runs a local event loop until every tracked node is bound or timeoutMs passes.
+    bool waitForCompletion(int timeoutMs);
+
+    bool isComplete() const { return m_pending.isEmpty(); }
+    QSet<int> pending() const { return m_pending; }
+
+Q_SIGNALS:
+    void completed();
+
+public Q_SLOTS:
+    void onIpAssigned(int nodeId, const QString &ip);
+
+private:
+    QSet<int> m_pending;
+};
+
+#endif // DHCPPHASETRACKER_H
@@ -1,21 +1,29 @@
 #include <QDebug>
 #include <QJsonArray>
-#include <unordered_map>
 
 #include "Network.h"
 #include "Topology/TopologyController.h"
+#include "../Globals/SimulationContext.h"
 
-Network::Network(const QJsonObject &config, QObject *parent)
-    : QObject(parent), m_config(config)
+Network::Network(const QJsonObject &config, SimulationContext *context, QObject *parent)
+    : QObject(parent), m_config(config), m_context(context)
 {}
 
 Network::~Network()
 {}
 
+void Network::shutdown()
+{
+    for (const auto &asInstance : m_autonomousSystems) {
+        asInstance->shutdown();
+    }
+}
+
 void Network::initialize(const IdAssignment &idAssignment, const bool torus)
 {
     createAutonomousSystems(idAssignment, torus);
     connectAutonomousSystems();
+    m_context->topology();
 }
 
 void Network::createAutonomousSystems(const IdAssignment &idAssignment, const bool torus)
@@ -24,7 +32,7 @@ void Network::createAutonomousSystems(const IdAssignment &idAssignment, const bo
     for (const QJsonValue &asValue : asArray)
     {
         QJsonObject asObject = asValue.toObject();
-        auto asInstance = QSharedPointer<AutonomousSystem>::create(asObject, idAssignment, torus);
+        auto asInstance = QSharedPointer<AutonomousSystem>::create(asObject, idAssignment, torus, m_context);
         m_autonomousSystems.push_back(asInstance);
     }
 }
@@ -46,6 +54,15 @@ std::vector<QSharedPointer<Router>> Network::getAllRouters() const {
     return allRouters;
 }
 
+std::vector<QSharedPointer<PC>> Network::getAllPCs() const {
+    std::vector<QSharedPointer<PC>> allPCs;
+    for (const auto &asInstance : m_autonomousSystems) {
+        const auto &pcs = asInstance->getPCs();
+        allPCs.insert(allPCs.end(), pcs.begin(), pcs.end());
+    }
+    return allPCs;
+}
+
 void Network::initiateDHCPPhase()
 {
     for (const auto &asInstance : m_autonomousSystems)
@@ -133,21 +150,11 @@ void Network::enableOSPFOnAllRouters()
 }
 
 void Network::startBGP(RoutingProtocol protocolAS1, RoutingProtocol protocolAS2) {
-    std::unordered_map<int, RoutingProtocol> asProtocolMap = {
-     {1, protocolAS1},
-     {2, protocolAS2}
-    };
-
     for (auto &asInstance : m_autonomousSystems) {
         int asNum = asInstance->getId();
 
-        auto protocolIt = asProtocolMap.find(asNum);
-        if (protocolIt == asProtocolMap.end()) {
-            qWarning() << "No routing protocol configured for AS" << asNum << ". Skipping.";
-            continue;
-        }
-
-        RoutingProtocol currentProtocol = protocolIt->second;
+        // The first AS has its own interior protocol; every other AS shares the second one.
+        RoutingProtocol currentProtocol = (asNum == 1) ? protocolAS1 : protocolAS2;
         const auto &routers = asInstance->getRouters();
 
         for (auto &router : routers) {
@@ -181,6 +188,32 @@ void Network::printAllRoutingTables()
     }
 }
 
+void Network::printBGPStatistics() const
+{
+    for (const auto &asInstance : m_autonomousSystems) {
+        int endpoints = 0;
+        int updatesSent = 0;
+        int updatesSuppressed = 0;
+        int paths = 0;
+        int prefixes = 0;
+        IBGPMode mode = IBGPMode::FullMesh;
+
+        for (const auto &router : asInstance->getRouters()) {
+            mode = router->getIBGPRole().mode;
+            endpoints += router->getIBGPRole().peers.size();
+            updatesSent += router->getBGPUpdatesSent();
+            updatesSuppressed += router->getBGPUpdatesSuppressed();
+            paths += router->getBGPRib().pathCount();
+            prefixes += router->getBGPRib().prefixCount();
+        }
+
+        qDebug() << "AS" << asInstance->getId() << "iBGP" << IBGPTopology::modeName(mode) << ":"
+                 << endpoints / 2 << "sessions," << updatesSent << "updates sent,"
+                 << updatesSuppressed << "unchanged prefixes suppressed,"
+                 << paths << "paths held for" << prefixes << "prefix entries";
+    }
+}
+
 void Network::setupDirectRoutesForRouters(RoutingProtocol protocol)
 {
     for (auto &asInstance : m_autonomousSystems) {
@@ -210,12 +243,12 @@ void Network::finalizeRoutesAfterDHCP(RoutingProtocol protocol, bool bgp, Routin
         for (auto &router : routers) {
             if (!router->isBroken()) {
                 if (!bgp) {
-                    router->setupDirectNeighborRoutes(protocol, asInstance->getId(), bgp);
+                    router->setupDirectNeighborRoutes(protocol, bgp);
                 } else {
                     if (asNum == 1) {
-                        router->setupDirectNeighborRoutes(protocolAS1, asInstance->getId(), bgp);
+                        router->setupDirectNeighborRoutes(protocolAS1, bgp);
                     } else {
-                        router->setupDirectNeighborRoutes(protocolAS2, asInstance->getId(), bgp);
+                        router->setupDirectNeighborRoutes(protocolAS2, bgp);
                     }
                 }
             }
@@ -15,7 +15,7 @@ class Network : public QObject
     Q_OBJECT
 
 public:
-    explicit Network(const QJsonObject &config, QObject *parent = nullptr);
+    explicit Network(const QJsonObject &config, SimulationContext *context, QObject *parent = nullptr);
     ~Network();
 
     void initialize(const IdAssignment &idAssignment, const bool torus);
@@ -29,16 +29,22 @@ public:
     void enableOSPFOnAllRouters();
     void startBGP(RoutingProtocol protocolAS1, RoutingProtocol protocolAS2);
     void printAllRoutingTables();
+    void printBGPStatistics() const;
     void setupDirectRoutesForRouters(RoutingProtocol protocol);
     void startEBGP();
     void startIBGP();
 
     void finalizeRoutesAfterDHCP(RoutingProtocol protocol, bool bgp, RoutingProtocol protocolAS1, RoutingProtocol protocolAS2);
     std::vector<QSharedPointer<Router>> getAllRouters() const;
+    std::vector<QSharedPointer<PC>> getAllPCs() const;
     std::vector<QSharedPointer<AutonomousSystem>> getAutonomousSystems() const;
 
+    // Stops every router and PC thread; the nodes stay usable from the calling thread.
+    void shutdown();
+
 private:
     QJsonObject m_config;
+    SimulationContext *m_context;
     std::vector<QSharedPointer<AutonomousSystem>> m_autonomousSystems;
 
     void createAutonomousSystems(const IdAssignment &idAssignment, bool torus);
@@ -0,0 +1,183 @@
+#include <QFile>
+#include <QDebug>
+#include <QSaveFile>
+#include <QDataStream>
+
+#include "Network.h"
+#include "NetworkSnapshot.h"
+#include "../Network/PC.h"
+#include "../Globals/ObjectThread.h"
+
+namespace {
+
+struct RouterRecord
+{
+    qint32 id = -1;
+    QVector<qint32> links;      // Connected router and PC id per port, in port order
+    QByteArray state;
+};
+
+QVector<qint32> linksOf(const QSharedPointer<Router> &router)
+{
+    QVector<qint32> links;
+    for (const auto &port : router->getPorts()) {
+        QSharedPointer<PC> pc = port->getConnectedPC();
+        links << port->getConnectedRouterId() << (pc ? pc->getId() : -1);
+    }
+    return links;
+}
+
+}
+
+bool NetworkSnapshot::save(const QString &path, const Network &network, const QByteArray &fingerprint,
+                           QString *error)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+
+    auto routers = network.getAllRouters();
+    out << quint32(routers.size());
+    for (const auto &router : routers) {
+        QByteArray state;
+        runOnObjectThread(router.data(), [&router, &state]() {
+            QDataStream stateOut(&state, QIODevice::WriteOnly);
+            stateOut.setVersion(QDataStream::Qt_6_0);
+            router->writeState(stateOut);
+        });
+        out << qint32(router->getId()) << linksOf(router) << state;
+    }
+
+    auto pcs = network.getAllPCs();
+    out << quint32(pcs.size());
+    for (const auto &pc : pcs) {
+        out << qint32(pc->getId()) << pc->getIpAddress();
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        *error = file.errorString();
+        return false;
+    }
+    QDataStream header(&file);
+    header.setVersion(QDataStream::Qt_6_0);
+    header << MAGIC << VERSION << fingerprint << qCompress(payload);
+    if (!file.commit()) {
+        *error = file.errorString();
+        return false;
+    }
+    qDebug() << "Network snapshot saved to" << path << ":" << routers.size() << "routers," << pcs.size() << "PCs,"
+             << file.size() << "bytes";
+    return true;
+}
+
+bool NetworkSnapshot::restore(const QString &path, const Network &network, const QByteArray &fingerprint,
+                              QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
+        return false;
+    }
+
+    QDataStream header(&file);
+    header.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0, version = 0;
+    QByteArray savedFingerprint, compressed;
+    header >> magic >> version;
+    if (magic != MAGIC || version != VERSION) {
+        *error = "not a network snapshot, or one from another version";
+        return false;
+    }
+    header >> savedFingerprint >> compressed;
+    if (savedFingerprint != fingerprint) {
+        *error = "taken with a different topology or routing options";
+        return false;
+    }
+
+    QByteArray payload = qUncompress(compressed);
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 count = 0;
+    in >> count;
+    QVector<RouterRecord> records;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        RouterRecord record;
+        in >> record.id >> record.links >> record.state;
+        records.append(record);
+    }
+    QHash<int, QString> pcAddresses;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        qint32 id;
+        QString ip;
+        in >> id >> ip;
+        pcAddresses.insert(id, ip);
+    }
+    if (header.status() != QDataStream::Ok || payload.isEmpty() || in.status() != QDataStream::Ok) {
+        *error = "truncated or corrupt";
+        return false;
+    }
+
+    // Check everything against the live network before touching it.
+    QHash<int, QSharedPointer<Router>> routersById;
+    for (const auto &router : network.getAllRouters()) {
+        routersById.insert(router->getId(), router);
+    }
+    auto pcs = network.getAllPCs();
+    if (records.size() != routersById.size() || pcAddresses.size() != static_cast<int>(pcs.size())) {
+        *error = "node counts differ from this network";
+        return false;
+    }
+    for (const RouterRecord &record : records) {
+        QSharedPointer<Router> router = routersById.value(record.id);
+        if (!router || linksOf(router) != record.links) {
+            *error = QString("port bindings of router %1 differ from this network").arg(record.id);
+            return false;
+        }
+    }
+    for (const auto &pc : pcs) {
+        if (!pcAddresses.contains(pc->getId())) {
+            *error = QString("PC %1 is missing").arg(pc->getId());
+            return false;
+        }
+    }
+
+    // Every router parses its state before any of them applies one, so a corrupt record leaves
+    // the whole network as it was.
+    QVector<RouterState> states(records.size());
+    for (int i = 0; i < records.size(); ++i) {
+        QSharedPointer<Router> router = routersById.value(records[i].id);
+        bool parsed = false;
+        runOnObjectThread(router.data(), [&router, &records, &states, &parsed, i]() {
+            QDataStream stateIn(records[i].state);
+            stateIn.setVersion(QDataStream::Qt_6_0);
+            parsed = router->parseState(stateIn, states[i]);
+        });
+        if (!parsed) {
+            *error = QString("state of router %1 is corrupt").arg(records[i].id);
+            return false;
+        }
+    }
+
+    for (int i = 0; i < records.size(); ++i) {
+        QSharedPointer<Router> router = routersById.value(records[i].id);
+        runOnObjectThread(router.data(), [&router, &states, i]() { router->applyState(states[i]); });
+    }
+    for (const auto &pc : pcs) {
+        pc->setIP(pcAddresses.value(pc->getId()));
+    }
+    // Ports toward PCs keep the PC's address, as set up after a cold DHCP phase.
+    for (const auto &router : routersById) {
+        for (const auto &port : router->getPorts()) {
+            if (QSharedPointer<PC> pc = port->getConnectedPC()) {
+                port->setConnectedRouterIP(pc->getIpAddress());
+            }
+        }
+    }
+
+    qDebug() << "Network snapshot restored from" << path << ":" << records.size() << "routers," << pcs.size()
+             << "PCs";
+    return true;
+}
@@ -0,0 +1,26 @@
+#ifndef NETWORKSNAPSHOT_H
+#define NETWORKSNAPSHOT_H
+
+#include <QString>
+#include <QByteArray>
+
+class Network;
+
+// Converged state of a whole network in a compact binary file, so runs that only change traffic
+// can skip DHCP and routing convergence. It holds every router's state (see Router::writeState),
+// the PCs' addresses and the port bindings. Bindings come from the config and are only checked;
+// the fingerprint, which the caller derives from the topology and routing options, keeps a
+// snapshot from being restored into a different network.
+class NetworkSnapshot
+{
+public:
+    static constexpr quint32 MAGIC = 0x434E534E;    // "CNSN"
+    static constexpr quint32 VERSION = 1;
+
+    static bool save(const QString &path, const Network &network, const QByteArray &fingerprint, QString *error);
+    // The file is checked against the network before any node is changed.
+    static bool restore(const QString &path, const Network &network, const QByteArray &fingerprint,
+                        QString *error);
+};
+
+#endif // NETWORKSNAPSHOT_H
@@ -0,0 +1,224 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "RoutingValidator.h"
+
+namespace {
+constexpr int UNKNOWN = -2;
+constexpr int BLACK_HOLE = -3;
+constexpr int LOOP = -4;
+constexpr int IN_PROGRESS = -5;
+}
+
+struct RoutingValidator::Scratch
+{
+    Scratch(int n, bool cached) : all(cached ? 0 : n), domain(cached ? 0 : n), queue(n), hops(n), firstHop(n)
+    {
+        path.reserve(n);
+    }
+
+    QVector<Distance> all;       // Only used when the distances are not cached
+    QVector<Distance> domain;
+    QVector<int> queue;
+    QVector<int> hops;       // Forwarding hops to the destination, or one of the codes above
+    QVector<int> firstHop;
+    QVector<int> path;
+};
+
+QString RoutingReport::summary() const
+{
+    return QString("%1 pairs, %2 delivered, %3 black holes, %4 loops, %5 wrong next hops, stretch mean %6 max %7")
+        .arg(pairs).arg(delivered).arg(blackHoles).arg(loops).arg(wrongNextHops)
+        .arg(meanStretch(), 0, 'f', 3).arg(maxStretch, 0, 'f', 3);
+}
+
+void RoutingValidator::setTopology(int nodeCount, const QVector<QPair<int, int>> &links, const QVector<int> &domainOf)
+{
+    QVector<int> degree(nodeCount, 0);
+    QVector<QPair<int, int>> edges;
+    edges.reserve(links.size() * 2);
+    for (const auto &[a, b] : links) {
+        if (a < 0 || b < 0 || a >= nodeCount || b >= nodeCount || a == b) continue;
+        edges.append(qMakePair(a, b));
+        edges.append(qMakePair(b, a));
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    for (const auto &edge : edges) {
+        ++degree[edge.first];
+    }
+
+    m_offsets.fill(0, nodeCount + 1);
+    for (int n = 0; n < nodeCount; ++n) {
+        m_offsets[n + 1] = m_offsets[n] + degree[n];
+    }
+    m_targets.resize(edges.size());
+    for (int i = 0; i < edges.size(); ++i) {
+        m_targets[i] = edges[i].second;   // Edges are sorted by source, so rows are already contiguous
+    }
+
+    m_domainOf = domainOf.size() == nodeCount ? domainOf : QVector<int>(nodeCount, 0);
+    m_distances.reset(nodeCount <= MAX_CACHED_NODES ? new DistanceRow[nodeCount] : nullptr);
+}
+
+bool RoutingValidator::isAdjacent(int a, int b) const
+{
+    if (a < 0 || a >= nodeCount()) return false;
+    auto begin = m_targets.constBegin() + m_offsets[a];
+    auto end = m_targets.constBegin() + m_offsets[a + 1];
+    return std::binary_search(begin, end, b);
+}
+
+void RoutingValidator::bfs(int source, bool sameDomainOnly, Distance *distance, QVector<int> &queue) const
+{
+    std::fill(distance, distance + nodeCount(), UNREACHABLE);
+    int head = 0;
+    int tail = 0;
+    distance[source] = 0;
+    queue[tail++] = source;
+
+    while (head < tail) {
+        int current = queue[head++];
+        for (int i = m_offsets[current]; i < m_offsets[current + 1]; ++i) {
+            int next = m_targets[i];
+            if (distance[next] != UNREACHABLE || (sameDomainOnly && m_domainOf[next] != m_domainOf[source])) continue;
+            distance[next] = distance[current] + 1;
+            queue[tail++] = next;
+        }
+    }
+}
+
+void RoutingValidator::checkDestination(int destination, const NextHopFn &nextHop, Scratch &scratch,
+                                        RoutingReport &report) const
+{
+    // Links are symmetric, so distances from the destination are distances to it.
+    int n = nodeCount();
+    const Distance *all = scratch.all.constData();
+    const Distance *domain = scratch.domain.constData();
+    if (m_distances) {
+        DistanceRow &row = m_distances[destination];
+        std::call_once(row.once, [&]() {
+            row.all.resize(n);
+            row.domain.resize(n);
+            bfs(destination, false, row.all.data(), scratch.queue);
+            bfs(destination, true, row.domain.data(), scratch.queue);
+        });
+        all = row.all.data();
+        domain = row.domain.data();
+    } else {
+        bfs(destination, false, scratch.all.data(), scratch.queue);
+        bfs(destination, true, scratch.domain.data(), scratch.queue);
+    }
+
+    scratch.hops.fill(UNKNOWN);
+    scratch.firstHop.fill(-1);
+    scratch.hops[destination] = 0;
+
+    auto sample = [&report](const QString &text) {
+        if (report.samples.size() < MAX_SAMPLES) {
+            report.samples.append(text);
+        }
+    };
+
+    for (int source = 0; source < n; ++source) {
+        if (source == destination || all[source] == UNREACHABLE) continue;
+
+        bool sameDomain = m_domainOf[source] == m_domainOf[destination];
+        if (!m_interDomain && !sameDomain) continue;
+
+        // Follow next hops until reaching a node whose outcome is known, then unwind.
+        int current = source;
+        int outcome = 0;
+        scratch.path.clear();
+        while (scratch.hops[current] == UNKNOWN) {
+            scratch.hops[current] = IN_PROGRESS;
+            scratch.path.append(current);
+            int hop = nextHop(current, destination);
+            scratch.firstHop[current] = hop;
+            if (hop < 0 || !isAdjacent(current, hop)) {
+                outcome = BLACK_HOLE;
+                break;
+            }
+            current = hop;
+        }
+        if (outcome == 0) {
+            outcome = scratch.hops[current] == IN_PROGRESS ? LOOP : scratch.hops[current];
+        }
+        for (int i = scratch.path.size() - 1; i >= 0; --i) {
+            if (outcome >= 0) {
+                ++outcome;
+            }
+            scratch.hops[scratch.path[i]] = outcome;
+        }
+
+        ++report.pairs;
+        int hops = scratch.hops[source];
+        if (hops == BLACK_HOLE) {
+            ++report.blackHoles;
+            sample(QString("%1 -> %2: black hole").arg(source).arg(destination));
+        } else if (hops == LOOP) {
+            ++report.loops;
+            sample(QString("%1 -> %2: forwarding loop").arg(source).arg(destination));
+        } else {
+            ++report.delivered;
+            int shortest = sameDomain && domain[source] != UNREACHABLE ? domain[source] : all[source];
+            double stretch = static_cast<double>(hops) / shortest;
+            report.totalStretch += stretch;
+            report.maxStretch = qMax(report.maxStretch, stretch);
+        }
+
+        int hop = scratch.firstHop[source];
+        if (sameDomain && domain[source] != UNREACHABLE && domain[source] > 0 && hop >= 0 && hop < n &&
+            domain[hop] != domain[source] - 1) {
+            ++report.wrongNextHops;
+            sample(QString("%1 -> %2: next hop %3 is not on a shortest path").arg(source).arg(destination).arg(hop));
+        }
+    }
+}
+
+RoutingReport RoutingValidator::validate(const NextHopFn &nextHop, int threads) const
+{
+    int n = nodeCount();
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    threads = qBound(1, threads, qMax(1, n));
+
+    std::atomic<int> nextDestination {0};
+    std::vector<RoutingReport> partial(threads);
+    auto work = [&](int worker) {
+        Scratch scratch(n, m_distances != nullptr);
+        for (int destination = nextDestination++; destination < n; destination = nextDestination++) {
+            checkDestination(destination, nextHop, scratch, partial[worker]);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int worker = 1; worker < threads; ++worker) {
+        workers.emplace_back(work, worker);
+    }
+    work(0);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    RoutingReport report;
+    for (const RoutingReport &part : partial) {
+        report.pairs += part.pairs;
+        report.delivered += part.delivered;
+        report.blackHoles += part.blackHoles;
+        report.loops += part.loops;
+        report.wrongNextHops += part.wrongNextHops;
+        report.totalStretch += part.totalStretch;
+        report.maxStretch = qMax(report.maxStretch, part.maxStretch);
+        for (const QString &text : part.samples) {
+            if (report.samples.size() < MAX_SAMPLES) {
+                report.samples.append(text);
+            }
+        }
+    }
+    return report;
+}
@@ -0,0 +1,80 @@
+#ifndef ROUTINGVALIDATOR_H
+#define ROUTINGVALIDATOR_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <functional>
+#include <QPair>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+
+struct RoutingReport
+{
+    qint64 pairs = 0;
+    qint64 delivered = 0;
+    qint64 blackHoles = 0;      // A router on the way has no usable next hop
+    qint64 loops = 0;
+    qint64 wrongNextHops = 0;   // Next hop not on any shortest path inside the domain
+    double totalStretch = 0;    // Forwarding hops / shortest hops, summed over delivered pairs
+    double maxStretch = 0;
+    QStringList samples;        // First failures, for the log
+
+    double meanStretch() const { return delivered > 0 ? totalStretch / delivered : 0; }
+    bool isClean() const { return blackHoles == 0 && loops == 0 && wrongNextHops == 0; }
+    QString summary() const;
+};
+
+// Ground truth for the forwarding tables. Node ids are dense (0..nodeCount-1, below 65535) and links
+// undirected; the adjacency is kept in compressed sparse row form. validate() runs one BFS per
+// destination, spread over worker threads, and follows every source's next hops toward it once,
+// sharing the common path suffixes, so a full check costs O(N * (N + E)) time and O(N) memory per
+// thread. The BFS distances only depend on the topology, so up to MAX_CACHED_NODES nodes they are
+// kept (4 * N^2 bytes) until the next setTopology() and later checks only walk the next hops.
+class RoutingValidator
+{
+public:
+    static constexpr int MAX_SAMPLES = 10;
+    static constexpr int MAX_CACHED_NODES = 4096;
+
+    // Next hop node that node uses toward destination, or -1 without a route. Called from
+    // several threads at once.
+    using NextHopFn = std::function<int(int node, int destination)>;
+
+    // domainOf assigns each node a routing domain; empty means one domain. Inside a domain next
+    // hops must lie on a shortest path; between domains only delivery is required, unless
+    // interDomain is false, in which case those pairs are skipped.
+    void setTopology(int nodeCount, const QVector<QPair<int, int>> &links, const QVector<int> &domainOf = {});
+    void setInterDomain(bool interDomain) { m_interDomain = interDomain; }
+
+    RoutingReport validate(const NextHopFn &nextHop, int threads = 0) const;
+
+    int nodeCount() const { return m_offsets.isEmpty() ? 0 : m_offsets.size() - 1; }
+    bool isAdjacent(int a, int b) const;
+
+private:
+    using Distance = quint16;
+    static constexpr Distance UNREACHABLE = 0xFFFF;
+
+    // Hop distances to one destination, over all links and within its domain. Filled by the first
+    // validate() that checks the destination.
+    struct DistanceRow
+    {
+        std::once_flag once;
+        std::vector<Distance> all;
+        std::vector<Distance> domain;
+    };
+
+    struct Scratch;
+    void checkDestination(int destination, const NextHopFn &nextHop, Scratch &scratch, RoutingReport &report) const;
+    void bfs(int source, bool sameDomainOnly, Distance *distance, QVector<int> &queue) const;
+
+    QVector<int> m_offsets;    // Neighbours of n are m_targets[m_offsets[n] .. m_offsets[n + 1])
+    QVector<int> m_targets;
+    QVector<int> m_domainOf;
+    bool m_interDomain = true;
+    std::unique_ptr<DistanceRow[]> m_distances;    // Per destination; null above MAX_CACHED_NODES
+};
+
+#endif // ROUTINGVALIDATOR_H
@@ -1,21 +1,31 @@
 #include <QFile>
 #include <QDebug>
 #include <QThread>
+#include <random>
 #include <iostream>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QCoreApplication>
-#include <RouterRegistry.h>
+#include <QCryptographicHash>
 #include <QRegularExpression>
 #include <QCommandLineParser>
 #include <QCommandLineOption>
 
 #include "Simulator.h"
+#include "DHCPPhaseTracker.h"
+#include "NetworkSnapshot.h"
+#include "Topology/NetworkImage.h"
+#include "ConvergenceOracle.h"
 #include "EventsCoordinator/EventsCoordinator.h"
+#include "DataGenerator/ArrivalProcess.h"
+#include "../Logger/Logger.h"
+#include "../Globals/RandomStream.h"
+#include "../Globals/SimulationContext.h"
 
 Simulator::Simulator(QObject *parent)
-    : QObject(parent)
+    : QObject(parent),
+    m_context(QSharedPointer<SimulationContext>::create())
 {}
 
 Simulator::~Simulator()
@@ -40,11 +50,50 @@ bool Simulator::loadConfig(const QString &configFilePath)
         return false;
     }
 
-    m_config = doc.object();
+    return applyConfig(doc.object(), configFilePath);
+}
+
+bool Simulator::applyConfig(const QJsonObject &config, const QString &sourcePath)
+{
+    m_config = config;
+    m_configPath = sourcePath;
 
     QString cycleDurationStr = m_config.value("cycle_duration").toString("100ms");
     m_cycleDuration = parseDuration(cycleDurationStr);
 
+    QString trafficDurationStr = m_config.value("traffic_duration").toString(
+        m_config.value("simulation_duration").toString("60s"));
+    m_trafficDuration = parseDuration(trafficDurationStr);
+
+    m_dhcpTimeout = parseDuration(m_config.value("dhcp_timeout").toString("10s"));
+    m_drainTimeout = parseDuration(m_config.value("drain_timeout").toString("30s"));
+
+    QJsonValue seedValue = m_config.value("seed");
+    if (seedValue.isString()) {
+        m_context->setSeed(seedValue.toString().toULongLong());
+    } else if (seedValue.isDouble()) {
+        m_context->setSeed(static_cast<quint64>(seedValue.toDouble()));
+    } else {
+        std::random_device rd;
+        m_context->setSeed((static_cast<quint64>(rd()) << 32) | rd());
+    }
+    qDebug() << "Random seed:" << m_context->seed();
+
+    m_context->setLogDirectory(m_config.value("log_directory").toString(m_context->logDirectory()));
+    m_snapshotPath = m_config.value("snapshot_file").toString();
+    m_warmStartPath = m_config.value("warm_start_file").toString();
+    m_imagePath = m_config.value("image_file").toString();
+
+    // Arrival processes are only built when traffic starts; refuse the ones that cannot be up front.
+    const double cycleSeconds = static_cast<double>(std::max<qint64>(m_cycleDuration.count(), 1)) / 1000.0;
+    for (const QJsonValue &model : m_config.value("traffic_models").toArray()) {
+        QString error;
+        if (!ArrivalProcess::checkConfig(model.toObject(), cycleSeconds, &error)) {
+            qWarning() << "Invalid traffic model:" << error;
+            return false;
+        }
+    }
+
     preAssignIDs();
 
     return true;
@@ -122,23 +171,25 @@ void Simulator::preAssignIDs()
 
 void Simulator::initializeNetwork()
 {
-    m_network = QSharedPointer<Network>::create(m_config);
+    m_runClock.start();
+    m_network = QSharedPointer<Network>::create(m_config, m_context.data());
     m_network->initialize(m_idAssignment, addTorus);
 
     m_metricsCollector = QSharedPointer<MetricsCollector>::create();
 
     auto allRouters = m_network->getAllRouters();
-    auto eventsCoordinator = EventsCoordinator::instance();
+    auto eventsCoordinator = m_context->events();
+    int bufferSize = m_config.value("router_buffer_size").toInt(10);
     for (const auto &router : allRouters) {
         eventsCoordinator->addRouter(router);
         router->initialize();
         router->setMetricsCollector(m_metricsCollector);
+        router->setBufferSize(bufferSize);
     }
 
     connect(eventsCoordinator, &EventsCoordinator::convergenceDetected, this, &Simulator::onConvergenceDetected);
 
-    m_dataGenerator = QSharedPointer<DataGenerator>::create();
-    m_dataGenerator->setLambda(1.0);
+    m_dataGenerator = QSharedPointer<DataGenerator>::create(m_context.data());
 
     std::vector<QSharedPointer<PC>> allPCs;
     for (const auto &asInstance : m_network->getAutonomousSystems()) {
@@ -147,21 +198,28 @@ void Simulator::initializeNetwork()
     }
 
     m_dataGenerator->setSenders(allPCs);
-    QString filePath = ":/configs/mainConfig/config.json";
-    m_dataGenerator->loadConfig(filePath);
+    m_dataGenerator->setCycleDuration(m_cycleDuration);
+    m_dataGenerator->setTrafficDuration(m_trafficDuration);
+    m_dataGenerator->loadConfig(m_config);
 
     for (const auto &pc : allPCs) {
         pc->setMetricsCollector(m_metricsCollector);
     }
 
-    connect(m_dataGenerator.data(), &DataGenerator::packetsGenerated, this, &Simulator::handleGeneratedPackets);
+    eventsCoordinator->setDataGenerator(m_dataGenerator.data());
+    connect(eventsCoordinator, &EventsCoordinator::packetsInjected, this, &Simulator::handleGeneratedPackets);
+    connect(eventsCoordinator, &EventsCoordinator::trafficDrained, this, &Simulator::onTrafficDrained);
 }
 
 void Simulator::handleGeneratedPackets(const std::vector<QSharedPointer<Packet>> &packets)
 {
-    qDebug() << "Simulator received" << packets.size() << "generated packets.";
+    LOG_TRACE(Forwarding) << "Simulator received" << packets.size() << "generated packets.";
 
     for (const auto &packet : packets) {
+        // Packets that cannot leave their sender count as sent and dropped, which keeps
+        // packetsInFlight() exact for the end of the traffic phase.
+        m_metricsCollector->recordPacketSent();
+
         if (packet->getPath().size() < 2) {
             qWarning() << "Simulator: Packet" << packet->getId() << "has insufficient path information.";
             m_metricsCollector->recordPacketDropped();
@@ -171,13 +229,7 @@ void Simulator::handleGeneratedPackets(const std::vector<QSharedPointer<Packet>>
         QString senderIP = packet->getPath().at(0);
         QString destinationIP = packet->getPath().at(1);
 
-        QSharedPointer<PC> sender = nullptr;
-        for (const auto &pc : m_dataGenerator->getSenders()) {
-            if (pc->getIpAddress() == senderIP) {
-                sender = pc;
-                break;
-            }
-        }
+        QSharedPointer<PC> sender = m_pcsByIp.value(senderIP);
 
         if (!sender) {
             qWarning() << "Simulator: Sender PC with IP" << senderIP << "not found.";
@@ -188,8 +240,7 @@ void Simulator::handleGeneratedPackets(const std::vector<QSharedPointer<Packet>>
         auto port = sender->getPort();
         if (port) {
             port->sendPacket(packet);
-            qDebug() << "Simulator: Packet" << packet->getId() << "sent from PC" << sender->getId() << "to" << destinationIP;
-            m_metricsCollector->recordPacketSent();
+            LOG_TRACE(Forwarding) << "Simulator: Packet" << packet->getId() << "sent from PC" << sender->getId() << "to" << destinationIP;
         } else {
             qWarning() << "Simulator: Sender PC" << sender->getId() << "has no available port.";
             m_metricsCollector->recordPacketDropped();
@@ -205,32 +256,78 @@ void Simulator::startSimulation()
     RoutingProtocol protocol = (mainAlgo == 1) ? RoutingProtocol::RIP : RoutingProtocol::OSPF;
     qDebug() << "Simulation initialized. Network topology is set up.";
 
-    // Initiate DHCP Phase for routers
-    initiateDHCPPhase();
-    QThread::sleep(5);
-
-    // Initiate DHCP Phase for PCs
-    if (m_network) {
-        m_network->initiateDHCPPhaseForPC();
+    QString traceFile = m_config.value("trace_file").toString();
+    if (!traceFile.isEmpty()) {
+        m_context->startEventTrace(traceFile, static_cast<quint64>(m_config.value("trace_capacity_records").toDouble(1 << 22)));
+    }
+    QString timelineFile = m_config.value("timeline_file").toString();
+    if (!timelineFile.isEmpty()) {
+        m_context->startTimeline(timelineFile, static_cast<quint64>(m_config.value("timeline_max_events").toDouble(1 << 20)));
     }
-    QThread::sleep(5);
 
-    // Check the assigned IP's
-    checkAssignedIP();
+    // A warm start takes addresses and routes from an earlier run instead of DHCP and convergence.
+    m_warmStarted = !m_warmStartPath.isEmpty() && restoreSnapshot();
+    if (!m_warmStarted) {
+        // Initiate DHCP Phase for routers; relays learn their path to the server from these offers
+        DHCPPhaseTracker routerLeases;
+        if (m_network) {
+            for (const auto &router : m_network->getAllRouters()) {
+                if (!router->isBroken() && !router->isDHCPServer()) {
+                    routerLeases.track(router.data());
+                }
+            }
+        }
+        initiateDHCPPhase();
+        routerLeases.waitForCompletion(static_cast<int>(m_dhcpTimeout.count()));
 
-    // Check the assigned IP's for PCs
-    checkAssignedIPPC();
+        // Initiate DHCP Phase for PCs
+        DHCPPhaseTracker pcLeases;
+        if (m_network) {
+            for (const auto &pc : m_network->getAllPCs()) {
+                pcLeases.track(pc.data());
+            }
+            m_network->initiateDHCPPhaseForPC();
+        }
+        pcLeases.waitForCompletion(static_cast<int>(m_dhcpTimeout.count()));
 
-    printTopologyVisualization();
+        // Check the assigned IP's
+        checkAssignedIP();
 
-    // Now we know all routers have IP addresses assigned, so we can setup direct routes:
-    if (m_network) {
-        m_network->setupDirectRoutesForRouters(protocol);
-        m_network->finalizeRoutesAfterDHCP(protocol, useBGP, protocolAS1, protocolAS2);
+        // Check the assigned IP's for PCs
+        checkAssignedIPPC();
+
+        if (!m_batch) {
+            printTopologyVisualization();
+        }
+
+        // Now we know all routers have IP addresses assigned, so we can setup direct routes:
+        if (m_network) {
+            m_network->setupDirectRoutesForRouters(protocol);
+            m_network->finalizeRoutesAfterDHCP(protocol, useBGP, protocolAS1, protocolAS2);
+        }
+    }
+
+    auto eventsCoordinator = m_context->events();
+    eventsCoordinator->setConvergenceWindow(
+        m_config.value("convergence_stable_ticks").toInt(ConvergenceDetector::DEFAULT_STABLE_TICKS));
+    if (m_network && m_config.value("convergence_oracle").toBool(false)) {
+        // With BGP each AS runs its own interior protocol and BGP only starts once those converge;
+        // without it the whole network is one domain.
+        QVector<std::vector<QSharedPointer<Router>>> domains;
+        if (useBGP) {
+            for (const auto &asInstance : m_network->getAutonomousSystems()) {
+                domains.append(asInstance->getRouters());
+            }
+        } else {
+            domains.append(m_network->getAllRouters());
+        }
+        m_convergenceOracle = QSharedPointer<ConvergenceOracle>::create(m_context->topology(), domains, !useBGP);
+        QSharedPointer<ConvergenceOracle> oracle = m_convergenceOracle;
+        eventsCoordinator->setConvergenceOracle([oracle]() { return oracle->startCheck(); });
     }
 
     // Start the event coordinator clock so RIP ticks can begin
-    EventsCoordinator::instance()->startClock(m_cycleDuration);
+    eventsCoordinator->startClock(m_cycleDuration);
 
     // Enable RIP on all routers
     if (m_network) {
@@ -242,57 +339,188 @@ void Simulator::startSimulation()
             m_network->enableOSPFOnAllRouters();
         }
     }
+
+    if (m_batch && m_timeLimit.count() > 0) {
+        qint64 remaining = qMax<qint64>(0, m_timeLimit.count() - m_runClock.elapsed());
+        QTimer::singleShot(static_cast<int>(remaining), this, [this]() { finishBatch(ExitTimeLimit); });
+    }
+
+    if (m_warmStarted) {
+        m_convergenceTick = 0;
+        validateRoutes();
+        initiatePacketSending();
+    }
 }
 
-void Simulator::onConvergenceDetected()
+void Simulator::validateRoutes()
 {
-    qDebug() << "Convergence detected. Preparing to print all routing tables:";
-
-    auto executeConvergenceActions = [this]() {
-        if (m_network) {
-            m_network->printAllRoutingTables();
-        }
+    if (!m_convergenceOracle) {
+        return;
+    }
+    m_convergenceOracle->verify();
+    RoutingReport report = m_convergenceOracle->lastReport();
+    qDebug() << "Routing validation:" << report.summary();
+    for (const QString &failure : report.samples) {
+        qDebug() << "  " << failure;
+    }
+}
 
-        qDebug() << "Proceeding with further steps.";
+QByteArray Simulator::snapshotFingerprint() const
+{
+    QJsonObject key;
+    key["Autonomous_systems"] = m_config.value("Autonomous_systems");
+    key["bgp"] = useBGP;
+    key["main_algo"] = mainAlgo;
+    key["first_as_algo"] = firstASAlgo;
+    key["second_as_algo"] = secondASAlgo;
+    key["torus"] = addTorus;
+    return QCryptographicHash::hash(QJsonDocument(key).toJson(QJsonDocument::Compact), QCryptographicHash::Sha1);
+}
 
-        auto eventsCoordinator = EventsCoordinator::instance();
-        eventsCoordinator->quit();
-        eventsCoordinator->wait();
+bool Simulator::restoreSnapshot()
+{
+    QString error;
+    if (!m_network || !NetworkSnapshot::restore(m_warmStartPath, *m_network, snapshotFingerprint(), &error)) {
+        qWarning() << "Cannot warm start from" << m_warmStartPath << ":" << error << "- converging from scratch.";
+        return false;
+    }
+    return true;
+}
 
-        qDebug() << "EventsCoordinator stopped. Ready for next actions.";
+void Simulator::writeImage()
+{
+    QString error;
+    if (!NetworkImage::write(m_imagePath, m_network->getAllRouters(), m_network->getAllPCs(),
+                             m_config.value("image_fibs").toBool(true), &error)) {
+        qWarning() << "Cannot write network image to" << m_imagePath << ":" << error;
+    }
+}
 
-        initiatePacketSending();
+void Simulator::saveSnapshot()
+{
+    QString error;
+    if (!NetworkSnapshot::save(m_snapshotPath, *m_network, snapshotFingerprint(), &error)) {
+        qWarning() << "Cannot save network snapshot to" << m_snapshotPath << ":" << error;
+    }
+}
 
-        QTimer::singleShot(5000, this, [this]() {
-            if (m_metricsCollector) {
-                m_metricsCollector->printStatistics();
-            }
-        });
-    };
+void Simulator::onConvergenceDetected()
+{
+    if (m_trafficStarted) {
+        return;
+    }
 
-    if (useBGP) {
-        qDebug() << "BGP is enabled. Delaying execution of convergence actions.";
-        m_network->startEBGP();
-        QTimer::singleShot(3000, this, [this]() {
+    auto eventsCoordinator = m_context->events();
+    qDebug() << "Convergence detected: routing tables last changed at tick" << eventsCoordinator->convergenceTick();
+
+    // With BGP, eBGP starts once the interior protocols have converged and iBGP once eBGP has.
+    // Best-path changes move the RIB versions too, so each stage ends on its own detection. The
+    // oracle only knows the interior domains and would pass at once, so these stages rely on the
+    // stability window.
+    if (useBGP && m_network && m_bgpStage != BgpStage::Internal) {
+        eventsCoordinator->restartConvergence(false);
+        if (m_bgpStage == BgpStage::None) {
+            qDebug() << "Interior routing converged. Starting eBGP.";
+            m_bgpStage = BgpStage::External;
+            m_network->startEBGP();
+        } else {
+            qDebug() << "eBGP converged. Starting iBGP.";
+            m_bgpStage = BgpStage::Internal;
             m_network->startIBGP();
-        });
-        QTimer::singleShot(5000, this, executeConvergenceActions);
+        }
+        return;
     }
-    else {
-        executeConvergenceActions();
-        qDebug() << "BGP is not enabled. Executing convergence actions immediately.";
+
+    m_convergenceTick = eventsCoordinator->convergenceTick();
+    emit convergenceReached();
+
+    if (m_network) {
+        m_network->printAllRoutingTables();
+        if (useBGP) {
+            m_network->printBGPStatistics();
+        }
     }
+
+    validateRoutes();
+    if (m_network && !m_snapshotPath.isEmpty()) {
+        saveSnapshot();
+    }
+    if (m_network && !m_imagePath.isEmpty()) {
+        writeImage();
+    }
+
+    qDebug() << "Routing converged at tick" << m_convergenceTick << ". Starting the traffic phase.";
+    initiatePacketSending();
 }
 
 void Simulator::initiatePacketSending()
 {
     qDebug() << "Initiating packet sending based on updated routing tables.";
 
-    if (m_dataGenerator) {
-        m_dataGenerator->generatePackets();
-        qDebug() << "DataGenerator has been instructed to generate packets.";
-    } else {
+    if (!m_dataGenerator) {
         qWarning() << "DataGenerator not initialized. Cannot generate packets.";
+        return;
+    }
+
+    m_trafficStarted = true;
+
+    m_pcsByIp.clear();
+    for (const auto &pc : m_dataGenerator->getSenders()) {
+        m_pcsByIp.insert(pc->getIpAddress(), pc);
+    }
+
+    if (!m_dataGenerator->startTraffic()) {
+        onTrafficDrained();
+        return;
+    }
+    qDebug() << "DataGenerator will inject traffic on every tick.";
+
+    m_context->events()->startClock(m_cycleDuration);
+}
+
+void Simulator::onTrafficDrained()
+{
+    qDebug() << "All traffic has been injected. Waiting for in-flight packets.";
+
+    // Polled once per cycle: the phase ends when every sent packet was delivered or dropped.
+    m_drainClock.start();
+    if (!m_drainTimer) {
+        m_drainTimer = new QTimer(this);
+        connect(m_drainTimer, &QTimer::timeout, this, &Simulator::checkTrafficDrained);
+    }
+    m_drainTimer->start(static_cast<int>(m_cycleDuration.count()));
+    checkTrafficDrained();
+}
+
+void Simulator::checkTrafficDrained()
+{
+    int inFlight = m_metricsCollector ? m_metricsCollector->packetsInFlight() : 0;
+    if (inFlight > 0 && m_drainClock.elapsed() < m_drainTimeout.count()) {
+        return;
+    }
+    if (inFlight > 0) {
+        qWarning() << "Gave up waiting for" << inFlight << "in-flight packets after" << m_drainTimeout.count() << "ms.";
+    }
+    finishTraffic();
+}
+
+void Simulator::finishTraffic()
+{
+    if (m_trafficFinished) {
+        return;
+    }
+    m_trafficFinished = true;
+    m_drainTimer->stop();
+
+    m_context->events()->stopClock();
+    if (m_metricsCollector) {
+        m_metricsCollector->printStatistics();
+    }
+    m_context->stopTraces();
+    emit simulationFinished();
+    if (m_batch) {
+        bool routesValid = !m_convergenceOracle || m_convergenceOracle->lastReport().isClean();
+        finishBatch(routesValid ? ExitOk : ExitRoutesInvalid);
     }
 }
 
@@ -321,45 +549,100 @@ void Simulator::checkAssignedIPPC() {
     }
 }
 
-bool Simulator::configureFromCommandLine(const QStringList& arguments)
+void Simulator::addCommandLineOptions(QCommandLineParser &parser)
 {
-    QCommandLineParser parser;
     parser.setApplicationDescription("UT Network Simulator");
     parser.addHelpOption();
 
-    QCommandLineOption bgpOption(QStringList() << "b" << "bgp",
-                                 "Enable BGP (yes/no).",
-                                 "bgp");
-    QCommandLineOption firstASAlgoOption(QStringList() << "f" << "first-as-algo",
-                                         "First AS algorithm (1 for RIP, 2 for OSPF).",
-                                         "first-as-algo");
-    QCommandLineOption secondASAlgoOption(QStringList() << "s" << "second-as-algo",
-                                          "Second AS algorithm (1 for RIP, 2 for OSPF).",
-                                          "second-as-algo");
-    QCommandLineOption mainAlgoOption(QStringList() << "m" << "main-algo",
-                                      "Main routing algorithm (1 for RIP, 2 for OSPF).",
-                                      "main-algo");
-    QCommandLineOption torusOption(QStringList() << "t" << "torus",
-                                   "Add torus topology (yes/no).",
-                                   "torus");
-
-    parser.addOption(bgpOption);
-    parser.addOption(firstASAlgoOption);
-    parser.addOption(secondASAlgoOption);
-    parser.addOption(mainAlgoOption);
-    parser.addOption(torusOption);
+    parser.addOption(QCommandLineOption(QStringList() << "b" << "bgp",
+                                        "Enable BGP (yes/no).",
+                                        "bgp"));
+    parser.addOption(QCommandLineOption(QStringList() << "f" << "first-as-algo",
+                                        "First AS algorithm (1 for RIP, 2 for OSPF).",
+                                        "first-as-algo"));
+    parser.addOption(QCommandLineOption(QStringList() << "s" << "second-as-algo",
+                                        "Second AS algorithm (1 for RIP, 2 for OSPF).",
+                                        "second-as-algo"));
+    parser.addOption(QCommandLineOption(QStringList() << "m" << "main-algo",
+                                        "Main routing algorithm (1 for RIP, 2 for OSPF).",
+                                        "main-algo"));
+    parser.addOption(QCommandLineOption(QStringList() << "t" << "torus",
+                                        "Add torus topology (yes/no).",
+                                        "torus"));
+    parser.addOption(QCommandLineOption(QStringList() << "seed",
+                                        "Seed for every random stream; the same seed reproduces a run.",
+                                        "seed"));
+    parser.addOption(QCommandLineOption(QStringList() << "batch",
+                                        "Never prompt: routing options missing from the command line come from the "
+                                        "config's \"routing\" block. Exits after the traffic phase with a JSON summary."));
+    parser.addOption(QCommandLineOption(QStringList() << "config",
+                                        "Configuration file to load instead of the built-in one.",
+                                        "path"));
+    parser.addOption(QCommandLineOption(QStringList() << "summary",
+                                        "Write the batch summary to this file instead of stdout.",
+                                        "file"));
+    parser.addOption(QCommandLineOption(QStringList() << "time-limit",
+                                        "Give up a batch run after this long, e.g. 90s or 5min (\"batch_time_limit\").",
+                                        "duration"));
+    parser.addOption(QCommandLineOption(QStringList() << "save-snapshot",
+                                        "Save the converged network to this file before the traffic phase "
+                                        "(\"snapshot_file\").",
+                                        "file"));
+    parser.addOption(QCommandLineOption(QStringList() << "warm-start",
+                                        "Restore the converged network from a snapshot of the same topology and "
+                                        "routing options, skipping DHCP and convergence (\"warm_start_file\").",
+                                        "file"));
+    parser.addOption(QCommandLineOption(QStringList() << "write-image",
+                                        "Write the converged topology, addresses and forwarding tables as a "
+                                        "memory-mappable network image (\"image_file\").",
+                                        "file"));
+}
 
+bool Simulator::configureFromCommandLine(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    addCommandLineOptions(parser);
     parser.process(arguments);
+    return configure(parser);
+}
+
+bool Simulator::configure(const QCommandLineParser &parser)
+{
+
+    if (parser.isSet("seed")) {
+        bool ok;
+        quint64 seed = parser.value("seed").toULongLong(&ok);
+        if (ok) {
+            m_context->setSeed(seed);
+            qDebug() << "Random seed:" << seed;
+        } else {
+            qWarning() << "Invalid value for seed option. Keeping seed" << m_context->seed();
+        }
+    }
+    if (parser.isSet("save-snapshot")) {
+        m_snapshotPath = parser.value("save-snapshot");
+    }
+    if (parser.isSet("warm-start")) {
+        m_warmStartPath = parser.value("warm-start");
+    }
+    if (parser.isSet("write-image")) {
+        m_imagePath = parser.value("write-image");
+    }
+
+    m_batch = parser.isSet("batch");
+    if (m_batch) {
+        return configureBatch(parser);
+    }
 
     bool argumentsProvided = false;
 
-    if (parser.isSet(bgpOption) || parser.isSet(firstASAlgoOption) ||
-       parser.isSet(secondASAlgoOption) || parser.isSet(mainAlgoOption) ||
-       parser.isSet(torusOption)) {
+    if (parser.isSet("bgp") || parser.isSet("first-as-algo") ||
+       parser.isSet("second-as-algo") || parser.isSet("main-algo") ||
+       parser.isSet("torus")) {
         argumentsProvided = true;
 
-        if (parser.isSet(bgpOption)) {
-            QString bgpValue = parser.value(bgpOption).toLower();
+        if (parser.isSet("bgp")) {
+            QString bgpValue = parser.value("bgp").toLower();
             if (bgpValue == "yes" || bgpValue == "y") {
                 setUseBGP(true);
             } else if (bgpValue == "no" || bgpValue == "n") {
@@ -373,9 +656,9 @@ bool Simulator::configureFromCommandLine(const QStringList& arguments)
         }
 
         if (useBGP) {
-            if (parser.isSet(firstASAlgoOption)) {
+            if (parser.isSet("first-as-algo")) {
                 bool ok;
-                int algo = parser.value(firstASAlgoOption).toInt(&ok);
+                int algo = parser.value("first-as-algo").toInt(&ok);
                 if (ok && (algo == 1 || algo == 2)) {
                     setFirstASAlgo(algo);
                 } else {
@@ -387,9 +670,9 @@ bool Simulator::configureFromCommandLine(const QStringList& arguments)
                 setFirstASAlgo(0);
             }
 
-            if (parser.isSet(secondASAlgoOption)) {
+            if (parser.isSet("second-as-algo")) {
                 bool ok;
-                int algo = parser.value(secondASAlgoOption).toInt(&ok);
+                int algo = parser.value("second-as-algo").toInt(&ok);
                 if (ok && (algo == 1 || algo == 2)) {
                     setSecondASAlgo(algo);
                 } else {
@@ -401,9 +684,9 @@ bool Simulator::configureFromCommandLine(const QStringList& arguments)
                 setSecondASAlgo(0);
             }
         } else {
-            if (parser.isSet(mainAlgoOption)) {
+            if (parser.isSet("main-algo")) {
                 bool ok;
-                int algo = parser.value(mainAlgoOption).toInt(&ok);
+                int algo = parser.value("main-algo").toInt(&ok);
                 if (ok && (algo == 1 || algo == 2)) {
                     setMainAlgo(algo);
                 } else {
@@ -416,8 +699,8 @@ bool Simulator::configureFromCommandLine(const QStringList& arguments)
             }
         }
 
-        if (parser.isSet(torusOption)) {
-            QString torusValue = parser.value(torusOption).toLower();
+        if (parser.isSet("torus")) {
+            QString torusValue = parser.value("torus").toLower();
             if (torusValue == "yes" || torusValue == "y") {
                 setAddTorus(true);
             } else if (torusValue == "no" || torusValue == "n") {
@@ -494,6 +777,145 @@ int Simulator::promptForAlgorithm(const QString& prompt)
     }
 }
 
+namespace {
+
+// Command line first, then the config's routing block; empty when neither sets it.
+QString batchValue(const QCommandLineParser &parser, const QJsonObject &routing, const QString &option, const QString &key)
+{
+    if (parser.isSet(option)) {
+        return parser.value(option).trimmed().toLower();
+    }
+    QJsonValue value = routing.value(key);
+    if (value.isBool()) {
+        return value.toBool() ? "yes" : "no";
+    }
+    if (value.isDouble()) {
+        return QString::number(value.toInt());
+    }
+    return value.toString().trimmed().toLower();
+}
+
+const char *algorithmName(int algo)
+{
+    return algo == 1 ? "rip" : algo == 2 ? "ospf" : "none";
+}
+
+}
+
+bool Simulator::configureBatch(const QCommandLineParser &parser)
+{
+    QJsonObject routing = m_config.value("routing").toObject();
+
+    auto yesNo = [&](const QString &option, const QString &key, bool &result) {
+        QString value = batchValue(parser, routing, option, key);
+        if (value == "yes" || value == "y") {
+            result = true;
+        } else if (value == "no" || value == "n") {
+            result = false;
+        } else {
+            qCritical() << "Batch mode:" << option << "must be yes or no (--" + option + " or routing." + key + "), got"
+                        << value;
+            return false;
+        }
+        return true;
+    };
+    auto algorithm = [&](const QString &option, const QString &key, int &result) {
+        QString value = batchValue(parser, routing, option, key);
+        if (value == "1" || value == "rip") {
+            result = 1;
+        } else if (value == "2" || value == "ospf") {
+            result = 2;
+        } else {
+            qCritical() << "Batch mode:" << option << "must be 1/rip or 2/ospf (--" + option + " or routing." + key + "), got"
+                        << value;
+            return false;
+        }
+        return true;
+    };
+
+    bool bgp = false;
+    bool torus = false;
+    int firstAlgo = 0;
+    int secondAlgo = 0;
+    int mainAlgorithm = 0;
+    if (!yesNo("bgp", "bgp", bgp) || !yesNo("torus", "torus", torus)) {
+        return false;
+    }
+    if (bgp) {
+        if (!algorithm("first-as-algo", "first_as_algo", firstAlgo) ||
+            !algorithm("second-as-algo", "second_as_algo", secondAlgo)) {
+            return false;
+        }
+    } else if (!algorithm("main-algo", "main_algo", mainAlgorithm)) {
+        return false;
+    }
+
+    setUseBGP(bgp);
+    setFirstASAlgo(firstAlgo);
+    setSecondASAlgo(secondAlgo);
+    setMainAlgo(mainAlgorithm);
+    setAddTorus(torus);
+
+    QString timeLimit = parser.isSet("time-limit") ? parser.value("time-limit")
+                                                   : m_config.value("batch_time_limit").toString();
+    m_timeLimit = timeLimit.isEmpty() ? std::chrono::milliseconds(0) : parseDuration(timeLimit);
+    return true;
+}
+
+void Simulator::finishBatch(ExitCode code)
+{
+    if (m_batchFinished) {
+        return;
+    }
+    m_batchFinished = true;
+
+    static const char *const statuses[] = {"ok", "bad_config", "time_limit", "routes_invalid"};
+    QJsonObject summary;
+    summary["status"] = statuses[code];
+    summary["exit_code"] = code;
+    summary["seed"] = QString::number(m_context->seed());
+    summary["config"] = m_configPath;
+    summary["bgp"] = useBGP;
+    if (useBGP) {
+        summary["first_as_algo"] = algorithmName(firstASAlgo);
+        summary["second_as_algo"] = algorithmName(secondASAlgo);
+    } else {
+        summary["main_algo"] = algorithmName(mainAlgo);
+    }
+    summary["torus"] = addTorus;
+    summary["wall_ms"] = static_cast<double>(m_runClock.elapsed());
+    summary["converged"] = m_trafficStarted;
+    summary["warm_start"] = m_warmStarted;
+    summary["convergence_tick"] = m_convergenceTick;
+    if (m_convergenceOracle) {
+        RoutingReport report = m_convergenceOracle->lastReport();
+        QJsonObject routes;
+        routes["pairs"] = static_cast<double>(report.pairs);
+        routes["delivered"] = static_cast<double>(report.delivered);
+        routes["black_holes"] = static_cast<double>(report.blackHoles);
+        routes["loops"] = static_cast<double>(report.loops);
+        routes["wrong_next_hops"] = static_cast<double>(report.wrongNextHops);
+        routes["mean_stretch"] = report.meanStretch();
+        summary["routes"] = routes;
+    }
+    if (m_metricsCollector) {
+        summary["metrics"] = m_metricsCollector->summary();
+    }
+
+    qDebug() << "Batch run finished:" << statuses[code];
+    shutdown();
+    emit batchFinished(code, summary);
+}
+
+void Simulator::shutdown()
+{
+    m_context->events()->stopClock();
+    m_context->stopTraces();
+    if (m_network) {
+        m_network->shutdown();
+    }
+}
+
 void Simulator::setUseBGP(bool bgp) { useBGP = bgp; }
 void Simulator::setFirstASAlgo(int algo) { firstASAlgo = algo; }
 void Simulator::setSecondASAlgo(int algo) { secondASAlgo = algo; }
@@ -593,7 +1015,7 @@ void Simulator::printAsciiDiagram(bool addTorus)
             {
                 //--- The standard 4×4 mesh with PCs across the top plus the torus addition. ---
                 auto r = [&](int rid){
-                    auto router = RouterRegistry::findRouterById(rid);
+                    auto router = m_context->routers().findRouterById(rid);
                     if (router)
                         printRouter(rid, router->isBroken());
                     else
@@ -634,7 +1056,7 @@ void Simulator::printAsciiDiagram(bool addTorus)
             {
                 //--- The standard 4×4 mesh with PCs across the top. ---
                 auto r = [&](int rid){
-                    auto router = RouterRegistry::findRouterById(rid);
+                    auto router = m_context->routers().findRouterById(rid);
                     if (router)
                         printRouter(rid, router->isBroken());
                     else
@@ -671,7 +1093,7 @@ void Simulator::printAsciiDiagram(bool addTorus)
         else if (asId == 2)
         {
             auto r = [&](int rid){
-                auto router = RouterRegistry::findRouterById(rid);
+                auto router = m_context->routers().findRouterById(rid);
                 if (router)
                     printRouter(rid, router->isBroken());
                 else
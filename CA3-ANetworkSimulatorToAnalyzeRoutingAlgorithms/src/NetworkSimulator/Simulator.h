@@ -1,8 +1,10 @@
 #ifndef SIMULATOR_H
 #define SIMULATOR_H
 
+#include <QHash>
 #include <QObject>
 #include <QString>
+#include <QElapsedTimer>
 #include <QJsonObject>
 #include <QSharedPointer>
 
@@ -11,15 +13,31 @@
 #include "DataGenerator/DataGenerator.h"
 #include "../MetricsCollector/MetricsCollector.h"
 
+class QTimer;
+class ConvergenceOracle;
+class SimulationContext;
+class QCommandLineParser;
+
 class Simulator : public QObject
 {
     Q_OBJECT
 
 public:
+    // Process exit status of a batch run.
+    enum ExitCode {
+        ExitOk = 0,
+        ExitBadConfig = 1,
+        ExitTimeLimit = 2,      // Stopped by --time-limit before the traffic phase finished
+        ExitRoutesInvalid = 3,  // The convergence oracle found black holes, loops or wrong next hops
+    };
+
+    // Each simulator owns its SimulationContext, so create it on the thread that will run it.
     explicit Simulator(QObject *parent = nullptr);
     ~Simulator();
 
     bool loadConfig(const QString &configFilePath);
+    // For configs already parsed, e.g. one base config shared by a sweep; sourcePath is informational.
+    bool applyConfig(const QJsonObject &config, const QString &sourcePath = QString());
     void initializeNetwork();
     void startSimulation();
     void initiateDHCPPhase();
@@ -27,25 +45,82 @@ public:
     void checkAssignedIPPC();
     void initiatePacketSending();
     QSharedPointer<Network> getNetwork() { return m_network; }
+    QSharedPointer<MetricsCollector> getMetricsCollector() const { return m_metricsCollector; }
+    std::chrono::milliseconds getCycleDuration() const { return m_cycleDuration; }
+    SimulationContext *getContext() const { return m_context.data(); }
+    // Tick of the last routing change before the traffic phase, BGP included; -1 until then.
+    int convergenceTick() const { return m_convergenceTick; }
 
+    static void addCommandLineOptions(QCommandLineParser &parser);
+    // Call after loadConfig. Outside batch mode, prompts on stdin when no routing option is given.
+    bool configure(const QCommandLineParser &parser);
     bool configureFromCommandLine(const QStringList& arguments);
+    bool isBatch() const { return m_batch; }
+
+    // Stops the clock, the traces and every router and PC thread. The network stays readable.
+    void shutdown();
     void printTopologyVisualization();
     void printAsciiDiagram(bool addTorus);
 
 public slots:
     void onConvergenceDetected();
     void handleGeneratedPackets(const std::vector<QSharedPointer<Packet>> &packets);
+    void onTrafficDrained();
 
 signals:
+    // Routing has converged, BGP stages included; the traffic phase starts right after.
     void convergenceReached();
+    // After the traffic phase has drained and the statistics are printed.
+    void simulationFinished();
+    // Batch mode only: the run is over and its threads are stopped. exitCode is an ExitCode.
+    void batchFinished(int exitCode, const QJsonObject &summary);
 
 private:
+    QSharedPointer<SimulationContext> m_context;   // Declared first so it outlives the network
     QJsonObject m_config;
+    QString m_configPath;
     QSharedPointer<Network> m_network;
     QSharedPointer<DataGenerator> m_dataGenerator;
     QSharedPointer<MetricsCollector> m_metricsCollector;
+    QSharedPointer<ConvergenceOracle> m_convergenceOracle;
     IdAssignment m_idAssignment;
     std::chrono::milliseconds m_cycleDuration;
+    std::chrono::milliseconds m_trafficDuration;
+    std::chrono::milliseconds m_dhcpTimeout;
+    std::chrono::milliseconds m_drainTimeout;     // Backstop for packets that never arrive
+    QHash<QString, QSharedPointer<PC>> m_pcsByIp;
+    bool m_trafficStarted = false;
+    int m_convergenceTick = -1;
+
+    // Staged routing start with BGP: interior protocols, then eBGP, then iBGP.
+    enum class BgpStage { None, External, Internal };
+    BgpStage m_bgpStage = BgpStage::None;
+    bool m_trafficFinished = false;
+    QTimer *m_drainTimer = nullptr;
+    QElapsedTimer m_drainClock;
+
+    // Snapshots of the converged network (NetworkSnapshot)
+    QString m_snapshotPath;
+    QString m_warmStartPath;
+    bool m_warmStarted = false;
+    QString m_imagePath;            // NetworkImage of the converged network
+
+    QByteArray snapshotFingerprint() const;
+    bool restoreSnapshot();
+    void saveSnapshot();
+    void writeImage();
+    void validateRoutes();
+    void checkTrafficDrained();
+    void finishTraffic();
+
+    // Batch mode
+    bool m_batch = false;
+    bool m_batchFinished = false;
+    std::chrono::milliseconds m_timeLimit {0};
+    QElapsedTimer m_runClock;
+
+    bool configureBatch(const QCommandLineParser &parser);
+    void finishBatch(ExitCode code);
 
     std::chrono::milliseconds parseDuration(const QString &durationStr);
 
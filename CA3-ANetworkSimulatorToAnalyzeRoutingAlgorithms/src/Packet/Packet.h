@@ -1,6 +1,7 @@
 #ifndef PACKET_H
 #define PACKET_H
 
+#include <atomic>
 #include <QString>
 #include <QVector>
 #include <QSharedPointer>
@@ -71,7 +72,7 @@ public:
     qint64 getId() const;
 
 private:
-    static qint64 s_nextId;
+    static std::atomic<qint64> s_nextId;     // Unique across every simulation in the process
     PacketType m_type;
     QString m_payload;
     QVector<QString> m_path;
@@ -1,18 +1,19 @@
 #include <QDebug>
 
 #include "Port.h"
+#include "../Logger/Logger.h"
 #include "../Network/PC.h"
 #include "../Network/Router.h"
-#include "../NetworkSimulator/Simulator.h"
-#include "../NetworkSimulator/ApplicationContext.h"
+#include "../Globals/SimulationContext.h"
 
-Port::Port(QObject *parent) :
+Port::Port(SimulationContext *context, QObject *parent) :
     QObject {parent},
     m_number(0),
     m_numberOfPacketsSent(0),
     m_numberOfPacketsReceived(0),
     m_routerIP(""),
     m_isConnected(false),
+    m_context(context),
     m_connectedPC(nullptr),
     m_connectedRouterIP(" ")
 {}
@@ -73,7 +74,7 @@ void Port::sendPacket(const PacketPtr_t &data) {
         ++m_numberOfPacketsSent;
     }
     emit packetSent(data);
-    qDebug() << "Port::sendPacket() emitted packetSent.";
+    LOG_TRACE(Forwarding) << "Port::sendPacket() emitted packetSent.";
 }
 
 void Port::receivePacket(const PacketPtr_t &data) {
@@ -82,7 +83,7 @@ void Port::receivePacket(const PacketPtr_t &data) {
         ++m_numberOfPacketsReceived;
     }
     emit packetReceived(data);
-    qDebug() << "Port::receivePacket() emitted packetReceived.";
+    LOG_TRACE(Forwarding) << "Port::receivePacket() emitted packetReceived.";
 }
 
 void Port::setConnectedRouterId(int routerId) {
@@ -99,14 +100,14 @@ void Port::connectToPC(QSharedPointer<PC> pc)
 {
     QMutexLocker locker(&m_mutex);
     if (m_connectedPC) {
-        qWarning() << "Port" << m_number << "is already connected to PC with IP" << m_connectedPC->getIpAddress();
+        LOG_WARNING(Topology) << "Port" << m_number << "is already connected to PC with IP" << m_connectedPC->getIpAddress();
         return;
     }
 
     m_connectedPC = pc;
     m_isConnected = true;
 
-    qDebug() << "Port" << m_number << "connected to PC with IP" << pc->getIpAddress();
+    LOG_DEBUG(Topology) << "Port" << m_number << "connected to PC with IP" << pc->getIpAddress();
 
     connect(this, &Port::packetReceived, pc.data(), &PC::processPacket);
     connect(pc.data(), &PC::packetSent, this, &Port::sendPacket);
@@ -120,40 +121,38 @@ QSharedPointer<PC> Port::getConnectedPC() const
 
 QString Port::getConnectedRouterIP() const
 {
-    QMutexLocker locker(&m_mutex);
+    quint64 epoch = m_context->addressEpoch();
+    int routerId;
+    {
+        QMutexLocker locker(&m_mutex);
 
-    if (m_connectedRouterIP != " ") {
-        return m_connectedRouterIP;
-    }
+        if (m_connectedRouterIP != " ") {
+            return m_connectedRouterIP;
+        }
 
-    if (m_connectedPC)
-        return QString();
+        if (m_connectedPC)
+            return QString();
 
-    if (m_connectedRouterId == -1)
-        return QString();
+        if (m_connectedRouterId == -1)
+            return QString();
 
-    QSharedPointer<Simulator> simulator = ApplicationContext::instance().getSimulator();
-    if (!simulator) {
-        qWarning() << "Port::getConnectedRouterIP() - Simulator instance not found.";
-        return QString();
+        if (m_resolvedRouterId == m_connectedRouterId && m_resolvedEpoch == epoch) {
+            return m_resolvedRouterIP;
+        }
+        routerId = m_connectedRouterId;
     }
 
-    QSharedPointer<Network> network = simulator->getNetwork();
-    if (!network) {
-        qWarning() << "Port::getConnectedRouterIP() - Network instance not found.";
+    // Resolve without holding the port lock; the router takes its own.
+    QSharedPointer<Router> router = m_context->routers().findRouterById(routerId);
+    if (!router) {
+        LOG_WARNING(Topology) << "Port::getConnectedRouterIP() - Router with ID" << routerId << "not found.";
         return QString();
     }
+    QString ip = router->getIPAddress();
 
-    const auto &autonomousSystems = network->getAutonomousSystems();
-    for (const auto &asInstance : autonomousSystems) {
-        const auto &routers = asInstance->getRouters();
-        for (const auto &router : routers) {
-            if (router->getId() == m_connectedRouterId) {
-                return router->getIPAddress();
-            }
-        }
-    }
-
-    qWarning() << "Port::getConnectedRouterIP() - Router with ID" << m_connectedRouterId << "not found.";
-    return QString();
+    QMutexLocker locker(&m_mutex);
+    m_resolvedRouterIP = ip;
+    m_resolvedRouterId = routerId;
+    m_resolvedEpoch = epoch;
+    return ip;
 }
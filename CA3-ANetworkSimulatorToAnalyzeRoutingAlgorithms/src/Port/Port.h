@@ -7,15 +7,19 @@
 #include "../Packet/Packet.h"
 
 class PC;
+class SimulationContext;
 
 class Port : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit Port(QObject *parent = nullptr);
+    // The context resolves connected router ids and is told about binding changes.
+    explicit Port(SimulationContext *context, QObject *parent = nullptr);
     ~Port() override;
 
+    SimulationContext *getContext() const { return m_context; }
+
     void setPortNumber(uint8_t number);
     uint8_t getPortNumber() const;
 
@@ -52,10 +56,16 @@ private:
     QString  m_routerIP;
     bool     m_isConnected;
 
+    SimulationContext *m_context;
     QSharedPointer<PC> m_connectedPC;
     QString m_connectedRouterIP;
     mutable QMutex m_mutex;
     int m_connectedRouterId = -1;
+
+    // Address of the router behind m_connectedRouterId, valid while the context's address epoch matches.
+    mutable QString m_resolvedRouterIP;
+    mutable int m_resolvedRouterId = -1;
+    mutable quint64 m_resolvedEpoch = 0;
 };
 
 typedef QSharedPointer<Port> PortPtr_t;
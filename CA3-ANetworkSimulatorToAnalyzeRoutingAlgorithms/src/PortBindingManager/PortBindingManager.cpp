@@ -1,19 +1,21 @@
 #include <QDebug>
 #include "PortBindingManager.h"
+#include "../Logger/Logger.h"
+#include "../Globals/SimulationContext.h"
 
 PortBindingManager::PortBindingManager(QObject *parent) : QObject(parent) {}
 
 void PortBindingManager::bind(const QSharedPointer<Port> &port1, const QSharedPointer<Port> &port2, int router1Id, int router2Id)
 {
     if (!port1 || !port2) {
-        qWarning() << "Invalid ports provided for binding.";
+        LOG_WARNING(Topology) << "Invalid ports provided for binding.";
         return;
     }
 
     QMutexLocker locker(&m_mutex);
 
     if (m_bindings.contains(port1) || m_bindings.contains(port2)) {
-        qWarning() << "One of the ports is already bound.";
+        LOG_WARNING(Topology) << "One of the ports is already bound.";
         return;
     }
 
@@ -37,29 +39,30 @@ void PortBindingManager::bind(const QSharedPointer<Port> &port1, const QSharedPo
         port2->setConnectedRouterId(router1Id);
     }
     else {
-        qWarning() << "Attempting to bind two Ports connected to PCs. Binding skipped.";
+        LOG_WARNING(Topology) << "Attempting to bind two Ports connected to PCs. Binding skipped.";
         return;
     }
 
     m_bindings.insert(port1, port2);
     m_bindings.insert(port2, port1);
+    port1->getContext()->invalidateTopology();
 
     emit bindingChanged(router1Id, port1->getPortNumber(), router2Id, port2->getPortNumber(), true);
-    qDebug() << "Ports bound between Router ID" << router1Id << "Port" << port1->getPortNumber()
-             << "and Router ID" << router2Id << "Port" << port2->getPortNumber();
+    LOG_DEBUG(Topology) << "Ports bound between Router ID" << router1Id << "Port" << port1->getPortNumber()
+                        << "and Router ID" << router2Id << "Port" << port2->getPortNumber();
 }
 
 bool PortBindingManager::unbind(const QSharedPointer<Port> &port1, const QSharedPointer<Port> &port2)
 {
     if (!port1 || !port2) {
-        qWarning() << "Invalid ports provided for unbinding.";
+        LOG_WARNING(Topology) << "Invalid ports provided for unbinding.";
         return false;
     }
 
     QMutexLocker locker(&m_mutex);
 
     if (m_bindings.value(port1) != port2) {
-        qWarning() << "Ports are not bound.";
+        LOG_WARNING(Topology) << "Ports are not bound.";
         return false;
     }
 
@@ -71,9 +74,10 @@ bool PortBindingManager::unbind(const QSharedPointer<Port> &port1, const QShared
 
     m_bindings.remove(port1);
     m_bindings.remove(port2);
+    port1->getContext()->invalidateTopology();
 
     emit bindingChanged(port1->getPortNumber(), port1->getPortNumber(), port2->getPortNumber(), port2->getPortNumber(), false);
-    qDebug() << "Ports unbound.";
+    LOG_DEBUG(Topology) << "Ports unbound.";
     return true;
 }
 
@@ -0,0 +1,375 @@
+#include <tuple>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <QHash>
+#include <QDebug>
+#include <QSaveFile>
+
+#include "NetworkImage.h"
+#include "../BGP/Prefix.h"
+#include "../Network/PC.h"
+#include "../Network/Router.h"
+#include "../Globals/ObjectThread.h"
+
+namespace {
+
+constexpr quint32 MAX_SECTIONS = 32;
+
+quint32 addressOf(const QString &text)
+{
+    quint32 address = 0;
+    return Prefix::parseAddress(text, address) ? address : 0;
+}
+
+quint64 align8(quint64 size)
+{
+    return (size + 7) & ~quint64(7);
+}
+
+struct PendingSection
+{
+    ImageSectionKind kind;
+    quint32 elementSize;
+    quint64 count;
+    QByteArray data;
+};
+
+template <typename T>
+PendingSection pendingSection(ImageSectionKind kind, const std::vector<T> &values)
+{
+    return {kind, static_cast<quint32>(sizeof(T)), values.size(),
+            QByteArray(reinterpret_cast<const char *>(values.data()), static_cast<qsizetype>(values.size() * sizeof(T)))};
+}
+
+// Unaddressed nodes sort after every assigned address.
+quint64 addressKey(const ImageNode &node)
+{
+    return node.address ? node.address : std::numeric_limits<quint64>::max();
+}
+
+}
+
+NetworkImage::~NetworkImage()
+{
+    close();
+}
+
+bool NetworkImage::write(const QString &path, const std::vector<QSharedPointer<Router>> &routers,
+                         const std::vector<QSharedPointer<PC>> &pcs, bool withFibs, QString *error)
+{
+    std::vector<ImageNode> nodes;
+    std::vector<QSharedPointer<Router>> routerOf;     // Parallel to nodes; null for PCs
+    for (const auto &router : routers) {
+        if (!router) continue;
+        quint8 flags = (router->isBroken() ? ImageNode::BROKEN : 0) | (router->isDHCPServer() ? ImageNode::DHCP_SERVER : 0);
+        nodes.push_back({router->getId(), addressOf(router->getIPAddress()), static_cast<qint16>(router->getAsId()),
+                         ImageNode::ROUTER, flags, 0});
+        routerOf.push_back(router);
+    }
+    for (const auto &pc : pcs) {
+        if (!pc) continue;
+        nodes.push_back({pc->getId(), addressOf(pc->getIpAddress()), -1, ImageNode::PC, 0, 0});
+        routerOf.push_back(nullptr);
+    }
+
+    // Like TopologySnapshot, the first node registered under an id wins.
+    std::vector<int> order(nodes.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+    std::stable_sort(order.begin(), order.end(), [&nodes](int a, int b) { return nodes[a].id < nodes[b].id; });
+    order.erase(std::unique(order.begin(), order.end(), [&nodes](int a, int b) { return nodes[a].id == nodes[b].id; }),
+                order.end());
+    std::vector<ImageNode> sortedNodes;
+    std::vector<QSharedPointer<Router>> sortedRouters;
+    QHash<int, int> indexById;
+    for (int i : order) {
+        indexById.insert(nodes[i].id, static_cast<int>(sortedNodes.size()));
+        sortedNodes.push_back(nodes[i]);
+        sortedRouters.push_back(routerOf[i]);
+    }
+    nodes.swap(sortedNodes);
+    routerOf.swap(sortedRouters);
+    quint32 nodeCount = static_cast<quint32>(nodes.size());
+
+    // Links seen from the routers' ports; a PC gets the reverse of its router's link and the router's AS.
+    std::vector<std::tuple<qint32, qint32, quint8>> edges;
+    quint32 routerCount = 0;
+    for (quint32 node = 0; node < nodeCount; ++node) {
+        if (!routerOf[node]) continue;
+        ++routerCount;
+        for (const auto &port : routerOf[node]->getPorts()) {
+            if (!port->isConnected()) continue;
+            QSharedPointer<PC> pc = port->getConnectedPC();
+            int target = indexById.value(pc ? pc->getId() : port->getConnectedRouterId(), -1);
+            if (target < 0 || target == static_cast<int>(node)) continue;
+            edges.emplace_back(node, target, port->getPortNumber());
+            if (pc) {
+                PortPtr_t pcPort = pc->getPort();
+                edges.emplace_back(target, node, pcPort ? pcPort->getPortNumber() : 0);
+                nodes[target].asId = nodes[node].asId;
+            }
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end(), [](const auto &a, const auto &b) {
+        return std::get<0>(a) == std::get<0>(b) && std::get<1>(a) == std::get<1>(b);
+    }), edges.end());
+
+    std::vector<quint32> adjacencyOffsets(nodeCount + 1, 0);
+    std::vector<qint32> targets;
+    std::vector<quint8> ports;
+    targets.reserve(edges.size());
+    ports.reserve(edges.size());
+    for (const auto &[node, target, port] : edges) {
+        ++adjacencyOffsets[node + 1];
+        targets.push_back(target);
+        ports.push_back(port);
+    }
+    for (quint32 node = 0; node < nodeCount; ++node) {
+        adjacencyOffsets[node + 1] += adjacencyOffsets[node];
+    }
+
+    std::vector<qint32> addressIndex(nodeCount);
+    for (quint32 node = 0; node < nodeCount; ++node) addressIndex[node] = static_cast<qint32>(node);
+    std::stable_sort(addressIndex.begin(), addressIndex.end(),
+                     [&nodes](qint32 a, qint32 b) { return addressKey(nodes[a]) < addressKey(nodes[b]); });
+
+    std::vector<PendingSection> sections;
+    sections.push_back(pendingSection(ImageSectionKind::Nodes, nodes));
+    sections.push_back(pendingSection(ImageSectionKind::AddressIndex, addressIndex));
+    sections.push_back(pendingSection(ImageSectionKind::AdjacencyOffsets, adjacencyOffsets));
+    sections.push_back(pendingSection(ImageSectionKind::AdjacencyTargets, targets));
+    sections.push_back(pendingSection(ImageSectionKind::AdjacencyPorts, ports));
+
+    quint64 fibEntryCount = 0;
+    if (withFibs) {
+        QHash<quint32, qint32> indexByAddress;
+        for (quint32 node = 0; node < nodeCount; ++node) {
+            if (nodes[node].address) indexByAddress.insert(nodes[node].address, static_cast<qint32>(node));
+        }
+
+        std::vector<quint32> fibOffsets(nodeCount + 1, 0);
+        std::vector<ImageFibEntry> fibEntries;
+        for (quint32 node = 0; node < nodeCount; ++node) {
+            fibOffsets[node] = static_cast<quint32>(fibEntries.size());
+            const QSharedPointer<Router> &router = routerOf[node];
+            if (!router) continue;
+
+            size_t first = fibEntries.size();
+            runOnObjectThread(router.data(), [&router, &fibEntries, &indexByAddress]() {
+                const ForwardingTable &table = router->currentForwardingTable();
+                for (auto it = table.entries().constBegin(); it != table.entries().constEnd(); ++it) {
+                    const FibEntry &entry = it.value();
+                    quint32 destination = addressOf(it.key());
+                    if (!entry.isValid() || !destination) continue;
+
+                    ImageFibEntry record {};
+                    record.destination = destination;
+                    record.nextHop = -1;
+                    record.metric = entry.metric;
+                    record.protocol = entry.protocol;
+                    record.flags = entry.isLocal() ? ImageFibEntry::LOCAL : 0;
+                    if (entry.adjacency != FibEntry::NO_ADJACENCY) {
+                        const Adjacency &adjacency = table.adjacency(entry.adjacency);
+                        record.port = adjacency.portNumber;
+                        record.nextHop = indexByAddress.value(addressOf(adjacency.nextHop), -1);
+                    }
+                    fibEntries.push_back(record);
+                }
+            });
+            std::sort(fibEntries.begin() + static_cast<std::ptrdiff_t>(first), fibEntries.end(),
+                      [](const ImageFibEntry &a, const ImageFibEntry &b) { return a.destination < b.destination; });
+        }
+        fibOffsets[nodeCount] = static_cast<quint32>(fibEntries.size());
+        fibEntryCount = fibEntries.size();
+        sections.push_back(pendingSection(ImageSectionKind::FibOffsets, fibOffsets));
+        sections.push_back(pendingSection(ImageSectionKind::FibEntries, fibEntries));
+    }
+
+    ImageHeader header {};
+    std::memcpy(header.magic, "CNIMAGE1", sizeof(header.magic));
+    header.version = IMAGE_FORMAT_VERSION;
+    header.sectionCount = static_cast<quint32>(sections.size());
+    header.nodeCount = nodeCount;
+    header.routerCount = routerCount;
+    header.edgeCount = edges.size();
+    header.fibEntryCount = fibEntryCount;
+
+    std::vector<ImageSection> table;
+    quint64 offset = align8(sizeof(ImageHeader) + sections.size() * sizeof(ImageSection));
+    for (const PendingSection &pending : sections) {
+        table.push_back({static_cast<quint32>(pending.kind), pending.elementSize, offset, pending.count});
+        offset = align8(offset + static_cast<quint64>(pending.data.size()));
+    }
+    header.fileSize = offset;
+
+    QByteArray image(static_cast<qsizetype>(header.fileSize), '\0');
+    std::memcpy(image.data(), &header, sizeof(header));
+    std::memcpy(image.data() + sizeof(header), table.data(), table.size() * sizeof(ImageSection));
+    for (size_t i = 0; i < sections.size(); ++i) {
+        std::memcpy(image.data() + table[i].offset, sections[i].data.constData(),
+                    static_cast<size_t>(sections[i].data.size()));
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(image) != image.size() || !file.commit()) {
+        *error = file.errorString();
+        return false;
+    }
+    qDebug() << "Network image written to" << path << ":" << nodeCount << "nodes," << header.edgeCount << "links,"
+             << fibEntryCount << "FIB entries," << header.fileSize << "bytes";
+    return true;
+}
+
+bool NetworkImage::open(const QString &path, QString *error)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        *error = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size < static_cast<qint64>(sizeof(ImageHeader)) || !(m_map = m_file.map(0, m_size))) {
+        *error = m_size < static_cast<qint64>(sizeof(ImageHeader)) ? "too short" : m_file.errorString();
+        close();
+        return false;
+    }
+
+    auto fail = [this, error](const QString &reason) {
+        *error = reason;
+        close();
+        return false;
+    };
+
+    const auto *header = reinterpret_cast<const ImageHeader *>(m_map);
+    if (std::memcmp(header->magic, "CNIMAGE1", sizeof(header->magic)) != 0) {
+        return fail("not a network image");
+    }
+    if (header->version != IMAGE_FORMAT_VERSION) {
+        return fail(QString("unsupported image version %1").arg(header->version));
+    }
+    if (header->fileSize != static_cast<quint64>(m_size) || header->sectionCount > MAX_SECTIONS ||
+        sizeof(ImageHeader) + header->sectionCount * sizeof(ImageSection) > static_cast<quint64>(m_size)) {
+        return fail("truncated or corrupt header");
+    }
+    m_header = header;
+
+    quint64 nodes = header->nodeCount;
+    QString reason;
+    m_nodes = reinterpret_cast<const ImageNode *>(section(ImageSectionKind::Nodes, sizeof(ImageNode), nodes, true, &reason));
+    m_addressIndex = reinterpret_cast<const qint32 *>(section(ImageSectionKind::AddressIndex, sizeof(qint32), nodes, true, &reason));
+    m_adjacencyOffsets = reinterpret_cast<const quint32 *>(
+        section(ImageSectionKind::AdjacencyOffsets, sizeof(quint32), nodes + 1, true, &reason));
+    m_targets = reinterpret_cast<const qint32 *>(
+        section(ImageSectionKind::AdjacencyTargets, sizeof(qint32), header->edgeCount, true, &reason));
+    m_ports = section(ImageSectionKind::AdjacencyPorts, sizeof(quint8), header->edgeCount, true, &reason);
+    m_fibOffsets = reinterpret_cast<const quint32 *>(
+        section(ImageSectionKind::FibOffsets, sizeof(quint32), nodes + 1, false, &reason));
+    if (m_fibOffsets) {
+        m_fibEntries = reinterpret_cast<const ImageFibEntry *>(
+            section(ImageSectionKind::FibEntries, sizeof(ImageFibEntry), header->fibEntryCount, true, &reason));
+    }
+    if (!reason.isEmpty()) {
+        return fail(reason);
+    }
+
+    // One pass over the indices so that no accessor can read outside the mapping later.
+    for (quint64 node = 0; node < nodes; ++node) {
+        if (node > 0 && m_nodes[node - 1].id >= m_nodes[node].id) return fail("nodes are not sorted by id");
+        if (m_addressIndex[node] < 0 || static_cast<quint64>(m_addressIndex[node]) >= nodes) {
+            return fail("address index out of range");
+        }
+        if (m_adjacencyOffsets[node] > m_adjacencyOffsets[node + 1]) return fail("adjacency offsets out of order");
+        if (m_fibOffsets && m_fibOffsets[node] > m_fibOffsets[node + 1]) return fail("FIB offsets out of order");
+    }
+    if (m_adjacencyOffsets[0] != 0 || m_adjacencyOffsets[nodes] != header->edgeCount) {
+        return fail("adjacency offsets do not cover the links");
+    }
+    for (quint64 edge = 0; edge < header->edgeCount; ++edge) {
+        if (m_targets[edge] < 0 || static_cast<quint64>(m_targets[edge]) >= nodes) return fail("link target out of range");
+    }
+    if (m_fibOffsets) {
+        if (m_fibOffsets[0] != 0 || m_fibOffsets[nodes] != header->fibEntryCount) {
+            return fail("FIB offsets do not cover the entries");
+        }
+        for (quint64 entry = 0; entry < header->fibEntryCount; ++entry) {
+            if (m_fibEntries[entry].nextHop < -1 || m_fibEntries[entry].nextHop >= static_cast<qint64>(nodes)) {
+                return fail("FIB next hop out of range");
+            }
+        }
+    }
+    return true;
+}
+
+const uchar *NetworkImage::section(ImageSectionKind kind, quint32 elementSize, quint64 count, bool required,
+                                   QString *error) const
+{
+    const auto *table = reinterpret_cast<const ImageSection *>(m_map + sizeof(ImageHeader));
+    for (quint32 i = 0; i < m_header->sectionCount; ++i) {
+        const ImageSection &entry = table[i];
+        if (entry.kind != static_cast<quint32>(kind)) continue;
+
+        if (entry.elementSize != elementSize || entry.count != count || entry.offset % 8 != 0 ||
+            entry.offset > static_cast<quint64>(m_size) ||
+            count > (static_cast<quint64>(m_size) - entry.offset) / elementSize) {
+            if (error->isEmpty()) *error = QString("section %1 is corrupt").arg(entry.kind);
+            return nullptr;
+        }
+        return m_map + entry.offset;
+    }
+    if (required && error->isEmpty()) {
+        *error = QString("section %1 is missing").arg(static_cast<quint32>(kind));
+    }
+    return nullptr;
+}
+
+void NetworkImage::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+    }
+    m_file.close();
+    m_map = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_nodes = nullptr;
+    m_addressIndex = nullptr;
+    m_adjacencyOffsets = nullptr;
+    m_targets = nullptr;
+    m_ports = nullptr;
+    m_fibOffsets = nullptr;
+    m_fibEntries = nullptr;
+}
+
+int NetworkImage::indexOf(int nodeId) const
+{
+    const ImageNode *end = m_nodes + nodeCount();
+    const ImageNode *it = std::lower_bound(m_nodes, end, nodeId, [](const ImageNode &node, int id) { return node.id < id; });
+    return it != end && it->id == nodeId ? static_cast<int>(it - m_nodes) : -1;
+}
+
+int NetworkImage::indexOfAddress(quint32 address) const
+{
+    if (!address) return -1;
+    const qint32 *end = m_addressIndex + nodeCount();
+    const qint32 *it = std::lower_bound(m_addressIndex, end, address,
+                                        [this](qint32 node, quint32 key) { return addressKey(m_nodes[node]) < key; });
+    return it != end && m_nodes[*it].address == address ? *it : -1;
+}
+
+int NetworkImage::portTo(int a, int b) const
+{
+    if (a < 0 || a >= nodeCount()) return -1;
+    const qint32 *it = std::lower_bound(neighborsBegin(a), neighborsEnd(a), b);
+    if (it == neighborsEnd(a) || *it != b) return -1;
+    return m_ports[it - m_targets];
+}
+
+const ImageFibEntry *NetworkImage::lookup(int node, quint32 destination) const
+{
+    if (!hasFibs() || node < 0 || node >= nodeCount()) return nullptr;
+    const ImageFibEntry *it = std::lower_bound(fibBegin(node), fibEnd(node), destination,
+                                               [](const ImageFibEntry &entry, quint32 key) { return entry.destination < key; });
+    return it != fibEnd(node) && it->destination == destination ? it : nullptr;
+}
@@ -0,0 +1,135 @@
+#ifndef NETWORKIMAGE_H
+#define NETWORKIMAGE_H
+
+#include <vector>
+#include <QFile>
+#include <QString>
+#include <QSharedPointer>
+
+class PC;
+class Router;
+
+// File layout: an ImageHeader, a table of ImageSection entries, then the sections, each starting
+// at an 8-byte boundary. Fields are fixed-width in the writer's byte order so a mapped file is read
+// in place. Nodes are sorted by id and referred to by their index in that order everywhere else.
+struct ImageHeader
+{
+    char magic[8];          // "CNIMAGE1"
+    quint32 version;
+    quint32 sectionCount;
+    quint32 nodeCount;      // Routers and PCs
+    quint32 routerCount;
+    quint64 edgeCount;      // Each link counts once per direction
+    quint64 fibEntryCount;  // 0 when the image was written without forwarding tables
+    quint64 fileSize;
+    char reserved[16];
+};
+
+enum class ImageSectionKind : quint32 {
+    Nodes = 1,              // ImageNode[nodeCount]
+    AddressIndex,           // qint32[nodeCount]: node indices in address order, unaddressed nodes last
+    AdjacencyOffsets,       // quint32[nodeCount + 1]
+    AdjacencyTargets,       // qint32[edgeCount], sorted per node
+    AdjacencyPorts,         // quint8[edgeCount]: local port number of each link
+    FibOffsets,             // quint32[nodeCount + 1]
+    FibEntries,             // ImageFibEntry[fibEntryCount], sorted by destination per node
+};
+
+struct ImageSection
+{
+    quint32 kind;
+    quint32 elementSize;
+    quint64 offset;         // From the start of the file
+    quint64 count;
+};
+
+struct ImageNode
+{
+    static constexpr quint8 ROUTER = 0;
+    static constexpr quint8 PC = 1;
+    static constexpr quint8 BROKEN = 0x1;
+    static constexpr quint8 DHCP_SERVER = 0x2;
+
+    qint32 id;
+    quint32 address;        // IPv4, 0 while unassigned
+    qint16 asId;            // -1 outside any AS
+    quint8 kind;
+    quint8 flags;
+    quint32 reserved;
+};
+
+struct ImageFibEntry
+{
+    static constexpr quint8 LOCAL = 0x1;    // Destination is attached to this router
+
+    quint32 destination;
+    qint32 nextHop;         // Node index, -1 when the next hop is not a node of the image
+    qint16 metric;
+    quint8 port;
+    quint8 protocol;        // RoutingProtocol
+    quint8 flags;
+    quint8 reserved[3];
+};
+
+static_assert(sizeof(ImageHeader) == 64, "image header is fixed-size");
+static_assert(sizeof(ImageSection) == 24, "image sections are fixed-size");
+static_assert(sizeof(ImageNode) == 16, "image nodes are fixed-size");
+static_assert(sizeof(ImageFibEntry) == 16, "image FIB entries are fixed-size");
+
+constexpr quint32 IMAGE_FORMAT_VERSION = 1;
+
+// Read-only view of a network image mapped into memory: node table, CSR adjacency over routers
+// and PCs, address assignments and optionally every router's forwarding table. open() checks the
+// layout once; after that every accessor reads the mapping directly and nothing is copied.
+class NetworkImage
+{
+public:
+    NetworkImage() = default;
+    ~NetworkImage();
+
+    NetworkImage(const NetworkImage &) = delete;
+    NetworkImage &operator=(const NetworkImage &) = delete;
+
+    bool open(const QString &path, QString *error);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    const ImageHeader &header() const { return *m_header; }
+    int nodeCount() const { return static_cast<int>(m_header->nodeCount); }
+    const ImageNode &node(int index) const { return m_nodes[index]; }
+    int indexOf(int nodeId) const;                      // -1 for unknown nodes
+    int indexOfAddress(quint32 address) const;
+
+    int degree(int node) const { return static_cast<int>(m_adjacencyOffsets[node + 1] - m_adjacencyOffsets[node]); }
+    const qint32 *neighborsBegin(int node) const { return m_targets + m_adjacencyOffsets[node]; }
+    const qint32 *neighborsEnd(int node) const { return m_targets + m_adjacencyOffsets[node + 1]; }
+    int portTo(int a, int b) const;                     // Local port number on a, or -1
+
+    bool hasFibs() const { return m_fibOffsets != nullptr; }
+    const ImageFibEntry *fibBegin(int node) const { return m_fibEntries + m_fibOffsets[node]; }
+    const ImageFibEntry *fibEnd(int node) const { return m_fibEntries + m_fibOffsets[node + 1]; }
+    const ImageFibEntry *lookup(int node, quint32 destination) const;    // nullptr without a route
+
+    // Nodes are read on their own threads. Forwarding tables are left out unless withFibs is set.
+    static bool write(const QString &path, const std::vector<QSharedPointer<Router>> &routers,
+                      const std::vector<QSharedPointer<PC>> &pcs, bool withFibs, QString *error);
+
+private:
+    const uchar *section(ImageSectionKind kind, quint32 elementSize, quint64 count, bool required,
+                         QString *error) const;
+
+    QFile m_file;
+    uchar *m_map = nullptr;
+    qint64 m_size = 0;
+
+    const ImageHeader *m_header = nullptr;
+    const ImageNode *m_nodes = nullptr;
+    const qint32 *m_addressIndex = nullptr;
+    const quint32 *m_adjacencyOffsets = nullptr;
+    const qint32 *m_targets = nullptr;
+    const quint8 *m_ports = nullptr;
+    const quint32 *m_fibOffsets = nullptr;
+    const ImageFibEntry *m_fibEntries = nullptr;
+};
+
+#endif // NETWORKIMAGE_H
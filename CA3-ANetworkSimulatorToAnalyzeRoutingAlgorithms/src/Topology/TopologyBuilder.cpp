@@ -7,10 +7,11 @@
 #include "TopologyBuilder.h"
 #include "../PortBindingManager/PortBindingManager.h"
 #include "../DHCPServer/DHCPServer.h"
-#include "../Globals/RouterRegistry.h"
+#include "../Globals/SimulationContext.h"
 
-TopologyBuilder::TopologyBuilder(const QJsonObject &config, const IdAssignment &idAssignment, QObject *parent)
-    : QObject(parent), m_config(config), m_idAssignment(idAssignment)
+TopologyBuilder::TopologyBuilder(const QJsonObject &config, const IdAssignment &idAssignment, SimulationContext *context,
+                                 QObject *parent)
+    : QObject(parent), m_config(config), m_idAssignment(idAssignment), m_context(context)
 {
     validateConfig();
     m_topologyType = config.value("topology_type").toString();
@@ -18,6 +19,30 @@ TopologyBuilder::TopologyBuilder(const QJsonObject &config, const IdAssignment &
 
 TopologyBuilder::~TopologyBuilder() {}
 
+void TopologyBuilder::stopThreads()
+{
+    QThread *home = QThread::currentThread();
+    auto bringHome = [home](QObject *node) {
+        if (node->thread() != home && node->thread()->isRunning()) {
+            QMetaObject::invokeMethod(node, [node, home]() { node->moveToThread(home); }, Qt::BlockingQueuedConnection);
+        }
+    };
+    for (const auto &router : m_routers) {
+        bringHome(router.data());
+    }
+    for (const auto &pc : m_pcs) {
+        bringHome(pc.data());
+    }
+
+    // The shared pointers own the nodes; deleteLater on finish would delete them a second time.
+    for (QThread *thread : m_threads) {
+        disconnect(thread, &QThread::finished, nullptr, nullptr);
+        thread->quit();
+        thread->wait();
+    }
+    m_threads.clear();
+}
+
 void TopologyBuilder::buildTopology(bool torus) {
     createRouters();
     setupTopology();
@@ -28,6 +53,7 @@ void TopologyBuilder::buildTopology(bool torus) {
 
     createPCs();
     configureDHCPServers();
+    configureIBGP();
 }
 
 void TopologyBuilder::validateConfig() const
@@ -51,6 +77,13 @@ void TopologyBuilder::createRouters() {
         throw std::runtime_error("Router count doesn't match assigned range.");
     }
 
+    // Each AS originates its address block into BGP as a single aggregate.
+    Prefix asPrefix;
+    QString subnet = m_config.value("dhcp_subnet").toString(DHCPServer::defaultSubnet(asId));
+    if (!Prefix::parse(subnet, asPrefix)) {
+        qWarning() << "Invalid subnet" << subnet << "for AS" << asId << ". It will not be advertised.";
+    }
+
     QJsonArray brokenRoutersArray = m_config.value("broken_routers").toArray();
     std::vector<int> brokenRouters;
 
@@ -67,7 +100,8 @@ void TopologyBuilder::createRouters() {
             isBroken = true;
         }
 
-        auto router = QSharedPointer<Router>::create(routerId, "", portCount, nullptr, isBroken);
+        auto router = QSharedPointer<Router>::create(routerId, "", m_context, portCount, nullptr, isBroken);
+        router->setAutonomousSystem(range, asPrefix.isValid() ? QVector<Prefix>{asPrefix} : QVector<Prefix>());
         QThread *routerThread = new QThread(this);
         router->moveToThread(routerThread);
 
@@ -77,13 +111,14 @@ void TopologyBuilder::createRouters() {
         connect(router.data(), &Router::finished, routerThread, &QObject::deleteLater);
 
         routerThread->start();
+        m_threads.push_back(routerThread);
         m_routers.push_back(router);
         qDebug() << "Created Router with ID:" << routerId;
 
         m_routerToASMap[routerId] = asId;
     }
 
-    RouterRegistry::addRouters(m_routers);
+    m_context->routers().addRouters(m_routers);
 
     for (auto &router : m_routers) {
         qDebug() << "  Router ID:" << router->getId();
@@ -140,7 +175,7 @@ void TopologyBuilder::createPCs()
                 continue;
             }
 
-            auto pc = QSharedPointer<PC>::create(pcId, " ", nullptr);
+            auto pc = QSharedPointer<PC>::create(pcId, " ", m_context);
             QThread *pcThread = new QThread(this);
             pc->moveToThread(pcThread);
 
@@ -148,6 +183,7 @@ void TopologyBuilder::createPCs()
             connect(pcThread, &QThread::finished, pc.data(), &QObject::deleteLater);
 
             pcThread->start();
+            m_threads.push_back(pcThread);
             m_pcs.push_back(pc);
 
             PortBindingManager bindingManager;
@@ -275,6 +311,26 @@ const QJsonObject &TopologyBuilder::getConfig() const
 
 void TopologyBuilder::configureDHCPServers() {
     QJsonArray dhcpServers = m_config.value("dhcpServers").toArray();
+    int asId = m_config.value("id").toInt();
+
+    // Gateways serving PCs act as DHCP relay agents.
+    for (const QJsonValue &value : m_config.value("user_gateways").toArray()) {
+        int gatewayId = value.toInt();
+        auto gatewayIt = std::find_if(m_routers.begin(), m_routers.end(),
+                                      [gatewayId](const QSharedPointer<Router> &router) {
+                                          return router->getId() == gatewayId;
+                                      });
+        if (gatewayIt != m_routers.end()) {
+            (*gatewayIt)->setDHCPRelay(true);
+        }
+    }
+
+    AsIdRange range;
+    if (!dhcpServers.isEmpty() && !m_idAssignment.getAsIdRange(asId, range)) {
+        qWarning() << "ID range not found for AS" << asId << ". Skipping DHCP servers.";
+        return;
+    }
+    QString subnet = m_config.value("dhcp_subnet").toString(DHCPServer::defaultSubnet(asId));
 
     for (const auto &value : dhcpServers) {
         int routerId = value.toInt();
@@ -286,13 +342,12 @@ void TopologyBuilder::configureDHCPServers() {
         if (routerIt != m_routers.end()) {
             auto router = *routerIt;
 
-            int asId = m_config.value("id").toInt();
             if (asId <= 0) {
                 qWarning() << "Invalid AS ID for DHCP server configuration.";
                 continue;
             }
 
-            auto dhcpServer = QSharedPointer<DHCPServer>::create(asId, router, this);
+            auto dhcpServer = QSharedPointer<DHCPServer>::create(asId, range, subnet, router, this);
             router->setDHCPServer(dhcpServer);
             qDebug() << "Configured DHCP Server for AS ID:" << asId
                      << "on Router ID:" << routerId;
@@ -302,6 +357,38 @@ void TopologyBuilder::configureDHCPServers() {
     }
 }
 
+void TopologyBuilder::configureIBGP()
+{
+    QVector<int> routerIds;
+    QVector<QPair<int, int>> links;
+
+    for (const auto &router : m_routers) {
+        if (router->isBroken()) {
+            continue;
+        }
+        routerIds.append(router->getId());
+
+        for (const auto &port : router->getPorts()) {
+            int neighborId = port->getConnectedRouterId();
+            if (port->isConnected() && !port->getConnectedPC() && m_routerToASMap.count(neighborId)) {
+                links.append(qMakePair(router->getId(), neighborId));
+            }
+        }
+    }
+
+    IBGPTopology topology;
+    topology.configure(m_config.value("ibgp").toObject(), routerIds, links);
+
+    int mraiTicks = m_config.value("bgp_mrai_ticks").toInt(BGP_DEFAULT_MRAI_TICKS);
+    for (const auto &router : m_routers) {
+        router->setIBGPRole(topology.roleOf(router->getId()));
+        router->setBGPMrai(mraiTicks);
+    }
+
+    qDebug() << "AS" << m_config.value("id").toInt() << "uses iBGP" << IBGPTopology::modeName(topology.mode())
+             << "with" << topology.sessionCount() << "sessions";
+}
+
 void TopologyBuilder::makeMeshTorus()
 {
     int rows = 4;
@@ -15,7 +15,8 @@ class TopologyBuilder : public QObject
     Q_OBJECT
 
 public:
-    explicit TopologyBuilder(const QJsonObject &config, const IdAssignment &idAssignment, QObject *parent = nullptr);
+    explicit TopologyBuilder(const QJsonObject &config, const IdAssignment &idAssignment, SimulationContext *context,
+                             QObject *parent = nullptr);
     ~TopologyBuilder();
 
     void buildTopology(bool torus);
@@ -25,6 +26,10 @@ public:
     int getASIdForRouter(int routerId) const;
     void makeMeshTorus();
     QSharedPointer<Router> findRouterById(int routerId) const;
+    SimulationContext *getContext() const { return m_context; }
+
+    // Moves every router and PC back to the calling thread, then stops their threads. Blocks.
+    void stopThreads();
 
 private:
     QJsonObject m_config;
@@ -32,9 +37,11 @@ private:
     QSet<QPair<int, int>> m_connectedPairs;
 
     const IdAssignment &m_idAssignment;
+    SimulationContext *m_context;
 
     std::vector<QSharedPointer<Router>> m_routers;
     std::vector<QSharedPointer<PC>> m_pcs;
+    std::vector<QThread *> m_threads;
     std::map<int, int> m_routerToASMap;
 
     void createRouters();
@@ -42,6 +49,7 @@ private:
     void setupTopology();
     void validateConfig() const;
     void configureDHCPServers();
+    void configureIBGP();
 };
 
 #endif // TOPOLOGYBUILDER_H
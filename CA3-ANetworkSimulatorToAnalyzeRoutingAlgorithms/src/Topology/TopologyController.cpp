@@ -4,7 +4,7 @@
 #include "TopologyBuilder.h"
 #include "../Network/Router.h"
 #include "TopologyController.h"
-#include "../Globals/RouterRegistry.h"
+#include "../Globals/SimulationContext.h"
 #include "../Network/AutonomousSystem.h"
 #include "../PortBindingManager/PortBindingManager.h"
 
@@ -33,19 +33,12 @@ void TopologyController::initiateDHCPIP(const QSharedPointer<Router> &router) {
         return;
     }
 
-    int asId = m_builder->getASIdForRouter(router->getId());
-
-    QString ipPrefix;
-    if (asId == 1) {
-        ipPrefix = "192.168.100.";
-    } else if (asId == 2) {
-        ipPrefix = "192.168.200.";
-    } else {
-        qWarning() << "Unsupported AS ID:" << asId << "for Router" << router->getId();
+    QString assignedIP = router->getDHCPServer()->assignStaticIP(router->getId());
+    if (assignedIP.isEmpty()) {
+        qWarning() << "No address available for DHCP server Router" << router->getId();
         return;
     }
 
-    QString assignedIP = ipPrefix + QString::number(router->getId());
     router->setIP(assignedIP);
     router->addDirectRoute(assignedIP, "255.255.255.255");
     qDebug() << "Router" << router->getId() << "added direct route for its own IP.";
@@ -133,5 +126,5 @@ void TopologyController::checkAssignedIPPC() {
 }
 
 QSharedPointer<Router> TopologyBuilder::findRouterById(int routerId) const {
-    return RouterRegistry::findRouterById(routerId);
+    return m_context->routers().findRouterById(routerId);
 }
@@ -0,0 +1,74 @@
+#include <tuple>
+#include <algorithm>
+
+#include "TopologySnapshot.h"
+#include "../Network/Router.h"
+
+TopologySnapshot::TopologySnapshot(const std::vector<QSharedPointer<Router>> &routers, quint64 version)
+    : m_version(version)
+{
+    std::vector<QSharedPointer<Router>> nodes;
+    nodes.reserve(routers.size());
+    for (const auto &router : routers) {
+        if (router) {
+            nodes.push_back(router);
+        }
+    }
+    // Like RouterRegistry, the first router registered under an id wins.
+    std::stable_sort(nodes.begin(), nodes.end(), [](const auto &a, const auto &b) { return a->getId() < b->getId(); });
+    nodes.erase(std::unique(nodes.begin(), nodes.end(), [](const auto &a, const auto &b) { return a->getId() == b->getId(); }),
+                nodes.end());
+
+    m_routerIds.reserve(static_cast<int>(nodes.size()));
+    for (const auto &router : nodes) {
+        m_routerIds.append(router->getId());
+    }
+
+    std::vector<std::tuple<int, int, quint8>> edges;
+    for (int node = 0; node < nodeCount(); ++node) {
+        for (const auto &port : nodes[node]->getPorts()) {
+            if (!port->isConnected() || port->getConnectedPC()) continue;
+            int target = indexOf(port->getConnectedRouterId());
+            if (target >= 0 && target != node) {
+                edges.emplace_back(node, target, port->getPortNumber());
+            }
+        }
+    }
+    // Parallel links collapse onto the lowest port number.
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end(), [](const auto &a, const auto &b) {
+        return std::get<0>(a) == std::get<0>(b) && std::get<1>(a) == std::get<1>(b);
+    }), edges.end());
+
+    m_offsets.fill(0, nodeCount() + 1);
+    m_targets.reserve(static_cast<int>(edges.size()));
+    m_ports.reserve(static_cast<int>(edges.size()));
+    for (const auto &[node, target, port] : edges) {
+        ++m_offsets[node + 1];
+        m_targets.append(target);
+        m_ports.append(port);
+    }
+    for (int node = 0; node < nodeCount(); ++node) {
+        m_offsets[node + 1] += m_offsets[node];
+    }
+}
+
+int TopologySnapshot::indexOf(int routerId) const
+{
+    auto it = std::lower_bound(m_routerIds.constBegin(), m_routerIds.constEnd(), routerId);
+    if (it == m_routerIds.constEnd() || *it != routerId) return -1;
+    return static_cast<int>(it - m_routerIds.constBegin());
+}
+
+bool TopologySnapshot::isAdjacent(int a, int b) const
+{
+    return portTo(a, b) >= 0;
+}
+
+int TopologySnapshot::portTo(int a, int b) const
+{
+    if (a < 0 || a >= nodeCount()) return -1;
+    const int *it = std::lower_bound(neighborsBegin(a), neighborsEnd(a), b);
+    if (it == neighborsEnd(a) || *it != b) return -1;
+    return m_ports[static_cast<int>(it - m_targets.constData())];
+}
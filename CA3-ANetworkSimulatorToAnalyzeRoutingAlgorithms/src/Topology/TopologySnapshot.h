@@ -0,0 +1,43 @@
+#ifndef TOPOLOGYSNAPSHOT_H
+#define TOPOLOGYSNAPSHOT_H
+
+#include <vector>
+#include <QVector>
+#include <QSharedPointer>
+
+class Router;
+
+// Immutable router-level adjacency in compressed sparse row form. Routers get dense node indices
+// in ascending id order; the neighbours of node n are targets()[offsets()[n] .. offsets()[n + 1]),
+// sorted, with the local port number of each link alongside. PC links are not part of it.
+class TopologySnapshot
+{
+public:
+    // version tags the snapshot, e.g. with the SimulationContext::topologyEpoch() it was built at.
+    explicit TopologySnapshot(const std::vector<QSharedPointer<Router>> &routers, quint64 version = 0);
+
+    int nodeCount() const { return m_routerIds.size(); }
+    int edgeCount() const { return m_targets.size(); }    // Each link counts once per direction
+    quint64 version() const { return m_version; }
+
+    int indexOf(int routerId) const;                       // -1 for unknown routers
+    int routerId(int node) const { return m_routerIds[node]; }
+
+    int degree(int node) const { return m_offsets[node + 1] - m_offsets[node]; }
+    const int *neighborsBegin(int node) const { return m_targets.constData() + m_offsets[node]; }
+    const int *neighborsEnd(int node) const { return m_targets.constData() + m_offsets[node + 1]; }
+    bool isAdjacent(int a, int b) const;
+    int portTo(int a, int b) const;                        // Local port number on a, or -1
+
+    const QVector<int> &offsets() const { return m_offsets; }
+    const QVector<int> &targets() const { return m_targets; }
+
+private:
+    QVector<int> m_routerIds;
+    QVector<int> m_offsets;
+    QVector<int> m_targets;
+    QVector<quint8> m_ports;
+    quint64 m_version = 0;
+};
+
+#endif // TOPOLOGYSNAPSHOT_H
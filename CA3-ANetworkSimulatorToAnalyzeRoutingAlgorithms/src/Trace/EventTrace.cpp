@@ -0,0 +1,177 @@
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QDebug>
+#include <QDateTime>
+#include <QFileInfo>
+
+#include "EventTrace.h"
+#include "../Logger/AsyncLogWriter.h"
+
+std::atomic<bool> EventTrace::s_enabled {false};
+
+namespace {
+
+// Single producer (the owning thread); whoever flushes holds flushMutex.
+struct Ring
+{
+    TraceRecord records[EventTrace::RING_RECORDS];
+    std::atomic<quint64> head {0};
+    std::atomic<quint64> tail {0};
+    QMutex flushMutex;
+    quint16 thread = 0;
+};
+
+QMutex s_stateMutex;                       // start/stop and ring registration
+std::vector<std::unique_ptr<Ring>> s_rings;
+thread_local Ring *t_ring = nullptr;
+
+QFile s_file;
+std::atomic<uchar *> s_records {nullptr};
+quint64 s_capacity = 0;
+std::atomic<quint64> s_cursor {0};
+std::atomic<quint64> s_dropped {0};
+std::chrono::steady_clock::time_point s_start;
+
+Ring *registerThread()
+{
+    QMutexLocker locker(&s_stateMutex);
+    s_rings.push_back(std::make_unique<Ring>());
+    Ring *ring = s_rings.back().get();
+    ring->thread = static_cast<quint16>(s_rings.size() - 1);
+    return ring;
+}
+
+void flush(Ring &ring)
+{
+    QMutexLocker locker(&ring.flushMutex);
+    quint64 tail = ring.tail.load(std::memory_order_relaxed);
+    quint64 head = ring.head.load(std::memory_order_acquire);
+    quint64 count = head - tail;
+    if (count == 0) return;
+
+    uchar *records = s_records.load(std::memory_order_acquire);
+    if (records) {
+        quint64 slot = s_cursor.fetch_add(count, std::memory_order_relaxed);
+        quint64 fits = slot < s_capacity ? qMin(count, s_capacity - slot) : 0;
+        for (quint64 i = 0; i < fits; ++i) {
+            std::memcpy(records + (slot + i) * sizeof(TraceRecord),
+                        &ring.records[(tail + i) % EventTrace::RING_RECORDS], sizeof(TraceRecord));
+        }
+        s_dropped.fetch_add(count - fits, std::memory_order_relaxed);
+    }
+    ring.tail.store(head, std::memory_order_release);
+}
+
+}
+
+bool EventTrace::start(const QString &path, quint64 capacityRecords)
+{
+    stop();
+    QMutexLocker locker(&s_stateMutex);
+
+    QString filePath = QFileInfo(path).isAbsolute() ? path : QDir(AsyncLogWriter::logDirectory()).filePath(path);
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    s_file.setFileName(filePath);
+    qint64 size = static_cast<qint64>(sizeof(TraceFileHeader) + capacityRecords * sizeof(TraceRecord));
+    if (capacityRecords == 0 || !s_file.open(QIODevice::ReadWrite | QIODevice::Truncate) || !s_file.resize(size)) {
+        qWarning() << "EventTrace: cannot create" << filePath << s_file.errorString();
+        s_file.close();
+        return false;
+    }
+    uchar *map = s_file.map(0, size);
+    if (!map) {
+        qWarning() << "EventTrace: cannot map" << filePath << s_file.errorString();
+        s_file.close();
+        return false;
+    }
+
+    TraceFileHeader header {};
+    std::memcpy(header.magic, "CNTRACE1", sizeof(header.magic));
+    header.version = TRACE_FORMAT_VERSION;
+    header.recordSize = sizeof(TraceRecord);
+    header.capacity = capacityRecords;
+    header.startEpochMs = QDateTime::currentMSecsSinceEpoch();
+    std::memcpy(map, &header, sizeof(header));
+
+    // Rings outlive sessions; whatever they held from an earlier one is discarded.
+    for (const auto &ring : s_rings) {
+        QMutexLocker ringLocker(&ring->flushMutex);
+        ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
+    s_capacity = capacityRecords;
+    s_cursor = 0;
+    s_dropped = 0;
+    s_start = std::chrono::steady_clock::now();
+    s_records.store(map + sizeof(TraceFileHeader), std::memory_order_release);
+    s_enabled.store(true, std::memory_order_release);
+    qDebug() << "EventTrace: writing up to" << capacityRecords << "records to" << filePath;
+    return true;
+}
+
+void EventTrace::stop()
+{
+    QMutexLocker locker(&s_stateMutex);
+    if (!s_records.load(std::memory_order_acquire)) return;
+
+    s_enabled.store(false, std::memory_order_release);
+    for (const auto &ring : s_rings) {
+        flush(*ring);
+    }
+
+    // Wait out flushes that started before the file went away.
+    uchar *records = s_records.exchange(nullptr, std::memory_order_acq_rel);
+    for (const auto &ring : s_rings) {
+        QMutexLocker ringLocker(&ring->flushMutex);
+    }
+
+    uchar *map = records - sizeof(TraceFileHeader);
+    TraceFileHeader header;
+    std::memcpy(&header, map, sizeof(header));
+    header.recordCount = recordsWritten();
+    header.dropped = s_dropped.load();
+    std::memcpy(map, &header, sizeof(header));
+
+    s_file.unmap(map);
+    s_file.close();
+    qDebug() << "EventTrace: stopped with" << header.recordCount << "records," << header.dropped << "dropped";
+}
+
+quint64 EventTrace::recordsWritten()
+{
+    return qMin(s_cursor.load(), s_capacity);
+}
+
+quint64 EventTrace::recordsDropped()
+{
+    return s_dropped.load();
+}
+
+void EventTrace::append(TraceEvent event, int node, qint64 packetId, qint32 arg0, qint32 arg1)
+{
+    Ring *ring = t_ring;
+    if (!ring) {
+        ring = t_ring = registerThread();
+    }
+
+    quint64 head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= RING_RECORDS) {
+        flush(*ring);
+    }
+
+    TraceRecord &record = ring->records[head % RING_RECORDS];
+    record.timestampNs = static_cast<quint64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_start).count());
+    record.packetId = packetId;
+    record.node = node;
+    record.event = static_cast<quint16>(event);
+    record.thread = ring->thread;
+    record.arg0 = arg0;
+    record.arg1 = arg1;
+    ring->head.store(head + 1, std::memory_order_release);
+}
@@ -0,0 +1,103 @@
+#ifndef EVENTTRACE_H
+#define EVENTTRACE_H
+
+#include <atomic>
+#include <QString>
+
+enum class TraceEvent : quint16 {
+    PacketEnqueue = 1,
+    PacketDequeue,
+    PacketForward,    // arg0 = port number, arg1 = TTL left
+    PacketDrop,       // arg0 = TraceDrop
+    PacketDeliver,
+    RouteChange,      // arg0 = RIB version, arg1 = routing table size
+};
+
+enum class TraceDrop : qint32 {
+    TtlExpired = 1,
+    NoRoute,
+    NoPort,
+    BufferFull,
+    BufferExpired,
+    RouterBroken,
+    Malformed,
+    Unsupported,
+};
+
+struct TraceRecord
+{
+    quint64 timestampNs;    // Since EventTrace::start
+    qint64 packetId;        // -1 when the event is not about a packet
+    qint32 node;
+    quint16 event;
+    quint16 thread;         // Small per-thread index, in order of each thread's first record
+    qint32 arg0;
+    qint32 arg1;
+};
+
+struct TraceFileHeader
+{
+    char magic[8];          // "CNTRACE1"
+    quint32 version;
+    quint32 recordSize;
+    quint64 capacity;       // Record slots in the file
+    quint64 recordCount;    // Written by stop(); 0 means the run ended early and readers must scan
+    quint64 dropped;        // Records that did not fit
+    qint64 startEpochMs;
+    char reserved[16];
+};
+
+static_assert(sizeof(TraceRecord) == 32, "trace records are fixed-size");
+static_assert(sizeof(TraceFileHeader) == 64, "trace header is fixed-size");
+
+constexpr quint32 TRACE_FORMAT_VERSION = 1;
+
+inline const char *traceEventName(quint16 event)
+{
+    static const char *const names[] = {"?", "enqueue", "dequeue", "forward", "drop", "deliver", "route"};
+    return event < sizeof(names) / sizeof(names[0]) ? names[event] : "?";
+}
+
+inline const char *traceDropName(qint32 reason)
+{
+    static const char *const names[] = {"?", "ttl", "no-route", "no-port", "buffer-full", "buffer-expired",
+                                        "broken", "malformed", "unsupported"};
+    return reason >= 0 && reason < static_cast<qint32>(sizeof(names) / sizeof(names[0])) ? names[reason] : "?";
+}
+
+// Binary event trace for post-hoc analysis. Each thread appends to its own ring without locking;
+// full rings are copied into a memory-mapped file at a slot range reserved with one atomic add, so
+// records from different threads interleave in the file and readers order them by timestamp.
+// When tracing is off, record() is a single relaxed load.
+class EventTrace
+{
+public:
+    static constexpr int RING_RECORDS = 1024;
+
+    // Relative paths resolve against the log directory. Returns false if the file cannot be mapped.
+    static bool start(const QString &path, quint64 capacityRecords);
+    static void stop();
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    static void record(TraceEvent event, int node, qint64 packetId = -1, qint32 arg0 = 0, qint32 arg1 = 0)
+    {
+        if (isEnabled()) {
+            append(event, node, packetId, arg0, arg1);
+        }
+    }
+
+    static void drop(int node, qint64 packetId, TraceDrop reason)
+    {
+        record(TraceEvent::PacketDrop, node, packetId, static_cast<qint32>(reason));
+    }
+
+    static quint64 recordsWritten();
+    static quint64 recordsDropped();
+
+private:
+    static void append(TraceEvent event, int node, qint64 packetId, qint32 arg0, qint32 arg1);
+
+    static std::atomic<bool> s_enabled;
+};
+
+#endif // EVENTTRACE_H
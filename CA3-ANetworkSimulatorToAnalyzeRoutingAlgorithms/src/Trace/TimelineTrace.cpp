@@ -0,0 +1,186 @@
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <QDir>
+#include <QSet>
+#include <QSaveFile>
+#include <QMutex>
+#include <QDebug>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include "TimelineTrace.h"
+#include "../Logger/AsyncLogWriter.h"
+
+std::atomic<bool> TimelineTrace::s_enabled {false};
+
+namespace {
+
+struct Span
+{
+    const char *name;
+    qint32 track;
+    quint8 kind;
+    qint32 tick;
+    qint64 timeNs;
+    qint64 value;       // Duration for spans, the sample for counters
+};
+
+// Only the owning thread appends; the mutex is uncontended until stop() collects.
+struct ThreadBuffer
+{
+    QMutex mutex;
+    std::vector<Span> spans;
+};
+
+QMutex s_stateMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+thread_local ThreadBuffer *t_buffer = nullptr;
+
+QString s_path;
+quint64 s_maxEvents = 0;
+std::atomic<quint64> s_recorded {0};
+std::atomic<quint64> s_dropped {0};
+qint64 s_originNs = 0;
+qint64 s_tickStartNs = -1;      // Clock thread only
+int s_lastTick = 0;             // Clock thread only
+
+ThreadBuffer *registerThread()
+{
+    QMutexLocker locker(&s_stateMutex);
+    s_buffers.push_back(std::make_unique<ThreadBuffer>());
+    return s_buffers.back().get();
+}
+
+QString micros(qint64 ns)
+{
+    return QString::number(ns / 1000.0, 'f', 3);
+}
+
+QString trackName(int track)
+{
+    return track == TimelineTrace::CLOCK_TRACK ? QString("Clock") : QString("Router %1").arg(track);
+}
+
+}
+
+bool TimelineTrace::start(const QString &path, quint64 maxEvents)
+{
+    stop();
+    QMutexLocker locker(&s_stateMutex);
+
+    s_path = QFileInfo(path).isAbsolute() ? path : QDir(AsyncLogWriter::logDirectory()).filePath(path);
+    QDir().mkpath(QFileInfo(s_path).absolutePath());
+    for (const auto &buffer : s_buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        buffer->spans.clear();
+    }
+    s_maxEvents = maxEvents;
+    s_recorded = 0;
+    s_dropped = 0;
+    s_originNs = now();
+    s_tickStartNs = -1;
+    s_lastTick = 0;
+    s_enabled.store(true, std::memory_order_release);
+    qDebug() << "TimelineTrace: recording to" << s_path;
+    return true;
+}
+
+bool TimelineTrace::stop()
+{
+    QMutexLocker locker(&s_stateMutex);
+    if (!s_enabled.exchange(false, std::memory_order_acq_rel)) return true;
+
+    std::vector<Span> spans;
+    for (const auto &buffer : s_buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        spans.insert(spans.end(), buffer->spans.begin(), buffer->spans.end());
+        buffer->spans.clear();
+        buffer->spans.shrink_to_fit();
+    }
+    std::stable_sort(spans.begin(), spans.end(), [](const Span &a, const Span &b) { return a.timeNs < b.timeNs; });
+
+    QSaveFile file(s_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "TimelineTrace: cannot write" << s_path << file.errorString();
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    out << "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"Network\"}}";
+
+    QSet<int> tracks;
+    for (const Span &span : spans) {
+        if (!tracks.contains(span.track)) {
+            tracks.insert(span.track);
+            out << ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":" << span.track << ",\"name\":\"thread_name\",\"args\":{\"name\":\""
+                << trackName(span.track) << "\"}}";
+            out << ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":" << span.track
+                << ",\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":" << span.track << "}}";
+        }
+
+        QString ts = micros(span.timeNs - s_originNs);
+        if (span.kind == Counter) {
+            out << ",\n{\"ph\":\"C\",\"pid\":1,\"tid\":" << span.track << ",\"name\":\"" << trackName(span.track) << ' '
+                << span.name << "\",\"ts\":" << ts << ",\"args\":{\"value\":" << span.value << "}}";
+        } else {
+            out << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << span.track << ",\"name\":\"" << span.name << "\",\"ts\":" << ts
+                << ",\"dur\":" << micros(span.value) << ",\"args\":{\"tick\":" << span.tick << "}}";
+        }
+    }
+    out << "\n]}\n";
+    out.flush();
+    if (!file.commit()) {
+        qWarning() << "TimelineTrace: cannot write" << s_path << file.errorString();
+        return false;
+    }
+
+    qDebug() << "TimelineTrace: wrote" << spans.size() << "events to" << s_path << "(" << s_dropped.load() << "dropped)";
+    return true;
+}
+
+void TimelineTrace::clockTick(int tick)
+{
+    if (!isEnabled()) return;
+
+    qint64 timeNs = now();
+    if (s_tickStartNs >= 0) {
+        append("tick", CLOCK_TRACK, Complete, s_tickStartNs, timeNs - s_tickStartNs, s_lastTick);
+    }
+    s_tickStartNs = timeNs;
+    s_lastTick = tick;
+}
+
+void TimelineTrace::complete(const char *name, int track, qint64 startNs, int tick)
+{
+    if (isEnabled()) {
+        append(name, track, Complete, startNs, now() - startNs, tick);
+    }
+}
+
+quint64 TimelineTrace::eventsRecorded()
+{
+    return s_recorded.load();
+}
+
+quint64 TimelineTrace::eventsDropped()
+{
+    return s_dropped.load();
+}
+
+void TimelineTrace::append(const char *name, int track, Kind kind, qint64 timeNs, qint64 value, int tick)
+{
+    if (s_recorded.fetch_add(1, std::memory_order_relaxed) >= s_maxEvents) {
+        s_recorded.fetch_sub(1, std::memory_order_relaxed);
+        s_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ThreadBuffer *buffer = t_buffer;
+    if (!buffer) {
+        buffer = t_buffer = registerThread();
+    }
+    QMutexLocker locker(&buffer->mutex);
+    buffer->spans.push_back({name, track, kind, tick, timeNs, value});
+}
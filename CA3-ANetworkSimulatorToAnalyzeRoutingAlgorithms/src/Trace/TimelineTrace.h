@@ -0,0 +1,77 @@
+#ifndef TIMELINETRACE_H
+#define TIMELINETRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <QString>
+
+// Timeline of router work in the Chrome trace_event JSON format, for chrome://tracing or
+// ui.perfetto.dev. Each router is a track (tid = router id) and each span carries the simulated
+// tick it ran in, as read from its simulation's clock; a Clock track shows the ticks themselves
+// against wall time. SimulationContext::startTimeline decides which simulation records it.
+// Spans are buffered per thread and the file is written once, by stop().
+class TimelineTrace
+{
+public:
+    static constexpr int CLOCK_TRACK = -1;
+
+    // Relative paths resolve against the log directory. maxEvents bounds the memory used.
+    static bool start(const QString &path, quint64 maxEvents = 1 << 20);
+    static bool stop();
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Called by the recording simulation's clock once per tick, from the clock's thread.
+    static void clockTick(int tick);
+
+    static qint64 now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // name must outlive the trace; string literals only.
+    static void complete(const char *name, int track, qint64 startNs, int tick);
+    static void counter(const char *name, int track, qint64 value)
+    {
+        if (isEnabled()) {
+            append(name, track, Counter, now(), value, 0);
+        }
+    }
+
+    static quint64 eventsRecorded();
+    static quint64 eventsDropped();
+
+private:
+    enum Kind : quint8 { Complete, Counter };
+    static void append(const char *name, int track, Kind kind, qint64 timeNs, qint64 value, int tick);
+
+    static std::atomic<bool> s_enabled;
+};
+
+// Scoped span on a router's track, tagged with the tick it started in:
+//     TraceSpan span("runDijkstra", m_id, m_context->tick());
+// Costs one relaxed load when the timeline is off.
+class TraceSpan
+{
+public:
+    TraceSpan(const char *name, int track, int tick)
+        : m_name(name), m_track(track), m_start(TimelineTrace::isEnabled() ? TimelineTrace::now() : -1), m_tick(tick)
+    {}
+    ~TraceSpan()
+    {
+        if (m_start >= 0) {
+            TimelineTrace::complete(m_name, m_track, m_start, m_tick);
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *m_name;
+    int m_track;
+    qint64 m_start;
+    int m_tick;
+};
+
+#endif // TIMELINETRACE_H
@@ -12,7 +12,17 @@ RESOURCES += \
     $$PWD/../app/resources.qrc
 
 SOURCES += \
+    $$PWD/BGP/BGPAdjRib.cpp \
+    $$PWD/BGP/BGPRib.cpp \
+    $$PWD/BGP/BGPUpdate.cpp \
+    $$PWD/BGP/IBGPTopology.cpp \
+    $$PWD/BGP/Prefix.cpp \
+    $$PWD/DHCPServer/AddressPool.cpp \
+    $$PWD/DHCPServer/DHCPMessage.cpp \
     $$PWD/DHCPServer/DHCPServer.cpp \
+    $$PWD/DHCPServer/DHCPTransactionCache.cpp \
+    $$PWD/Logger/AsyncLogWriter.cpp \
+    $$PWD/EventsCoordinator/ConvergenceDetector.cpp \
     $$PWD/EventsCoordinator/EventsCoordinator.cpp \
     $$PWD/IP/IP.cpp \
     $$PWD/PortBindingManager/PortBindingManager.cpp \
@@ -20,25 +30,47 @@ SOURCES += \
     $$PWD/MACAddress/MACAddress.cpp \
     $$PWD/MACAddress/MACAddressGenerator.cpp \
     $$PWD/DataGenerator/DataGenerator.cpp \
+    $$PWD/DataGenerator/ArrivalProcess.cpp \
+    $$PWD/DataGenerator/AliasTable.cpp \
+    $$PWD/DataGenerator/TrafficMatrix.cpp \
     $$PWD/Packet/Packet.cpp \
     $$PWD/Header/DataLinkHeader.cpp \
     $$PWD/Header/TCPHeader.cpp \
     $$PWD/NetworkSimulator/Simulator.cpp \
     $$PWD/NetworkSimulator/Network.cpp \
     $$PWD/Network/AutonomousSystem.cpp \
+    $$PWD/Network/ForwardingTable.cpp \
     $$PWD/Network/Router.cpp \
     $$PWD/Network/PC.cpp \
     $$PWD/Network/Node.cpp \
-    $$PWD/NetworkSimulator/ApplicationContext.cpp \
+    $$PWD/NetworkSimulator/ConvergenceOracle.cpp \
+    $$PWD/NetworkSimulator/NetworkSnapshot.cpp \
+    $$PWD/NetworkSimulator/DHCPPhaseTracker.cpp \
+    $$PWD/NetworkSimulator/RoutingValidator.cpp \
     $$PWD/IP/IPHeader.cpp \
     $$PWD/Topology/TopologyController.cpp \
     $$PWD/Topology/TopologyBuilder.cpp \
+    $$PWD/Topology/TopologySnapshot.cpp \
+    $$PWD/Topology/NetworkImage.cpp \
+    $$PWD/Trace/EventTrace.cpp \
+    $$PWD/Trace/TimelineTrace.cpp \
     $$PWD/BroadCast/UDP.cpp \
     $$PWD/Globals/RouterRegistry.cpp \
+    $$PWD/Globals/RandomStream.cpp \
+    $$PWD/Globals/SimulationContext.cpp \
     $$PWD/MetricsCollector/MetricsCollector.cpp
 
 HEADERS += \
+    $$PWD/BGP/BGPAdjRib.h \
+    $$PWD/BGP/BGPRib.h \
+    $$PWD/BGP/BGPUpdate.h \
+    $$PWD/BGP/IBGPTopology.h \
+    $$PWD/BGP/Prefix.h \
+    $$PWD/DHCPServer/AddressPool.h \
+    $$PWD/DHCPServer/DHCPMessage.h \
     $$PWD/DHCPServer/DHCPServer.h \
+    $$PWD/DHCPServer/DHCPTransactionCache.h \
+    $$PWD/EventsCoordinator/ConvergenceDetector.h \
     $$PWD/EventsCoordinator/EventsCoordinator.h \
     $$PWD/Globals/Globals.h \
     $$PWD/IP/IP.h \
@@ -47,21 +79,36 @@ HEADERS += \
     $$PWD/MACAddress/MACAddress.h \
     $$PWD/MACAddress/MACAddressGenerator.h \
     $$PWD/DataGenerator/DataGenerator.h \
+    $$PWD/DataGenerator/ArrivalProcess.h \
+    $$PWD/DataGenerator/AliasTable.h \
+    $$PWD/DataGenerator/TrafficMatrix.h \
     $$PWD/Packet/Packet.h \
     $$PWD/Header/DataLinkHeader.h \
     $$PWD/Header/TCPHeader.h \
     $$PWD/NetworkSimulator/Simulator.h \
     $$PWD/NetworkSimulator/Network.h \
     $$PWD/Network/AutonomousSystem.h \
+    $$PWD/Network/ForwardingTable.h \
     $$PWD/Network/Router.h \
     $$PWD/Network/PC.h \
     $$PWD/Network/Node.h \
-    $$PWD/NetworkSimulator/ApplicationContext.h \
+    $$PWD/NetworkSimulator/ConvergenceOracle.h \
+    $$PWD/NetworkSimulator/NetworkSnapshot.h \
+    $$PWD/NetworkSimulator/DHCPPhaseTracker.h \
+    $$PWD/NetworkSimulator/RoutingValidator.h \
     $$PWD/IP/IPHeader.h \
     $$PWD/Topology/TopologyController.h \
     $$PWD/Topology/TopologyBuilder.h \
+    $$PWD/Topology/TopologySnapshot.h \
+    $$PWD/Topology/NetworkImage.h \
+    $$PWD/Trace/EventTrace.h \
+    $$PWD/Trace/TimelineTrace.h \
     $$PWD/Globals/IdAssignment.h \
     $$PWD/BroadCast/UDP.h \
     $$PWD/Globals/RouterRegistry.h \
+    $$PWD/Globals/RandomStream.h \
+    $$PWD/Globals/SimulationContext.h \
+    $$PWD/Globals/ObjectThread.h \
+    $$PWD/Logger/AsyncLogWriter.h \
     $$PWD/Logger/Logger.h \
     $$PWD/MetricsCollector/MetricsCollector.h
@@ -0,0 +1,95 @@
+#include <QtTest/QtTest>
+#include "../src/DHCPServer/AddressPool.h"
+
+class AddressPoolTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testConfigure();
+    void testInvalidSubnet();
+    void testPreferredHost();
+    void testAllocateUntilExhausted();
+    void testReleaseAndReuse();
+    void testHostOf();
+};
+
+void AddressPoolTests::testConfigure() {
+    AddressPool pool;
+    QVERIFY(pool.configure("192.168.100.0/24"));
+    QCOMPARE(pool.capacity(), 254);
+    QCOMPARE(pool.available(), 254);
+    QCOMPARE(pool.subnet(), QString("192.168.100.0/24"));
+    QCOMPARE(pool.addressOf(1), QString("192.168.100.1"));
+    QCOMPARE(pool.addressOf(254), QString("192.168.100.254"));
+    QCOMPARE(pool.addressOf(255), QString());
+
+    QVERIFY(pool.configure("10.3.7.9/16"));
+    QCOMPARE(pool.subnet(), QString("10.3.0.0/16"));
+    QCOMPARE(pool.capacity(), 65534);
+    QCOMPARE(pool.addressOf(300), QString("10.3.1.44"));
+}
+
+void AddressPoolTests::testInvalidSubnet() {
+    AddressPool pool;
+    QVERIFY(!pool.configure("192.168.100.0"));
+    QVERIFY(!pool.configure("192.168.300.0/24"));
+    QVERIFY(!pool.configure("192.168.100.0/31"));
+    QVERIFY(!pool.isValid());
+    QCOMPARE(pool.allocate(), -1);
+}
+
+void AddressPoolTests::testPreferredHost() {
+    AddressPool pool;
+    pool.configure("192.168.200.0/24");
+
+    QCOMPARE(pool.allocate(23), 23);
+    QVERIFY(pool.isAllocated(23));
+    QVERIFY(!pool.reserve(23));
+
+    // A taken or out-of-range preference falls back to the lowest free host.
+    QCOMPARE(pool.allocate(23), 1);
+    QCOMPARE(pool.allocate(1000), 2);
+    QCOMPARE(pool.available(), 251);
+}
+
+void AddressPoolTests::testAllocateUntilExhausted() {
+    AddressPool pool;
+    pool.configure("10.0.0.0/22");
+
+    QSet<int> hosts;
+    for (int i = 0; i < pool.capacity(); ++i) {
+        int host = pool.allocate();
+        QVERIFY(host >= 1 && host <= pool.capacity());
+        hosts.insert(host);
+    }
+    QCOMPARE(hosts.size(), 1022);
+    QCOMPARE(pool.available(), 0);
+    QCOMPARE(pool.allocate(), -1);
+}
+
+void AddressPoolTests::testReleaseAndReuse() {
+    AddressPool pool;
+    pool.configure("192.168.1.0/28");
+    for (int i = 0; i < pool.capacity(); ++i) {
+        pool.allocate();
+    }
+
+    pool.release(7);
+    pool.release(7);
+    QCOMPARE(pool.available(), 1);
+    QCOMPARE(pool.allocate(), 7);
+    QCOMPARE(pool.allocate(), -1);
+}
+
+void AddressPoolTests::testHostOf() {
+    AddressPool pool;
+    pool.configure("192.168.100.0/24");
+    QCOMPARE(pool.hostOf("192.168.100.42"), 42);
+    QCOMPARE(pool.hostOf("192.168.100.0"), -1);
+    QCOMPARE(pool.hostOf("192.168.100.255"), -1);
+    QCOMPARE(pool.hostOf("192.168.200.42"), -1);
+    QCOMPARE(pool.hostOf("not-an-ip"), -1);
+}
+
+// QTEST_MAIN(AddressPoolTests)
+#include "AddressPoolTests.moc"
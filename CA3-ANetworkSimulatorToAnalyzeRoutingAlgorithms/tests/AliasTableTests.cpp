@@ -0,0 +1,59 @@
+#include <QtTest/QtTest>
+#include <random>
+#include "../src/DataGenerator/AliasTable.h"
+
+class AliasTableTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testEmptyTable();
+    void testSingleEntry();
+    void testZeroWeightNeverSampled();
+    void testSampleFrequencies();
+};
+
+void AliasTableTests::testEmptyTable() {
+    RandomStream rng(1);
+    AliasTable table(std::vector<double> {0.0, 0.0});
+    QVERIFY(table.isEmpty());
+    QCOMPARE(table.sample(rng), -1);
+}
+
+void AliasTableTests::testSingleEntry() {
+    RandomStream rng(1);
+    AliasTable table(std::vector<double> {4.0});
+    QCOMPARE(table.size(), 1);
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(table.sample(rng), 0);
+    }
+}
+
+void AliasTableTests::testZeroWeightNeverSampled() {
+    RandomStream rng(3);
+    AliasTable table(std::vector<double> {1.0, 0.0, 2.0});
+    QCOMPARE(table.probabilityOf(1), 0.0);
+    for (int i = 0; i < 10000; ++i) {
+        QVERIFY(table.sample(rng) != 1);
+    }
+}
+
+void AliasTableTests::testSampleFrequencies() {
+    RandomStream rng(5);
+    std::vector<double> weights {5.0, 1.0, 3.0, 1.0};
+    AliasTable table(weights);
+
+    const int samples = 200000;
+    std::vector<int> counts(weights.size(), 0);
+    for (int i = 0; i < samples; ++i) {
+        counts[table.sample(rng)]++;
+    }
+
+    for (size_t i = 0; i < weights.size(); ++i) {
+        double expected = weights[i] / 10.0;
+        QVERIFY(qAbs(static_cast<double>(counts[i]) / samples - expected) < 0.01);
+        QVERIFY(qAbs(table.probabilityOf(static_cast<int>(i)) - expected) < 1e-12);
+    }
+}
+
+// QTEST_MAIN(AliasTableTests)
+#include "AliasTableTests.moc"
@@ -0,0 +1,388 @@
+#include <QtTest/QtTest>
+#include "../src/BGP/BGPRib.h"
+#include "../src/BGP/BGPAdjRib.h"
+#include "../src/BGP/IBGPTopology.h"
+
+class BGPTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testPrefixParsing();
+    void testPrefixAggregation();
+    void testUpdateRoundTrip();
+    void testMalformedUpdates();
+    void testDecisionProcess();
+    void testMedOnlyWithinNeighborAs();
+    void testLongestPrefixMatch();
+    void testWithdraw();
+    void testReflectionAttributesRoundTrip();
+    void testClusterListTieBreak();
+    void testFullMeshSessions();
+    void testRouteReflectorSessions();
+    void testConfederationSessions();
+    void testAdjRibInDuplicates();
+    void testAdjRibOutPacking();
+    void testAdjRibOutDiff();
+};
+
+static BGPPath makePath(const QString &prefix, int peerId, const QVector<int> &asPath)
+{
+    BGPPath path;
+    Prefix::parse(prefix, path.prefix);
+    path.peerId = peerId;
+    path.asPath = asPath;
+    path.external = true;
+    path.nextHop = QString("10.0.0.%1").arg(peerId);
+    return path;
+}
+
+void BGPTests::testPrefixParsing() {
+    Prefix prefix;
+    QVERIFY(Prefix::parse("192.168.100.77/24", prefix));
+    QCOMPARE(prefix.toString(), QString("192.168.100.0/24"));
+    QCOMPARE(prefix.maskString(), QString("255.255.255.0"));
+    QVERIFY(prefix.contains(QString("192.168.100.31")));
+    QVERIFY(!prefix.contains(QString("192.168.200.31")));
+
+    QVERIFY(!Prefix::parse("192.168.100.0", prefix));
+    QVERIFY(!Prefix::parse("192.168.100.0/33", prefix));
+    QVERIFY(!Prefix::parse("192.168.300.0/24", prefix));
+}
+
+void BGPTests::testPrefixAggregation() {
+    QVector<Prefix> prefixes(4);
+    Prefix::parse("10.1.0.0/25", prefixes[0]);
+    Prefix::parse("10.1.0.128/25", prefixes[1]);
+    Prefix::parse("10.1.1.0/24", prefixes[2]);
+    Prefix::parse("10.1.0.64/26", prefixes[3]);
+
+    QVector<Prefix> aggregated = Prefix::aggregate(prefixes);
+    QCOMPARE(aggregated.size(), 1);
+    QCOMPARE(aggregated.first().toString(), QString("10.1.0.0/23"));
+
+    Prefix::parse("10.2.0.0/24", prefixes[2]);
+    aggregated = Prefix::aggregate(prefixes);
+    QCOMPARE(aggregated.size(), 2);
+    QCOMPARE(aggregated[0].toString(), QString("10.1.0.0/24"));
+    QCOMPARE(aggregated[1].toString(), QString("10.2.0.0/24"));
+}
+
+void BGPTests::testUpdateRoundTrip() {
+    BGPUpdate update;
+    update.internal = true;
+    update.senderId = 17;
+    update.nextHop = "192.168.200.17";
+    update.localPref = 150;
+    update.med = 5;
+    update.asPath = {2, 3};
+    update.announced.resize(2);
+    Prefix::parse("192.168.200.0/24", update.announced[0]);
+    Prefix::parse("10.3.0.0/16", update.announced[1]);
+    update.withdrawn.resize(1);
+    Prefix::parse("10.4.0.0/16", update.withdrawn[0]);
+
+    QCOMPARE(update.toPayload(),
+             QString("BGP_UPDATE:I:17:192.168.200.17:150:5:2,3:192.168.200.0/24;10.3.0.0/16:10.4.0.0/16"));
+
+    BGPUpdate parsed;
+    QVERIFY(BGPUpdate::parse(update.toPayload(), parsed));
+    QVERIFY(parsed.internal);
+    QCOMPARE(parsed.senderId, 17);
+    QCOMPARE(parsed.nextHop, QString("192.168.200.17"));
+    QCOMPARE(parsed.localPref, 150);
+    QCOMPARE(parsed.med, 5);
+    QCOMPARE(parsed.asPath, QVector<int>({2, 3}));
+    QCOMPARE(parsed.announced, update.announced);
+    QCOMPARE(parsed.withdrawn, update.withdrawn);
+}
+
+void BGPTests::testMalformedUpdates() {
+    BGPUpdate parsed;
+    QVERIFY(!BGPUpdate::parse("EBGP_UPDATE:192.168.100.1,255.255.255.255,1#192.168.100.2", parsed));
+    QVERIFY(!BGPUpdate::parse("BGP_UPDATE:X:1:1.1.1.1:100:0::1.0.0.0/8:", parsed));
+    QVERIFY(!BGPUpdate::parse("BGP_UPDATE:E:1:1.1.1.1:100:0:a:1.0.0.0/8:", parsed));
+    QVERIFY(!BGPUpdate::parse("BGP_UPDATE:E:1:1.1.1.1:100:0:1:1.0.0.0:", parsed));
+    QVERIFY(BGPUpdate::parse("BGP_UPDATE:E:1:1.1.1.1:100:0:1::", parsed));
+    QVERIFY(parsed.isEmpty());
+}
+
+void BGPTests::testDecisionProcess() {
+    BGPRib rib;
+    QVERIFY(rib.update(makePath("10.3.0.0/16", 5, {2, 3})));
+
+    // Shorter AS_PATH wins.
+    QVERIFY(rib.update(makePath("10.3.0.0/16", 7, {3})));
+    QCOMPARE(rib.best(makePath("10.3.0.0/16", 0, {}).prefix)->peerId, 7);
+
+    // Higher LOCAL_PREF beats a shorter AS_PATH.
+    BGPPath preferred = makePath("10.3.0.0/16", 9, {4, 5, 3});
+    preferred.localPref = 200;
+    QVERIFY(rib.update(preferred));
+    QCOMPARE(rib.best(preferred.prefix)->peerId, 9);
+
+    // eBGP beats iBGP once everything else ties.
+    BGPPath internal = makePath("10.9.0.0/16", 1, {6});
+    internal.external = false;
+    rib.update(internal);
+    QVERIFY(rib.update(makePath("10.9.0.0/16", 4, {6})));
+    QCOMPARE(rib.best(internal.prefix)->peerId, 4);
+
+    // A locally originated prefix is never displaced.
+    BGPPath local = makePath("10.9.0.0/16", -1, {});
+    QVERIFY(rib.update(local));
+    BGPPath strong = makePath("10.9.0.0/16", 2, {6});
+    strong.localPref = 500;
+    QVERIFY(!rib.update(strong));
+    QVERIFY(rib.best(local.prefix)->isLocal());
+    QCOMPARE(rib.prefixCount(), 2);
+}
+
+void BGPTests::testMedOnlyWithinNeighborAs() {
+    BGPRib rib;
+    BGPPath high = makePath("10.3.0.0/16", 5, {2, 3});
+    high.med = 50;
+    high.igpCost = 5;
+    BGPPath low = makePath("10.3.0.0/16", 6, {2, 3});
+    low.med = 10;
+    low.igpCost = 5;
+    rib.update(high);
+    rib.update(low);
+    QCOMPARE(rib.best(high.prefix)->peerId, 6);
+
+    // MED is not compared across neighbour ASes; the IGP cost decides instead.
+    BGPPath other = makePath("10.3.0.0/16", 8, {4, 3});
+    other.med = 90;
+    other.igpCost = 1;
+    rib.update(other);
+    QCOMPARE(rib.best(high.prefix)->peerId, 8);
+}
+
+void BGPTests::testLongestPrefixMatch() {
+    BGPRib rib;
+    rib.update(makePath("10.0.0.0/8", 1, {2}));
+    rib.update(makePath("10.3.0.0/16", 2, {3}));
+    rib.update(makePath("10.3.7.0/24", 3, {4}));
+
+    QCOMPARE(rib.lookup(QString("10.3.7.9"))->peerId, 3);
+    QCOMPARE(rib.lookup(QString("10.3.8.9"))->peerId, 2);
+    QCOMPARE(rib.lookup(QString("10.200.0.1"))->peerId, 1);
+    QVERIFY(rib.lookup(QString("192.168.100.1")) == nullptr);
+    QVERIFY(rib.lookup(QString("not-an-ip")) == nullptr);
+}
+
+void BGPTests::testWithdraw() {
+    BGPRib rib;
+    rib.update(makePath("10.3.0.0/16", 5, {3}));
+    rib.update(makePath("10.3.0.0/16", 6, {2, 3}));
+    Prefix prefix = makePath("10.3.0.0/16", 0, {}).prefix;
+
+    QVERIFY(!rib.withdraw(prefix, 6));
+    QVERIFY(!rib.withdraw(prefix, 6));
+    QCOMPARE(rib.best(prefix)->peerId, 5);
+
+    QVERIFY(rib.withdraw(prefix, 5));
+    QVERIFY(rib.best(prefix) == nullptr);
+    QCOMPARE(rib.prefixCount(), 0);
+    QVERIFY(rib.lookup(QString("10.3.0.1")) == nullptr);
+}
+
+void BGPTests::testReflectionAttributesRoundTrip() {
+    BGPUpdate update;
+    update.internal = true;
+    update.senderId = 6;
+    update.nextHop = "192.168.100.14";
+    update.asPath = {2};
+    update.originatorId = 14;
+    update.clusterList = {1, 3};
+    update.confedPath = {65002};
+    update.announced.resize(1);
+    Prefix::parse("192.168.200.0/24", update.announced[0]);
+
+    QCOMPARE(update.toPayload(),
+             QString("BGP_UPDATE:I:6:192.168.100.14:100:0:2:192.168.200.0/24::14:1,3:65002"));
+
+    BGPUpdate parsed;
+    QVERIFY(BGPUpdate::parse(update.toPayload(), parsed));
+    QCOMPARE(parsed.originatorId, 14);
+    QCOMPARE(parsed.clusterList, QVector<int>({1, 3}));
+    QCOMPARE(parsed.confedPath, QVector<int>({65002}));
+    QVERIFY(!BGPUpdate::parse("BGP_UPDATE:I:6:1.1.1.1:100:0:2:1.0.0.0/8::14:1,x:", parsed));
+}
+
+void BGPTests::testClusterListTieBreak() {
+    BGPRib rib;
+    BGPPath twice = makePath("10.3.0.0/16", 2, {3});
+    twice.external = false;
+    twice.clusterList = {1, 2};
+    BGPPath once = makePath("10.3.0.0/16", 9, {3});
+    once.external = false;
+    once.clusterList = {1};
+
+    rib.update(twice);
+    rib.update(once);
+    QCOMPARE(rib.best(once.prefix)->peerId, 9);
+    QCOMPARE(rib.pathCount(), 2);
+}
+
+void BGPTests::testFullMeshSessions() {
+    IBGPTopology topology;
+    QVERIFY(topology.configure(QJsonObject(), {1, 2, 3, 4, 5}, {}));
+    QCOMPARE(topology.mode(), IBGPMode::FullMesh);
+    QCOMPARE(topology.sessionCount(), 10);
+    QCOMPARE(topology.roleOf(3).peers.size(), 4);
+    QVERIFY(!topology.roleOf(3).isReflector());
+
+    IBGPMode mode;
+    QVERIFY(IBGPTopology::parseMode("Route_Reflector", mode));
+    QCOMPARE(mode, IBGPMode::RouteReflector);
+    QVERIFY(!IBGPTopology::parseMode("mesh", mode));
+}
+
+void BGPTests::testRouteReflectorSessions() {
+    QJsonObject config = QJsonDocument::fromJson(R"({
+        "mode": "route_reflector",
+        "route_reflectors": [
+            { "router": 1, "cluster_id": 7 },
+            { "router": 2, "clients": [5, 6] }
+        ]
+    })").object();
+
+    IBGPTopology topology;
+    QVERIFY(topology.configure(config, {1, 2, 3, 4, 5, 6}, {}));
+
+    // Reflector 1 serves 3..6, reflector 2 serves 5 and 6, and the reflectors peer with each other.
+    QCOMPARE(topology.sessionCount(), 7);
+
+    IBGPRole reflector = topology.roleOf(1);
+    QCOMPARE(reflector.clusterId, 7);
+    QVERIFY(reflector.findPeer(4)->client);
+    QVERIFY(!reflector.findPeer(2)->client);
+    QCOMPARE(topology.roleOf(2).clusterId, 2);
+
+    IBGPRole client = topology.roleOf(5);
+    QVERIFY(!client.isReflector());
+    QCOMPARE(client.peers.size(), 2);
+    QVERIFY(!client.findPeer(1)->client);
+    QCOMPARE(topology.roleOf(3).peers.size(), 1);
+}
+
+void BGPTests::testConfederationSessions() {
+    QJsonObject config = QJsonDocument::fromJson(R"({
+        "mode": "confederation",
+        "sub_as": [
+            { "id": 65001, "routers": [1, 2, 3] },
+            { "id": 65002, "routers": [4, 5] }
+        ]
+    })").object();
+
+    IBGPTopology topology;
+    QVERIFY(topology.configure(config, {1, 2, 3, 4, 5}, {{3, 4}, {4, 3}, {1, 2}}));
+
+    // Three sessions inside 65001, one inside 65002 and one across the 3-4 link.
+    QCOMPARE(topology.sessionCount(), 5);
+    QCOMPARE(topology.roleOf(3).subAs, 65001);
+    QCOMPARE(topology.roleOf(3).findPeer(4)->subAs, 65002);
+    QVERIFY(topology.roleOf(1).findPeer(4) == nullptr);
+}
+
+void BGPTests::testAdjRibInDuplicates() {
+    BGPAdjRibIn ribIn;
+    BGPPath path = makePath("10.3.0.0/16", 5, {2, 3});
+
+    QVERIFY(ribIn.announce(path));
+    QVERIFY(!ribIn.announce(path));
+
+    path.med = 10;
+    QVERIFY(ribIn.announce(path));
+    QVERIFY(ribIn.announce(makePath("10.3.0.0/16", 6, {3})));
+    QCOMPARE(ribIn.pathCount(), 2);
+
+    QVERIFY(ribIn.withdraw(5, path.prefix));
+    QVERIFY(!ribIn.withdraw(5, path.prefix));
+    QVERIFY(!ribIn.withdraw(9, path.prefix));
+    QCOMPARE(ribIn.pathCount(), 1);
+}
+
+static BGPUpdate makeExport(int senderId, const QVector<int> &asPath)
+{
+    BGPUpdate update;
+    update.senderId = senderId;
+    update.nextHop = QString("10.0.0.%1").arg(senderId);
+    update.asPath = asPath;
+    return update;
+}
+
+void BGPTests::testAdjRibOutPacking() {
+    BGPAdjRibOut ribOut;
+    QVector<Prefix> prefixes(4);
+    Prefix::parse("10.1.0.0/16", prefixes[0]);
+    Prefix::parse("10.2.0.0/16", prefixes[1]);
+    Prefix::parse("10.3.0.0/16", prefixes[2]);
+    Prefix::parse("10.4.0.0/16", prefixes[3]);
+
+    // The same prefix queued twice is sent once.
+    ribOut.queue(7, prefixes);
+    ribOut.queue(7, {prefixes[0]});
+    QCOMPARE(ribOut.pendingPeers(), QVector<int>({7}));
+    QVector<Prefix> pending = ribOut.takePending(7);
+    QCOMPARE(pending.size(), 4);
+    QVERIFY(ribOut.pendingPeers().isEmpty());
+
+    QHash<Prefix, BGPUpdate> exports;
+    exports.insert(prefixes[0], makeExport(1, {1}));
+    exports.insert(prefixes[1], makeExport(1, {1}));
+    exports.insert(prefixes[2], makeExport(1, {1, 3}));
+    exports.insert(prefixes[3], makeExport(1, {1}));
+
+    QVector<BGPUpdate> updates = ribOut.diff(7, pending, exports, makeExport(1, {}));
+    QCOMPARE(updates.size(), 2);
+    int announced = 0;
+    for (const BGPUpdate &update : updates) {
+        announced += update.announced.size();
+        QVERIFY(update.withdrawn.isEmpty());
+    }
+    QCOMPARE(announced, 4);
+    QCOMPARE(ribOut.advertisedCount(), 4);
+}
+
+void BGPTests::testAdjRibOutDiff() {
+    BGPAdjRibOut ribOut;
+    QVector<Prefix> prefixes(2);
+    Prefix::parse("10.1.0.0/16", prefixes[0]);
+    Prefix::parse("10.2.0.0/16", prefixes[1]);
+
+    QHash<Prefix, BGPUpdate> exports;
+    exports.insert(prefixes[0], makeExport(1, {1}));
+    exports.insert(prefixes[1], makeExport(1, {1}));
+    QCOMPARE(ribOut.diff(7, prefixes, exports, makeExport(1, {})).size(), 1);
+
+    // Nothing changed: the peer already has both prefixes.
+    QVERIFY(ribOut.diff(7, prefixes, exports, makeExport(1, {})).isEmpty());
+    QCOMPARE(ribOut.suppressedCount(), 2);
+
+    // Another peer has its own Adj-RIB-Out.
+    QCOMPARE(ribOut.diff(8, prefixes, exports, makeExport(1, {})).size(), 1);
+
+    // One prefix changes path, the other is no longer exported; both fit in one UPDATE.
+    exports.insert(prefixes[0], makeExport(1, {1, 4}));
+    exports.remove(prefixes[1]);
+    QVector<BGPUpdate> updates = ribOut.diff(7, prefixes, exports, makeExport(1, {}));
+    QCOMPARE(updates.size(), 1);
+    QCOMPARE(updates[0].announced, QVector<Prefix>({prefixes[0]}));
+    QCOMPARE(updates[0].withdrawn, QVector<Prefix>({prefixes[1]}));
+
+    // Withdrawing again is a no-op, and a withdrawal on its own still gets an UPDATE.
+    QVERIFY(ribOut.diff(7, {prefixes[1]}, exports, makeExport(1, {})).isEmpty());
+    updates = ribOut.diff(7, {prefixes[0]}, {}, makeExport(1, {}));
+    QCOMPARE(updates.size(), 1);
+    QVERIFY(updates[0].announced.isEmpty());
+    QCOMPARE(updates[0].senderId, 1);
+    QCOMPARE(ribOut.advertisedCount(), 2);
+
+    ribOut.markSent(7, 1000);
+    QCOMPARE(ribOut.lastSent(7), 1000);
+    QCOMPARE(ribOut.lastSent(9), -1);
+}
+
+// QTEST_MAIN(BGPTests)
+#include "BGPTests.moc"
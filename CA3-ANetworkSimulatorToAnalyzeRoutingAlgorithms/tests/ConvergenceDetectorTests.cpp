@@ -0,0 +1,142 @@
+#include <QtTest/QtTest>
+#include "../src/EventsCoordinator/ConvergenceDetector.h"
+
+class ConvergenceDetectorTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testConvergesAfterStableWindow();
+    void testChangeRestartsWindow();
+    void testOracleEndsRunEarly();
+    void testFailingOracleFallsBackToWindow();
+    void testStaleOracleResultIgnored();
+    void testResetStartsNewMeasurement();
+
+private:
+    static QSharedPointer<OracleCheck> finishedCheck(bool clean);
+};
+
+QSharedPointer<OracleCheck> ConvergenceDetectorTests::finishedCheck(bool clean) {
+    auto check = QSharedPointer<OracleCheck>::create();
+    check->clean = clean;
+    check->finished.store(true);
+    return check;
+}
+
+void ConvergenceDetectorTests::testConvergesAfterStableWindow() {
+    ConvergenceDetector detector(3);
+    QVERIFY(!detector.observe(1, 5));
+    QVERIFY(!detector.observe(2, 9));
+    QVERIFY(!detector.observe(3, 9));
+    QVERIFY(!detector.observe(4, 9));
+    QVERIFY(detector.observe(5, 9));
+    QVERIFY(detector.isConverged());
+    QVERIFY(!detector.isVerified());
+    QCOMPARE(detector.lastChangeTick(), 2);
+
+    // Reported once per quiet period.
+    QVERIFY(!detector.observe(6, 9));
+}
+
+void ConvergenceDetectorTests::testChangeRestartsWindow() {
+    ConvergenceDetector detector(2);
+    detector.observe(1, 1);
+    detector.observe(2, 1);
+    QVERIFY(!detector.observe(3, 2));
+    QCOMPARE(detector.quietTicks(), 0);
+    QVERIFY(!detector.observe(4, 2));
+    QVERIFY(detector.observe(5, 2));
+    QCOMPARE(detector.lastChangeTick(), 3);
+
+    // A later change re-arms the detector.
+    QVERIFY(!detector.observe(6, 4));
+    QVERIFY(!detector.isConverged());
+    detector.observe(7, 4);
+    QVERIFY(detector.observe(8, 4));
+    QCOMPARE(detector.lastChangeTick(), 6);
+}
+
+void ConvergenceDetectorTests::testOracleEndsRunEarly() {
+    ConvergenceDetector detector(20);
+    int calls = 0;
+    detector.setOracle([&calls]() { return finishedCheck(++calls >= 2); });
+
+    detector.observe(1, 7);
+    int tick = 2;
+    while (!detector.observe(tick, 7)) {
+        ++tick;
+    }
+
+    // The oracle starts every ORACLE_QUIET_TICKS quiet ticks and passes on its second run, whose
+    // result is picked up on the following tick.
+    QCOMPARE(tick, 2 + 2 * ConvergenceDetector::ORACLE_QUIET_TICKS);
+    QCOMPARE(calls, 2);
+    QVERIFY(detector.isVerified());
+    QCOMPARE(detector.lastChangeTick(), 1);
+}
+
+void ConvergenceDetectorTests::testFailingOracleFallsBackToWindow() {
+    ConvergenceDetector detector(4);
+    detector.setOracle([]() { return finishedCheck(false); });
+
+    detector.observe(1, 3);
+    QVERIFY(!detector.observe(2, 3));
+    QVERIFY(!detector.observe(3, 3));
+    QVERIFY(!detector.observe(4, 3));
+    QVERIFY(detector.observe(5, 3));
+    QVERIFY(!detector.isVerified());
+}
+
+void ConvergenceDetectorTests::testStaleOracleResultIgnored() {
+    ConvergenceDetector detector(6);
+    QVector<QSharedPointer<OracleCheck>> checks;
+    detector.setOracle([&checks]() {
+        checks.append(QSharedPointer<OracleCheck>::create());
+        return checks.last();
+    });
+
+    detector.observe(1, 3);
+    detector.observe(2, 3);
+    detector.observe(3, 3);
+    QCOMPARE(checks.size(), 1);
+
+    // Only one run at a time.
+    detector.observe(4, 3);
+    detector.observe(5, 3);
+    QCOMPARE(checks.size(), 1);
+
+    // The routes change while the run is outstanding; its clean result is about the old ones.
+    QVERIFY(!detector.observe(6, 4));
+    checks[0]->clean = true;
+    checks[0]->finished.store(true);
+    QVERIFY(!detector.observe(7, 4));
+    QVERIFY(!detector.isConverged());
+
+    // A new run starts for the new routes, and the window still applies while it is out.
+    detector.observe(8, 4);
+    QCOMPARE(checks.size(), 2);
+    for (int tick = 9; tick < 12; ++tick) {
+        QVERIFY(!detector.observe(tick, 4));
+    }
+    QVERIFY(detector.observe(12, 4));
+    QVERIFY(!detector.isVerified());
+    QCOMPARE(detector.lastChangeTick(), 6);
+}
+
+void ConvergenceDetectorTests::testResetStartsNewMeasurement() {
+    ConvergenceDetector detector(2);
+    detector.observe(1, 5);
+    detector.observe(2, 5);
+    QVERIFY(detector.observe(3, 5));
+
+    // Nothing changes after the reset, yet the new measurement starts at the next observation.
+    detector.reset();
+    QVERIFY(!detector.isConverged());
+    QVERIFY(!detector.observe(10, 5));
+    QVERIFY(!detector.observe(11, 5));
+    QVERIFY(detector.observe(12, 5));
+    QCOMPARE(detector.lastChangeTick(), 10);
+}
+
+// QTEST_MAIN(ConvergenceDetectorTests)
+#include "ConvergenceDetectorTests.moc"
@@ -0,0 +1,128 @@
+#include <QtTest/QtTest>
+#include "../src/DHCPServer/DHCPMessage.h"
+#include "../src/DHCPServer/DHCPTransactionCache.h"
+
+class DHCPMessageTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testRequestRoundTrip();
+    void testLegacyRequest();
+    void testOfferRoundTrip();
+    void testIPv6Offer();
+    void testNextHop();
+    void testMalformedPayloads();
+    void testTransactionCacheDuplicates();
+    void testTransactionCacheExpiry();
+    void testTransactionCacheCapacity();
+};
+
+void DHCPMessageTests::testRequestRoundTrip() {
+    DHCPMessage request;
+    request.clientId = 24;
+    request.xid = 3735928559u;
+    request.route = {1, 6, 5};
+
+    QCOMPARE(request.toPayload(), QString("DHCP_REQUEST:24:3735928559:F:1,6,5"));
+
+    DHCPMessage parsed;
+    QVERIFY(DHCPMessage::parse(request.toPayload(), parsed));
+    QCOMPARE(parsed.kind, DHCPMessage::Request);
+    QCOMPARE(parsed.clientId, 24);
+    QCOMPARE(parsed.xid, 3735928559u);
+    QVERIFY(!parsed.unicast);
+    QCOMPARE(parsed.route, QVector<int>({1, 6, 5}));
+}
+
+void DHCPMessageTests::testLegacyRequest() {
+    DHCPMessage parsed;
+    QVERIFY(DHCPMessage::parse("DHCP_REQUEST:7", parsed));
+    QCOMPARE(parsed.clientId, 7);
+    QVERIFY(parsed.route.isEmpty());
+}
+
+void DHCPMessageTests::testOfferRoundTrip() {
+    DHCPMessage offer;
+    offer.kind = DHCPMessage::Offer;
+    offer.offeredIP = "192.168.100.24";
+    offer.clientId = 24;
+    offer.xid = 42;
+    offer.route = {5, 6, 1};
+
+    DHCPMessage parsed;
+    QVERIFY(DHCPMessage::parse(offer.toPayload(), parsed));
+    QCOMPARE(parsed.kind, DHCPMessage::Offer);
+    QCOMPARE(parsed.offeredIP, QString("192.168.100.24"));
+    QCOMPARE(parsed.clientId, 24);
+    QCOMPARE(parsed.xid, 42u);
+    QCOMPARE(parsed.route, QVector<int>({5, 6, 1}));
+
+    QVERIFY(DHCPMessage::parse("DHCP_OFFER:192.168.100.3:3", parsed));
+    QCOMPARE(parsed.offeredIP, QString("192.168.100.3"));
+    QCOMPARE(parsed.clientId, 3);
+}
+
+void DHCPMessageTests::testIPv6Offer() {
+    DHCPMessage parsed;
+    QVERIFY(DHCPMessage::parse("DHCP_OFFER:::ffff:c0a8:6418:24:9:5,1", parsed));
+    QCOMPARE(parsed.offeredIP, QString("::ffff:c0a8:6418"));
+    QCOMPARE(parsed.clientId, 24);
+    QCOMPARE(parsed.xid, 9u);
+    QCOMPARE(parsed.route, QVector<int>({5, 1}));
+}
+
+void DHCPMessageTests::testNextHop() {
+    DHCPMessage offer;
+    offer.route = {5, 6, 1};
+    QCOMPARE(offer.nextHop(5), 6);
+    QCOMPARE(offer.nextHop(6), 1);
+    QCOMPARE(offer.nextHop(1), -1);
+    QCOMPARE(offer.nextHop(9), -1);
+}
+
+void DHCPMessageTests::testMalformedPayloads() {
+    DHCPMessage parsed;
+    QVERIFY(!DHCPMessage::parse("DHCP_REQUEST", parsed));
+    QVERIFY(!DHCPMessage::parse("DHCP_REQUEST:abc", parsed));
+    QVERIFY(!DHCPMessage::parse("DHCP_OFFER:1.2.3.4", parsed));
+    QVERIFY(!DHCPMessage::parse("RIP_UPDATE:1", parsed));
+}
+
+void DHCPMessageTests::testTransactionCacheDuplicates() {
+    DHCPTransactionCache cache(16, 1000);
+    DHCPMessage request;
+    request.clientId = 24;
+    request.xid = 1;
+    DHCPMessage offer = request;
+    offer.kind = DHCPMessage::Offer;
+
+    QVERIFY(cache.insert(request.transactionKey(), 0));
+    QVERIFY(!cache.insert(request.transactionKey(), 10));
+    QVERIFY(cache.insert(offer.transactionKey(), 10));
+    request.xid = 2;
+    QVERIFY(cache.insert(request.transactionKey(), 10));
+}
+
+void DHCPMessageTests::testTransactionCacheExpiry() {
+    DHCPTransactionCache cache(16, 1000);
+    QVERIFY(cache.insert(7, 0));
+    QVERIFY(cache.contains(7, 999));
+    QVERIFY(!cache.contains(7, 1000));
+    QVERIFY(cache.insert(7, 1000));
+
+    QVERIFY(cache.insert(8, 2500));
+    QCOMPARE(cache.size(), 1);
+}
+
+void DHCPMessageTests::testTransactionCacheCapacity() {
+    DHCPTransactionCache cache(100, 60000);
+    for (quint64 key = 0; key < 10000; ++key) {
+        QVERIFY(cache.insert(key, static_cast<qint64>(key)));
+    }
+    QCOMPARE(cache.size(), 100);
+    QVERIFY(cache.contains(9999, 10000));
+    QVERIFY(!cache.contains(0, 10000));
+}
+
+// QTEST_MAIN(DHCPMessageTests)
+#include "DHCPMessageTests.moc"
@@ -0,0 +1,68 @@
+#include <QtTest/QtTest>
+#include "../src/NetworkSimulator/DHCPPhaseTracker.h"
+
+class DHCPPhaseTrackerTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testEmptyPhaseIsComplete();
+    void testCompletesWhenAllBound();
+    void testUnknownAndRepeatedNodesIgnored();
+    void testWaitReturnsOnCompletion();
+    void testWaitTimesOut();
+};
+
+void DHCPPhaseTrackerTests::testEmptyPhaseIsComplete() {
+    DHCPPhaseTracker tracker;
+    QVERIFY(tracker.isComplete());
+    QVERIFY(tracker.waitForCompletion(0));
+}
+
+void DHCPPhaseTrackerTests::testCompletesWhenAllBound() {
+    DHCPPhaseTracker tracker;
+    QSignalSpy spy(&tracker, &DHCPPhaseTracker::completed);
+    tracker.expect(1);
+    tracker.expect(2);
+
+    tracker.onIpAssigned(1, "192.168.100.1");
+    QVERIFY(!tracker.isComplete());
+    QCOMPARE(spy.count(), 0);
+
+    tracker.onIpAssigned(2, "192.168.100.2");
+    QVERIFY(tracker.isComplete());
+    QCOMPARE(spy.count(), 1);
+}
+
+void DHCPPhaseTrackerTests::testUnknownAndRepeatedNodesIgnored() {
+    DHCPPhaseTracker tracker;
+    QSignalSpy spy(&tracker, &DHCPPhaseTracker::completed);
+    tracker.expect(5);
+
+    tracker.onIpAssigned(9, "192.168.100.9");
+    QCOMPARE(tracker.pending(), QSet<int>({5}));
+
+    tracker.onIpAssigned(5, "192.168.100.5");
+    tracker.onIpAssigned(5, "192.168.100.5");
+    QCOMPARE(spy.count(), 1);
+}
+
+void DHCPPhaseTrackerTests::testWaitReturnsOnCompletion() {
+    DHCPPhaseTracker tracker;
+    tracker.expect(3);
+    QTimer::singleShot(10, &tracker, [&tracker]() { tracker.onIpAssigned(3, "192.168.100.3"); });
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QVERIFY(tracker.waitForCompletion(5000));
+    QVERIFY(elapsed.elapsed() < 5000);
+}
+
+void DHCPPhaseTrackerTests::testWaitTimesOut() {
+    DHCPPhaseTracker tracker;
+    tracker.expect(4);
+    QVERIFY(!tracker.waitForCompletion(20));
+    QCOMPARE(tracker.pending(), QSet<int>({4}));
+}
+
+// QTEST_MAIN(DHCPPhaseTrackerTests)
+#include "DHCPPhaseTrackerTests.moc"
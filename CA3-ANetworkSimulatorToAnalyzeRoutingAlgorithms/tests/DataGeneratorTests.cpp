@@ -1,37 +1,52 @@
 #include <QtTest/QtTest>
-#include <QSignalSpy>
 #include <QSharedPointer>
 #include "../src/DataGenerator/DataGenerator.h"
+#include "../src/DataGenerator/ArrivalProcess.h"
+#include "../src/DataGenerator/TrafficMatrix.h"
 #include "../src/Network/PC.h"
 #include "../src/Packet/Packet.h"
+#include "../src/Globals/SimulationContext.h"
 
 class DataGeneratorTests : public QObject {
     Q_OBJECT
 
 private Q_SLOTS:
-    void testDefaultLambda();
-    void testSetLambda();
+    void testNoSendersByDefault();
     void testSetSenders();
-    void testGeneratePoissonLoads();
-    void testGeneratePackets();
-    void testPacketsSignalEmission();
+    void testTrafficNeedsTwoSenders();
+    void testDefaultLoadSpreadsPacketsPerSimulation();
+    void testTrafficScheduleBatches();
+    void testParetoArrivalRate();
+    void testOnOffArrivalsAreBursty();
+    void testTraceArrivalsReplay();
+    void testTraceArrivalsEpochTimestamps();
+    void testGravityTrafficMatrix();
+    void testElephantFlowShare();
+
+private:
+    SimulationContext m_context;    // Owns the nodes built by each test
 };
 
-void DataGeneratorTests::testDefaultLambda() {
-    DataGenerator generator;
-    QCOMPARE(static_cast<int>(generator.getSenders().size()), 0);
+static QJsonObject trafficMatrixConfig(const char *matrix)
+{
+    QByteArray json = QByteArray(R"({
+        "Autonomous_systems": [
+            {"id": 1, "gateways": [{"node": 1, "users": [24, 25]}]},
+            {"id": 2, "gateways": [{"node": 20, "users": [32, 33]}]}
+        ],
+        "traffic_matrix": )") + matrix + "}";
+    return QJsonDocument::fromJson(json).object();
 }
 
-void DataGeneratorTests::testSetLambda() {
-    DataGenerator generator;
-    generator.setLambda(5.0);
-    QVERIFY(true); // If no crash happens, test passes.
+void DataGeneratorTests::testNoSendersByDefault() {
+    DataGenerator generator(&m_context);
+    QCOMPARE(static_cast<int>(generator.getSenders().size()), 0);
 }
 
 void DataGeneratorTests::testSetSenders() {
-    DataGenerator generator;
-    QSharedPointer<PC> pc1 = QSharedPointer<PC>::create(1, "192.168.0.1");
-    QSharedPointer<PC> pc2 = QSharedPointer<PC>::create(2, "192.168.0.2");
+    DataGenerator generator(&m_context);
+    QSharedPointer<PC> pc1 = QSharedPointer<PC>::create(1, "192.168.0.1", &m_context);
+    QSharedPointer<PC> pc2 = QSharedPointer<PC>::create(2, "192.168.0.2", &m_context);
 
     std::vector<QSharedPointer<PC>> senders = {pc1, pc2};
     generator.setSenders(senders);
@@ -41,54 +56,183 @@ void DataGeneratorTests::testSetSenders() {
     QCOMPARE(static_cast<int>(generator.getSenders()[1]->getId()), 2);
 }
 
-void DataGeneratorTests::testGeneratePoissonLoads() {
-    DataGenerator generator;
-    generator.setLambda(2.0);
+void DataGeneratorTests::testTrafficNeedsTwoSenders() {
+    DataGenerator generator(&m_context);
+    QVERIFY(!generator.startTraffic());
+    QVERIFY(!generator.hasPendingTraffic());
+    QVERIFY(generator.nextBatch().empty());
+
+    generator.setSenders({QSharedPointer<PC>::create(1, "192.168.0.1", &m_context)});
+    QVERIFY(!generator.startTraffic());
+    QVERIFY(!generator.hasPendingTraffic());
+}
 
-    std::vector<int> loads = generator.generatePoissonLoads(100, 10);
-    QCOMPARE(static_cast<int>(loads.size()), 10);
-    int totalPackets = 0;
-    for (int load : loads) {
-        QVERIFY(load >= 0); // Ensure no negative loads
-        totalPackets += load;
+void DataGeneratorTests::testDefaultLoadSpreadsPacketsPerSimulation() {
+    DataGenerator generator(&m_context);
+    generator.loadConfig(QJsonObject {{"packets_per_simulation", 2000}});
+    generator.setSenders({QSharedPointer<PC>::create(1, "192.168.0.1", &m_context),
+                          QSharedPointer<PC>::create(2, "192.168.0.2", &m_context)});
+    generator.setCycleDuration(std::chrono::milliseconds(100));
+    generator.setTrafficDuration(std::chrono::milliseconds(1000));
+    QVERIFY(generator.startTraffic());
+
+    int total = 0;
+    while (generator.hasPendingTraffic()) {
+        total += static_cast<int>(generator.nextBatch().size());
     }
-    QVERIFY(totalPackets > 0); // Some packets should have been generated
+    QVERIFY(total > 1700 && total < 2300);
 }
 
-void DataGeneratorTests::testGeneratePackets() {
-    DataGenerator generator;
-    QSharedPointer<PC> pc1 = QSharedPointer<PC>::create(1, "192.168.0.1");
-    QSharedPointer<PC> pc2 = QSharedPointer<PC>::create(2, "192.168.0.2");
+void DataGeneratorTests::testTrafficScheduleBatches() {
+    DataGenerator generator(&m_context);
+    QSharedPointer<PC> pc1 = QSharedPointer<PC>::create(1, "192.168.0.1", &m_context);
+    QSharedPointer<PC> pc2 = QSharedPointer<PC>::create(2, "192.168.0.2", &m_context);
+    QSharedPointer<PC> pc3 = QSharedPointer<PC>::create(3, "192.168.0.3", &m_context);
+
+    generator.setSenders({pc1, pc2, pc3});
+    generator.setCycleDuration(std::chrono::milliseconds(100));
+    generator.setTrafficDuration(std::chrono::milliseconds(1000));
+    generator.setOfferedLoad(500.0);
+    QVERIFY(generator.startTraffic());
+
+    int ticks = 0;
+    int total = 0;
+    while (generator.hasPendingTraffic()) {
+        std::vector<QSharedPointer<Packet>> batch = generator.nextBatch();
+        ++ticks;
+        for (const auto &packet : batch) {
+            QVERIFY(packet->getPayload().contains("Hello from PC"));
+            QCOMPARE(packet->getPath().size(), 2);
+            QVERIFY(packet->getPath().at(0) != packet->getPath().at(1));
+        }
+        total += static_cast<int>(batch.size());
+    }
+    QCOMPARE(ticks, 10);
+    QVERIFY(total > 10);
+    QVERIFY(generator.nextBatch().empty());
+}
 
-    generator.setSenders({pc1, pc2});
-    QSignalSpy spy(&generator, &DataGenerator::packetsGenerated);
+void DataGeneratorTests::testParetoArrivalRate() {
+    RandomStream rng(7);
+    ParetoArrivals pareto(100.0, 1.8, 0.1);
 
-    generator.generatePackets();
+    long long total = 0;
+    for (int tick = 0; tick < 20000; ++tick) {
+        int count = pareto.nextTick(rng);
+        QVERIFY(count >= 0);
+        total += count;
+    }
+    // 100 pps over 2000 s; heavy tails converge slowly, so allow a wide band.
+    QVERIFY(total > 150000 && total < 250000);
+}
 
-    QCOMPARE(spy.count(), 1);
+void DataGeneratorTests::testOnOffArrivalsAreBursty() {
+    RandomStream rng(11);
+    OnOffArrivals onOff(200.0, 0.0, 0.5, 1.5, 0.0, 0.1);
+
+    const int ticks = 20000;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    for (int tick = 0; tick < ticks; ++tick) {
+        double count = onOff.nextTick(rng);
+        sum += count;
+        sumSquares += count * count;
+    }
+    double mean = sum / ticks;
+    double variance = sumSquares / ticks - mean * mean;
 
-    QList<QVariant> arguments = spy.takeFirst();
-    auto packets = arguments.at(0).value<std::vector<QSharedPointer<Packet>>>();
+    QVERIFY(mean > 3.0 && mean < 7.0); // 200 pps * 25% duty cycle * 0.1 s
+    QVERIFY(variance > 2.0 * mean);    // overdispersed compared to Poisson
+}
 
-    QVERIFY(packets.size() > 0); // Ensure packets are generated
-    for (const auto &packet : packets) {
-        QVERIFY(packet->getPayload().contains("Hello from PC"));
-    }
+void DataGeneratorTests::testTraceArrivalsReplay() {
+    QTemporaryFile trace;
+    QVERIFY(trace.open());
+    trace.write("# seconds count\n0.01\n0.05 2\n0.25\n");
+    trace.close();
+
+    RandomStream rng(1);
+    TraceArrivals replay(trace.fileName(), 0.1, true);
+    QVERIFY(replay.isValid());
+    QCOMPARE(replay.nextTick(rng), 3);
+    QCOMPARE(replay.nextTick(rng), 0);
+    QCOMPARE(replay.nextTick(rng), 1);
+    QCOMPARE(replay.nextTick(rng), 3); // loops back to the start
 }
 
-void DataGeneratorTests::testPacketsSignalEmission() {
-    DataGenerator generator;
-    QSharedPointer<PC> pc1 = QSharedPointer<PC>::create(1, "192.168.0.1");
-    QSharedPointer<PC> pc2 = QSharedPointer<PC>::create(2, "192.168.0.2");
+void DataGeneratorTests::testTraceArrivalsEpochTimestamps() {
+    QTemporaryFile trace;
+    QVERIFY(trace.open());
+    trace.write("1700000000.01\n1700000000.05 2\n1700000000.25\n");
+    trace.close();
+
+    // Replayed from the first record, not from 1970.
+    RandomStream rng(1);
+    TraceArrivals replay(trace.fileName(), 0.1, false);
+    QVERIFY(replay.isValid());
+    QCOMPARE(replay.nextTick(rng), 3);
+    QCOMPARE(replay.nextTick(rng), 0);
+    QCOMPARE(replay.nextTick(rng), 1);
+    QCOMPARE(replay.nextTick(rng), 0);
+    QVERIFY(ArrivalProcess::checkConfig(QJsonObject {{"model", "trace"}, {"file", trace.fileName()}}, 0.1, nullptr));
+
+    // A span too long to hold one bucket per tick is a configuration error.
+    QTemporaryFile sparse;
+    QVERIFY(sparse.open());
+    sparse.write("0\n1700000000\n");
+    sparse.close();
+    TraceArrivals tooLong(sparse.fileName(), 0.1, false);
+    QVERIFY(!tooLong.isValid());
+    QVERIFY(!tooLong.error().isEmpty());
+    QString error;
+    QVERIFY(!ArrivalProcess::checkConfig(QJsonObject {{"model", "trace"}, {"file", sparse.fileName()}}, 0.1, &error));
+    QVERIFY(error.contains(sparse.fileName()));
+}
 
-    generator.setSenders({pc1, pc2});
-    QSignalSpy spy(&generator, &DataGenerator::packetsGenerated);
+void DataGeneratorTests::testGravityTrafficMatrix() {
+    TrafficMatrix matrix;
+    matrix.loadConfig(trafficMatrixConfig(R"({"model": "gravity", "weights": {"1": 3, "2": 1}})"));
+    matrix.build({24, 25, 32, 33});
+
+    QCOMPARE(matrix.groups().size(), 2);
+    QVERIFY(qAbs(matrix.requestedShare(0, 0) - 9.0 / 16.0) < 1e-9);
+    QVERIFY(qAbs(matrix.requestedShare(0, 1) - 3.0 / 16.0) < 1e-9);
+    QVERIFY(qAbs(matrix.requestedShare(1, 1) - 1.0 / 16.0) < 1e-9);
+    QVERIFY(qAbs(matrix.senderShare(0) - 6.0 / 16.0) < 1e-9);
+
+    RandomStream rng(9);
+    const int n = 4;
+    std::vector<int> counts(n * n, 0);
+    for (int i = 0; i < 100000; ++i) {
+        int sender = matrix.sampleSender(rng);
+        int destination = matrix.sampleDestination(sender, rng);
+        QVERIFY(sender != destination);
+        counts[sender * n + destination]++;
+    }
 
-    generator.generatePackets();
+    std::vector<double> achieved = matrix.achievedShares(counts);
+    for (int g = 0; g < 2; ++g) {
+        for (int h = 0; h < 2; ++h) {
+            QVERIFY(qAbs(achieved[g * 2 + h] - matrix.requestedShare(g, h)) < 0.01);
+        }
+    }
+}
 
-    QCOMPARE(spy.count(), 1);
-    auto packets = spy.takeFirst().at(0).value<std::vector<QSharedPointer<Packet>>>();
-    QVERIFY(packets.size() > 0);
+void DataGeneratorTests::testElephantFlowShare() {
+    TrafficMatrix matrix;
+    matrix.loadConfig(trafficMatrixConfig(R"({"model": "uniform", "elephant_flows": [{"src": 24, "dst": 33, "share": 0.5}]})"));
+    matrix.build({24, 25, 32, 33});
+
+    RandomStream rng(13);
+    int toElephant = 0;
+    const int samples = 60000;
+    for (int i = 0; i < samples; ++i) {
+        if (matrix.sampleDestination(0, rng) == 3) {
+            ++toElephant;
+        }
+    }
+    // Half of PC 24's traffic is pinned to PC 33, the rest is spread over the other three PCs.
+    QVERIFY(qAbs(static_cast<double>(toElephant) / samples - (0.5 + 0.5 / 3.0)) < 0.01);
 }
 
 // QTEST_MAIN(DataGeneratorTests)
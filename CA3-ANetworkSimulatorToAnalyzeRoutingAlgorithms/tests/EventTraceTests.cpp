@@ -0,0 +1,101 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "../src/Trace/EventTrace.h"
+
+class EventTraceTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testDisabledByDefault();
+    void testConcurrentThreads();
+    void testOverflowIsCounted();
+
+private:
+    static QVector<TraceRecord> readRecords(const QString &path, TraceFileHeader &header);
+};
+
+QVector<TraceRecord> EventTraceTests::readRecords(const QString &path, TraceFileHeader &header) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) ||
+        file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header)) {
+        return {};
+    }
+    QVector<TraceRecord> records(static_cast<qsizetype>(header.recordCount));
+    file.read(reinterpret_cast<char *>(records.data()), records.size() * sizeof(TraceRecord));
+    return records;
+}
+
+void EventTraceTests::testDisabledByDefault() {
+    QVERIFY(!EventTrace::isEnabled());
+    EventTrace::record(TraceEvent::PacketEnqueue, 1, 1);
+    EventTrace::stop();
+    QVERIFY(!EventTrace::isEnabled());
+}
+
+void EventTraceTests::testConcurrentThreads() {
+    QTemporaryDir dir;
+    QString path = dir.filePath("trace.bin");
+    const int producers = 4;
+    const int perProducer = 3 * EventTrace::RING_RECORDS + 17;
+    QVERIFY(EventTrace::start(path, producers * perProducer));
+
+    QList<QThread *> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.append(QThread::create([p]() {
+            for (int i = 0; i < perProducer; ++i) {
+                EventTrace::record(TraceEvent::PacketForward, p, i, p, i);
+            }
+        }));
+        threads.last()->start();
+    }
+    for (QThread *thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+    EventTrace::stop();
+
+    TraceFileHeader header;
+    QVector<TraceRecord> records = readRecords(path, header);
+    QCOMPARE(QByteArray(header.magic, sizeof(header.magic)), QByteArray("CNTRACE1"));
+    QCOMPARE(header.version, TRACE_FORMAT_VERSION);
+    QCOMPARE(header.dropped, static_cast<quint64>(0));
+    QCOMPARE(records.size(), producers * perProducer);
+
+    // Threads interleave in the file, but each one's records keep their order.
+    QVector<qint64> next(producers, 0);
+    QVector<quint64> lastTimestamp(producers, 0);
+    for (const TraceRecord &record : records) {
+        QCOMPARE(record.event, static_cast<quint16>(TraceEvent::PacketForward));
+        QCOMPARE(record.arg0, record.node);
+        QCOMPARE(record.packetId, next[record.node]++);
+        QVERIFY(record.timestampNs >= lastTimestamp[record.node]);
+        lastTimestamp[record.node] = record.timestampNs;
+    }
+    for (qint64 count : next) {
+        QCOMPARE(count, static_cast<qint64>(perProducer));
+    }
+}
+
+void EventTraceTests::testOverflowIsCounted() {
+    QTemporaryDir dir;
+    QString path = dir.filePath("small.bin");
+    QVERIFY(EventTrace::start(path, 100));
+    for (int i = 0; i < 250; ++i) {
+        EventTrace::drop(7, i, TraceDrop::NoRoute);
+    }
+    EventTrace::stop();
+    QCOMPARE(EventTrace::recordsWritten(), static_cast<quint64>(100));
+    QCOMPARE(EventTrace::recordsDropped(), static_cast<quint64>(150));
+
+    TraceFileHeader header;
+    QVector<TraceRecord> records = readRecords(path, header);
+    QCOMPARE(header.capacity, static_cast<quint64>(100));
+    QCOMPARE(header.dropped, static_cast<quint64>(150));
+    QCOMPARE(records.size(), 100);
+    QCOMPARE(records.first().packetId, static_cast<qint64>(0));
+    QCOMPARE(records.last().packetId, static_cast<qint64>(99));
+    QCOMPARE(records.last().arg0, static_cast<qint32>(TraceDrop::NoRoute));
+}
+
+// QTEST_MAIN(EventTraceTests)
+#include "EventTraceTests.moc"
@@ -0,0 +1,72 @@
+#include <QtTest/QtTest>
+#include "../src/Network/ForwardingTable.h"
+#include "../src/Globals/SimulationContext.h"
+
+class ForwardingTableTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testAdjacenciesAreShared();
+    void testLookup();
+    void testClear();
+
+private:
+    SimulationContext m_context;    // Owns the nodes built by each test
+};
+
+void ForwardingTableTests::testAdjacenciesAreShared() {
+    auto port1 = PortPtr_t::create(&m_context);
+    auto port2 = PortPtr_t::create(&m_context);
+    port2->setPortNumber(2);
+
+    ForwardingTable table;
+    qint32 a = table.adjacencyFor(port1, "10.0.0.1");
+    QCOMPARE(table.adjacencyFor(port1, "10.0.0.1"), a);
+    qint32 b = table.adjacencyFor(port2, "10.0.0.2");
+    QVERIFY(b != a);
+    QVERIFY(table.adjacencyFor(port1, "10.0.0.3") != a);
+    QCOMPARE(table.adjacencyFor(nullptr, "10.0.0.1"), FibEntry::NO_ADJACENCY);
+
+    QCOMPARE(table.adjacencyCount(), 3);
+    QCOMPARE(table.adjacency(b).port, port2);
+    QCOMPARE(table.adjacency(b).portNumber, static_cast<uint8_t>(2));
+    QCOMPARE(table.adjacency(b).nextHop, QString("10.0.0.2"));
+}
+
+void ForwardingTableTests::testLookup() {
+    auto port = PortPtr_t::create(&m_context);
+    ForwardingTable table;
+    qint32 adjacency = table.adjacencyFor(port, "10.0.0.1");
+
+    // Many destinations behind one neighbour
+    table.insert("10.0.0.5", adjacency, 3, 1, false);
+    table.insert("10.0.0.6", adjacency, 4, 1, false);
+    table.insert("10.0.0.9", FibEntry::NO_ADJACENCY, 1, 1, true);
+    QCOMPARE(table.size(), 3);
+    QCOMPARE(table.adjacencyCount(), 1);
+
+    const FibEntry &entry = table.lookup("10.0.0.6");
+    QVERIFY(entry.isValid());
+    QVERIFY(!entry.isLocal());
+    QCOMPARE(entry.adjacency, adjacency);
+    QCOMPARE(entry.metric, static_cast<qint16>(4));
+
+    QVERIFY(table.lookup("10.0.0.9").isLocal());
+    QVERIFY(!table.lookup("10.0.0.7").isValid());
+    QCOMPARE(table.lookup("10.0.0.7").adjacency, FibEntry::NO_ADJACENCY);
+}
+
+void ForwardingTableTests::testClear() {
+    ForwardingTable table;
+    table.insert("10.0.0.5", table.adjacencyFor(PortPtr_t::create(&m_context), "10.0.0.1"), 3, 1, false);
+    table.setVersion(7);
+    table.clear();
+
+    QCOMPARE(table.size(), 0);
+    QCOMPARE(table.adjacencyCount(), 0);
+    QVERIFY(!table.lookup("10.0.0.5").isValid());
+    QCOMPARE(table.version(), static_cast<quint64>(7));
+}
+
+// QTEST_MAIN(ForwardingTableTests)
+#include "ForwardingTableTests.moc"
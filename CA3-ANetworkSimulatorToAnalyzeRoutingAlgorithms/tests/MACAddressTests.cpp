@@ -35,14 +35,16 @@ void MACAddressTests::testMACAddressInvalidInput() {
 }
 
 void MACAddressTests::testMACAddressGeneration() {
-    MACAddress mac = MACAddressGenerator::generate();
+    MACAddressGenerator generator;
+    MACAddress mac = generator.generate();
     QVERIFY(MACAddress::isValid(mac.toString()));
 }
 
 void MACAddressTests::testMACAddressUniqueness() {
+    MACAddressGenerator generator;
     QSet<QString> generatedAddresses;
     for (int i = 0; i < 1000; ++i) {
-        MACAddress mac = MACAddressGenerator::generate();
+        MACAddress mac = generator.generate();
         QVERIFY(!generatedAddresses.contains(mac.toString()));
         generatedAddresses.insert(mac.toString());
     }
@@ -0,0 +1,82 @@
+#include <QtTest/QtTest>
+#include "../src/MetricsCollector/MetricsCollector.h"
+#include "../src/Network/Router.h"
+#include "../src/Globals/SimulationContext.h"
+
+class MetricsCollectorTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testEmptySummary();
+    void testSummary();
+    void testCongestedRouterKeepsInFlightCount();
+
+private:
+    SimulationContext m_context;    // Owns the nodes built by each test
+};
+
+void MetricsCollectorTests::testEmptySummary() {
+    MetricsCollector collector;
+    QJsonObject summary = collector.summary();
+    QCOMPARE(summary.value("sent").toInt(), 0);
+    QCOMPARE(summary.value("loss_rate").toDouble(), 0.0);
+    QCOMPARE(summary.value("wait_cycles_p99").toInt(), 0);
+}
+
+void MetricsCollectorTests::testSummary() {
+    MetricsCollector collector;
+    for (int i = 0; i < 4; ++i) {
+        collector.recordPacketSent();
+    }
+    collector.recordPacketReceived({"192.168.100.1", "192.168.100.2"});
+    collector.recordPacketReceived({"192.168.100.1"});
+    collector.recordPacketReceived({"192.168.100.3"});
+    collector.recordPacketDropped();
+    collector.recordHopCount(6);
+    for (int cycles = 100; cycles >= 1; --cycles) {
+        collector.recordWaitCycle(cycles);
+    }
+    for (int i = 0; i < 5; ++i) {
+        collector.recordPacketProcessed();
+    }
+
+    QJsonObject summary = collector.summary();
+    QCOMPARE(summary.value("sent").toInt(), 4);
+    QCOMPARE(summary.value("received").toInt(), 3);
+    QCOMPARE(summary.value("dropped").toInt(), 1);
+    QCOMPARE(summary.value("loss_rate").toDouble(), 0.25);
+    QCOMPARE(summary.value("average_hops").toDouble(), 2.0);
+    QCOMPARE(summary.value("packets_processed").toInt(), 5);
+    QCOMPARE(summary.value("wait_cycles_p50").toInt(), 50);
+    QCOMPARE(summary.value("wait_cycles_p90").toInt(), 90);
+    QCOMPARE(summary.value("wait_cycles_p99").toInt(), 99);
+    QCOMPARE(summary.value("wait_cycles_max").toInt(), 100);
+}
+
+void MetricsCollectorTests::testCongestedRouterKeepsInFlightCount() {
+    auto metrics = QSharedPointer<MetricsCollector>::create();
+    Router router(1, "10.0.0.1", &m_context);
+    router.setMetricsCollector(metrics);
+    router.setBufferSize(1);
+    QVERIFY(router.enqueuePacketToBuffer(PacketPtr_t::create(PacketType::Control, "RIP_UPDATE")));
+    metrics->recordPacketSent();
+
+    // Control traffic hitting the full buffer is not part of the delivery metrics.
+    router.processPacket(PacketPtr_t::create(PacketType::Control, "RIP_UPDATE"), nullptr);
+    QCOMPARE(metrics->packetsInFlight(), 1);
+
+    // A data packet is dropped once at the full buffer and never also delivered.
+    router.processPacket(PacketPtr_t::create(PacketType::Data, "Data:10.0.0.1:hello"), nullptr);
+    QCOMPARE(metrics->packetsInFlight(), 0);
+    QCOMPARE(metrics->summary().value("dropped").toInt(), 1);
+    QCOMPARE(metrics->summary().value("received").toInt(), 0);
+
+    Router broken(2, "10.0.0.2", &m_context, 6, nullptr, true);
+    broken.setMetricsCollector(metrics);
+    metrics->recordPacketSent();
+    broken.processPacket(PacketPtr_t::create(PacketType::OSPFHello, "OSPF_HELLO"), nullptr);
+    QCOMPARE(metrics->packetsInFlight(), 1);
+}
+
+// QTEST_MAIN(MetricsCollectorTests)
+#include "MetricsCollectorTests.moc"
@@ -0,0 +1,119 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QSharedPointer>
+#include "../src/BGP/Prefix.h"
+#include "../src/Network/Router.h"
+#include "../src/PortBindingManager/PortBindingManager.h"
+#include "../src/Topology/NetworkImage.h"
+#include "../src/Globals/SimulationContext.h"
+
+class NetworkImageTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testWriteAndMap();
+    void testWithoutFibs();
+    void testRejectsCorruptImages();
+
+private:
+    SimulationContext m_context;    // Owns the nodes built by each test
+    static quint32 address(const QString &text);
+};
+
+quint32 NetworkImageTests::address(const QString &text) {
+    quint32 value = 0;
+    Prefix::parseAddress(text, value);
+    return value;
+}
+
+void NetworkImageTests::testWriteAndMap() {
+    auto r1 = QSharedPointer<Router>::create(1, "10.0.0.1", &m_context);
+    auto r2 = QSharedPointer<Router>::create(2, "10.0.0.2", &m_context);
+    auto r3 = QSharedPointer<Router>::create(3, "10.0.0.3", &m_context);
+    PortBindingManager bindingManager;
+    PortPtr_t r1ToR2 = r1->getAvailablePort();
+    bindingManager.bind(r1ToR2, r2->getAvailablePort(), 1, 2);
+    PortPtr_t r2ToR3 = r2->getAvailablePort();
+    bindingManager.bind(r2ToR3, r3->getAvailablePort(), 2, 3);
+    r1->addRoute("10.0.0.3", "255.255.255.255", "10.0.0.2", 2, RoutingProtocol::RIP, r1ToR2);
+    r2->addRoute("10.0.0.3", "255.255.255.255", "10.0.0.3", 1, RoutingProtocol::RIP, r2ToR3);
+
+    QTemporaryDir directory;
+    QString path = directory.filePath("network.img");
+    QString error;
+    QVERIFY(NetworkImage::write(path, {r3, r1, r2}, {}, true, &error));
+
+    NetworkImage image;
+    QVERIFY2(image.open(path, &error), qPrintable(error));
+    QCOMPARE(image.nodeCount(), 3);
+    QCOMPARE(image.header().routerCount, quint32(3));
+    QCOMPARE(image.header().edgeCount, quint64(4));
+
+    // Nodes are numbered in id order
+    QCOMPARE(image.node(0).id, 1);
+    QCOMPARE(image.indexOf(2), 1);
+    QCOMPARE(image.indexOf(9), -1);
+    QCOMPARE(image.indexOfAddress(address("10.0.0.3")), 2);
+    QCOMPARE(image.indexOfAddress(address("10.0.0.9")), -1);
+
+    QCOMPARE(image.degree(1), 2);
+    QCOMPARE(image.portTo(0, 1), static_cast<int>(r1ToR2->getPortNumber()));
+    QCOMPARE(image.portTo(0, 2), -1);
+
+    QVERIFY(image.hasFibs());
+    const ImageFibEntry *entry = image.lookup(0, address("10.0.0.3"));
+    QVERIFY(entry);
+    QCOMPARE(entry->nextHop, 1);
+    QCOMPARE(entry->port, r1ToR2->getPortNumber());
+    QCOMPARE(entry->metric, static_cast<qint16>(2));
+    QCOMPARE(image.lookup(1, address("10.0.0.3"))->nextHop, 2);
+    QVERIFY(!image.lookup(0, address("10.0.0.9")));
+}
+
+void NetworkImageTests::testWithoutFibs() {
+    auto router = QSharedPointer<Router>::create(1, "10.0.0.1", &m_context);
+    router->addDirectRoute("10.0.0.1", "255.255.255.255");
+
+    QTemporaryDir directory;
+    QString path = directory.filePath("network.img");
+    QString error;
+    QVERIFY(NetworkImage::write(path, {router}, {}, false, &error));
+
+    NetworkImage image;
+    QVERIFY(image.open(path, &error));
+    QVERIFY(!image.hasFibs());
+    QVERIFY(!image.lookup(0, address("10.0.0.1")));
+    QCOMPARE(image.degree(0), 0);
+}
+
+void NetworkImageTests::testRejectsCorruptImages() {
+    auto router = QSharedPointer<Router>::create(1, "10.0.0.1", &m_context);
+    QTemporaryDir directory;
+    QString path = directory.filePath("network.img");
+    QString error;
+    QVERIFY(NetworkImage::write(path, {router}, {}, true, &error));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray bytes = file.readAll();
+    file.close();
+
+    QFile truncated(directory.filePath("truncated.img"));
+    QVERIFY(truncated.open(QIODevice::WriteOnly));
+    truncated.write(bytes.left(bytes.size() - 8));
+    truncated.close();
+
+    NetworkImage image;
+    QVERIFY(!image.open(truncated.fileName(), &error));
+    QVERIFY(!image.isOpen());
+
+    QFile garbage(directory.filePath("garbage.img"));
+    QVERIFY(garbage.open(QIODevice::WriteOnly));
+    garbage.write(QByteArray(128, 'x'));
+    garbage.close();
+    QVERIFY(!image.open(garbage.fileName(), &error));
+    QVERIFY(!image.open(directory.filePath("missing.img"), &error));
+}
+
+// QTEST_MAIN(NetworkImageTests)
+#include "NetworkImageTests.moc"
@@ -0,0 +1,103 @@
+#include <QtTest/QtTest>
+#include <QDataStream>
+#include <QTemporaryDir>
+#include "../src/Network/Router.h"
+#include "../src/NetworkSimulator/Network.h"
+#include "../src/NetworkSimulator/NetworkSnapshot.h"
+#include "../src/Globals/SimulationContext.h"
+
+class NetworkSnapshotTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testRouterStateRoundTrip();
+    void testCorruptStateLeavesRouterUntouched();
+    void testParseStateOnlyReads();
+    void testRestoreChecksFile();
+
+private:
+    SimulationContext m_context;    // Owns the nodes built by each test
+};
+
+void NetworkSnapshotTests::testRouterStateRoundTrip() {
+    Router source(1, "10.0.0.1", &m_context);
+    source.addDirectRoute("10.0.0.1", "255.255.255.255");
+    source.addRoute("10.0.0.5", "255.255.255.255", "10.0.0.2", 2, RoutingProtocol::OSPF, source.getPorts()[1]);
+
+    QByteArray state;
+    QDataStream out(&state, QIODevice::WriteOnly);
+    source.writeState(out);
+
+    Router target(1, "10.0.0.9", &m_context);
+    quint64 version = target.getRibVersion();
+    QDataStream in(state);
+    QVERIFY(target.readState(in));
+
+    QCOMPARE(target.getIPAddress(), QString("10.0.0.1"));
+    QVERIFY(target.getRibVersion() > version);
+    RouteEntry route = target.findBestRoutePath("10.0.0.5");
+    QCOMPARE(route.nextHop, QString("10.0.0.2"));
+    QCOMPARE(route.metric, 2);
+    QVERIFY(route.protocol == RoutingProtocol::OSPF);
+    QCOMPARE(route.learnedFromPort, target.getPorts()[1]);    // The target's own port, by number
+    QCOMPARE(target.forwardingEntry("10.0.0.5").metric, static_cast<qint16>(2));
+}
+
+void NetworkSnapshotTests::testCorruptStateLeavesRouterUntouched() {
+    Router source(1, "10.0.0.1", &m_context);
+    source.addRoute("10.0.0.5", "255.255.255.255", "10.0.0.2", 2, RoutingProtocol::RIP);
+    QByteArray state;
+    QDataStream out(&state, QIODevice::WriteOnly);
+    source.writeState(out);
+
+    Router target(1, "10.0.0.9", &m_context);
+    QDataStream in(state.left(state.size() / 2));
+    QVERIFY(!target.readState(in));
+    QCOMPARE(target.getIPAddress(), QString("10.0.0.9"));
+    QVERIFY(target.findBestRoutePath("10.0.0.5").destination.isEmpty());
+}
+
+void NetworkSnapshotTests::testParseStateOnlyReads() {
+    Router source(1, "10.0.0.1", &m_context);
+    source.addRoute("10.0.0.5", "255.255.255.255", "10.0.0.2", 2, RoutingProtocol::RIP);
+    QByteArray state;
+    QDataStream out(&state, QIODevice::WriteOnly);
+    source.writeState(out);
+
+    // Snapshot restores parse every router's state before applying any of them.
+    Router target(1, "10.0.0.9", &m_context);
+    quint64 version = target.getRibVersion();
+    RouterState parsed;
+    QDataStream in(state);
+    QVERIFY(target.parseState(in, parsed));
+    QCOMPARE(target.getIPAddress(), QString("10.0.0.9"));
+    QCOMPARE(target.getRibVersion(), version);
+    QCOMPARE(parsed.ip, QString("10.0.0.1"));
+
+    target.applyState(parsed);
+    QCOMPARE(target.getIPAddress(), QString("10.0.0.1"));
+    QCOMPARE(target.findBestRoutePath("10.0.0.5").nextHop, QString("10.0.0.2"));
+}
+
+void NetworkSnapshotTests::testRestoreChecksFile() {
+    QTemporaryDir directory;
+    SimulationContext context;
+    Network network(QJsonObject(), &context);
+    QString path = directory.filePath("converged.snap");
+    QString error;
+
+    QVERIFY(NetworkSnapshot::save(path, network, "topology-a", &error));
+    QVERIFY(!NetworkSnapshot::restore(path, network, "topology-b", &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(NetworkSnapshot::restore(path, network, "topology-a", &error));
+
+    QFile garbage(directory.filePath("garbage.snap"));
+    QVERIFY(garbage.open(QIODevice::WriteOnly));
+    garbage.write("not a snapshot");
+    garbage.close();
+    QVERIFY(!NetworkSnapshot::restore(garbage.fileName(), network, "topology-a", &error));
+    QVERIFY(!NetworkSnapshot::restore(directory.filePath("missing.snap"), network, "topology-a", &error));
+}
+
+// QTEST_MAIN(NetworkSnapshotTests)
+#include "NetworkSnapshotTests.moc"
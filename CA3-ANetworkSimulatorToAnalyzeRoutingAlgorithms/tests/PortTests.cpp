@@ -1,5 +1,7 @@
 #include <QtTest/QtTest>
 #include "../src/Port/Port.h"
+#include "../src/Network/Router.h"
+#include "../src/Globals/SimulationContext.h"
 
 class PortTests : public QObject {
     Q_OBJECT
@@ -9,30 +11,35 @@ private Q_SLOTS:
     void testSetAndGetRouterIP();
     void testConnectionState();
     void testPacketTransmission();
+    void testConnectedRouterIPFollowsReassignment();
+
+private:
+    SimulationContext m_context;    // Owns the nodes built by each test
 };
 
 void PortTests::testSetAndGetPortNumber() {
-    Port port;
+    Port port(&m_context);
     port.setPortNumber(10);
     QCOMPARE(port.getPortNumber(), static_cast<uint8_t>(10));
 }
 
 void PortTests::testSetAndGetRouterIP() {
-    Port port;
+    Port port(&m_context);
     QString ip = "192.168.1.1";
     port.setRouterIP(ip);
     QCOMPARE(port.getRouterIP(), ip);
 }
 
 void PortTests::testConnectionState() {
-    Port port;
+    Port port(&m_context);
     QVERIFY(!port.isConnected());
     port.setConnected(true);
     QVERIFY(port.isConnected());
 }
 
 void PortTests::testPacketTransmission() {
-    Port port1, port2;
+    Port port1(&m_context);
+    Port port2(&m_context);
 
     QSignalSpy spy1(&port1, &Port::packetSent);
     QSignalSpy spy2(&port2, &Port::packetReceived);
@@ -46,5 +53,27 @@ void PortTests::testPacketTransmission() {
     QCOMPARE(spy2.count(), 1);
 }
 
+void PortTests::testConnectedRouterIPFollowsReassignment() {
+    SimulationContext context;
+    QSharedPointer<Router> neighbor = QSharedPointer<Router>::create(42, "10.0.0.42", &context);
+    context.routers().addRouters({neighbor});
+
+    Port port(&context);
+    QCOMPARE(port.getConnectedRouterIP(), QString());
+    port.setConnectedRouterId(42);
+    QCOMPARE(port.getConnectedRouterIP(), QString("10.0.0.42"));
+    QCOMPARE(port.getConnectedRouterIP(), QString("10.0.0.42"));
+
+    // Leases in another simulation leave this one's cached addresses valid
+    quint64 epoch = context.addressEpoch();
+    QSharedPointer<Router> stranger = QSharedPointer<Router>::create(7, "10.0.1.7", &m_context);
+    stranger->setIP("10.0.1.8");
+    QCOMPARE(context.addressEpoch(), epoch);
+
+    // A new address for the neighbour replaces the cached one
+    neighbor->setIP("10.0.0.99");
+    QCOMPARE(port.getConnectedRouterIP(), QString("10.0.0.99"));
+}
+
 // QTEST_MAIN(PortTests)
 #include "PortTests.moc"
@@ -0,0 +1,84 @@
+#include <QtTest/QtTest>
+#include <random>
+#include "../src/Globals/RandomStream.h"
+#include "../src/MACAddress/MACAddressGenerator.h"
+
+class RandomStreamTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testSameSeedSameSequence();
+    void testComponentsAreIndependent();
+    void testCounterBasedAccess();
+    void testSeededMACAddress();
+};
+
+void RandomStreamTests::testSameSeedSameSequence() {
+    RandomStream::setGlobalSeed(42);
+    RandomStream first = RandomStream::forComponent("traffic");
+    RandomStream second = RandomStream::forComponent("traffic");
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(first(), second());
+    }
+
+    RandomStream::setGlobalSeed(43);
+    RandomStream other = RandomStream::forComponent("traffic");
+    RandomStream::setGlobalSeed(42);
+    RandomStream again = RandomStream::forComponent("traffic");
+    QVERIFY(other() != again());
+}
+
+void RandomStreamTests::testComponentsAreIndependent() {
+    RandomStream::setGlobalSeed(7);
+    RandomStream traffic = RandomStream::forComponent("traffic");
+    RandomStream mac = RandomStream::forComponent("mac", 1);
+    RandomStream mac2 = RandomStream::forComponent("mac", 2);
+    quint64 t = traffic();
+    quint64 m = mac();
+    QVERIFY(t != m);
+    QVERIFY(m != mac2());
+
+    // Draws from one stream do not shift another.
+    RandomStream fresh = RandomStream::forComponent("traffic");
+    for (int i = 0; i < 10; ++i) {
+        mac();
+    }
+    QCOMPARE(fresh(), t);
+}
+
+void RandomStreamTests::testCounterBasedAccess() {
+    RandomStream stream(123);
+    quint64 third = stream.at(2);
+    stream();
+    stream();
+    QCOMPARE(stream(), third);
+    QCOMPARE(stream.position(), quint64(3));
+
+    std::uniform_int_distribution<int> dice(1, 6);
+    RandomStream a(5);
+    RandomStream b(5);
+    for (int i = 0; i < 50; ++i) {
+        QCOMPARE(dice(a), dice(b));
+    }
+}
+
+void RandomStreamTests::testSeededMACAddress() {
+    quint64 bits = RandomStream::forComponent(2024, "mac", 9001)();
+    QString expected;
+    for (int i = 0; i < 6; ++i) {
+        expected += QString::asprintf("%02X", static_cast<int>((bits >> (8 * i)) & 0xFF));
+        if (i < 5) expected += ":";
+    }
+
+    MACAddressGenerator generator(2024);
+    MACAddress first = generator.generate(9001);
+    QCOMPARE(first.toString(), expected);
+
+    // Reusing a key under the same seed collides with the address handed out above and must move on.
+    MACAddress second = generator.generate(9001);
+    QVERIFY(first.toString() != second.toString());
+    QVERIFY(MACAddress::isValid(second.toString()));
+}
+
+// QTEST_MAIN(RandomStreamTests)
+#include "RandomStreamTests.moc"
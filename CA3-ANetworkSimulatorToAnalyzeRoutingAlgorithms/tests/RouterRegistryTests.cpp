@@ -2,6 +2,7 @@
 #include <QSharedPointer>
 #include "../src/Globals/RouterRegistry.h"
 #include "../src/Network/Router.h"
+#include "../src/Globals/SimulationContext.h"
 
 class RouterRegistryTests : public QObject {
     Q_OBJECT
@@ -11,62 +12,82 @@ private Q_SLOTS:
     void testFindRouterById();
     void testFindRouterById_NotFound();
     void testDuplicateRouterIds();
+    void testFindAfterDirectEdit();
+
+private:
+    SimulationContext m_context;    // Owns the nodes built by each test
 };
 
 void RouterRegistryTests::testAddRouters() {
-    // Clear previous routers
-    RouterRegistry::allRouters.clear();
+    RouterRegistry registry;
 
-    QSharedPointer<Router> router1 = QSharedPointer<Router>::create(1, "192.168.1.1");
-    QSharedPointer<Router> router2 = QSharedPointer<Router>::create(2, "192.168.1.2");
+    QSharedPointer<Router> router1 = QSharedPointer<Router>::create(1, "192.168.1.1", &m_context);
+    QSharedPointer<Router> router2 = QSharedPointer<Router>::create(2, "192.168.1.2", &m_context);
 
     std::vector<QSharedPointer<Router>> routers = {router1, router2};
-    RouterRegistry::addRouters(routers);
+    registry.addRouters(routers);
 
-    QCOMPARE(RouterRegistry::allRouters.size(), static_cast<size_t>(2));
-    QCOMPARE(RouterRegistry::allRouters[0]->getId(), 1);
-    QCOMPARE(RouterRegistry::allRouters[1]->getId(), 2);
+    QCOMPARE(registry.allRouters.size(), static_cast<size_t>(2));
+    QCOMPARE(registry.allRouters[0]->getId(), 1);
+    QCOMPARE(registry.allRouters[1]->getId(), 2);
 }
 
 void RouterRegistryTests::testFindRouterById() {
-    // Clear previous routers
-    RouterRegistry::allRouters.clear();
+    RouterRegistry registry;
 
-    QSharedPointer<Router> router1 = QSharedPointer<Router>::create(1, "192.168.1.1");
-    QSharedPointer<Router> router2 = QSharedPointer<Router>::create(2, "192.168.1.2");
+    QSharedPointer<Router> router1 = QSharedPointer<Router>::create(1, "192.168.1.1", &m_context);
+    QSharedPointer<Router> router2 = QSharedPointer<Router>::create(2, "192.168.1.2", &m_context);
 
-    RouterRegistry::addRouters({router1, router2});
+    registry.addRouters({router1, router2});
 
-    auto foundRouter = RouterRegistry::findRouterById(1);
+    auto foundRouter = registry.findRouterById(1);
     QVERIFY(foundRouter != nullptr);
     QCOMPARE(foundRouter->getId(), 1);
     QCOMPARE(foundRouter->getIPAddress(), QString("192.168.1.1"));
 }
 
 void RouterRegistryTests::testFindRouterById_NotFound() {
-    // Clear previous routers
-    RouterRegistry::allRouters.clear();
+    RouterRegistry registry;
 
-    QSharedPointer<Router> router1 = QSharedPointer<Router>::create(1, "192.168.1.1");
-    RouterRegistry::addRouters({router1});
+    QSharedPointer<Router> router1 = QSharedPointer<Router>::create(1, "192.168.1.1", &m_context);
+    registry.addRouters({router1});
 
-    auto foundRouter = RouterRegistry::findRouterById(999); // Non-existing ID
+    auto foundRouter = registry.findRouterById(999); // Non-existing ID
     QVERIFY(foundRouter == nullptr);
 }
 
 void RouterRegistryTests::testDuplicateRouterIds() {
-    // Clear previous routers
-    RouterRegistry::allRouters.clear();
+    RouterRegistry registry;
 
-    QSharedPointer<Router> router1 = QSharedPointer<Router>::create(1, "192.168.1.1");
-    QSharedPointer<Router> routerDuplicate = QSharedPointer<Router>::create(1, "192.168.1.100");
+    QSharedPointer<Router> router1 = QSharedPointer<Router>::create(1, "192.168.1.1", &m_context);
+    QSharedPointer<Router> routerDuplicate = QSharedPointer<Router>::create(1, "192.168.1.100", &m_context);
 
-    RouterRegistry::addRouters({router1, routerDuplicate});
+    registry.addRouters({router1, routerDuplicate});
 
-    auto foundRouter = RouterRegistry::findRouterById(1);
+    auto foundRouter = registry.findRouterById(1);
     QVERIFY(foundRouter != nullptr);
     QCOMPARE(foundRouter->getIPAddress(), QString("192.168.1.1")); // First added router should remain
 }
 
+void RouterRegistryTests::testFindAfterDirectEdit() {
+    RouterRegistry registry;
+
+    QSharedPointer<Router> router1 = QSharedPointer<Router>::create(1, "192.168.1.1", &m_context);
+    QSharedPointer<Router> router40 = QSharedPointer<Router>::create(40, "192.168.1.40", &m_context);
+    registry.addRouters({router40, router1});
+
+    QCOMPARE(registry.findRouterById(40), router40);
+    QVERIFY(registry.findRouterById(-1) == nullptr);
+    QVERIFY(registry.findRouterById(1000) == nullptr);
+
+    // Routers pushed without addRouters are still found
+    QSharedPointer<Router> router7 = QSharedPointer<Router>::create(7, "192.168.1.7", &m_context);
+    registry.allRouters.push_back(router7);
+    QCOMPARE(registry.findRouterById(7), router7);
+
+    registry.allRouters.clear();
+    QVERIFY(registry.findRouterById(40) == nullptr);
+}
+
 // QTEST_MAIN(RouterRegistryTests)
 #include "RouterRegistryTests.moc"
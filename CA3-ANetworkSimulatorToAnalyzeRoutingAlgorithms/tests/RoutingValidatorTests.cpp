@@ -0,0 +1,170 @@
+#include <QtTest/QtTest>
+#include "../src/NetworkSimulator/RoutingValidator.h"
+
+class RoutingValidatorTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testShortestPathTablesAreClean();
+    void testBlackHoleAndLoop();
+    void testDetourCountsStretch();
+    void testDomains();
+    void testThreadCountDoesNotChangeResult();
+    void testNewTopologyReplacesCachedDistances();
+};
+
+// rows x columns grid; node r * columns + c.
+static QVector<QPair<int, int>> gridLinks(int rows, int columns)
+{
+    QVector<QPair<int, int>> links;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < columns; ++c) {
+            int node = r * columns + c;
+            if (c + 1 < columns) links.append(qMakePair(node, node + 1));
+            if (r + 1 < rows) links.append(qMakePair(node, node + columns));
+        }
+    }
+    return links;
+}
+
+// Dimension-order routing: fix the column first, then the row. Always a shortest path on a grid.
+static RoutingValidator::NextHopFn gridRouting(int columns)
+{
+    return [columns](int node, int destination) {
+        int column = node % columns;
+        int targetColumn = destination % columns;
+        if (column != targetColumn) {
+            return column < targetColumn ? node + 1 : node - 1;
+        }
+        return node < destination ? node + columns : node - columns;
+    };
+}
+
+void RoutingValidatorTests::testShortestPathTablesAreClean() {
+    RoutingValidator validator;
+    validator.setTopology(30 * 30, gridLinks(30, 30));
+
+    RoutingReport report = validator.validate(gridRouting(30));
+    QCOMPARE(report.pairs, qint64(900) * 899);
+    QCOMPARE(report.delivered, report.pairs);
+    QVERIFY(report.isClean());
+    QCOMPARE(report.maxStretch, 1.0);
+    QCOMPARE(report.meanStretch(), 1.0);
+}
+
+void RoutingValidatorTests::testBlackHoleAndLoop() {
+    // Line 0 - 1 - 2 - 3
+    RoutingValidator validator;
+    validator.setTopology(4, {{0, 1}, {1, 2}, {2, 3}});
+    QVERIFY(validator.isAdjacent(1, 2));
+    QVERIFY(!validator.isAdjacent(0, 2));
+
+    auto routing = [](int node, int destination) {
+        if (destination == 3 && node == 2) return -1;   // 2 lost its route to 3
+        if (destination == 0 && node == 2) return 3;    // 2 and 3 bounce traffic for 0
+        if (destination == 0 && node == 3) return 2;
+        if (destination == 1 && node == 0) return 2;    // Not a neighbour
+        return node < destination ? node + 1 : node - 1;
+    };
+
+    RoutingReport report = validator.validate(routing, 1);
+    QCOMPARE(report.pairs, qint64(12));
+    // Toward 3: 0, 1 and 2 all end at 2. Toward 1: 0 names a non-neighbour.
+    QCOMPARE(report.blackHoles, qint64(4));
+    // Toward 0: 2 and 3 loop.
+    QCOMPARE(report.loops, qint64(2));
+    QCOMPARE(report.delivered, qint64(6));
+    // 2 -> 0 via 3 and 0 -> 1 via the non-neighbour 2 are off every shortest path.
+    QCOMPARE(report.wrongNextHops, qint64(2));
+    QVERIFY(!report.isClean());
+    QVERIFY(!report.samples.isEmpty());
+}
+
+void RoutingValidatorTests::testDetourCountsStretch() {
+    // Square 0 - 1 - 2 - 3 - 0; node 0 reaches 1 the long way round.
+    RoutingValidator validator;
+    validator.setTopology(4, {{0, 1}, {1, 2}, {2, 3}, {3, 0}});
+
+    auto routing = [](int node, int destination) {
+        if (node == 0 && destination == 1) return 3;
+        if (node == 3 && destination == 1) return 2;
+        if (node == 2 && destination == 0) return 3;
+        if (qAbs(node - destination) == 1 || qAbs(node - destination) == 3) return destination;
+        return node == 0 || node == 2 ? 1 : 0;
+    };
+
+    RoutingReport report = validator.validate(routing, 2);
+    QCOMPARE(report.delivered, qint64(12));
+    QCOMPARE(report.wrongNextHops, qint64(1));
+    QCOMPARE(report.maxStretch, 3.0);
+    QVERIFY(!report.isClean());
+}
+
+void RoutingValidatorTests::testDomains() {
+    // Domain 0: 0 - 1 - 2 and a shortcut 0 - 2 through domain 1's node 3.
+    RoutingValidator validator;
+    validator.setTopology(4, {{0, 1}, {1, 2}, {0, 3}, {3, 2}}, {0, 0, 0, 1});
+
+    // Inside domain 0 the path 0 - 1 - 2 is the shortest one; leaving the domain would be wrong.
+    auto routing = [](int node, int destination) {
+        if (node == 3) return destination == 2 ? 2 : 0;
+        if (destination == 3) return node == 1 ? 0 : 3;
+        return node < destination ? node + 1 : node - 1;
+    };
+
+    RoutingReport report = validator.validate(routing);
+    QCOMPARE(report.pairs, qint64(12));
+    QVERIFY(report.isClean());
+
+    validator.setInterDomain(false);
+    report = validator.validate(routing);
+    QCOMPARE(report.pairs, qint64(6));
+    QVERIFY(report.isClean());
+}
+
+void RoutingValidatorTests::testThreadCountDoesNotChangeResult() {
+    RoutingValidator validator;
+    validator.setTopology(12 * 12, gridLinks(12, 12));
+
+    auto broken = [routing = gridRouting(12)](int node, int destination) {
+        return node == 40 ? -1 : routing(node, destination);
+    };
+
+    RoutingReport single = validator.validate(broken, 1);
+    RoutingReport parallel = validator.validate(broken, 8);
+    QVERIFY(single.blackHoles > 0);
+    QCOMPARE(parallel.pairs, single.pairs);
+    QCOMPARE(parallel.blackHoles, single.blackHoles);
+    QCOMPARE(parallel.delivered, single.delivered);
+    QCOMPARE(parallel.totalStretch, single.totalStretch);
+}
+
+void RoutingValidatorTests::testNewTopologyReplacesCachedDistances() {
+    auto alongLine = [](int node, int destination) { return node < destination ? node + 1 : node - 1; };
+
+    // Line 0 - 1 - 2 - 3, checked twice against the same cached distances.
+    RoutingValidator validator;
+    validator.setTopology(4, {{0, 1}, {1, 2}, {2, 3}});
+    QVERIFY(validator.validate(alongLine).isClean());
+    QCOMPARE(validator.validate(alongLine).maxStretch, 1.0);
+
+    // Closing the ring makes 0 and 3 neighbours, so walking the line is now a detour.
+    validator.setTopology(4, {{0, 1}, {1, 2}, {2, 3}, {3, 0}});
+    RoutingReport ring = validator.validate(alongLine);
+    QVERIFY(ring.wrongNextHops > 0);
+    QCOMPARE(ring.maxStretch, 3.0);
+
+    // Past the cache limit the distances are recomputed on every call, with the same results.
+    const int n = RoutingValidator::MAX_CACHED_NODES + 1;
+    QVector<QPair<int, int>> line;
+    for (int node = 0; node + 1 < n; ++node) {
+        line.append(qMakePair(node, node + 1));
+    }
+    validator.setTopology(n, line);
+    RoutingReport uncached = validator.validate(alongLine);
+    QCOMPARE(uncached.pairs, qint64(n) * (n - 1));
+    QVERIFY(uncached.isClean());
+}
+
+// QTEST_MAIN(RoutingValidatorTests)
+#include "RoutingValidatorTests.moc"
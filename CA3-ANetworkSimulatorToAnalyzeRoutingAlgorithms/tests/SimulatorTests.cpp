@@ -0,0 +1,66 @@
+#include <QtTest/QtTest>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include "../src/NetworkSimulator/Simulator.h"
+
+class SimulatorTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testBatchUsesRoutingConfig();
+    void testBatchCommandLineOverridesConfig();
+    void testBatchRejectsMissingOptions();
+
+private:
+    static QString writeConfig(const QTemporaryDir &dir, const QJsonObject &routing);
+    static bool configure(const QString &configPath, const QStringList &arguments);
+};
+
+QString SimulatorTests::writeConfig(const QTemporaryDir &dir, const QJsonObject &routing) {
+    QJsonObject config;
+    config["seed"] = 7;
+    config["log_directory"] = dir.path();
+    config["routing"] = routing;
+
+    QString path = dir.filePath("config.json");
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(config).toJson());
+    }
+    return path;
+}
+
+bool SimulatorTests::configure(const QString &configPath, const QStringList &arguments) {
+    Simulator simulator;
+    return simulator.loadConfig(configPath) &&
+           simulator.configureFromCommandLine(QStringList {"cnca3"} + arguments) && simulator.isBatch();
+}
+
+void SimulatorTests::testBatchUsesRoutingConfig() {
+    QTemporaryDir dir;
+    QString path = writeConfig(dir, {{"bgp", false}, {"main_algo", "ospf"}, {"torus", "no"}});
+    QVERIFY(configure(path, {"--batch"}));
+
+    path = writeConfig(dir, {{"bgp", true}, {"first_as_algo", 1}, {"second_as_algo", "rip"}, {"torus", true}});
+    QVERIFY(configure(path, {"--batch"}));
+}
+
+void SimulatorTests::testBatchCommandLineOverridesConfig() {
+    QTemporaryDir dir;
+    QString path = writeConfig(dir, {{"bgp", "maybe"}, {"main_algo", 3}, {"torus", false}});
+    QVERIFY(!configure(path, {"--batch"}));
+    QVERIFY(configure(path, {"--batch", "--bgp", "no", "--main-algo", "2"}));
+    QVERIFY(!configure(path, {"--batch", "--bgp", "no", "--main-algo", "5"}));
+}
+
+void SimulatorTests::testBatchRejectsMissingOptions() {
+    QTemporaryDir dir;
+    QString path = writeConfig(dir, {{"bgp", true}, {"first_as_algo", "rip"}, {"torus", false}});
+    QVERIFY(!configure(path, {"--batch"}));
+    QVERIFY(configure(path, {"--batch", "--second-as-algo", "ospf"}));
+    QVERIFY(!configure(path, {"--batch", "--bgp", "no"}));
+}
+
+// QTEST_MAIN(SimulatorTests)
+#include "SimulatorTests.moc"
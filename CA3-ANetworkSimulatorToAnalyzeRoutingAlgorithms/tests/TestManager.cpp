@@ -1,16 +1,69 @@
 #include <QtTest/QtTest>
+#include "AddressPoolTests.cpp"
+#include "AliasTableTests.cpp"
+#include "AsyncLogWriterTests.cpp"
+#include "BGPTests.cpp"
+#include "ConvergenceDetectorTests.cpp"
+#include "DHCPMessageTests.cpp"
+#include "DHCPPhaseTrackerTests.cpp"
 #include "DataGeneratorTests.cpp"
 #include "DataLinkHeaderTests.cpp"
+#include "EventTraceTests.cpp"
+#include "ForwardingTableTests.cpp"
 #include "IPHeaderTests.cpp"
 #include "MACAddressTests.cpp"
+#include "MetricsCollectorTests.cpp"
+#include "NetworkImageTests.cpp"
+#include "NetworkSnapshotTests.cpp"
 #include "PacketTests.cpp"
 #include "PortTests.cpp"
+#include "RandomStreamTests.cpp"
 #include "RouterRegistryTests.cpp"
+#include "RoutingValidatorTests.cpp"
+#include "SimulationContextTests.cpp"
+#include "SimulatorTests.cpp"
 #include "TCPHeaderTests.cpp"
+#include "TimelineTraceTests.cpp"
+#include "TopologySnapshotTests.cpp"
 
 int main(int argc, char *argv[]) {
     int status = 0;
 
+    {
+        AddressPoolTests addressPoolTests;
+        status |= QTest::qExec(&addressPoolTests, argc, argv);
+    }
+
+    {
+        AliasTableTests aliasTableTests;
+        status |= QTest::qExec(&aliasTableTests, argc, argv);
+    }
+
+    {
+        AsyncLogWriterTests asyncLogWriterTests;
+        status |= QTest::qExec(&asyncLogWriterTests, argc, argv);
+    }
+
+    {
+        BGPTests bgpTests;
+        status |= QTest::qExec(&bgpTests, argc, argv);
+    }
+
+    {
+        ConvergenceDetectorTests convergenceDetectorTests;
+        status |= QTest::qExec(&convergenceDetectorTests, argc, argv);
+    }
+
+    {
+        DHCPMessageTests dhcpMessageTests;
+        status |= QTest::qExec(&dhcpMessageTests, argc, argv);
+    }
+
+    {
+        DHCPPhaseTrackerTests dhcpPhaseTrackerTests;
+        status |= QTest::qExec(&dhcpPhaseTrackerTests, argc, argv);
+    }
+
     {
         DataGeneratorTests dataGeneratorTests;
         status |= QTest::qExec(&dataGeneratorTests, argc, argv);
@@ -21,6 +74,16 @@ int main(int argc, char *argv[]) {
         status |= QTest::qExec(&dataLinkHeaderTests, argc, argv);
     }
 
+    {
+        EventTraceTests eventTraceTests;
+        status |= QTest::qExec(&eventTraceTests, argc, argv);
+    }
+
+    {
+        ForwardingTableTests forwardingTableTests;
+        status |= QTest::qExec(&forwardingTableTests, argc, argv);
+    }
+
     {
         IPHeaderTests ipHeaderTests;
         status |= QTest::qExec(&ipHeaderTests, argc, argv);
@@ -31,6 +94,21 @@ int main(int argc, char *argv[]) {
         status |= QTest::qExec(&macAddressTests, argc, argv);
     }
 
+    {
+        MetricsCollectorTests metricsCollectorTests;
+        status |= QTest::qExec(&metricsCollectorTests, argc, argv);
+    }
+
+    {
+        NetworkImageTests networkImageTests;
+        status |= QTest::qExec(&networkImageTests, argc, argv);
+    }
+
+    {
+        NetworkSnapshotTests networkSnapshotTests;
+        status |= QTest::qExec(&networkSnapshotTests, argc, argv);
+    }
+
     {
         PacketTests packetTests;
         status |= QTest::qExec(&packetTests, argc, argv);
@@ -41,15 +119,45 @@ int main(int argc, char *argv[]) {
         status |= QTest::qExec(&portTests, argc, argv);
     }
 
+    {
+        RandomStreamTests randomStreamTests;
+        status |= QTest::qExec(&randomStreamTests, argc, argv);
+    }
+
     {
         RouterRegistryTests routerRegistryTests;
         status |= QTest::qExec(&routerRegistryTests, argc, argv);
     }
 
+    {
+        RoutingValidatorTests routingValidatorTests;
+        status |= QTest::qExec(&routingValidatorTests, argc, argv);
+    }
+
+    {
+        SimulationContextTests simulationContextTests;
+        status |= QTest::qExec(&simulationContextTests, argc, argv);
+    }
+
+    {
+        SimulatorTests simulatorTests;
+        status |= QTest::qExec(&simulatorTests, argc, argv);
+    }
+
     {
         TCPHeaderTests tcpHeaderTests;
         status |= QTest::qExec(&tcpHeaderTests, argc, argv);
     }
 
+    {
+        TimelineTraceTests timelineTraceTests;
+        status |= QTest::qExec(&timelineTraceTests, argc, argv);
+    }
+
+    {
+        TopologySnapshotTests topologySnapshotTests;
+        status |= QTest::qExec(&topologySnapshotTests, argc, argv);
+    }
+
     return status;
 }
@@ -0,0 +1,98 @@
+#include <QtTest/QtTest>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include "../src/Trace/TimelineTrace.h"
+
+class TimelineTraceTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testSpansPerRouterTrack();
+    void testEventLimit();
+
+private:
+    static QJsonArray readEvents(const QString &path);
+};
+
+QJsonArray TimelineTraceTests::readEvents(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return QJsonDocument::fromJson(file.readAll()).object().value("traceEvents").toArray();
+}
+
+void TimelineTraceTests::testSpansPerRouterTrack() {
+    QTemporaryDir dir;
+    QString path = dir.filePath("timeline.json");
+    QVERIFY(TimelineTrace::start(path));
+
+    TimelineTrace::clockTick(1);
+    {
+        TraceSpan outer("runDijkstra", 3, 1);
+        TraceSpan inner("processLSA", 3, 1);
+    }
+    TimelineTrace::clockTick(2);
+    QThread *thread = QThread::create([]() {
+        TraceSpan span("processPacket", 5, 2);
+        TimelineTrace::counter("queue", 5, 4);
+    });
+    thread->start();
+    thread->wait();
+    delete thread;
+    TimelineTrace::clockTick(3);
+    QVERIFY(TimelineTrace::stop());
+
+    QMap<QString, QJsonObject> spans;
+    QStringList trackNames;
+    int counters = 0;
+    int ticks = 0;
+    for (const QJsonValue &value : readEvents(path)) {
+        QJsonObject event = value.toObject();
+        QString phase = event.value("ph").toString();
+        if (phase == "M" && event.value("name").toString() == "thread_name") {
+            trackNames << event.value("args").toObject().value("name").toString();
+        } else if (phase == "C") {
+            ++counters;
+            QCOMPARE(event.value("name").toString(), QString("Router 5 queue"));
+        } else if (phase == "X" && event.value("tid").toInt() == TimelineTrace::CLOCK_TRACK) {
+            ++ticks;
+        } else if (phase == "X") {
+            spans.insert(event.value("name").toString(), event);
+        }
+    }
+
+    QCOMPARE(spans.size(), 3);
+    QCOMPARE(spans["runDijkstra"].value("tid").toInt(), 3);
+    QCOMPARE(spans["processPacket"].value("tid").toInt(), 5);
+    QCOMPARE(spans["runDijkstra"].value("args").toObject().value("tick").toInt(), 1);
+    QCOMPARE(spans["processPacket"].value("args").toObject().value("tick").toInt(), 2);
+    QVERIFY(spans["runDijkstra"].value("dur").toDouble() >= spans["processLSA"].value("dur").toDouble());
+    QVERIFY(spans["runDijkstra"].value("ts").toDouble() <= spans["processLSA"].value("ts").toDouble());
+    QCOMPARE(counters, 1);
+    QCOMPARE(ticks, 2);
+    QVERIFY(trackNames.contains("Router 3"));
+    QVERIFY(trackNames.contains("Router 5"));
+    QVERIFY(trackNames.contains("Clock"));
+}
+
+void TimelineTraceTests::testEventLimit() {
+    QTemporaryDir dir;
+    QString path = dir.filePath("limited.json");
+    QVERIFY(TimelineTrace::start(path, 10));
+    for (int i = 0; i < 25; ++i) {
+        TraceSpan span("processPacket", 1, 0);
+    }
+    QVERIFY(TimelineTrace::stop());
+    QCOMPARE(TimelineTrace::eventsRecorded(), static_cast<quint64>(10));
+    QCOMPARE(TimelineTrace::eventsDropped(), static_cast<quint64>(15));
+
+    // Nothing is recorded once stopped.
+    { TraceSpan span("processPacket", 1, 0); }
+    QCOMPARE(TimelineTrace::eventsRecorded(), static_cast<quint64>(10));
+}
+
+// QTEST_MAIN(TimelineTraceTests)
+#include "TimelineTraceTests.moc"
@@ -0,0 +1,109 @@
+#include <QtTest/QtTest>
+#include <QSharedPointer>
+#include "../src/Globals/SimulationContext.h"
+#include "../src/Network/Router.h"
+#include "../src/PortBindingManager/PortBindingManager.h"
+#include "../src/Topology/TopologySnapshot.h"
+
+class TopologySnapshotTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testBuildFromBoundPorts();
+    void testUnboundPortsAreIgnored();
+    void testCurrentRebuildsOnBinding();
+
+private:
+    SimulationContext m_context;    // Owns the nodes built by each test
+    static void link(const QSharedPointer<Router> &a, const QSharedPointer<Router> &b);
+};
+
+void TopologySnapshotTests::link(const QSharedPointer<Router> &a, const QSharedPointer<Router> &b) {
+    PortBindingManager bindingManager;
+    bindingManager.bind(a->getAvailablePort(), b->getAvailablePort(), a->getId(), b->getId());
+}
+
+void TopologySnapshotTests::testBuildFromBoundPorts() {
+    auto r10 = QSharedPointer<Router>::create(10, "10.0.0.10", &m_context);
+    auto r3 = QSharedPointer<Router>::create(3, "10.0.0.3", &m_context);
+    auto r7 = QSharedPointer<Router>::create(7, "10.0.0.7", &m_context);
+    auto r5 = QSharedPointer<Router>::create(5, "10.0.0.5", &m_context);
+    link(r3, r5);
+    link(r5, r7);
+    link(r7, r10);
+    link(r3, r7);
+
+    TopologySnapshot snapshot({r10, r3, r7, r5});
+    QCOMPARE(snapshot.nodeCount(), 4);
+    QCOMPARE(snapshot.edgeCount(), 8);
+
+    // Nodes are numbered in id order
+    QCOMPARE(snapshot.indexOf(3), 0);
+    QCOMPARE(snapshot.indexOf(5), 1);
+    QCOMPARE(snapshot.indexOf(7), 2);
+    QCOMPARE(snapshot.indexOf(10), 3);
+    QCOMPARE(snapshot.indexOf(99), -1);
+    QCOMPARE(snapshot.routerId(2), 7);
+
+    // Router 7 sees 3, 5 and 10, in node order
+    QCOMPARE(snapshot.degree(2), 3);
+    QVector<int> neighbors(snapshot.neighborsBegin(2), snapshot.neighborsEnd(2));
+    QCOMPARE(neighbors, QVector<int>({0, 1, 3}));
+
+    QVERIFY(snapshot.isAdjacent(0, 2));
+    QVERIFY(!snapshot.isAdjacent(0, 3));
+    QCOMPARE(snapshot.portTo(0, 1), 1);    // 3 used its first port for 5
+    QCOMPARE(snapshot.portTo(0, 2), 2);
+    QCOMPARE(snapshot.portTo(2, 0), 3);    // 7 used ports 1 and 2 for 5 and 10
+    QCOMPARE(snapshot.portTo(0, 3), -1);
+}
+
+void TopologySnapshotTests::testUnboundPortsAreIgnored() {
+    auto r1 = QSharedPointer<Router>::create(1, "10.0.0.1", &m_context);
+    auto r2 = QSharedPointer<Router>::create(2, "10.0.0.2", &m_context);
+    auto r3 = QSharedPointer<Router>::create(3, "10.0.0.3", &m_context);
+
+    PortBindingManager bindingManager;
+    PortPtr_t a = r1->getAvailablePort();
+    PortPtr_t b = r2->getAvailablePort();
+    bindingManager.bind(a, b, 1, 2);
+    link(r2, r3);
+    QVERIFY(bindingManager.unbind(a, b));
+
+    TopologySnapshot snapshot({r1, r2, r3});
+    QCOMPARE(snapshot.edgeCount(), 2);
+    QCOMPARE(snapshot.degree(0), 0);
+    QVERIFY(snapshot.isAdjacent(1, 2));
+    QVERIFY(!snapshot.isAdjacent(0, 1));
+}
+
+void TopologySnapshotTests::testCurrentRebuildsOnBinding() {
+    SimulationContext context;
+    auto r1 = QSharedPointer<Router>::create(1, "10.0.0.1", &context);
+    auto r2 = QSharedPointer<Router>::create(2, "10.0.0.2", &context);
+    context.routers().addRouters({r1, r2});
+
+    auto before = context.topology();
+    QCOMPARE(before->nodeCount(), 2);
+    QCOMPARE(before->edgeCount(), 0);
+    QCOMPARE(context.topology(), before);    // Unchanged topology, same snapshot
+
+    PortBindingManager bindingManager;
+    PortPtr_t a = r1->getAvailablePort();
+    PortPtr_t b = r2->getAvailablePort();
+    quint64 otherEpoch = m_context.topologyEpoch();
+    bindingManager.bind(a, b, 1, 2);
+    QCOMPARE(m_context.topologyEpoch(), otherEpoch);    // Other simulations keep their snapshots
+
+    auto bound = context.topology();
+    QVERIFY(bound != before);
+    QVERIFY(bound->version() > before->version());
+    QVERIFY(bound->isAdjacent(0, 1));
+    QVERIFY(!before->isAdjacent(0, 1));               // Earlier snapshots never change
+
+    QVERIFY(bindingManager.unbind(a, b));
+    QCOMPARE(context.topology()->edgeCount(), 0);
+}
+
+// QTEST_MAIN(TopologySnapshotTests)
+#include "TopologySnapshotTests.moc"
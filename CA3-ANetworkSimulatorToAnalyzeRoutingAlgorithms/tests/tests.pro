@@ -5,14 +5,32 @@ QT += core testlib
 QT += network
 
 SOURCES += $$PWD/TestManager.cpp \
+           $$PWD/AliasTableTests.cpp \
+           $$PWD/AddressPoolTests.cpp \
+           $$PWD/AsyncLogWriterTests.cpp \
+           $$PWD/BGPTests.cpp \
+           $$PWD/ConvergenceDetectorTests.cpp \
+           $$PWD/DHCPMessageTests.cpp \
+           $$PWD/DHCPPhaseTrackerTests.cpp \
+           $$PWD/EventTraceTests.cpp \
+           $$PWD/ForwardingTableTests.cpp \
            $$PWD/MACAddressTests.cpp \
+           $$PWD/MetricsCollectorTests.cpp \
+           $$PWD/NetworkImageTests.cpp \
+           $$PWD/NetworkSnapshotTests.cpp \
            $$PWD/PacketTests.cpp \
            $$PWD/DataGeneratorTests.cpp \
            $$PWD/DataLinkHeaderTests.cpp \
            $$PWD/TCPHeaderTests.cpp \
+           $$PWD/TimelineTraceTests.cpp \
+           $$PWD/TopologySnapshotTests.cpp \
            $$PWD/IPHeaderTests.cpp \
            $$PWD/PortTests.cpp \
-           $$PWD/RouterRegistryTests.cpp
+           $$PWD/RouterRegistryTests.cpp \
+           $$PWD/RoutingValidatorTests.cpp \
+           $$PWD/SimulationContextTests.cpp \
+           $$PWD/SimulatorTests.cpp \
+           $$PWD/RandomStreamTests.cpp
 
 INCLUDEPATH += $$PWD/../src \
                $$PWD/../src/Globals
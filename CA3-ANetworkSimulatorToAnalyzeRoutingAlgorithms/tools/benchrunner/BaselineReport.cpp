@@ -0,0 +1,73 @@
+#include <QStringList>
+
+#include "BaselineReport.h"
+
+namespace {
+
+enum class Direction { HigherIsWorse, LowerIsWorse };
+
+struct Rule
+{
+    const char *metric;
+    Direction direction;
+};
+
+const Rule RULES[] = {
+    {"wall_ms", Direction::HigherIsWorse},
+    {"peak_rss_kb", Direction::HigherIsWorse},
+    {"events_per_second", Direction::LowerIsWorse},
+    {"convergence_sim_ms", Direction::HigherIsWorse},
+    {"wait_cycles_p99", Direction::HigherIsWorse},
+};
+
+}
+
+BaselineReport::Row BaselineReport::compare(const QString &scenario, const QJsonObject &metrics) const
+{
+    Row row {scenario, Status::Pass, metrics, QString()};
+    if (!m_baseline.contains(scenario)) {
+        row.status = Status::New;
+        return row;
+    }
+
+    QJsonObject baseline = m_baseline.value(scenario).toObject();
+    QStringList regressions;
+    for (const Rule &rule : RULES) {
+        double before = baseline.value(rule.metric).toDouble();
+        double after = metrics.value(rule.metric).toDouble();
+        if (before <= 0) continue;
+
+        double change = (after - before) / before;
+        bool worse = rule.direction == Direction::HigherIsWorse ? change > m_threshold : change < -m_threshold;
+        if (worse) {
+            regressions << QString("%1 %2%3%").arg(rule.metric).arg(change > 0 ? "+" : "").arg(change * 100.0, 0, 'f', 1);
+        }
+    }
+
+    double lossChange = metrics.value("loss_rate").toDouble() - baseline.value("loss_rate").toDouble();
+    if (lossChange > m_lossTolerance) {
+        regressions << QString("loss_rate +%1").arg(lossChange, 0, 'f', 3);
+    }
+
+    if (!regressions.isEmpty()) {
+        row.status = Status::Regressed;
+        row.detail = regressions.join(", ");
+    }
+    return row;
+}
+
+BaselineReport::Row BaselineReport::error(const QString &scenario, const QString &message)
+{
+    return Row {scenario, Status::Error, QJsonObject(), message};
+}
+
+QString BaselineReport::statusName(Status status)
+{
+    switch (status) {
+    case Status::Pass: return "PASS";
+    case Status::Regressed: return "FAIL";
+    case Status::New: return "NEW";
+    case Status::Error: return "ERROR";
+    }
+    return "?";
+}
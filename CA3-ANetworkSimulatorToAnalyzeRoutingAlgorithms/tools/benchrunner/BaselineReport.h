@@ -0,0 +1,39 @@
+#ifndef BASELINEREPORT_H
+#define BASELINEREPORT_H
+
+#include <QMap>
+#include <QString>
+#include <QJsonObject>
+
+// Compares per-scenario results against a stored baseline. Costs (wall time, memory,
+// convergence, tail wait) regress when they grow by more than the threshold, throughput when it
+// shrinks by more, and loss when it rises by more than lossTolerance in absolute terms.
+class BaselineReport
+{
+public:
+    enum class Status { Pass, Regressed, New, Error };
+
+    struct Row
+    {
+        QString scenario;
+        Status status = Status::Pass;
+        QJsonObject metrics;
+        QString detail;
+    };
+
+    BaselineReport(double threshold, double lossTolerance)
+        : m_threshold(threshold), m_lossTolerance(lossTolerance) {}
+
+    void setBaseline(const QJsonObject &scenarios) { m_baseline = scenarios; }
+    Row compare(const QString &scenario, const QJsonObject &metrics) const;
+
+    static Row error(const QString &scenario, const QString &message);
+    static QString statusName(Status status);
+
+private:
+    double m_threshold;
+    double m_lossTolerance;
+    QJsonObject m_baseline;
+};
+
+#endif // BASELINEREPORT_H
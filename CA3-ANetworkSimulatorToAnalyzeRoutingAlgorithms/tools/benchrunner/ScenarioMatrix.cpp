@@ -0,0 +1,115 @@
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "ScenarioMatrix.h"
+
+namespace {
+
+QJsonObject readObject(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = QString("cannot open %1: %2").arg(path, file.errorString());
+        return {};
+    }
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!document.isObject()) {
+        *error = QString("%1: %2").arg(path, parseError.errorString());
+        return {};
+    }
+    return document.object();
+}
+
+QJsonValue mergeValue(const QJsonValue &base, const QJsonValue &patch)
+{
+    if (base.isObject() && patch.isObject()) {
+        return ScenarioMatrix::merge(base.toObject(), patch.toObject());
+    }
+    if (base.isArray() && patch.isArray()) {
+        QJsonArray merged = base.toArray();
+        QJsonArray patches = patch.toArray();
+        for (qsizetype i = 0; i < patches.size(); ++i) {
+            if (i < merged.size()) {
+                merged[i] = mergeValue(merged[i], patches[i]);
+            } else {
+                merged.append(patches[i]);
+            }
+        }
+        return merged;
+    }
+    return patch;
+}
+
+}
+
+QJsonObject ScenarioMatrix::merge(const QJsonObject &base, const QJsonObject &patch)
+{
+    QJsonObject merged = base;
+    for (auto it = patch.constBegin(); it != patch.constEnd(); ++it) {
+        merged[it.key()] = mergeValue(merged.value(it.key()), it.value());
+    }
+    return merged;
+}
+
+bool ScenarioMatrix::load(const QString &path, QString *error)
+{
+    QJsonObject matrix = readObject(path, error);
+    if (matrix.isEmpty()) return false;
+
+    QString basePath = matrix.value("base_config").toString();
+    if (basePath.isEmpty()) {
+        *error = "matrix has no base_config";
+        return false;
+    }
+    basePath = QFileInfo(path).dir().filePath(basePath);
+    m_baseConfig = readObject(basePath, error);
+    if (m_baseConfig.isEmpty()) return false;
+
+    m_repeat = qMax(1, matrix.value("repeat").toInt(1));
+    m_axes.clear();
+    for (const QJsonValue &axisValue : matrix.value("axes").toArray()) {
+        QJsonObject axisObject = axisValue.toObject();
+        Axis axis;
+        axis.name = axisObject.value("name").toString();
+        QJsonObject values = axisObject.value("values").toObject();
+        for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+            AxisValue value;
+            value.name = it.key();
+            for (const QJsonValue &argument : it.value().toObject().value("args").toArray()) {
+                value.arguments << argument.toString();
+            }
+            value.patch = it.value().toObject().value("config").toObject();
+            axis.values.append(value);
+        }
+        if (axis.name.isEmpty() || axis.values.isEmpty()) {
+            *error = QString("axis %1 needs a name and at least one value").arg(m_axes.size());
+            return false;
+        }
+        m_axes.append(axis);
+    }
+    return true;
+}
+
+QVector<Scenario> ScenarioMatrix::expand() const
+{
+    QVector<Scenario> scenarios {Scenario {QString(), m_baseConfig, {}}};
+    for (const Axis &axis : m_axes) {
+        QVector<Scenario> next;
+        for (const Scenario &scenario : scenarios) {
+            for (const AxisValue &value : axis.values) {
+                Scenario expanded = scenario;
+                QString label = axis.name + "=" + value.name;
+                expanded.name = scenario.name.isEmpty() ? label : scenario.name + "," + label;
+                expanded.config = merge(scenario.config, value.patch);
+                expanded.arguments += value.arguments;
+                next.append(expanded);
+            }
+        }
+        scenarios = next;
+    }
+    return scenarios;
+}
@@ -0,0 +1,51 @@
+#ifndef SCENARIOMATRIX_H
+#define SCENARIOMATRIX_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+struct Scenario
+{
+    QString name;               // "protocol=rip,torus=off,..." in axis order
+    QJsonObject config;         // Base config with every chosen value's patch applied
+    QStringList arguments;      // Simulator command line
+};
+
+// A matrix file names a base config and a list of axes; each axis value may carry command line
+// arguments and a config patch. Scenarios are the cartesian product of the axes:
+//     {"base_config": "../../app/config.json",
+//      "axes": [{"name": "protocol", "values": {"rip": {"args": ["--main-algo", "1"]}}},
+//               {"name": "buffer", "values": {"6": {"config": {"router_buffer_size": 6}}}}]}
+// Patches merge into the config recursively; arrays of objects merge element by element, so
+// {"Autonomous_systems": [{"topology_type": "Mesh"}]} only changes the first AS.
+class ScenarioMatrix
+{
+public:
+    bool load(const QString &path, QString *error);
+    QVector<Scenario> expand() const;
+
+    int repeat() const { return m_repeat; }
+
+    static QJsonObject merge(const QJsonObject &base, const QJsonObject &patch);
+
+private:
+    struct AxisValue
+    {
+        QString name;
+        QStringList arguments;
+        QJsonObject patch;
+    };
+    struct Axis
+    {
+        QString name;
+        QVector<AxisValue> values;
+    };
+
+    QJsonObject m_baseConfig;
+    QVector<Axis> m_axes;
+    int m_repeat = 1;
+};
+
+#endif // SCENARIOMATRIX_H
@@ -0,0 +1,19 @@
+TEMPLATE = app
+TARGET = benchrunner
+CONFIG += console c++20
+QT += core network
+
+SOURCES += $$PWD/main.cpp \
+           $$PWD/ScenarioMatrix.cpp \
+           $$PWD/BaselineReport.cpp
+
+HEADERS += $$PWD/ScenarioMatrix.h \
+           $$PWD/BaselineReport.h
+
+DISTFILES += $$PWD/scenarios.json
+
+INCLUDEPATH += $$PWD/../../src \
+               $$PWD/../../src/Globals
+
+LIBS += -L$$PWD/../../lib -lcnca3lib
+win32: LIBS += -lpsapi
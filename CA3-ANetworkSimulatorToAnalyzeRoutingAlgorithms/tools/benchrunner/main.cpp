@@ -0,0 +1,262 @@
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <QDir>
+#include <QFile>
+#include <QProcess>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QRegularExpression>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "ScenarioMatrix.h"
+#include "BaselineReport.h"
+#include "NetworkSimulator/Simulator.h"
+
+// Headless macro benchmarks: every scenario of a matrix runs the whole simulator (DHCP,
+// convergence and traffic) in a child process of this binary, so each run starts from clean
+// singletons and its peak RSS is its own. Results are compared with a stored baseline.
+
+namespace {
+
+const char *RUN_SCENARIO = "--run-scenario";
+
+qint64 peakRssKb()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))
+               ? static_cast<qint64>(counters.PeakWorkingSetSize / 1024)
+               : 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef Q_OS_MACOS
+    return usage.ru_maxrss / 1024;      // Bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+void quietMessageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    if (type != QtDebugMsg && type != QtInfoMsg) {
+        fprintf(stderr, "%s\n", qPrintable(message));
+    }
+}
+
+// Child side: one simulation, reported as a single JSON line on stdout.
+int runScenario(QCoreApplication &app, const QString &configPath, const QStringList &simulatorArguments)
+{
+    QElapsedTimer wall;
+    wall.start();
+
+    auto simulator = QSharedPointer<Simulator>::create();
+    if (!simulator->loadConfig(configPath) ||
+        !simulator->configureFromCommandLine(QStringList {app.applicationFilePath()} + simulatorArguments)) {
+        return 2;
+    }
+
+    qint64 convergenceWallMs = -1;
+    int convergenceTick = -1;
+    QObject::connect(simulator.data(), &Simulator::convergenceReached, &app, [&]() {
+        convergenceWallMs = wall.elapsed();
+        convergenceTick = simulator->convergenceTick();
+    });
+
+    QObject::connect(simulator.data(), &Simulator::simulationFinished, &app, [&]() {
+        QJsonObject result = simulator->getMetricsCollector()->summary();
+        qint64 wallMs = wall.elapsed();
+        result["wall_ms"] = static_cast<double>(wallMs);
+        result["peak_rss_kb"] = static_cast<double>(peakRssKb());
+        result["events_per_second"] =
+            wallMs > 0 ? result.value("packets_processed").toDouble() * 1000.0 / wallMs : 0.0;
+        result["convergence_wall_ms"] = static_cast<double>(convergenceWallMs);
+        result["convergence_tick"] = convergenceTick;
+        result["convergence_sim_ms"] =
+            convergenceTick >= 0 ? static_cast<double>(convergenceTick * simulator->getCycleDuration().count()) : -1.0;
+
+        QByteArray line = QJsonDocument(result).toJson(QJsonDocument::Compact) + '\n';
+        fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stdout);
+        fflush(stdout);
+        simulator->shutdown();
+        app.exit(0);
+    });
+
+    simulator->initializeNetwork();
+    simulator->startSimulation();
+    return app.exec();
+}
+
+QJsonObject median(const QVector<QJsonObject> &runs)
+{
+    QJsonObject result = runs.first();
+    for (auto it = result.begin(); it != result.end(); ++it) {
+        QVector<double> values;
+        for (const QJsonObject &run : runs) {
+            values.append(run.value(it.key()).toDouble());
+        }
+        std::sort(values.begin(), values.end());
+        it.value() = values[values.size() / 2];
+    }
+    return result;
+}
+
+// Parent side: runs one child and parses its result line.
+bool runChild(const QString &configPath, const Scenario &scenario, int timeoutMs, QJsonObject *result, QString *error)
+{
+    QProcess child;
+    child.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    child.start(QCoreApplication::applicationFilePath(), QStringList {RUN_SCENARIO, configPath} + scenario.arguments);
+    if (!child.waitForFinished(timeoutMs)) {
+        child.kill();
+        child.waitForFinished();
+        *error = QString("timed out after %1 s").arg(timeoutMs / 1000);
+        return false;
+    }
+    if (child.exitStatus() != QProcess::NormalExit || child.exitCode() != 0) {
+        *error = QString("exited with status %1").arg(child.exitCode());
+        return false;
+    }
+
+    QJsonDocument document = QJsonDocument::fromJson(child.readAllStandardOutput().trimmed());
+    if (!document.isObject()) {
+        *error = "no result line";
+        return false;
+    }
+    *result = document.object();
+    return true;
+}
+
+bool writeJson(const QString &path, const QJsonObject &object)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot write" << path << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(object).toJson());
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    qInstallMessageHandler(quietMessageHandler);
+
+    QStringList arguments = app.arguments();
+    if (arguments.size() >= 3 && arguments[1] == RUN_SCENARIO) {
+        return runScenario(app, arguments[2], arguments.mid(3));
+    }
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Run the simulator over a scenario matrix and compare with a baseline.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("matrix", "Scenario matrix (JSON).");
+    QCommandLineOption baselineOption("baseline", "Compare with this results file.", "file");
+    QCommandLineOption outputOption("output", "Write results here; usable as a later baseline.", "file");
+    QCommandLineOption thresholdOption("threshold", "Allowed relative regression (default 0.15).", "fraction", "0.15");
+    QCommandLineOption lossOption("loss-tolerance", "Allowed absolute loss rate increase (default 0.02).", "fraction",
+                                  "0.02");
+    QCommandLineOption repeatOption("repeat", "Runs per scenario; the median is kept. Overrides the matrix.", "n");
+    QCommandLineOption filterOption("filter", "Only scenarios whose name matches this regular expression.", "regex");
+    QCommandLineOption timeoutOption("timeout", "Seconds before a run is killed (default 600).", "seconds", "600");
+    parser.addOptions({baselineOption, outputOption, thresholdOption, lossOption, repeatOption, filterOption,
+                       timeoutOption});
+    parser.process(app);
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(2);
+    }
+
+    QString error;
+    ScenarioMatrix matrix;
+    if (!matrix.load(parser.positionalArguments().first(), &error)) {
+        qCritical() << "Invalid scenario matrix:" << error;
+        return 2;
+    }
+
+    BaselineReport report(parser.value(thresholdOption).toDouble(), parser.value(lossOption).toDouble());
+    if (parser.isSet(baselineOption)) {
+        QFile file(parser.value(baselineOption));
+        if (!file.open(QIODevice::ReadOnly)) {
+            qCritical() << "Cannot read baseline" << file.fileName();
+            return 2;
+        }
+        report.setBaseline(QJsonDocument::fromJson(file.readAll()).object().value("scenarios").toObject());
+    }
+
+    int repeat = parser.isSet(repeatOption) ? qMax(1, parser.value(repeatOption).toInt()) : matrix.repeat();
+    int timeoutMs = parser.value(timeoutOption).toInt() * 1000;
+    QRegularExpression filter(parser.value(filterOption));
+
+    QTemporaryDir workDir;
+    QTextStream out(stdout);
+    QJsonObject results;
+    bool failed = false;
+    int index = 0;
+    for (const Scenario &scenario : matrix.expand()) {
+        if (!filter.match(scenario.name).hasMatch()) continue;
+
+        // Each run logs into its own directory so concurrent matrices never share files.
+        QString runDir = workDir.filePath(QString::number(index++));
+        QDir().mkpath(runDir);
+        QJsonObject config = scenario.config;
+        config["log_directory"] = runDir;
+        QString configPath = QDir(runDir).filePath("config.json");
+        writeJson(configPath, config);
+
+        QVector<QJsonObject> runs;
+        QString runError;
+        for (int run = 0; run < repeat && runError.isEmpty(); ++run) {
+            QJsonObject result;
+            if (runChild(configPath, scenario, timeoutMs, &result, &runError)) {
+                runs.append(result);
+            }
+        }
+
+        BaselineReport::Row row = runError.isEmpty() ? report.compare(scenario.name, median(runs))
+                                                     : BaselineReport::error(scenario.name, runError);
+        if (!runError.isEmpty() || row.status == BaselineReport::Status::Regressed) {
+            failed = true;
+        }
+        if (!row.metrics.isEmpty()) {
+            results[scenario.name] = row.metrics;
+        }
+
+        out << QString("%1  %2  wall %3 ms  rss %4 MB  %5 ev/s  conv %6 ms  p99 %7  loss %8%")
+                   .arg(BaselineReport::statusName(row.status), -5)
+                   .arg(scenario.name)
+                   .arg(row.metrics.value("wall_ms").toDouble(), 0, 'f', 0)
+                   .arg(row.metrics.value("peak_rss_kb").toDouble() / 1024.0, 0, 'f', 1)
+                   .arg(row.metrics.value("events_per_second").toDouble(), 0, 'f', 0)
+                   .arg(row.metrics.value("convergence_sim_ms").toDouble(), 0, 'f', 0)
+                   .arg(row.metrics.value("wait_cycles_p99").toInt())
+                   .arg(row.metrics.value("loss_rate").toDouble() * 100.0, 0, 'f', 1);
+        if (!row.detail.isEmpty()) out << "  (" << row.detail << ")";
+        out << Qt::endl;
+    }
+
+    if (parser.isSet(outputOption)) {
+        QJsonObject document;
+        document["generated"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+        document["repeat"] = repeat;
+        document["scenarios"] = results;
+        if (!writeJson(parser.value(outputOption), document)) return 2;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,137 @@
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include "BGP/Prefix.h"
+#include "Globals/RandomStream.h"
+#include "Topology/NetworkImage.h"
+
+// Offline reader for network images written with --write-image. Everything is answered from the
+// mapped file, so even very large networks open without parsing a config or building nodes.
+
+namespace {
+
+QString kindName(const ImageNode &node)
+{
+    return node.kind == ImageNode::ROUTER ? "router" : "pc";
+}
+
+void printNode(QTextStream &out, const NetworkImage &image, int index)
+{
+    const ImageNode &node = image.node(index);
+    out << kindName(node) << " " << node.id << "  " << Prefix::formatAddress(node.address) << "  AS " << node.asId
+        << ((node.flags & ImageNode::BROKEN) ? "  broken" : "") << ((node.flags & ImageNode::DHCP_SERVER) ? "  dhcp" : "")
+        << Qt::endl;
+    for (const qint32 *it = image.neighborsBegin(index); it != image.neighborsEnd(index); ++it) {
+        out << "  port " << image.portTo(index, *it) << " -> " << kindName(image.node(*it)) << " "
+            << image.node(*it).id << Qt::endl;
+    }
+    if (!image.hasFibs()) return;
+    for (const ImageFibEntry *entry = image.fibBegin(index); entry != image.fibEnd(index); ++entry) {
+        out << "  " << Prefix::formatAddress(entry->destination) << "  via "
+            << (entry->nextHop >= 0 ? QString::number(image.node(entry->nextHop).id) : QString("-")) << "  port "
+            << entry->port << "  metric " << entry->metric << ((entry->flags & ImageFibEntry::LOCAL) ? "  local" : "")
+            << Qt::endl;
+    }
+}
+
+// Follows the forwarding tables from router a toward router b's address, like a data packet would.
+enum class Walk { Delivered, BlackHole, Loop };
+
+Walk walk(const NetworkImage &image, int from, int to)
+{
+    quint32 destination = image.node(to).address;
+    int node = from;
+    for (int hops = 0; hops <= image.nodeCount(); ++hops) {
+        if (node == to) return Walk::Delivered;
+        const ImageFibEntry *entry = image.lookup(node, destination);
+        if (!entry || entry->nextHop < 0) return Walk::BlackHole;
+        node = entry->nextHop;
+    }
+    return Walk::Loop;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Inspect a network image written by the simulator.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("image", "Network image to read.");
+    QCommandLineOption nodeOption("node", "Print this node's links and forwarding table.", "id");
+    QCommandLineOption checkOption("check", "Walk the forwarding tables between router pairs.");
+    QCommandLineOption sampleOption("sample", "Pairs checked at most, picked at random (default 100000).", "n",
+                                    "100000");
+    parser.addOptions({nodeOption, checkOption, sampleOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    NetworkImage image;
+    QString error;
+    if (!image.open(parser.positionalArguments().first(), &error)) {
+        err << "Cannot open " << parser.positionalArguments().first() << ": " << error << Qt::endl;
+        return 1;
+    }
+    const ImageHeader &header = image.header();
+    out << header.nodeCount << " nodes (" << header.routerCount << " routers), " << header.edgeCount / 2 << " links, "
+        << header.fibEntryCount << " FIB entries, " << header.fileSize << " bytes, opened in "
+        << timer.nsecsElapsed() / 1000 << " us" << Qt::endl;
+
+    if (parser.isSet(nodeOption)) {
+        int index = image.indexOf(parser.value(nodeOption).toInt());
+        if (index < 0) {
+            err << "No node " << parser.value(nodeOption) << Qt::endl;
+            return 1;
+        }
+        printNode(out, image, index);
+    }
+
+    if (parser.isSet(checkOption)) {
+        if (!image.hasFibs()) {
+            err << "The image has no forwarding tables" << Qt::endl;
+            return 1;
+        }
+        QVector<int> routers;
+        for (int node = 0; node < image.nodeCount(); ++node) {
+            const ImageNode &entry = image.node(node);
+            if (entry.kind == ImageNode::ROUTER && entry.address && !(entry.flags & ImageNode::BROKEN)) {
+                routers.append(node);
+            }
+        }
+
+        int routerCount = static_cast<int>(routers.size());
+        quint64 pairs = routerCount > 1 ? quint64(routerCount) * quint64(routerCount - 1) : 0;
+        quint64 sample = qMin<quint64>(pairs, parser.value(sampleOption).toULongLong());
+        quint64 counts[3] = {0, 0, 0};
+        RandomStream stream(1);
+        timer.restart();
+        for (quint64 i = 0; i < sample; ++i) {
+            int a, b;
+            if (sample == pairs) {
+                a = static_cast<int>(i / (routerCount - 1));
+                b = static_cast<int>(i % (routerCount - 1));
+                if (b >= a) ++b;
+            } else {
+                a = static_cast<int>(stream() % routerCount);
+                do {
+                    b = static_cast<int>(stream() % routerCount);
+                } while (b == a);
+            }
+            ++counts[static_cast<int>(walk(image, routers[a], routers[b]))];
+        }
+        out << sample << " of " << pairs << " router pairs: " << counts[0] << " delivered, " << counts[1]
+            << " black holes, " << counts[2] << " loops (" << timer.elapsed() << " ms)" << Qt::endl;
+        if (counts[1] || counts[2]) return 2;
+    }
+    return 0;
+}
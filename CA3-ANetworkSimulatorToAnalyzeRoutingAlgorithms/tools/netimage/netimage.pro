@@ -0,0 +1,11 @@
+TEMPLATE = app
+TARGET = netimage
+CONFIG += console c++20
+QT += core
+
+SOURCES += $$PWD/main.cpp
+
+INCLUDEPATH += $$PWD/../../src \
+               $$PWD/../../src/Globals
+
+LIBS += -L$$PWD/../../lib -lcnca3lib
@@ -0,0 +1,120 @@
+#include <QThread>
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QCommandLineParser>
+
+#include "SweepRunner.h"
+#include "NetworkSimulator/Simulator.h"
+
+SweepWorker::SweepWorker(const SweepRun &run, const QString &matrixPath, const QString &timeLimit)
+    : m_run(run),
+    m_matrixPath(matrixPath),
+    m_timeLimit(timeLimit)
+{}
+
+SweepWorker::~SweepWorker() {}
+
+void SweepWorker::start()
+{
+    m_wall.start();
+    m_simulator = QSharedPointer<Simulator>::create();
+    connect(m_simulator.data(), &Simulator::batchFinished, this, &SweepWorker::onBatchFinished);
+
+    QStringList arguments {"sweep", "--batch"};
+    arguments += m_run.scenario.arguments;
+    if (!m_timeLimit.isEmpty()) {
+        arguments += {"--time-limit", m_timeLimit};
+    }
+
+    QCommandLineParser parser;
+    Simulator::addCommandLineOptions(parser);
+    QJsonObject config = m_run.scenario.config;
+    config["log_directory"] = m_run.logDirectory;
+    if (!parser.parse(arguments)) {
+        qWarning() << m_run.scenario.name << parser.errorText();
+        onBatchFinished(Simulator::ExitBadConfig, QJsonObject());
+        return;
+    }
+    if (!m_simulator->applyConfig(config, m_matrixPath) || !m_simulator->configure(parser)) {
+        onBatchFinished(Simulator::ExitBadConfig, QJsonObject());
+        return;
+    }
+
+    m_simulator->initializeNetwork();
+    m_simulator->startSimulation();
+}
+
+void SweepWorker::onBatchFinished(int exitCode, const QJsonObject &summary)
+{
+    QJsonObject result;
+    result["run"] = m_run.index;
+    result["scenario"] = m_run.scenario.name;
+    result["repeat"] = m_run.repeat;
+    result["exit_code"] = exitCode;
+    result["wall_ms"] = static_cast<double>(m_wall.elapsed());
+    result["summary"] = summary;
+
+    // Still inside the simulator's own signal; tear it down once that has returned.
+    QMetaObject::invokeMethod(this, [this, result]() {
+        m_simulator.reset();
+        emit finished(result);
+    }, Qt::QueuedConnection);
+}
+
+SweepRunner::SweepRunner(const QVector<SweepRun> &runs, int jobs, const QString &matrixPath,
+                         const QString &timeLimit, QIODevice *output, QObject *parent)
+    : QObject(parent),
+    m_runs(runs),
+    m_jobs(qMax(1, jobs)),
+    m_matrixPath(matrixPath),
+    m_timeLimit(timeLimit),
+    m_output(output)
+{}
+
+void SweepRunner::start()
+{
+    if (m_runs.isEmpty()) {
+        emit finished();
+        return;
+    }
+    while (m_running < m_jobs && m_next < m_runs.size()) {
+        launchNext();
+    }
+}
+
+void SweepRunner::launchNext()
+{
+    const SweepRun &run = m_runs[m_next++];
+    ++m_running;
+
+    auto *thread = new QThread();
+    auto *worker = new SweepWorker(run, m_matrixPath, m_timeLimit);
+    worker->moveToThread(thread);
+    connect(thread, &QThread::started, worker, &SweepWorker::start);
+    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(worker, &SweepWorker::finished, this,
+            [this, thread](const QJsonObject &result) { onRunFinished(thread, result); });
+    thread->start();
+}
+
+void SweepRunner::onRunFinished(QThread *thread, const QJsonObject &result)
+{
+    thread->quit();
+    thread->wait();
+    delete thread;
+    --m_running;
+    ++m_completed;
+
+    if (result.value("exit_code").toInt() != Simulator::ExitOk) {
+        ++m_failures;
+    }
+    m_packetsProcessed +=
+        result.value("summary").toObject().value("metrics").toObject().value("packets_processed").toDouble();
+    m_output->write(QJsonDocument(result).toJson(QJsonDocument::Compact) + '\n');
+
+    if (m_next < m_runs.size()) {
+        launchNext();
+    } else if (m_running == 0) {
+        emit finished();
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef SWEEPRUNNER_H
+#define SWEEPRUNNER_H
+
+#include <QVector>
+#include <QObject>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+
+#include "ScenarioMatrix.h"
+
+class QThread;
+class QIODevice;
+class Simulator;
+
+struct SweepRun
+{
+    int index = 0;
+    int repeat = 0;
+    Scenario scenario;
+    QString logDirectory;
+};
+
+// Runs one batch simulation on the thread it was moved to. The Simulator, and with it the
+// simulation's context and clock, is created and destroyed on that thread.
+class SweepWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    SweepWorker(const SweepRun &run, const QString &matrixPath, const QString &timeLimit);
+    ~SweepWorker() override;
+
+public slots:
+    void start();
+
+signals:
+    void finished(const QJsonObject &result);
+
+private:
+    void onBatchFinished(int exitCode, const QJsonObject &summary);
+
+    SweepRun m_run;
+    QString m_matrixPath;
+    QString m_timeLimit;
+    QElapsedTimer m_wall;
+    QSharedPointer<Simulator> m_simulator;
+};
+
+// Keeps up to `jobs` workers busy, each on its own thread, and writes one JSON line per run.
+class SweepRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    SweepRunner(const QVector<SweepRun> &runs, int jobs, const QString &matrixPath, const QString &timeLimit,
+                QIODevice *output, QObject *parent = nullptr);
+
+    void start();
+
+    int completed() const { return m_completed; }
+    int failures() const { return m_failures; }
+    double packetsProcessed() const { return m_packetsProcessed; }
+
+signals:
+    void finished();
+
+private:
+    void launchNext();
+    void onRunFinished(QThread *thread, const QJsonObject &result);
+
+    QVector<SweepRun> m_runs;
+    int m_jobs;
+    QString m_matrixPath;
+    QString m_timeLimit;
+    QIODevice *m_output;
+
+    int m_next = 0;
+    int m_running = 0;
+    int m_completed = 0;
+    int m_failures = 0;
+    double m_packetsProcessed = 0;
+};
+
+#endif // SWEEPRUNNER_H
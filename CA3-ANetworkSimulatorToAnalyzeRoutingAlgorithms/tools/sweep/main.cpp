@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QRegularExpression>
+
+#include "ScenarioMatrix.h"
+#include "SweepRunner.h"
+
+// Parameter sweeps in one process: every scenario of a matrix (see tools/benchrunner) runs as a
+// batch simulation on a thread of its own, several at a time. Each run has its own
+// SimulationContext, so runs share nothing but the binary; traces are process-wide and are
+// dropped from the scenarios. One JSON line per run goes to --output or stdout.
+
+namespace {
+
+void quietMessageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    if (type != QtDebugMsg && type != QtInfoMsg) {
+        fprintf(stderr, "%s\n", qPrintable(message));
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    qInstallMessageHandler(quietMessageHandler);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Run every scenario of a matrix as concurrent in-process batch simulations.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("matrix", "Scenario matrix (JSON).");
+    QCommandLineOption jobsOption("jobs", "Simulations run at once (default: one per core).", "n",
+                                  QString::number(QThread::idealThreadCount()));
+    QCommandLineOption outputOption("output", "Write result lines here instead of stdout.", "file");
+    QCommandLineOption logsOption("log-root", "Keep each run's logs under this directory.", "dir");
+    QCommandLineOption repeatOption("repeat", "Runs per scenario. Overrides the matrix.", "n");
+    QCommandLineOption filterOption("filter", "Only scenarios whose name matches this regular expression.", "regex");
+    QCommandLineOption timeLimitOption("time-limit", "Wall-clock limit per run, e.g. 90s or 5min.", "duration");
+    parser.addOptions({jobsOption, outputOption, logsOption, repeatOption, filterOption, timeLimitOption});
+    parser.process(app);
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(2);
+    }
+
+    QString matrixPath = parser.positionalArguments().first();
+    QString error;
+    ScenarioMatrix matrix;
+    if (!matrix.load(matrixPath, &error)) {
+        qCritical() << "Invalid scenario matrix:" << error;
+        return 2;
+    }
+
+    QTemporaryDir tempDir;
+    QString logRoot = parser.isSet(logsOption) ? parser.value(logsOption) : tempDir.path();
+    int repeat = parser.isSet(repeatOption) ? qMax(1, parser.value(repeatOption).toInt()) : matrix.repeat();
+    QRegularExpression filter(parser.value(filterOption));
+
+    QVector<SweepRun> runs;
+    for (const Scenario &scenario : matrix.expand()) {
+        if (!filter.match(scenario.name).hasMatch()) continue;
+
+        for (int r = 0; r < repeat; ++r) {
+            SweepRun run;
+            run.index = runs.size();
+            run.repeat = r;
+            run.scenario = scenario;
+            run.scenario.config.remove("trace_file");
+            run.scenario.config.remove("timeline_file");
+            run.logDirectory = QDir(logRoot).filePath(QString("run-%1").arg(run.index));
+            QDir().mkpath(run.logDirectory);
+            runs.append(run);
+        }
+    }
+
+    QFile output;
+    bool opened;
+    if (parser.isSet(outputOption)) {
+        output.setFileName(parser.value(outputOption));
+        opened = output.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
+    } else {
+        opened = output.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+    if (!opened) {
+        qCritical() << "Cannot write" << output.fileName() << output.errorString();
+        return 2;
+    }
+
+    int jobs = qMax(1, parser.value(jobsOption).toInt());
+    QElapsedTimer wall;
+    wall.start();
+    SweepRunner runner(runs, jobs, matrixPath, parser.value(timeLimitOption), &output);
+    QObject::connect(&runner, &SweepRunner::finished, &app, &QCoreApplication::quit, Qt::QueuedConnection);
+    runner.start();
+    app.exec();
+    output.flush();
+
+    double seconds = wall.elapsed() / 1000.0;
+    fprintf(stderr, "%d runs, %d failed, %d jobs, %.1f s wall, %.2f runs/s, %.0f packets/s\n", runner.completed(),
+            runner.failures(), jobs, seconds, seconds > 0 ? runner.completed() / seconds : 0.0,
+            seconds > 0 ? runner.packetsProcessed() / seconds : 0.0);
+    return runner.failures() > 0 ? 1 : 0;
+}
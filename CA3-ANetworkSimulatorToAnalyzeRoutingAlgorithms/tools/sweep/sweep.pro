@@ -0,0 +1,17 @@
+TEMPLATE = app
+TARGET = sweep
+CONFIG += console c++20
+QT += core network
+
+SOURCES += $$PWD/main.cpp \
+           $$PWD/SweepRunner.cpp \
+           $$PWD/../benchrunner/ScenarioMatrix.cpp
+
+HEADERS += $$PWD/SweepRunner.h \
+           $$PWD/../benchrunner/ScenarioMatrix.h
+
+INCLUDEPATH += $$PWD/../../src \
+               $$PWD/../../src/Globals \
+               $$PWD/../benchrunner
+
+LIBS += -L$$PWD/../../lib -lcnca3lib
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstring>
+#include <QFile>
+#include <QVector>
+#include <QTextStream>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include "Trace/EventTrace.h"
+
+// Offline reader for the files EventTrace writes. Only the record layout is shared with the
+// simulator, so this links against Qt Core alone.
+
+namespace {
+
+QString describe(const TraceRecord &record)
+{
+    switch (static_cast<TraceEvent>(record.event)) {
+    case TraceEvent::PacketForward:
+        return QString("port=%1 ttl=%2").arg(record.arg0).arg(record.arg1);
+    case TraceEvent::PacketDrop:
+        return QString("reason=%1").arg(traceDropName(record.arg0));
+    case TraceEvent::RouteChange:
+        return QString("rib=%1 routes=%2").arg(record.arg0).arg(record.arg1);
+    default:
+        return QString();
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Decode a binary event trace written by the simulator.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("trace", "Trace file to read.");
+    QCommandLineOption csvOption("csv", "Print records as CSV.");
+    QCommandLineOption packetOption("packet", "Only print records for this packet id.", "id");
+    QCommandLineOption summaryOption("summary", "Only print per-event counts.");
+    parser.addOptions({csvOption, packetOption, summaryOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+
+    QFile file(parser.positionalArguments().first());
+    if (!file.open(QIODevice::ReadOnly)) {
+        err << "Cannot open " << file.fileName() << ": " << file.errorString() << Qt::endl;
+        return 1;
+    }
+
+    TraceFileHeader header;
+    if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header) ||
+        std::memcmp(header.magic, "CNTRACE1", sizeof(header.magic)) != 0) {
+        err << file.fileName() << " is not an event trace" << Qt::endl;
+        return 1;
+    }
+    if (header.version != TRACE_FORMAT_VERSION || header.recordSize != sizeof(TraceRecord)) {
+        err << "Unsupported trace version " << header.version << " (record size " << header.recordSize << ")"
+            << Qt::endl;
+        return 1;
+    }
+
+    // recordCount is only filled in by a clean stop. Otherwise take every slot that was written;
+    // unwritten slots are still zero.
+    quint64 available = static_cast<quint64>(file.size() - sizeof(TraceFileHeader)) / sizeof(TraceRecord);
+    bool complete = header.recordCount != 0;
+    quint64 count = qMin(complete ? header.recordCount : header.capacity, available);
+
+    QVector<TraceRecord> records(static_cast<qsizetype>(count));
+    file.read(reinterpret_cast<char *>(records.data()), static_cast<qint64>(count * sizeof(TraceRecord)));
+    if (!complete) {
+        records.erase(std::remove_if(records.begin(), records.end(),
+                                     [](const TraceRecord &record) { return record.event == 0; }),
+                      records.end());
+    }
+
+    // Threads flush in batches, so file order is only ordered per thread.
+    std::stable_sort(records.begin(), records.end(), [](const TraceRecord &a, const TraceRecord &b) {
+        return a.timestampNs < b.timestampNs;
+    });
+
+    bool ok = true;
+    qint64 packetFilter = parser.isSet(packetOption) ? parser.value(packetOption).toLongLong(&ok) : -1;
+    if (!ok) {
+        err << "Invalid packet id " << parser.value(packetOption) << Qt::endl;
+        return 1;
+    }
+
+    quint64 counts[8] = {};
+    if (parser.isSet(csvOption) && !parser.isSet(summaryOption)) {
+        out << "timestamp_ns,thread,node,event,packet,arg0,arg1" << Qt::endl;
+    }
+    for (const TraceRecord &record : records) {
+        if (packetFilter >= 0 && record.packetId != packetFilter) continue;
+        counts[record.event < 8 ? record.event : 0]++;
+        if (parser.isSet(summaryOption)) continue;
+
+        if (parser.isSet(csvOption)) {
+            out << record.timestampNs << ',' << record.thread << ',' << record.node << ','
+                << traceEventName(record.event) << ',' << record.packetId << ',' << record.arg0 << ','
+                << record.arg1 << '\n';
+        } else {
+            out << QString("%1 us  t%2  node %3  %4")
+                       .arg(record.timestampNs / 1000.0, 12, 'f', 3)
+                       .arg(record.thread, -3)
+                       .arg(record.node, -4)
+                       .arg(traceEventName(record.event), -8);
+            if (record.packetId >= 0) out << "  packet " << record.packetId;
+            QString details = describe(record);
+            if (!details.isEmpty()) out << "  " << details;
+            out << '\n';
+        }
+    }
+
+    if (!parser.isSet(csvOption) || parser.isSet(summaryOption)) {
+        out << "---" << Qt::endl;
+        out << records.size() << " records" << (complete ? "" : " (trace was not stopped cleanly)") << ", "
+            << header.dropped << " dropped, capacity " << header.capacity << Qt::endl;
+        for (quint16 event = 1; event < 8; ++event) {
+            if (counts[event]) out << "  " << traceEventName(event) << ": " << counts[event] << Qt::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tracedecode
+CONFIG += console c++20
+QT += core
+
+SOURCES += $$PWD/main.cpp
+
+INCLUDEPATH += $$PWD/../../src